@@ -325,6 +325,7 @@ DEFINE_Bool(disable_pk_storage_page_cache, "false");
 
 // Cache for mow primary key storage page size
 DEFINE_String(pk_storage_page_cache_limit, "10%");
+DEFINE_String(compressed_page_cache_limit, "0");
 // data page size for primary key index
 DEFINE_Int32(primary_key_data_page_size, "32768");
 
@@ -983,6 +984,7 @@ DEFINE_Validator(file_cache_min_file_segment_size, [](const int64_t config) -> b
 DEFINE_Bool(clear_file_cache, "false");
 DEFINE_Bool(enable_file_cache_query_limit, "false");
 DEFINE_mInt32(file_cache_wait_sec_after_fail, "0"); // // zero for no waiting and retrying
+DEFINE_mBool(enable_file_cache_tinylfu_admission, "false");
 
 DEFINE_mInt32(index_cache_entry_stay_time_after_lookup_s, "1800");
 DEFINE_mInt32(inverted_index_cache_stale_sweep_time_sec, "600");
@@ -1107,6 +1109,46 @@ DEFINE_Bool(exit_on_exception, "false");
 // cgroup
 DEFINE_String(doris_cgroup_cpu_path, "");
 
+DEFINE_mBool(enable_local_file_prefetch, "true");
+
+DEFINE_mBool(enable_page_predicate_evaluation, "true");
+
+DEFINE_String(storage_page_cache_eviction_policy, "LRU");
+DEFINE_Validator(storage_page_cache_eviction_policy, [](const std::string& config) -> bool {
+    return config == "LRU" || config == "CLOCK";
+});
+
+DEFINE_String(tinylfu_admission_cache_types, "");
+
+DEFINE_mInt32(segment_read_ahead_max_pages, "8");
+
+DEFINE_mBool(enable_remote_file_prefetch, "true");
+
+DEFINE_mBool(enable_hash_join_radix_partition, "false");
+
+DEFINE_mInt32(spill_sort_merge_parallelism, "8");
+
+DEFINE_mInt32(agg_finalize_parallelism, "1");
+
+DEFINE_mInt32(streaming_agg_sample_interval, "8");
+
+DEFINE_mBool(enable_exchange_hot_key_detection, "false");
+
+DEFINE_mBool(enable_exchange_column_encoding, "false");
+
+DEFINE_Bool(enable_pipeline_numa_affinity, "false");
+
+DEFINE_mInt32(blocked_task_scheduler_idle_wait_us, "0");
+
+DEFINE_mInt32(memtable_sort_parallelism, "4");
+DEFINE_mInt32(memtable_parallel_sort_min_rows, "65536");
+
+DEFINE_mInt32(memtable_writer_shard_num, "1");
+
+DEFINE_mInt32(segment_writer_min_columns_per_thread, "32");
+
+DEFINE_mInt32(mow_pk_hash_index_max_rows, "0");
+
 // clang-format off
 #ifdef BE_TEST
 // test s3
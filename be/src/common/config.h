@@ -376,6 +376,10 @@ DECLARE_Bool(disable_pk_storage_page_cache);
 // Cache for mow primary key storage page size, it's seperated from
 // storage_page_cache_limit
 DECLARE_String(pk_storage_page_cache_limit);
+// Cache for the still compressed storage pages, it's the second tier of storage page cache.
+// A page missing in storage page cache but found here is decompressed without reading file.
+// "0" means disabled.
+DECLARE_String(compressed_page_cache_limit);
 // data page size for primary key index
 DECLARE_Int32(primary_key_data_page_size);
 
@@ -1023,6 +1027,9 @@ DECLARE_Bool(clear_file_cache);
 DECLARE_Bool(enable_file_cache_query_limit);
 // only for debug, will be removed after finding out the root cause
 DECLARE_mInt32(file_cache_wait_sec_after_fail); // zero for no waiting and retrying
+// Use TinyLFU admission for the query queue of file cache: when the queue is full a new file
+// segment is only cached if it is read more frequently than the segment to be evicted.
+DECLARE_mBool(enable_file_cache_tinylfu_admission);
 
 // inverted index searcher cache
 // cache entry stay time after lookup
@@ -1183,6 +1190,91 @@ DECLARE_mBool(exit_on_exception);
 // cgroup
 DECLARE_String(doris_cgroup_cpu_path);
 
+// Whether to hint the kernel to read pages of local segment files in the background before
+// they are actually read, e.g. all pages touched by a batch of rowids.
+DECLARE_mBool(enable_local_file_prefetch);
+
+// Whether to evaluate comparison predicates directly on the decoded data pages for columns
+// which are only used for filtering, without materializing their values.
+DECLARE_mBool(enable_page_predicate_evaluation);
+
+// Replacement policy of storage page cache shards, "LRU" or "CLOCK".
+// CLOCK lets lookups share the shard lock, which scales better with many scanner threads.
+DECLARE_String(storage_page_cache_eviction_policy);
+
+// Comma separated cache types, e.g. "DataPageCache,IndexPageCache", which use TinyLFU admission:
+// when the cache is full a new entry is only admitted if it is accessed more frequently than
+// the entry to be evicted, so a large scan does not flush the hot entries out of the cache.
+DECLARE_String(tinylfu_admission_cache_types);
+
+// Max number of data pages a column iterator reads ahead during a sequential segment scan.
+// The window starts from one page and doubles as long as the scan keeps consuming the pages
+// read ahead. 0 disables read ahead.
+DECLARE_mInt32(segment_read_ahead_max_pages);
+
+// Whether to warm the file cache in the background for ranges of remote segment files which
+// are going to be read, e.g. data pages read ahead by sequential scans.
+DECLARE_mBool(enable_remote_file_prefetch);
+
+// Whether to radix partition the rows of hash join build and probe by the sub table of the
+// partitioned hash table, so the inserts and lookups of a batch run sub table by sub table
+// on a cache resident working set instead of hitting random sub tables.
+DECLARE_mBool(enable_hash_join_radix_partition);
+
+// The max number of intermediate merges of spilled sort runs that one sort node runs
+// concurrently, each merge runs in SpillSortMergeThreadPool. 1 means merging serially.
+DECLARE_mInt32(spill_sort_merge_parallelism);
+
+// The max number of result batches that the final phase of aggregation finalizes
+// concurrently in AggFinalizeThreadPool, each batch holds batch size groups. 1 means
+// finalizing the groups serially by the source task.
+DECLARE_mInt32(agg_finalize_parallelism);
+
+// Once a streaming pre-aggregation passes its input through, it samples the keys of one
+// block out of this many and resumes aggregating if they repeat enough. 0 means never
+// resuming, the pre-aggregation streams until the end once it stops expanding.
+DECLARE_mInt32(streaming_agg_sample_interval);
+
+// Whether hash partitioned exchanges look for the partition keys which alone take more than
+// the fair share of one receiver and report them, with the bytes sent to each receiver, in
+// the profile. Experimental, off by default.
+DECLARE_mBool(enable_exchange_hot_key_detection);
+
+// Whether exchanges encode the integer and low cardinality string columns of the blocks they
+// send before compressing them. Only enable it once all the BEs of the cluster can decode them.
+DECLARE_mBool(enable_exchange_column_encoding);
+
+// Whether the pipeline workers are spread over the NUMA nodes and bound to the cores of their
+// node. The tasks of a fragment instance then run on one node, so the memory they allocate is
+// local to it, and workers only steal tasks of the other nodes when their node has none.
+DECLARE_Bool(enable_pipeline_numa_affinity);
+
+// How long the blocked task scheduler sleeps when none of its tasks became runnable. Scans
+// and exchange rpcs wake it up as soon as they make progress, but not all the events a task
+// may wait for do, e.g. runtime filters, hash join builds and pending finish, the timeout
+// bounds their delay. 0 keeps polling the tasks without sleeping.
+DECLARE_mInt32(blocked_task_scheduler_idle_wait_us);
+
+// The max number of threads of the flush pool which sort the rows of one flushed memtable, the
+// idle threads sort chunks of at least memtable_parallel_sort_min_rows rows which are merged
+// afterwards. 1 sorts every memtable on its flushing thread.
+DECLARE_mInt32(memtable_sort_parallelism);
+DECLARE_mInt32(memtable_parallel_sort_min_rows);
+
+// The number of memtables the concurrent writers of one duplicate key tablet insert into, each
+// of them is flushed to its own segments. 1 serializes the writes of a tablet on one memtable.
+DECLARE_mInt32(memtable_writer_shard_num);
+
+// The columns of a segment written by a memtable flush are encoded and compressed by up to one
+// idle thread of the flush pool per this many columns. 0 writes every segment on the flushing
+// thread.
+DECLARE_mInt32(segment_writer_min_columns_per_thread);
+
+// The primary key lookups of merge-on-write tables probe an in-memory hash index of the keys of
+// segments with at most this many rows, built once the segment is first looked up in and kept
+// with the cached segment. 0 disables the hash index.
+DECLARE_mInt32(mow_pk_hash_index_max_rows);
+
 #ifdef BE_TEST
 // test s3
 DECLARE_String(test_s3_resource);
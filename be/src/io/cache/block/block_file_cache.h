@@ -70,6 +70,8 @@ struct CacheContext {
     CacheContext() = default;
     TUniqueId query_id;
     CacheType cache_type;
+    // blocks got by a prefetch are not counted as accessed by the admission policy
+    bool is_prefetch = false;
 };
 
 /**
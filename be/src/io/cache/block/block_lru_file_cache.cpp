@@ -40,6 +40,7 @@
 #include <system_error>
 #include <utility>
 
+#include "common/config.h"
 #include "common/status.h"
 #include "io/cache/block/block_file_cache.h"
 #include "io/cache/block/block_file_cache_fwd.h"
@@ -60,6 +61,7 @@ namespace io {
 
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(file_cache_hits_ratio, MetricUnit::NOUNIT);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(file_cache_removed_elements, MetricUnit::OPERATIONS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(file_cache_admission_rejected_elements, MetricUnit::OPERATIONS);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(file_cache_index_queue_max_size, MetricUnit::BYTES);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(file_cache_index_queue_curr_size, MetricUnit::BYTES);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(file_cache_index_queue_max_elements, MetricUnit::NOUNIT);
@@ -83,6 +85,9 @@ LRUFileCache::LRUFileCache(const std::string& cache_base_path,
                             7 * 24 * 60 * 60);
     _normal_queue = LRUQueue(cache_settings.query_queue_size, cache_settings.query_queue_elements,
                              24 * 60 * 60);
+    // TinyLFU admission of the query queue is switched by a mutable config, size the sketch
+    // up front so the accesses are counted as soon as it is enabled
+    _sketch.ensure_capacity(cache_settings.query_queue_elements);
 
     _entity = DorisMetrics::instance()->metric_registry()->register_entity(
             "lru_file_cache", {{"path", _cache_base_path}});
@@ -90,6 +95,7 @@ LRUFileCache::LRUFileCache(const std::string& cache_base_path,
 
     INT_DOUBLE_METRIC_REGISTER(_entity, file_cache_hits_ratio);
     INT_UGAUGE_METRIC_REGISTER(_entity, file_cache_removed_elements);
+    INT_UGAUGE_METRIC_REGISTER(_entity, file_cache_admission_rejected_elements);
 
     INT_UGAUGE_METRIC_REGISTER(_entity, file_cache_index_queue_max_size);
     INT_UGAUGE_METRIC_REGISTER(_entity, file_cache_index_queue_curr_size);
@@ -394,9 +400,15 @@ FileBlocksHolder LRUFileCache::get_or_set(const Key& key, size_t offset, size_t
     DCHECK(!file_blocks.empty());
     _num_read_segments += file_blocks.size();
     for (auto& segment : file_blocks) {
-        if (segment->state() == FileBlock::State::DOWNLOADED) {
+        auto state = segment->state();
+        if (state == FileBlock::State::DOWNLOADED) {
             _num_hit_segments++;
         }
+        // one access of the segment, its admission when it is reserved does not count again
+        if (config::enable_file_cache_tinylfu_admission && !context.is_prefetch &&
+            context.cache_type == CacheType::NORMAL && state != FileBlock::State::SKIP_CACHE) {
+            _sketch.increment(sketch_hash(key, segment->offset()));
+        }
     }
     return FileBlocksHolder(std::move(file_blocks));
 }
@@ -688,6 +700,11 @@ bool LRUFileCache::try_reserve_for_lru(const Key& key, QueryFileCacheContextPtr
                    queue_element_size >= max_element_size;
         };
 
+        if (context.cache_type == CacheType::NORMAL && is_overflow() &&
+            !admit(key, offset, queue, cache_lock)) {
+            return false;
+        }
+
         std::vector<FileBlockCell*> to_evict;
         std::vector<FileBlockCell*> trash;
         for (const auto& [entry_key, entry_offset, entry_size] : queue) {
@@ -748,6 +765,28 @@ bool LRUFileCache::try_reserve_for_lru(const Key& key, QueryFileCacheContextPtr
     return true;
 }
 
+bool LRUFileCache::admit(const Key& key, size_t offset, LRUQueue& queue,
+                         std::lock_guard<std::mutex>& cache_lock) {
+    if (!config::enable_file_cache_tinylfu_admission) {
+        return true;
+    }
+    // the access was counted by get_or_set
+    uint64_t hash = sketch_hash(key, offset);
+    // the victim is the least recently used file segment which can be evicted
+    for (const auto& [entry_key, entry_offset, entry_size] : queue) {
+        auto* cell = get_cell(entry_key, entry_offset, cache_lock);
+        if (cell == nullptr || !cell->releasable()) {
+            continue;
+        }
+        if (_sketch.frequency(hash) > _sketch.frequency(sketch_hash(entry_key, entry_offset))) {
+            return true;
+        }
+        ++_num_admission_rejected_segments;
+        return false;
+    }
+    return true;
+}
+
 void LRUFileCache::remove(FileBlockSPtr file_block, std::lock_guard<std::mutex>& cache_lock,
                           std::lock_guard<std::mutex>&) {
     auto key = file_block->key();
@@ -1106,6 +1145,7 @@ void LRUFileCache::update_cache_metrics() const {
 
     file_cache_hits_ratio->set_value(hit_ratio);
     file_cache_removed_elements->set_value(_num_removed_segments);
+    file_cache_admission_rejected_elements->set_value(_num_admission_rejected_segments);
 
     file_cache_index_queue_max_size->set_value(_index_queue.get_max_size());
     file_cache_index_queue_curr_size->set_value(_index_queue.get_total_cache_size(l));
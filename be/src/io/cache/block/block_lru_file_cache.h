@@ -34,6 +34,7 @@
 #include "common/status.h"
 #include "io/cache/block/block_file_cache.h"
 #include "io/cache/block/block_file_segment.h"
+#include "util/frequency_sketch.h"
 #include "util/metrics.h"
 
 namespace doris {
@@ -188,6 +189,15 @@ private:
 
     bool need_to_move(CacheType cell_type, CacheType query_type) const;
 
+    static uint64_t sketch_hash(const Key& key, size_t offset) {
+        return KeyHash()(key) ^ (offset * 0x9e3779b97f4a7c15ULL);
+    }
+
+    // TinyLFU admission of the query queue, return false if the file segment should not be
+    // cached because it is read less frequently than the segment to be evicted.
+    bool admit(const Key& key, size_t offset, LRUQueue& queue,
+               std::lock_guard<std::mutex>& cache_lock);
+
     void run_background_operation();
 
     void update_cache_metrics() const;
@@ -201,11 +211,15 @@ private:
     size_t _num_read_segments = 0;
     size_t _num_hit_segments = 0;
     size_t _num_removed_segments = 0;
+    size_t _num_admission_rejected_segments = 0;
+    // access frequency of file segments, protected by _mutex
+    FrequencySketch _sketch;
 
     std::shared_ptr<MetricEntity> _entity = nullptr;
 
     DoubleGauge* file_cache_hits_ratio = nullptr;
     UIntGauge* file_cache_removed_elements = nullptr;
+    UIntGauge* file_cache_admission_rejected_elements = nullptr;
 
     UIntGauge* file_cache_index_queue_max_size = nullptr;
     UIntGauge* file_cache_index_queue_curr_size = nullptr;
@@ -34,9 +34,11 @@
 #include "io/cache/block/block_file_segment.h"
 #include "io/fs/file_reader.h"
 #include "io/io_common.h"
+#include "runtime/exec_env.h"
 #include "util/bit_util.h"
 #include "util/doris_metrics.h"
 #include "util/runtime_profile.h"
+#include "util/threadpool.h"
 
 namespace doris {
 namespace io {
@@ -75,6 +77,62 @@ Status CachedRemoteFileReader::close() {
     return _remote_file_reader->close();
 }
 
+void CachedRemoteFileReader::prefetch_range(size_t offset, size_t bytes,
+                                            const IOContext* io_ctx) {
+    if (!config::enable_remote_file_prefetch || io_ctx == nullptr || !io_ctx->read_file_cache ||
+        closed() || offset >= size() || bytes == 0) {
+        return;
+    }
+    auto* pool = ExecEnv::GetInstance()->buffered_reader_prefetch_thread_pool();
+    // the task may outlive the reader of the query
+    auto reader = weak_from_this().lock();
+    if (pool == nullptr || reader == nullptr) {
+        return;
+    }
+    IOContext ctx = *io_ctx;
+    // refs of the query are not valid in the background task
+    ctx.query_id = nullptr;
+    ctx.file_cache_stats = nullptr;
+    bytes = std::min(bytes, size() - offset);
+    pool->submit_func([reader = std::move(reader), offset, bytes, ctx]() {
+        Status st = reader->_download_into_cache(offset, bytes, &ctx);
+        if (!st.ok()) {
+            LOG_EVERY_N(WARNING, 100)
+                    << "failed to prefetch " << reader->path().native() << ": " << st;
+        }
+    });
+}
+
+Status CachedRemoteFileReader::_download_into_cache(size_t offset, size_t bytes,
+                                                   const IOContext* io_ctx) {
+    auto [align_left, align_size] = _align_size(offset, bytes);
+    CacheContext cache_context(io_ctx);
+    cache_context.is_prefetch = true;
+    FileBlocksHolder holder = _cache->get_or_set(_cache_key, align_left, align_size, cache_context);
+    // Blocks are downloaded one by one through a buffer of the prefetch thread, which is at
+    // most file_cache_max_file_segment_size large. Blocks downloaded by others are not waited
+    // for, and blocks which skip the cache are not read at all.
+    static thread_local std::vector<char> buffer;
+    for (auto& block : holder.file_segments) {
+        if (block->state() != FileBlock::State::EMPTY) {
+            continue;
+        }
+        block->get_or_set_downloader();
+        if (!block->is_downloader()) {
+            continue;
+        }
+        size_t block_size = block->range().size();
+        buffer.resize(block_size);
+        size_t bytes_read = 0;
+        RETURN_IF_ERROR(_remote_file_reader->read_at(
+                block->range().left, Slice(buffer.data(), block_size), &bytes_read, io_ctx));
+        DorisMetrics::instance()->s3_bytes_read_total->increment(bytes_read);
+        RETURN_IF_ERROR(block->append(Slice(buffer.data(), block_size)));
+        RETURN_IF_ERROR(block->finalize_write());
+    }
+    return Status::OK();
+}
+
 std::pair<size_t, size_t> CachedRemoteFileReader::_align_size(size_t offset,
                                                               size_t read_size) const {
     size_t left = offset;
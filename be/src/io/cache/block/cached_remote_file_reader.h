@@ -36,7 +36,8 @@ namespace io {
 struct IOContext;
 struct FileCacheStatistics;
 
-class CachedRemoteFileReader final : public FileReader {
+class CachedRemoteFileReader final : public FileReader,
+                                     public std::enable_shared_from_this<CachedRemoteFileReader> {
 public:
     CachedRemoteFileReader(FileReaderSPtr remote_file_reader, const FileReaderOptions& opts);
 
@@ -54,6 +55,10 @@ public:
 
     FileReader* get_remote_reader() { return _remote_file_reader.get(); }
 
+    // Download the range into file cache in the background, so the following read of it hits
+    // the cache. It is a hint, errors are ignored.
+    void prefetch_range(size_t offset, size_t bytes, const IOContext* io_ctx) override;
+
 protected:
     Status read_at_impl(size_t offset, Slice result, size_t* bytes_read,
                         const IOContext* io_ctx) override;
@@ -79,6 +84,8 @@ private:
 
     Status _read_from_cache(size_t offset, Slice result, size_t* bytes_read,
                             const IOContext* io_ctx);
+    // Download the blocks of the range which are not in file cache yet, nothing is read out.
+    Status _download_into_cache(size_t offset, size_t bytes, const IOContext* io_ctx);
 };
 
 } // namespace io
@@ -74,6 +74,10 @@ public:
     Status read_at(size_t offset, Slice result, size_t* bytes_read,
                    const IOContext* io_ctx = nullptr);
 
+    /// Hint that [offset, offset + bytes) will be read soon. Readers which are able to load
+    /// the range in the background start doing so and return immediately, others ignore it.
+    virtual void prefetch_range(size_t offset, size_t bytes, const IOContext* io_ctx = nullptr) {}
+
     virtual Status close() = 0;
 
     virtual const Path& path() const = 0;
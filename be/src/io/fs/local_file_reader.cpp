@@ -20,6 +20,7 @@
 #include <bthread/bthread.h>
 // IWYU pragma: no_include <bthread/errno.h>
 #include <errno.h> // IWYU pragma: keep
+#include <fcntl.h>
 #include <fmt/format.h>
 #include <glog/logging.h>
 #include <unistd.h>
@@ -32,6 +33,7 @@
 
 // IWYU pragma: no_include <opentelemetry/common/threadlocal.h>
 #include "common/compiler_util.h" // IWYU pragma: keep
+#include "common/config.h"
 #include "io/fs/err_utils.h"
 #include "util/async_io.h"
 #include "util/doris_metrics.h"
@@ -108,5 +110,21 @@ Status LocalFileReader::read_at_impl(size_t offset, Slice result, size_t* bytes_
     return Status::OK();
 }
 
+void LocalFileReader::prefetch_range(size_t offset, size_t bytes, const IOContext* /*io_ctx*/) {
+    if (!config::enable_local_file_prefetch || closed() || offset >= _file_size) {
+        return;
+    }
+    bytes = std::min(bytes, _file_size - offset);
+    // POSIX_FADV_WILLNEED only queues the reads of the range into page cache, so the following
+    // pread of the range will not wait for the disk.
+    int res = ::posix_fadvise(_fd, offset, bytes, POSIX_FADV_WILLNEED);
+    if (UNLIKELY(res != 0)) {
+        LOG_EVERY_N(WARNING, 100) << fmt::format("failed to prefetch {}: {}", _path.native(),
+                                                 std::strerror(res));
+        return;
+    }
+    DorisMetrics::instance()->local_bytes_prefetched_total->increment(bytes);
+}
+
 } // namespace io
 } // namespace doris
@@ -49,6 +49,8 @@ public:
 
     FileSystemSPtr fs() const override { return _fs; }
 
+    void prefetch_range(size_t offset, size_t bytes, const IOContext* io_ctx) override;
+
 private:
     Status read_at_impl(size_t offset, Slice result, size_t* bytes_read,
                         const IOContext* io_ctx) override;
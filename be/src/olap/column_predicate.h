@@ -196,6 +196,14 @@ public:
         DCHECK(false) << "should not reach here";
     }
 
+    // evaluate on `size` fixed length values stored contiguously in `data`, e.g. the decoded
+    // buffer of a data page, and AND the result into flags.
+    // return false if the values can not be evaluated in this layout.
+    virtual bool evaluate_and_raw(const void* data, size_t size_of_element, uint16_t size,
+                                  bool* flags) const {
+        return false;
+    }
+
     virtual std::string get_search_str() const {
         DCHECK(false) << "should not reach here";
         return "";
@@ -326,6 +326,22 @@ public:
         _evaluate_vec_internal<true>(column, size, flags);
     }
 
+    bool evaluate_and_raw(const void* data, size_t size_of_element, uint16_t size,
+                          bool* flags) const override {
+        // only types whose predicate column keeps the same layout as the storage page
+        if constexpr (std::is_same_v<T, StringRef> || Type == TYPE_DATE ||
+                      Type == TYPE_DATETIME || Type == TYPE_DECIMALV2 || Type == TYPE_BOOLEAN) {
+            return false;
+        } else {
+            if (_opposite || size_of_element != sizeof(T)) {
+                return false;
+            }
+            _base_loop_vec<false, true>(size, flags, nullptr, reinterpret_cast<const T*>(data),
+                                        _value);
+            return true;
+        }
+    }
+
 private:
     template <typename LeftT, typename RightT>
     bool _operator(const LeftT& lhs, const RightT& rhs) const {
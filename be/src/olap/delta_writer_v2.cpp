@@ -141,12 +141,16 @@ Status DeltaWriterV2::write(const vectorized::Block* block, const std::vector<in
     if (UNLIKELY(row_idxs.empty() && !is_append)) {
         return Status::OK();
     }
-    _lock_watch.start();
-    std::lock_guard<std::mutex> l(_lock);
-    _lock_watch.stop();
-    if (!_is_init && !_is_cancelled) {
-        RETURN_IF_ERROR(init());
+    {
+        _lock_watch.start();
+        std::lock_guard<std::mutex> l(_lock);
+        _lock_watch.stop();
+        if (!_is_init && !_is_cancelled) {
+            RETURN_IF_ERROR(init());
+        }
     }
+    // the memtable writer synchronizes the writes itself, the writes of a duplicate key tablet
+    // may run concurrently
     SCOPED_TIMER(_write_memtable_timer);
     return _memtable_writer->write(block, row_idxs, is_append);
 }
@@ -385,27 +385,28 @@ public:
         if constexpr (PT == PredicateType::IN_LIST) {
             // IN predicate can not use ngram bf, just return true to accept
             if (bf->is_ngram_bf()) return true;
-            HybridSetBase::IteratorBase* iter = _values->begin();
-            while (iter->has_next()) {
-                if constexpr (std::is_same_v<T, StringRef>) {
-                    const StringRef* value = (const StringRef*)iter->get_value();
-                    if (bf->test_bytes(value->data, value->size)) {
-                        return true;
-                    }
-                } else if constexpr (Type == TYPE_DATE) {
-                    const void* value = iter->get_value();
-                    if (bf->test_bytes(reinterpret_cast<const char*>(value), sizeof(uint24_t))) {
-                        return true;
-                    }
-                } else {
-                    const T* value = (const T*)(iter->get_value());
-                    if (bf->test_bytes(reinterpret_cast<const char*>(value), sizeof(*value))) {
-                        return true;
+            // the values are hashed once and tested against the bloom filter of every page
+            // in batch
+            if (!_bf_hashes_ready) {
+                HybridSetBase::IteratorBase* iter = _values->begin();
+                while (iter->has_next()) {
+                    if constexpr (std::is_same_v<T, StringRef>) {
+                        const StringRef* value = (const StringRef*)iter->get_value();
+                        _bf_hashes.push_back(bf->hash(value->data, value->size));
+                    } else if constexpr (Type == TYPE_DATE) {
+                        const void* value = iter->get_value();
+                        _bf_hashes.push_back(
+                                bf->hash(reinterpret_cast<const char*>(value), sizeof(uint24_t)));
+                    } else {
+                        const T* value = (const T*)(iter->get_value());
+                        _bf_hashes.push_back(
+                                bf->hash(reinterpret_cast<const char*>(value), sizeof(*value)));
                     }
+                    iter->next();
                 }
-                iter->next();
+                _bf_hashes_ready = true;
             }
-            return false;
+            return bf->test_any_hash(_bf_hashes.data(), _bf_hashes.size());
         } else {
             LOG(FATAL) << "Bloom filter is not supported by predicate type.";
             return true;
@@ -591,6 +592,9 @@ private:
     std::shared_ptr<HybridSetBase> _values;
     mutable std::map<std::pair<RowsetId, uint32_t>, std::vector<vectorized::UInt8>>
             _segment_id_to_value_in_dict_flags;
+    // hashes of _values for bloom filter, all bloom filter indexes use the same hash function
+    mutable std::vector<uint64_t> _bf_hashes;
+    mutable bool _bf_hashes_ready = false;
     T _min_value;
     T _max_value;
 
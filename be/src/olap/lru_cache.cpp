@@ -8,6 +8,7 @@
 
 #include <mutex>
 #include <new>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
 
@@ -26,6 +27,7 @@ DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(cache_usage_ratio, MetricUnit::NOUNIT);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(cache_lookup_count, MetricUnit::OPERATIONS);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(cache_hit_count, MetricUnit::OPERATIONS);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(cache_hit_ratio, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(cache_admission_reject_count, MetricUnit::OPERATIONS);
 
 uint32_t CacheKey::hash(const char* data, size_t n, uint32_t seed) const {
     // Similar to murmur hash
@@ -233,6 +235,9 @@ void LRUCache::_lru_append(LRUHandle* list, LRUHandle* e) {
 Cache::Handle* LRUCache::lookup(const CacheKey& key, uint32_t hash) {
     std::lock_guard l(_mutex);
     ++_lookup_count;
+    if (_admission_policy == CacheAdmissionPolicy::TINY_LFU) {
+        _sketch.increment(hash);
+    }
     LRUHandle* e = _table.lookup(key, hash);
     if (e != nullptr) {
         // we get it from _table, so in_cache must be true
@@ -247,6 +252,11 @@ Cache::Handle* LRUCache::lookup(const CacheKey& key, uint32_t hash) {
     return reinterpret_cast<Cache::Handle*>(e);
 }
 
+bool LRUCache::contains(const CacheKey& key, uint32_t hash) {
+    std::lock_guard l(_mutex);
+    return _table.lookup(key, hash) != nullptr;
+}
+
 void LRUCache::release(Cache::Handle* handle) {
     if (handle == nullptr) {
         return;
@@ -347,34 +357,79 @@ bool LRUCache::_check_element_count_limit() {
     return _element_count_capacity != 0 && _table.element_count() >= _element_count_capacity;
 }
 
-Cache::Handle* LRUCache::insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
-                                void (*deleter)(const CacheKey& key, void* value),
-                                MemTrackerLimiter* tracker, CachePriority priority, size_t bytes) {
+bool LRUCache::_admit(const LRUHandle* e) {
+    if (_admission_policy != CacheAdmissionPolicy::TINY_LFU ||
+        e->priority != CachePriority::NORMAL || _cache_value_check_timestamp) {
+        return true;
+    }
+    // there is still room for the new entry, nothing will be evicted
+    if (_usage + e->total_size <= _capacity && !_check_element_count_limit()) {
+        return true;
+    }
+    const LRUHandle* victim = _lru_normal.next;
+    if (victim == &_lru_normal) {
+        return true;
+    }
+    // replacing the value of an existing key is always allowed
+    if (_table.lookup(e->key(), e->hash) != nullptr) {
+        return true;
+    }
+    return _sketch.frequency(e->hash) > _sketch.frequency(victim->hash);
+}
+
+static LRUHandle* create_lru_handle(LRUCacheType type, const CacheKey& key, uint32_t hash,
+                                    void* value, size_t charge,
+                                    void (*deleter)(const CacheKey& key, void* value),
+                                    MemTrackerLimiter* tracker, CachePriority priority,
+                                    size_t bytes) {
     size_t handle_size = sizeof(LRUHandle) - 1 + key.size();
     LRUHandle* e = reinterpret_cast<LRUHandle*>(malloc(handle_size));
     e->value = value;
     e->deleter = deleter;
     e->charge = charge;
     e->key_length = key.size();
-    e->total_size = (_type == LRUCacheType::SIZE ? handle_size + charge : 1);
-    DCHECK(_type == LRUCacheType::SIZE || bytes != -1) << " _type " << _type;
-    e->bytes = (_type == LRUCacheType::SIZE ? handle_size + charge : handle_size + bytes);
+    e->total_size = (type == LRUCacheType::SIZE ? handle_size + charge : 1);
+    DCHECK(type == LRUCacheType::SIZE || bytes != -1) << " _type " << type;
+    e->bytes = (type == LRUCacheType::SIZE ? handle_size + charge : handle_size + bytes);
     e->hash = hash;
     e->refs = 2; // one for the returned handle, one for LRUCache.
     e->next = e->prev = nullptr;
     e->in_cache = true;
+    e->referenced = false;
     e->priority = priority;
     e->mem_tracker = tracker;
-    e->type = _type;
+    e->type = type;
     memcpy(e->key_data, key.data(), key.size());
     // The memory of the parameter value should be recorded in the tls mem tracker,
     // transfer the memory ownership of the value to ShardedLRUCache::_mem_tracker.
     THREAD_MEM_TRACKER_TRANSFER_TO(e->bytes, tracker);
     DorisMetrics::instance()->lru_cache_memory_bytes->increment(e->bytes);
+    return e;
+}
+
+Cache::Handle* LRUCache::insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
+                                void (*deleter)(const CacheKey& key, void* value),
+                                MemTrackerLimiter* tracker, CachePriority priority, size_t bytes) {
+    LRUHandle* e =
+            create_lru_handle(_type, key, hash, value, charge, deleter, tracker, priority, bytes);
     LRUHandle* to_remove_head = nullptr;
     {
         std::lock_guard l(_mutex);
 
+        if (_admission_policy == CacheAdmissionPolicy::TINY_LFU) {
+            // the access was counted by the lookup which missed the key
+            _sketch.ensure_capacity(_table.element_count() + 1);
+        }
+        if (!_admit(e)) {
+            // The entry is not put into the cache, it is only visible to the caller
+            // and freed when the caller releases it.
+            e->in_cache = false;
+            e->refs = 1;
+            _usage += e->total_size;
+            ++_admission_reject_count;
+            return reinterpret_cast<Cache::Handle*>(e);
+        }
+
         // Free the space following strict LRU policy until enough space
         // is freed or the lru list is empty
         if (_cache_value_check_timestamp) {
@@ -511,16 +566,250 @@ void LRUCache::set_cache_value_check_timestamp(bool cache_value_check_timestamp)
     _cache_value_check_timestamp = cache_value_check_timestamp;
 }
 
+void LRUCache::set_admission_policy(CacheAdmissionPolicy admission_policy) {
+    std::lock_guard l(_mutex);
+    _admission_policy = admission_policy;
+    if (_admission_policy != CacheAdmissionPolicy::TINY_LFU) {
+        return;
+    }
+    // Size the sketch for the entries the cache is expected to hold, so the accesses are counted
+    // from the first lookup. A cache charged by bytes is assumed to hold entries of the default
+    // data page size, the sketch still grows with the entries when they are smaller.
+    size_t expected_element_count = _element_count_capacity;
+    if (expected_element_count == 0) {
+        expected_element_count =
+                _type == LRUCacheType::NUMBER ? _capacity : _capacity / (64 * 1024);
+    }
+    _sketch.ensure_capacity(expected_element_count);
+}
+
+ClockCache::ClockCache(LRUCacheType type) : _type(type) {
+    // Make empty ring
+    _ring.next = &_ring;
+    _ring.prev = &_ring;
+    _hand = &_ring;
+}
+
+ClockCache::~ClockCache() {
+    prune();
+}
+
+bool ClockCache::_unref(LRUHandle* e) {
+    uint32_t refs = std::atomic_ref<uint32_t>(e->refs).fetch_sub(1, std::memory_order_acq_rel);
+    DCHECK(refs > 0);
+    return refs == 1;
+}
+
+void ClockCache::_ring_remove(LRUHandle* e) {
+    if (_hand == e) {
+        // let the hand continue from the next entry
+        _hand = e->prev;
+    }
+    e->next->prev = e->prev;
+    e->prev->next = e->next;
+    e->prev = e->next = nullptr;
+}
+
+void ClockCache::_ring_append(LRUHandle* e) {
+    // Make "e" newest entry by inserting just before the dummy head
+    e->next = &_ring;
+    e->prev = _ring.prev;
+    e->prev->next = e;
+    e->next->prev = e;
+}
+
+bool ClockCache::_need_evict(size_t total_size) const {
+    return _usage.load(std::memory_order_relaxed) + total_size > _capacity ||
+           (_element_count_capacity != 0 && _table.element_count() >= _element_count_capacity);
+}
+
+// REQUIRES: exclusive lock held, e is in cache.
+void ClockCache::_remove_from_cache(LRUHandle* e, LRUHandle** to_remove_head) {
+    _ring_remove(e);
+    e->in_cache = false;
+    _usage.fetch_sub(e->total_size, std::memory_order_relaxed);
+    if (_unref(e)) {
+        e->next = *to_remove_head;
+        *to_remove_head = e;
+    }
+}
+
+// REQUIRES: exclusive lock held, e is in cache and not in use.
+void ClockCache::_evict_one_entry(LRUHandle* e, LRUHandle** to_remove_head) {
+    DCHECK(e->in_cache);
+    bool removed = _table.remove(e);
+    DCHECK(removed);
+    _remove_from_cache(e, to_remove_head);
+}
+
+void ClockCache::_evict(size_t total_size, LRUHandle** to_remove_head) {
+    // Nobody can take a new reference while we hold the exclusive lock, so an entry
+    // with refs == 1 is owned by the cache only and stays so.
+    for (auto evictable : {CachePriority::NORMAL, CachePriority::DURABLE}) {
+        // two rounds are enough, the first one clears all referenced flags
+        size_t steps = 2 * _table.element_count();
+        while (steps-- > 0 && _need_evict(total_size) && _ring.next != &_ring) {
+            LRUHandle* e = _hand->next == &_ring ? _ring.next : _hand->next;
+            _hand = e;
+            if (e->priority > evictable ||
+                std::atomic_ref<uint32_t>(e->refs).load(std::memory_order_acquire) > 1) {
+                continue;
+            }
+            if (std::atomic_ref<bool>(e->referenced).exchange(false, std::memory_order_relaxed)) {
+                // second chance
+                continue;
+            }
+            _evict_one_entry(e, to_remove_head);
+        }
+    }
+}
+
+Cache::Handle* ClockCache::insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
+                                  void (*deleter)(const CacheKey& key, void* value),
+                                  MemTrackerLimiter* tracker, CachePriority priority,
+                                  size_t bytes) {
+    LRUHandle* e =
+            create_lru_handle(_type, key, hash, value, charge, deleter, tracker, priority, bytes);
+    LRUHandle* to_remove_head = nullptr;
+    {
+        std::lock_guard l(_mutex);
+        _evict(e->total_size, &to_remove_head);
+
+        // note that the cache might get larger than its capacity if not enough
+        // space was freed
+        auto old = _table.insert(e);
+        _ring_append(e);
+        _usage.fetch_add(e->total_size, std::memory_order_relaxed);
+        if (old != nullptr) {
+            _remove_from_cache(old, &to_remove_head);
+        }
+    }
+
+    // free the entries outside of mutex
+    while (to_remove_head != nullptr) {
+        LRUHandle* next = to_remove_head->next;
+        to_remove_head->free();
+        to_remove_head = next;
+    }
+    return reinterpret_cast<Cache::Handle*>(e);
+}
+
+Cache::Handle* ClockCache::lookup(const CacheKey& key, uint32_t hash) {
+    _lookup_count.fetch_add(1, std::memory_order_relaxed);
+    std::shared_lock l(_mutex);
+    LRUHandle* e = _table.lookup(key, hash);
+    if (e != nullptr) {
+        // we get it from _table, so in_cache must be true
+        DCHECK(e->in_cache);
+        std::atomic_ref<uint32_t>(e->refs).fetch_add(1, std::memory_order_relaxed);
+        std::atomic_ref<bool> referenced(e->referenced);
+        if (!referenced.load(std::memory_order_relaxed)) {
+            // avoid dirtying the cache line of hot entries again and again
+            referenced.store(true, std::memory_order_relaxed);
+        }
+        _hit_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    return reinterpret_cast<Cache::Handle*>(e);
+}
+
+bool ClockCache::contains(const CacheKey& key, uint32_t hash) {
+    std::shared_lock l(_mutex);
+    return _table.lookup(key, hash) != nullptr;
+}
+
+void ClockCache::release(Cache::Handle* handle) {
+    if (handle == nullptr) {
+        return;
+    }
+    LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
+    if (_usage.load(std::memory_order_relaxed) <= _capacity) {
+        // e must not be touched once our reference is dropped, unless it was the last one
+        if (_unref(e)) {
+            e->free();
+        }
+        return;
+    }
+    // over capacity, take this opportunity and remove the item if nobody else uses it.
+    // in_cache is read before dropping our reference: if e is in cache, the cache keeps it
+    // alive while we hold the exclusive lock, otherwise another user may free it right after.
+    bool last_ref = false;
+    LRUHandle* to_remove_head = nullptr;
+    {
+        std::lock_guard l(_mutex);
+        bool in_cache = e->in_cache;
+        last_ref = _unref(e);
+        if (in_cache &&
+            std::atomic_ref<uint32_t>(e->refs).load(std::memory_order_acquire) == 1 &&
+            _usage.load(std::memory_order_relaxed) > _capacity) {
+            _evict_one_entry(e, &to_remove_head);
+        }
+    }
+    // free handle out of mutex
+    if (last_ref) {
+        e->free();
+    } else if (to_remove_head != nullptr) {
+        to_remove_head->free();
+    }
+}
+
+void ClockCache::erase(const CacheKey& key, uint32_t hash) {
+    LRUHandle* to_remove_head = nullptr;
+    {
+        std::lock_guard l(_mutex);
+        LRUHandle* e = _table.remove(key, hash);
+        if (e != nullptr) {
+            _remove_from_cache(e, &to_remove_head);
+        }
+    }
+    // free handle out of mutex
+    if (to_remove_head != nullptr) {
+        to_remove_head->free();
+    }
+}
+
+int64_t ClockCache::prune() {
+    return prune_if([](const void*) { return true; });
+}
+
+int64_t ClockCache::prune_if(CacheValuePredicate pred, bool lazy_mode) {
+    LRUHandle* to_remove_head = nullptr;
+    {
+        std::lock_guard l(_mutex);
+        // from the oldest entry, entries in use are skipped like LRUCache does
+        LRUHandle* p = _ring.next;
+        while (p != &_ring) {
+            LRUHandle* next = p->next;
+            if (std::atomic_ref<uint32_t>(p->refs).load(std::memory_order_acquire) == 1) {
+                if (pred(p->value)) {
+                    _evict_one_entry(p, &to_remove_head);
+                } else if (lazy_mode) {
+                    break;
+                }
+            }
+            p = next;
+        }
+    }
+    int64_t pruned_count = 0;
+    while (to_remove_head != nullptr) {
+        ++pruned_count;
+        LRUHandle* next = to_remove_head->next;
+        to_remove_head->free();
+        to_remove_head = next;
+    }
+    return pruned_count;
+}
+
 inline uint32_t ShardedLRUCache::_hash_slice(const CacheKey& s) {
     return s.hash(s.data(), s.size(), 0);
 }
 
 ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity, LRUCacheType type,
-                                 uint32_t num_shards, uint32_t total_element_count_capacity)
+                                 uint32_t num_shards, uint32_t total_element_count_capacity,
+                                 CacheEvictionPolicy eviction_policy,
+                                 CacheAdmissionPolicy admission_policy)
         : _name(name),
           _num_shard_bits(Bits::FindLSBSetNonZero(num_shards)),
           _num_shards(num_shards),
-          _shards(nullptr),
           _last_id(1),
           _total_capacity(total_capacity) {
     _mem_tracker = std::make_unique<MemTrackerLimiter>(MemTrackerLimiter::Type::GLOBAL, name);
@@ -531,13 +820,24 @@ ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity,
     const size_t per_shard = (total_capacity + (_num_shards - 1)) / _num_shards;
     const size_t per_shard_element_count_capacity =
             (total_element_count_capacity + (_num_shards - 1)) / _num_shards;
-    LRUCache** shards = new (std::nothrow) LRUCache*[_num_shards];
-    for (int s = 0; s < _num_shards; s++) {
-        shards[s] = new LRUCache(type);
-        shards[s]->set_capacity(per_shard);
-        shards[s]->set_element_count_capacity(per_shard_element_count_capacity);
+    if (eviction_policy == CacheEvictionPolicy::CLOCK) {
+        ClockCache** shards = new (std::nothrow) ClockCache*[_num_shards];
+        for (int s = 0; s < _num_shards; s++) {
+            shards[s] = new ClockCache(type);
+            shards[s]->set_capacity(per_shard);
+            shards[s]->set_element_count_capacity(per_shard_element_count_capacity);
+        }
+        _clock_shards = shards;
+    } else {
+        LRUCache** shards = new (std::nothrow) LRUCache*[_num_shards];
+        for (int s = 0; s < _num_shards; s++) {
+            shards[s] = new LRUCache(type);
+            shards[s]->set_capacity(per_shard);
+            shards[s]->set_element_count_capacity(per_shard_element_count_capacity);
+            shards[s]->set_admission_policy(admission_policy);
+        }
+        _shards = shards;
     }
-    _shards = shards;
 
     _entity = DorisMetrics::instance()->metric_registry()->register_entity(
             std::string("lru_cache:") + name, {{"name", name}});
@@ -548,6 +848,7 @@ ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity,
     INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, cache_lookup_count);
     INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, cache_hit_count);
     INT_DOUBLE_METRIC_REGISTER(_entity, cache_hit_ratio);
+    INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, cache_admission_reject_count);
 
     _hit_count_bvar.reset(new bvar::Adder<uint64_t>("doris_cache", _name));
     _hit_count_per_second.reset(new bvar::PerSecond<bvar::Adder<uint64_t>>(
@@ -563,6 +864,7 @@ ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity,
                                  bool cache_value_check_timestamp,
                                  uint32_t total_element_count_capacity)
         : ShardedLRUCache(name, total_capacity, type, num_shards, total_element_count_capacity) {
+    DCHECK(_shards != nullptr);
     for (int s = 0; s < _num_shards; s++) {
         _shards[s]->set_cache_value_time_extractor(cache_value_time_extractor);
         _shards[s]->set_cache_value_check_timestamp(cache_value_check_timestamp);
@@ -578,29 +880,42 @@ ShardedLRUCache::~ShardedLRUCache() {
         }
         delete[] _shards;
     }
+    if (_clock_shards) {
+        for (int s = 0; s < _num_shards; s++) {
+            delete _clock_shards[s];
+        }
+        delete[] _clock_shards;
+    }
 }
 
 Cache::Handle* ShardedLRUCache::insert(const CacheKey& key, void* value, size_t charge,
                                        void (*deleter)(const CacheKey& key, void* value),
                                        CachePriority priority, size_t bytes) {
     const uint32_t hash = _hash_slice(key);
-    return _shards[_shard(hash)]->insert(key, hash, value, charge, deleter, _mem_tracker.get(),
-                                         priority, bytes);
+    return _call_shard(_shard(hash), [&](auto* shard) {
+        return shard->insert(key, hash, value, charge, deleter, _mem_tracker.get(), priority,
+                             bytes);
+    });
 }
 
 Cache::Handle* ShardedLRUCache::lookup(const CacheKey& key) {
     const uint32_t hash = _hash_slice(key);
-    return _shards[_shard(hash)]->lookup(key, hash);
+    return _call_shard(_shard(hash), [&](auto* shard) { return shard->lookup(key, hash); });
+}
+
+bool ShardedLRUCache::contains(const CacheKey& key) {
+    const uint32_t hash = _hash_slice(key);
+    return _call_shard(_shard(hash), [&](auto* shard) { return shard->contains(key, hash); });
 }
 
 void ShardedLRUCache::release(Handle* handle) {
     LRUHandle* h = reinterpret_cast<LRUHandle*>(handle);
-    _shards[_shard(h->hash)]->release(handle);
+    _call_shard(_shard(h->hash), [&](auto* shard) { shard->release(handle); });
 }
 
 void ShardedLRUCache::erase(const CacheKey& key) {
     const uint32_t hash = _hash_slice(key);
-    _shards[_shard(hash)]->erase(key, hash);
+    _call_shard(_shard(hash), [&](auto* shard) { shard->erase(key, hash); });
 }
 
 void* ShardedLRUCache::value(Handle* handle) {
@@ -619,7 +934,7 @@ uint64_t ShardedLRUCache::new_id() {
 int64_t ShardedLRUCache::prune() {
     int64_t num_prune = 0;
     for (int s = 0; s < _num_shards; s++) {
-        num_prune += _shards[s]->prune();
+        num_prune += _call_shard(s, [](auto* shard) { return shard->prune(); });
     }
     return num_prune;
 }
@@ -627,7 +942,7 @@ int64_t ShardedLRUCache::prune() {
 int64_t ShardedLRUCache::prune_if(CacheValuePredicate pred, bool lazy_mode) {
     int64_t num_prune = 0;
     for (int s = 0; s < _num_shards; s++) {
-        num_prune += _shards[s]->prune_if(pred, lazy_mode);
+        num_prune += _call_shard(s, [&](auto* shard) { return shard->prune_if(pred, lazy_mode); });
     }
     return num_prune;
 }
@@ -639,7 +954,7 @@ int64_t ShardedLRUCache::mem_consumption() {
 int64_t ShardedLRUCache::get_usage() {
     size_t total_usage = 0;
     for (int i = 0; i < _num_shards; i++) {
-        total_usage += _shards[i]->get_usage();
+        total_usage += _call_shard(i, [](auto* shard) { return shard->get_usage(); });
     }
     return total_usage;
 }
@@ -650,10 +965,20 @@ void ShardedLRUCache::update_cache_metrics() const {
     size_t total_lookup_count = 0;
     size_t total_hit_count = 0;
     for (int i = 0; i < _num_shards; i++) {
-        total_capacity += _shards[i]->get_capacity();
-        total_usage += _shards[i]->get_usage();
-        total_lookup_count += _shards[i]->get_lookup_count();
-        total_hit_count += _shards[i]->get_hit_count();
+        _call_shard(i, [&](auto* shard) {
+            total_capacity += shard->get_capacity();
+            total_usage += shard->get_usage();
+            total_lookup_count += shard->get_lookup_count();
+            total_hit_count += shard->get_hit_count();
+        });
+    }
+
+    if (_shards != nullptr) {
+        size_t total_admission_reject_count = 0;
+        for (int i = 0; i < _num_shards; i++) {
+            total_admission_reject_count += _shards[i]->get_admission_reject_count();
+        }
+        cache_admission_reject_count->set_value(total_admission_reject_count);
     }
 
     cache_capacity->set_value(total_capacity);
@@ -666,8 +991,10 @@ void ShardedLRUCache::update_cache_metrics() const {
 }
 
 Cache* new_lru_cache(const std::string& name, size_t capacity, LRUCacheType type,
-                     uint32_t num_shards) {
-    return new ShardedLRUCache(name, capacity, type, num_shards);
+                     uint32_t num_shards, CacheEvictionPolicy eviction_policy,
+                     CacheAdmissionPolicy admission_policy) {
+    return new ShardedLRUCache(name, capacity, type, num_shards, 0, eviction_policy,
+                               admission_policy);
 }
 
 } // namespace doris
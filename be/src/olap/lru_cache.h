@@ -22,6 +22,7 @@
 #include "runtime/memory/mem_tracker_limiter.h"
 #include "runtime/thread_context.h"
 #include "util/doris_metrics.h"
+#include "util/frequency_sketch.h"
 #include "util/lock.h"
 #include "util/metrics.h"
 #include "util/slice.h"
@@ -59,10 +60,30 @@ enum LRUCacheType {
     NUMBER // The capacity of cache is based on the number of cache entry.
 };
 
+// Replacement policy of each shard in ShardedLRUCache.
+enum class CacheEvictionPolicy {
+    LRU,  // Strict LRU, every lookup and release takes the shard mutex.
+    CLOCK // CLOCK (second chance), lookups only take a shared lock, see ClockCache.
+};
+
+// Whether a new entry is admitted when the cache is full, only supported by LRU shards.
+enum class CacheAdmissionPolicy {
+    NONE,    // Always admit the new entry and evict the LRU entries.
+    TINY_LFU // Admit the new entry only if it is accessed more frequently than the LRU victim,
+             // so a large scan can not flush the hot entries out of the cache. Every lookup,
+             // hit or miss, is one access, the insert after a missed lookup is not another one.
+};
+
+static constexpr uint32_t DEFAULT_LRU_CACHE_NUM_SHARDS = 16;
+
 // Create a new cache with a specified name and capacity.
-// This implementation of Cache uses a least-recently-used eviction policy.
+// This implementation of Cache uses a least-recently-used eviction policy unless
+// `eviction_policy` says otherwise.
 extern Cache* new_lru_cache(const std::string& name, size_t capacity,
-                            LRUCacheType type = LRUCacheType::SIZE, uint32_t num_shards = 16);
+                            LRUCacheType type = LRUCacheType::SIZE,
+                            uint32_t num_shards = DEFAULT_LRU_CACHE_NUM_SHARDS,
+                            CacheEvictionPolicy eviction_policy = CacheEvictionPolicy::LRU,
+                            CacheAdmissionPolicy admission_policy = CacheAdmissionPolicy::NONE);
 
 class CacheKey {
 public:
@@ -188,6 +209,10 @@ public:
     // longer needed.
     virtual Handle* lookup(const CacheKey& key) = 0;
 
+    // Return true if the cache has a mapping for "key". Unlike lookup(), it is not counted
+    // as an access of the entry, so neither the statistics nor the eviction order change.
+    virtual bool contains(const CacheKey& key) = 0;
+
     // Release a mapping returned by a previous Lookup().
     // REQUIRES: handle must not have been released yet.
     // REQUIRES: handle must have been returned by a method on *this.
@@ -250,6 +275,7 @@ struct LRUHandle {
     size_t total_size; // including key length
     size_t bytes;      // Used by LRUCacheType::NUMBER, LRUCacheType::SIZE equal to total_size.
     bool in_cache;     // Whether entry is in the cache.
+    bool referenced;   // Used by ClockCache, set on lookup and cleared by the clock hand.
     uint32_t refs;
     uint32_t hash; // Hash of key(); used for fast sharding and comparisons
     CachePriority priority = CachePriority::NORMAL;
@@ -341,6 +367,7 @@ public:
                           MemTrackerLimiter* tracker,
                           CachePriority priority = CachePriority::NORMAL, size_t bytes = -1);
     Cache::Handle* lookup(const CacheKey& key, uint32_t hash);
+    bool contains(const CacheKey& key, uint32_t hash);
     void release(Cache::Handle* handle);
     void erase(const CacheKey& key, uint32_t hash);
     int64_t prune();
@@ -348,9 +375,12 @@ public:
 
     void set_cache_value_time_extractor(CacheValueTimeExtractor cache_value_time_extractor);
     void set_cache_value_check_timestamp(bool cache_value_check_timestamp);
+    // Set after the capacities, the frequency sketch of TINY_LFU is sized by them.
+    void set_admission_policy(CacheAdmissionPolicy admission_policy);
 
     uint64_t get_lookup_count() const { return _lookup_count; }
     uint64_t get_hit_count() const { return _hit_count; }
+    uint64_t get_admission_reject_count() const { return _admission_reject_count; }
     size_t get_usage() const { return _usage; }
     size_t get_capacity() const { return _capacity; }
 
@@ -362,6 +392,7 @@ private:
     void _evict_from_lru_with_time(size_t total_size, LRUHandle** to_remove_head);
     void _evict_one_entry(LRUHandle* e);
     bool _check_element_count_limit();
+    bool _admit(const LRUHandle* e);
 
 private:
     LRUCacheType _type;
@@ -391,12 +422,88 @@ private:
     LRUHandleSortedSet _sorted_durable_entries_with_timestamp;
 
     uint32_t _element_count_capacity = 0;
+
+    CacheAdmissionPolicy _admission_policy = CacheAdmissionPolicy::NONE;
+    // access frequency of keys, only used by TINY_LFU admission
+    FrequencySketch _sketch;
+    uint64_t _admission_reject_count = 0;
+};
+
+// A cache shard with the same interface as LRUCache but replaces entries by CLOCK.
+//
+// All entries in cache are kept in a ring no matter whether they are in use. A lookup only
+// takes the shared lock to search the hash table, then increases the reference count and
+// sets the `referenced` flag of the entry atomically, and release never takes the lock unless
+// the cache is over capacity, so hits of hot entries don't serialize on the shard mutex.
+// Insert, erase and prune take the exclusive lock. On eviction the clock hand sweeps the ring,
+// skips entries in use, gives entries with `referenced` set a second chance and evicts the
+// first other one. DURABLE entries are evicted only if no NORMAL entry can be evicted.
+//
+// Unlike LRUCache, the usage is decreased as soon as an entry leaves the cache even if it is
+// still in use, and value time based eviction is not supported.
+class ClockCache {
+public:
+    ClockCache(LRUCacheType type);
+    ~ClockCache();
+
+    void set_capacity(size_t capacity) { _capacity = capacity; }
+    void set_element_count_capacity(uint32_t element_count_capacity) {
+        _element_count_capacity = element_count_capacity;
+    }
+
+    Cache::Handle* insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
+                          void (*deleter)(const CacheKey& key, void* value),
+                          MemTrackerLimiter* tracker,
+                          CachePriority priority = CachePriority::NORMAL, size_t bytes = -1);
+    Cache::Handle* lookup(const CacheKey& key, uint32_t hash);
+    bool contains(const CacheKey& key, uint32_t hash);
+    void release(Cache::Handle* handle);
+    void erase(const CacheKey& key, uint32_t hash);
+    int64_t prune();
+    int64_t prune_if(CacheValuePredicate pred, bool lazy_mode = false);
+
+    uint64_t get_lookup_count() const { return _lookup_count.load(std::memory_order_relaxed); }
+    uint64_t get_hit_count() const { return _hit_count.load(std::memory_order_relaxed); }
+    size_t get_usage() const { return _usage.load(std::memory_order_relaxed); }
+    size_t get_capacity() const { return _capacity; }
+
+private:
+    void _ring_remove(LRUHandle* e);
+    void _ring_append(LRUHandle* e);
+    bool _unref(LRUHandle* e);
+    bool _need_evict(size_t total_size) const;
+    void _evict(size_t total_size, LRUHandle** to_remove_head);
+    void _evict_one_entry(LRUHandle* e, LRUHandle** to_remove_head);
+    void _remove_from_cache(LRUHandle* e, LRUHandle** to_remove_head);
+
+private:
+    LRUCacheType _type;
+
+    // Initialized before use.
+    size_t _capacity = 0;
+    uint32_t _element_count_capacity = 0;
+
+    // shared by lookups, exclusive for anything changing the table or the ring.
+    SharedMutex _mutex;
+    std::atomic<size_t> _usage = 0;
+
+    // Dummy head of the ring, _ring.next is the oldest entry.
+    LRUHandle _ring;
+    // The clock hand, points to the entry checked last time.
+    LRUHandle* _hand = nullptr;
+
+    HandleTable _table;
+
+    std::atomic<uint64_t> _lookup_count = 0;
+    std::atomic<uint64_t> _hit_count = 0;
 };
 
 class ShardedLRUCache : public Cache {
 public:
     explicit ShardedLRUCache(const std::string& name, size_t total_capacity, LRUCacheType type,
-                             uint32_t num_shards, uint32_t element_count_capacity = 0);
+                             uint32_t num_shards, uint32_t element_count_capacity = 0,
+                             CacheEvictionPolicy eviction_policy = CacheEvictionPolicy::LRU,
+                             CacheAdmissionPolicy admission_policy = CacheAdmissionPolicy::NONE);
     explicit ShardedLRUCache(const std::string& name, size_t total_capacity, LRUCacheType type,
                              uint32_t num_shards,
                              CacheValueTimeExtractor cache_value_time_extractor,
@@ -408,6 +515,7 @@ public:
                            CachePriority priority = CachePriority::NORMAL,
                            size_t bytes = -1) override;
     virtual Handle* lookup(const CacheKey& key) override;
+    bool contains(const CacheKey& key) override;
     virtual void release(Handle* handle) override;
     virtual void erase(const CacheKey& key) override;
     virtual void* value(Handle* handle) override;
@@ -428,10 +536,17 @@ private:
         return _num_shard_bits > 0 ? (hash >> (32 - _num_shard_bits)) : 0;
     }
 
+    template <typename Func>
+    auto _call_shard(uint32_t shard, Func&& func) const {
+        return _clock_shards != nullptr ? func(_clock_shards[shard]) : func(_shards[shard]);
+    }
+
     std::string _name;
     const int _num_shard_bits;
     const uint32_t _num_shards;
-    LRUCache** _shards;
+    // only one of them is created according to the eviction policy
+    LRUCache** _shards = nullptr;
+    ClockCache** _clock_shards = nullptr;
     std::atomic<uint64_t> _last_id;
     size_t _total_capacity;
 
@@ -443,6 +558,7 @@ private:
     IntAtomicCounter* cache_lookup_count = nullptr;
     IntAtomicCounter* cache_hit_count = nullptr;
     DoubleGauge* cache_hit_ratio = nullptr;
+    IntAtomicCounter* cache_admission_reject_count = nullptr;
     // bvars
     std::unique_ptr<bvar::Adder<uint64_t>> _hit_count_bvar;
     std::unique_ptr<bvar::PerSecond<bvar::Adder<uint64_t>>> _hit_count_per_second;
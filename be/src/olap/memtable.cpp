@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -37,6 +38,7 @@
 #include "tablet_meta.h"
 #include "util/runtime_profile.h"
 #include "util/stopwatch.hpp"
+#include "util/threadpool.h"
 #include "vec/aggregate_functions/aggregate_function_reader.h"
 #include "vec/aggregate_functions/aggregate_function_simple_factory.h"
 #include "vec/columns/column.h"
@@ -246,12 +248,29 @@ void MemTable::_put_into_output(vectorized::Block& in_block) {
                                    row_pos_vec.data() + in_block.rows());
 }
 
-size_t MemTable::_sort() {
+size_t MemTable::_sort(ThreadPool* sort_pool) {
     SCOPED_RAW_TIMER(&_stat.sort_ns);
     _stat.sort_times++;
+    _vec_row_comparator->set_block(&_input_mutable_block);
+    // sort new rows, in parallel if the memtable is large and the pool has idle threads
+    size_t num_chunks = 1;
+    if (sort_pool != nullptr && config::memtable_sort_parallelism > 1) {
+        size_t rows = _row_in_blocks.size() - _last_sorted_pos;
+        num_chunks = std::min({static_cast<size_t>(config::memtable_sort_parallelism),
+                               static_cast<size_t>(sort_pool->num_idle_threads()) + 1,
+                               rows / std::max(config::memtable_parallel_sort_min_rows, 1)});
+    }
+    size_t same_keys_num = num_chunks > 1 ? _parallel_sort_rows(sort_pool, num_chunks)
+                                          : _sort_rows(_last_sorted_pos, _row_in_blocks.size());
+    // merge new rows and old rows
+    same_keys_num += _merge_rows(0, _last_sorted_pos, _row_in_blocks.size());
+    _last_sorted_pos = _row_in_blocks.size();
+    return same_keys_num;
+}
+
+size_t MemTable::_sort_rows(size_t begin, size_t end) {
     size_t same_keys_num = 0;
-    // sort new rows
-    Tie tie = Tie(_last_sorted_pos, _row_in_blocks.size());
+    Tie tie = Tie(begin, end);
     for (size_t i = 0; i < _tablet_schema->num_key_columns(); i++) {
         auto cmp = [&](const RowInBlock* lhs, const RowInBlock* rhs) -> int {
             return _input_mutable_block.compare_one_column(lhs->_row_pos, rhs->_row_pos, i, -1);
@@ -269,8 +288,46 @@ size_t MemTable::_sort() {
                 });
         same_keys_num += iter.right() - iter.left();
     }
-    // merge new rows and old rows
-    _vec_row_comparator->set_block(&_input_mutable_block);
+    return same_keys_num;
+}
+
+size_t MemTable::_parallel_sort_rows(ThreadPool* sort_pool, size_t num_chunks) {
+    const size_t begin = _last_sorted_pos;
+    const size_t rows = _row_in_blocks.size() - begin;
+    std::vector<size_t> bounds(num_chunks + 1);
+    for (size_t i = 0; i <= num_chunks; ++i) {
+        bounds[i] = begin + rows * i / num_chunks;
+    }
+    // each task only touches the rows of its own chunks and its own counter
+    std::vector<size_t> same_keys_nums(num_chunks, 0);
+    // the memory of the sort is counted to the load like the rest of the flush
+    auto mem_tracker = thread_context()->thread_mem_tracker_mgr->limiter_mem_tracker();
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < num_chunks; ++i) {
+        tasks.emplace_back([&, i] {
+            SCOPED_SWITCH_THREAD_MEM_TRACKER_LIMITER(mem_tracker);
+            same_keys_nums[i] = _sort_rows(bounds[i], bounds[i + 1]);
+        });
+    }
+    run_in_parallel(sort_pool, std::move(tasks));
+    // merge neighbouring chunks until the new rows are sorted
+    for (size_t width = 1; width < num_chunks; width *= 2) {
+        tasks.clear();
+        for (size_t i = 0; i + width < num_chunks; i += 2 * width) {
+            size_t end = bounds[std::min(i + 2 * width, num_chunks)];
+            tasks.emplace_back([&, i, width, end] {
+                SCOPED_SWITCH_THREAD_MEM_TRACKER_LIMITER(mem_tracker);
+                same_keys_nums[i] += _merge_rows(bounds[i], bounds[i + width], end);
+            });
+        }
+        run_in_parallel(sort_pool, std::move(tasks));
+    }
+    return std::accumulate(same_keys_nums.begin(), same_keys_nums.end(), size_t(0));
+}
+
+size_t MemTable::_merge_rows(size_t begin, size_t middle, size_t end) {
+    size_t same_keys_num = 0;
+    bool is_dup = (_keys_type == KeysType::DUP_KEYS);
     auto cmp_func = [this, is_dup, &same_keys_num](const RowInBlock* l,
                                                    const RowInBlock* r) -> bool {
         auto value = (*(this->_vec_row_comparator))(l, r);
@@ -281,9 +338,9 @@ size_t MemTable::_sort() {
             return value < 0;
         }
     };
-    auto new_row_it = std::next(_row_in_blocks.begin(), _last_sorted_pos);
-    std::inplace_merge(_row_in_blocks.begin(), new_row_it, _row_in_blocks.end(), cmp_func);
-    _last_sorted_pos = _row_in_blocks.size();
+    std::inplace_merge(std::next(_row_in_blocks.begin(), begin),
+                       std::next(_row_in_blocks.begin(), middle),
+                       std::next(_row_in_blocks.begin(), end), cmp_func);
     return same_keys_num;
 }
 
@@ -438,8 +495,8 @@ bool MemTable::need_agg() const {
     return false;
 }
 
-std::unique_ptr<vectorized::Block> MemTable::to_block() {
-    size_t same_keys_num = _sort();
+std::unique_ptr<vectorized::Block> MemTable::to_block(ThreadPool* sort_pool) {
+    size_t same_keys_num = _sort(sort_pool);
     if (_keys_type == KeysType::DUP_KEYS || same_keys_num == 0) {
         if (_keys_type == KeysType::DUP_KEYS && _tablet_schema->num_key_columns() == 0) {
             _output_mutable_block.swap(_input_mutable_block);
@@ -41,6 +41,7 @@ namespace doris {
 class Schema;
 class SlotDescriptor;
 class TabletSchema;
+class ThreadPool;
 class TupleDescriptor;
 enum KeysType : int;
 
@@ -186,7 +187,8 @@ public:
 
     bool need_agg() const;
 
-    std::unique_ptr<vectorized::Block> to_block();
+    // `sort_pool` may help sorting the rows of a large memtable, see _sort.
+    std::unique_ptr<vectorized::Block> to_block(ThreadPool* sort_pool = nullptr);
 
     bool empty() const { return _input_mutable_block.rows() == 0; }
 
@@ -239,7 +241,13 @@ private:
     size_t _last_sorted_pos = 0;
 
     //return number of same keys
-    size_t _sort();
+    size_t _sort(ThreadPool* sort_pool = nullptr);
+    // sort the rows in [begin, end) by their keys, return number of same keys
+    size_t _sort_rows(size_t begin, size_t end);
+    // sort the new rows in `num_chunks` chunks on `sort_pool`, then merge them
+    size_t _parallel_sort_rows(ThreadPool* sort_pool, size_t num_chunks);
+    // merge the sorted rows [begin, middle) and [middle, end), return number of same keys
+    size_t _merge_rows(size_t begin, size_t middle, size_t end);
     void _sort_one_column(std::vector<RowInBlock*>& row_in_blocks, Tie& tie,
                           std::function<int(const RowInBlock*, const RowInBlock*)> cmp);
     template <bool is_final>
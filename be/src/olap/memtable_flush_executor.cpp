@@ -106,7 +106,7 @@ Status FlushToken::_do_flush_memtable(MemTable* memtable, int32_t segment_id, in
                   << ", rows: " << memtable->stat().raw_rows;
     int64_t duration_ns;
     SCOPED_RAW_TIMER(&duration_ns);
-    std::unique_ptr<vectorized::Block> block = memtable->to_block();
+    std::unique_ptr<vectorized::Block> block = memtable->to_block(_sort_pool);
     {
         SCOPED_CONSUME_MEM_TRACKER(memtable->flush_mem_tracker());
         SKIP_MEMORY_CHECK(RETURN_IF_ERROR(
@@ -188,21 +188,24 @@ Status MemTableFlushExecutor::create_flush_token(std::unique_ptr<FlushToken>& fl
         if (rowset_writer->type() == BETA_ROWSET && !should_serial) {
             // beta rowset can be flush in CONCURRENT, because each memtable using a new segment writer.
             flush_token.reset(
-                    new FlushToken(_flush_pool->new_token(ThreadPool::ExecutionMode::CONCURRENT)));
+                    new FlushToken(_flush_pool->new_token(ThreadPool::ExecutionMode::CONCURRENT),
+                                   _flush_pool.get()));
         } else {
             // alpha rowset do not support flush in CONCURRENT.
-            flush_token.reset(
-                    new FlushToken(_flush_pool->new_token(ThreadPool::ExecutionMode::SERIAL)));
+            flush_token.reset(new FlushToken(
+                    _flush_pool->new_token(ThreadPool::ExecutionMode::SERIAL), _flush_pool.get()));
         }
     } else {
         if (rowset_writer->type() == BETA_ROWSET && !should_serial) {
             // beta rowset can be flush in CONCURRENT, because each memtable using a new segment writer.
             flush_token.reset(new FlushToken(
-                    _high_prio_flush_pool->new_token(ThreadPool::ExecutionMode::CONCURRENT)));
+                    _high_prio_flush_pool->new_token(ThreadPool::ExecutionMode::CONCURRENT),
+                    _high_prio_flush_pool.get()));
         } else {
             // alpha rowset do not support flush in CONCURRENT.
             flush_token.reset(new FlushToken(
-                    _high_prio_flush_pool->new_token(ThreadPool::ExecutionMode::SERIAL)));
+                    _high_prio_flush_pool->new_token(ThreadPool::ExecutionMode::SERIAL),
+                    _high_prio_flush_pool.get()));
         }
     }
     flush_token->set_rowset_writer(rowset_writer);
@@ -57,8 +57,12 @@ std::ostream& operator<<(std::ostream& os, const FlushStatistic& stat);
 //    because the entire job will definitely fail;
 class FlushToken {
 public:
-    explicit FlushToken(std::unique_ptr<ThreadPoolToken> flush_pool_token)
-            : _flush_token(std::move(flush_pool_token)), _flush_status(Status::OK()) {}
+    // `sort_pool` is the pool the token submits to, its idle threads help sorting large
+    // memtables.
+    FlushToken(std::unique_ptr<ThreadPoolToken> flush_pool_token, ThreadPool* sort_pool)
+            : _flush_token(std::move(flush_pool_token)),
+              _sort_pool(sort_pool),
+              _flush_status(Status::OK()) {}
 
     Status submit(std::unique_ptr<MemTable> mem_table);
 
@@ -84,6 +88,7 @@ private:
     Status _do_flush_memtable(MemTable* memtable, int32_t segment_id, int64_t* flush_size);
 
     std::unique_ptr<ThreadPoolToken> _flush_token;
+    ThreadPool* _sort_pool;
 
     // Records the current flush status of the tablet.
     // Note: Once its value is set to Failed, it cannot return to SUCCESS.
@@ -121,6 +126,8 @@ public:
     Status create_flush_token(std::unique_ptr<FlushToken>& flush_token, RowsetWriter* rowset_writer,
                               bool should_serial, bool is_high_priority);
 
+    ThreadPool* flush_pool() { return _flush_pool.get(); }
+
 private:
     std::unique_ptr<ThreadPool> _flush_pool;
     std::unique_ptr<ThreadPool> _high_prio_flush_pool;
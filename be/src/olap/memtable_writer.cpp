@@ -19,9 +19,11 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <ostream>
 #include <string>
+#include <thread>
 #include <utility>
 
 // IWYU pragma: no_include <opentelemetry/common/threadlocal.h>
@@ -59,7 +61,7 @@ MemTableWriter::~MemTableWriter() {
         // cancel and wait all memtables in flush queue to be finished
         _flush_token->cancel();
     }
-    _mem_table.reset();
+    _shards.clear();
 }
 
 Status MemTableWriter::init(std::shared_ptr<RowsetWriter> rowset_writer,
@@ -68,7 +70,14 @@ Status MemTableWriter::init(std::shared_ptr<RowsetWriter> rowset_writer,
     _tablet_schema = tablet_schema;
     _unique_key_mow = unique_key_mow;
 
-    _reset_mem_table();
+    size_t num_shards = 1;
+    if (_tablet_schema->keys_type() == KeysType::DUP_KEYS) {
+        num_shards = std::max(config::memtable_writer_shard_num, 1);
+    }
+    for (size_t i = 0; i < num_shards; ++i) {
+        _shards.push_back(std::make_unique<MemTableShard>());
+        _reset_mem_table(_shards.back().get());
+    }
 
     // create flush handler
     // by assigning segment_id to memtable before submiting to flush executor,
@@ -90,33 +99,42 @@ Status MemTableWriter::write(const vectorized::Block* block, const std::vector<i
     if (UNLIKELY(row_idxs.empty() && !is_append)) {
         return Status::OK();
     }
-    _lock_watch.start();
-    std::lock_guard<std::mutex> l(_lock);
-    _lock_watch.stop();
+    MonotonicStopWatch lock_watch;
+    lock_watch.start();
+    std::shared_lock<std::shared_mutex> l(_lock);
+    lock_watch.stop();
     if (_is_cancelled) {
+        _lock_wait_ns += lock_watch.elapsed_time();
         return _cancel_status;
     }
     if (!_is_init) {
+        _lock_wait_ns += lock_watch.elapsed_time();
         return Status::Error<NOT_INITIALIZED>("delta segment writer has not been initialized");
     }
     if (_is_closed) {
+        _lock_wait_ns += lock_watch.elapsed_time();
         return Status::Error<ALREADY_CLOSED>("write block after closed tablet_id={}, load_id={}-{}",
                                              _req.tablet_id, _req.load_id.hi(), _req.load_id.lo());
     }
+    std::unique_lock<std::mutex> shard_lock;
+    lock_watch.start();
+    MemTableShard* shard = _lock_shard(&shard_lock);
+    lock_watch.stop();
+    _lock_wait_ns += lock_watch.elapsed_time();
 
     if (is_append) {
         _total_received_rows += block->rows();
     } else {
         _total_received_rows += row_idxs.size();
     }
-    _mem_table->insert(block, row_idxs, is_append);
+    shard->mem_table->insert(block, row_idxs, is_append);
 
-    if (UNLIKELY(_mem_table->need_agg() && config::enable_shrink_memory)) {
-        _mem_table->shrink_memtable_by_agg();
+    if (UNLIKELY(shard->mem_table->need_agg() && config::enable_shrink_memory)) {
+        shard->mem_table->shrink_memtable_by_agg();
     }
-    if (UNLIKELY(_mem_table->need_flush())) {
-        auto s = _flush_memtable_async();
-        _reset_mem_table();
+    if (UNLIKELY(shard->mem_table->need_flush())) {
+        auto s = _flush_memtable_async(shard);
+        _reset_mem_table(shard);
         if (UNLIKELY(!s.ok())) {
             return s;
         }
@@ -125,13 +143,32 @@ Status MemTableWriter::write(const vectorized::Block* block, const std::vector<i
     return Status::OK();
 }
 
-Status MemTableWriter::_flush_memtable_async() {
+MemTableWriter::MemTableShard* MemTableWriter::_lock_shard(
+        std::unique_lock<std::mutex>* shard_lock) {
+    const size_t num_shards = _shards.size();
+    const size_t home = num_shards == 1 ? 0
+                                        : std::hash<std::thread::id>()(std::this_thread::get_id()) %
+                                                  num_shards;
+    for (size_t i = 0; i < num_shards; ++i) {
+        auto* shard = _shards[(home + i) % num_shards].get();
+        std::unique_lock<std::mutex> l(shard->lock, std::try_to_lock);
+        if (l.owns_lock()) {
+            *shard_lock = std::move(l);
+            return shard;
+        }
+    }
+    // every shard is busy, wait for the one of this thread
+    *shard_lock = std::unique_lock<std::mutex>(_shards[home]->lock);
+    return _shards[home].get();
+}
+
+Status MemTableWriter::_flush_memtable_async(MemTableShard* shard) {
     DCHECK(_flush_token != nullptr);
-    return _flush_token->submit(std::move(_mem_table));
+    return _flush_token->submit(std::move(shard->mem_table));
 }
 
 Status MemTableWriter::flush_async() {
-    std::lock_guard<std::mutex> l(_lock);
+    std::lock_guard<std::shared_mutex> l(_lock);
     if (!_is_init || _is_closed) {
         // This writer is uninitialized or closed before flushing, do nothing.
         // We return OK instead of NOT_INITIALIZED or ALREADY_CLOSED.
@@ -144,17 +181,23 @@ Status MemTableWriter::flush_async() {
         return _cancel_status;
     }
 
-    VLOG_NOTICE << "flush memtable to reduce mem consumption. memtable size: "
-                << _mem_table->memory_usage() << ", tablet: " << _req.tablet_id
-                << ", load id: " << print_id(_req.load_id);
-    auto s = _flush_memtable_async();
-    _reset_mem_table();
-    return s;
+    Status st;
+    for (auto& shard : _shards) {
+        VLOG_NOTICE << "flush memtable to reduce mem consumption. memtable size: "
+                    << shard->mem_table->memory_usage() << ", tablet: " << _req.tablet_id
+                    << ", load id: " << print_id(_req.load_id);
+        auto s = _flush_memtable_async(shard.get());
+        _reset_mem_table(shard.get());
+        if (st.ok()) {
+            st = s;
+        }
+    }
+    return st;
 }
 
 Status MemTableWriter::wait_flush() {
     {
-        std::lock_guard<std::mutex> l(_lock);
+        std::lock_guard<std::shared_mutex> l(_lock);
         if (!_is_init || _is_closed) {
             // return OK instead of NOT_INITIALIZED or ALREADY_CLOSED for same reason
             // as described in flush_async()
@@ -169,42 +212,47 @@ Status MemTableWriter::wait_flush() {
     return Status::OK();
 }
 
-void MemTableWriter::_reset_mem_table() {
+void MemTableWriter::_reset_mem_table(MemTableShard* shard) {
+    const uint32_t mem_table_num = _mem_table_num++;
 #ifndef BE_TEST
     auto mem_table_insert_tracker = std::make_shared<MemTracker>(
             fmt::format("MemTableManualInsert:TabletId={}:MemTableNum={}#loadID={}",
-                        std::to_string(tablet_id()), _mem_table_num,
+                        std::to_string(tablet_id()), mem_table_num,
                         UniqueId(_req.load_id).to_string()),
             ExecEnv::GetInstance()->memtable_memory_limiter()->mem_tracker());
     auto mem_table_flush_tracker = std::make_shared<MemTracker>(
             fmt::format("MemTableHookFlush:TabletId={}:MemTableNum={}#loadID={}",
-                        std::to_string(tablet_id()), _mem_table_num++,
+                        std::to_string(tablet_id()), mem_table_num,
                         UniqueId(_req.load_id).to_string()),
             ExecEnv::GetInstance()->memtable_memory_limiter()->mem_tracker());
 #else
     auto mem_table_insert_tracker = std::make_shared<MemTracker>(fmt::format(
             "MemTableManualInsert:TabletId={}:MemTableNum={}#loadID={}",
-            std::to_string(tablet_id()), _mem_table_num, UniqueId(_req.load_id).to_string()));
+            std::to_string(tablet_id()), mem_table_num, UniqueId(_req.load_id).to_string()));
     auto mem_table_flush_tracker = std::make_shared<MemTracker>(fmt::format(
             "MemTableHookFlush:TabletId={}:MemTableNum={}#loadID={}", std::to_string(tablet_id()),
-            _mem_table_num++, UniqueId(_req.load_id).to_string()));
+            mem_table_num, UniqueId(_req.load_id).to_string()));
 #endif
     {
         std::lock_guard<SpinLock> l(_mem_table_tracker_lock);
         _mem_table_insert_trackers.push_back(mem_table_insert_tracker);
         _mem_table_flush_trackers.push_back(mem_table_flush_tracker);
+        shard->insert_tracker = mem_table_insert_tracker;
+        shard->flush_tracker = mem_table_flush_tracker;
     }
-    _mem_table.reset(new MemTable(_req.tablet_id, _tablet_schema.get(), _req.slots, _req.tuple_desc,
-                                  _unique_key_mow, mem_table_insert_tracker,
-                                  mem_table_flush_tracker));
+    shard->mem_table.reset(new MemTable(_req.tablet_id, _tablet_schema.get(), _req.slots,
+                                        _req.tuple_desc, _unique_key_mow,
+                                        mem_table_insert_tracker, mem_table_flush_tracker));
 
     _segment_num++;
 }
 
 Status MemTableWriter::close() {
-    _lock_watch.start();
-    std::lock_guard<std::mutex> l(_lock);
-    _lock_watch.stop();
+    MonotonicStopWatch lock_watch;
+    lock_watch.start();
+    std::lock_guard<std::shared_mutex> l(_lock);
+    lock_watch.stop();
+    _lock_wait_ns += lock_watch.elapsed_time();
     if (_is_cancelled) {
         return _cancel_status;
     }
@@ -217,19 +265,21 @@ Status MemTableWriter::close() {
         return Status::OK();
     }
 
-    auto s = _flush_memtable_async();
-    _mem_table.reset();
-    _is_closed = true;
-    if (UNLIKELY(!s.ok())) {
-        return s;
-    } else {
-        return Status::OK();
+    Status st;
+    for (auto& shard : _shards) {
+        auto s = _flush_memtable_async(shard.get());
+        shard->mem_table.reset();
+        if (st.ok()) {
+            st = s;
+        }
     }
+    _is_closed = true;
+    return st;
 }
 
 Status MemTableWriter::_do_close_wait() {
     SCOPED_RAW_TIMER(&_close_wait_time_ns);
-    std::lock_guard<std::mutex> l(_lock);
+    std::lock_guard<std::shared_mutex> l(_lock);
     DCHECK(_is_init)
             << "delta writer is supposed be to initialized before close_wait() being called";
 
@@ -248,7 +298,9 @@ Status MemTableWriter::_do_close_wait() {
         return st;
     }
 
-    _mem_table.reset();
+    for (auto& shard : _shards) {
+        shard->mem_table.reset();
+    }
 
     if (_rowset_writer->num_rows() + _flush_token->memtable_stat().merged_rows !=
         _total_received_rows) {
@@ -290,7 +342,7 @@ void MemTableWriter::_update_profile(RuntimeProfile* profile) {
     auto raw_rows_num = ADD_COUNTER(child, "RawRowNum", TUnit::UNIT);
     auto merged_rows_num = ADD_COUNTER(child, "MergedRowNum", TUnit::UNIT);
 
-    COUNTER_UPDATE(lock_timer, _lock_watch.elapsed_time());
+    COUNTER_UPDATE(lock_timer, _lock_wait_ns);
     COUNTER_SET(delete_bitmap_timer, _rowset_writer->delete_bitmap_ns());
     COUNTER_SET(segment_writer_timer, _rowset_writer->segment_writer_ns());
     COUNTER_SET(wait_flush_timer, _wait_flush_time_ns);
@@ -312,11 +364,13 @@ Status MemTableWriter::cancel() {
 }
 
 Status MemTableWriter::cancel_with_status(const Status& st) {
-    std::lock_guard<std::mutex> l(_lock);
+    std::lock_guard<std::shared_mutex> l(_lock);
     if (_is_cancelled) {
         return Status::OK();
     }
-    _mem_table.reset();
+    for (auto& shard : _shards) {
+        shard->mem_table.reset();
+    }
     if (_flush_token != nullptr) {
         // cancel and wait all memtables in flush queue to be finished
         _flush_token->cancel();
@@ -362,9 +416,11 @@ int64_t MemTableWriter::active_memtable_mem_consumption() {
     int64_t mem_usage = 0;
     {
         std::lock_guard<SpinLock> l(_mem_table_tracker_lock);
-        if (_mem_table_insert_trackers.size() > 0) {
-            mem_usage += (*_mem_table_insert_trackers.rbegin())->consumption();
-            mem_usage += (*_mem_table_flush_trackers.rbegin())->consumption();
+        for (const auto& shard : _shards) {
+            if (shard->insert_tracker != nullptr) {
+                mem_usage += shard->insert_tracker->consumption();
+                mem_usage += shard->flush_tracker->consumption();
+            }
         }
     }
     return mem_usage;
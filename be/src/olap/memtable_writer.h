@@ -59,7 +59,10 @@ class Block;
 enum MemType { WRITE = 1, FLUSH = 2, ALL = 3 };
 
 // Writer for a particular (load, index, tablet).
-// This class is NOT thread-safe, external synchronization is required.
+// The writes of a duplicate key tablet may run concurrently, they are spread over
+// memtable_writer_shard_num memtables which are flushed to separate segments, the rows of such
+// a tablet need no order across segments. The writes of other tablets are serialized on one
+// memtable.
 class MemTableWriter {
 public:
     MemTableWriter(const WriteRequest& req);
@@ -108,10 +111,23 @@ public:
     const FlushStatistic& get_flush_token_stats();
 
 private:
-    // push a full memtable to flush executor
-    Status _flush_memtable_async();
+    // A memtable the writes of the tablet insert into.
+    struct MemTableShard {
+        std::mutex lock;
+        std::unique_ptr<MemTable> mem_table;
+        // the trackers of mem_table, guarded by _mem_table_tracker_lock
+        std::shared_ptr<MemTracker> insert_tracker;
+        std::shared_ptr<MemTracker> flush_tracker;
+    };
 
-    void _reset_mem_table();
+    // Lock a shard for a write into `shard_lock`. A thread keeps to the same shard while no other
+    // writer holds it, and otherwise takes the first free one.
+    MemTableShard* _lock_shard(std::unique_lock<std::mutex>* shard_lock);
+
+    // push the full memtable of `shard` to flush executor
+    Status _flush_memtable_async(MemTableShard* shard);
+
+    void _reset_mem_table(MemTableShard* shard);
 
     Status _do_close_wait();
     void _update_profile(RuntimeProfile* profile);
@@ -122,7 +138,7 @@ private:
     Status _cancel_status;
     WriteRequest _req;
     std::shared_ptr<RowsetWriter> _rowset_writer;
-    std::unique_ptr<MemTable> _mem_table;
+    std::vector<std::unique_ptr<MemTableShard>> _shards;
     TabletSchemaSPtr _tablet_schema;
     bool _unique_key_mow = false;
 
@@ -132,15 +148,16 @@ private:
     SpinLock _mem_table_tracker_lock;
     std::atomic<uint32_t> _mem_table_num = 1;
 
-    std::mutex _lock;
+    // writes hold it shared and lock their shard, the other operations hold it exclusively
+    std::shared_mutex _lock;
 
     // total rows num written by MemTableWriter
-    int64_t _total_received_rows = 0;
+    std::atomic<int64_t> _total_received_rows = 0;
     int64_t _wait_flush_time_ns = 0;
     int64_t _close_wait_time_ns = 0;
-    int64_t _segment_num = 0;
+    std::atomic<int64_t> _segment_num = 0;
 
-    MonotonicStopWatch _lock_watch;
+    std::atomic<int64_t> _lock_wait_ns = 0;
 };
 
 } // namespace doris
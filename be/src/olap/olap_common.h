@@ -337,6 +337,9 @@ struct OlapReaderStatistics {
 
     int64_t total_pages_num = 0;
     int64_t cached_pages_num = 0;
+    // pages missing in page cache but found in compressed page cache
+    int64_t compressed_cached_pages_num = 0;
+    int64_t read_ahead_pages_num = 0;
 
     int64_t rows_bitmap_index_filtered = 0;
     int64_t bitmap_index_filter_timer = 0;
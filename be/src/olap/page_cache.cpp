@@ -24,17 +24,25 @@
 #include "runtime/exec_env.h"
 
 namespace doris {
+CacheEvictionPolicy StoragePageCache::eviction_policy() {
+    return config::storage_page_cache_eviction_policy == "CLOCK" ? CacheEvictionPolicy::CLOCK
+                                                                 : CacheEvictionPolicy::LRU;
+}
+
 StoragePageCache* StoragePageCache::create_global_cache(size_t capacity,
                                                         int32_t index_cache_percentage,
                                                         int64_t pk_index_cache_capacity,
-                                                        uint32_t num_shards) {
-    StoragePageCache* res = new StoragePageCache(capacity, index_cache_percentage,
-                                                 pk_index_cache_capacity, num_shards);
+                                                        uint32_t num_shards,
+                                                        int64_t compressed_cache_capacity) {
+    StoragePageCache* res =
+            new StoragePageCache(capacity, index_cache_percentage, pk_index_cache_capacity,
+                                 num_shards, compressed_cache_capacity);
     return res;
 }
 
 StoragePageCache::StoragePageCache(size_t capacity, int32_t index_cache_percentage,
-                                   int64_t pk_index_cache_capacity, uint32_t num_shards)
+                                   int64_t pk_index_cache_capacity, uint32_t num_shards,
+                                   int64_t compressed_cache_capacity)
         : _index_cache_percentage(index_cache_percentage) {
     if (index_cache_percentage == 0) {
         _data_page_cache = std::make_unique<DataPageCache>(capacity, num_shards);
@@ -52,6 +60,10 @@ StoragePageCache::StoragePageCache(size_t capacity, int32_t index_cache_percenta
         _pk_index_page_cache =
                 std::make_unique<PKIndexPageCache>(pk_index_cache_capacity, num_shards);
     }
+    if (compressed_cache_capacity > 0) {
+        _compressed_page_cache =
+                std::make_unique<CompressedPageCache>(compressed_cache_capacity, num_shards);
+    }
 }
 
 bool StoragePageCache::lookup(const CacheKey& key, PageCacheHandle* handle,
@@ -66,6 +78,10 @@ bool StoragePageCache::lookup(const CacheKey& key, PageCacheHandle* handle,
     return true;
 }
 
+bool StoragePageCache::contains(const CacheKey& key, segment_v2::PageTypePB page_type) {
+    return _get_page_cache(page_type)->contains(key.encode());
+}
+
 void StoragePageCache::insert(const CacheKey& key, DataPage* data, PageCacheHandle* handle,
                               segment_v2::PageTypePB page_type, bool in_memory) {
     auto deleter = [](const doris::CacheKey& key, void* value) {
@@ -84,4 +100,32 @@ void StoragePageCache::insert(const CacheKey& key, DataPage* data, PageCacheHand
     handle->update_last_visit_time();
 }
 
+bool StoragePageCache::lookup_compressed(const CacheKey& key, PageCacheHandle* handle) {
+    auto cache = _compressed_page_cache->get();
+    auto lru_handle = cache->lookup(key.encode());
+    if (lru_handle == nullptr) {
+        return false;
+    }
+    *handle = PageCacheHandle(cache, lru_handle);
+    handle->update_last_visit_time();
+    return true;
+}
+
+bool StoragePageCache::contains_compressed(const CacheKey& key) {
+    return _compressed_page_cache->get()->contains(key.encode());
+}
+
+void StoragePageCache::insert_compressed(const CacheKey& key, DataPage* data,
+                                         PageCacheHandle* handle) {
+    auto deleter = [](const doris::CacheKey& key, void* value) {
+        DataPage* cache_value = (DataPage*)value;
+        delete cache_value;
+    };
+
+    auto cache = _compressed_page_cache->get();
+    auto lru_handle = cache->insert(key.encode(), data, data->capacity(), deleter);
+    *handle = PageCacheHandle(cache, lru_handle);
+    handle->update_last_visit_time();
+}
+
 } // namespace doris
@@ -105,7 +105,7 @@ public:
         DataPageCache(size_t capacity, uint32_t num_shards)
                 : LRUCachePolicy(CachePolicy::CacheType::DATA_PAGE_CACHE, capacity,
                                  LRUCacheType::SIZE, config::data_page_cache_stale_sweep_time_sec,
-                                 num_shards) {}
+                                 num_shards, eviction_policy()) {}
     };
 
     class IndexPageCache : public LRUCachePolicy {
@@ -113,7 +113,7 @@ public:
         IndexPageCache(size_t capacity, uint32_t num_shards)
                 : LRUCachePolicy(CachePolicy::CacheType::INDEXPAGE_CACHE, capacity,
                                  LRUCacheType::SIZE, config::index_page_cache_stale_sweep_time_sec,
-                                 num_shards) {}
+                                 num_shards, eviction_policy()) {}
     };
 
     class PKIndexPageCache : public LRUCachePolicy {
@@ -121,22 +121,37 @@ public:
         PKIndexPageCache(size_t capacity, uint32_t num_shards)
                 : LRUCachePolicy(CachePolicy::CacheType::PK_INDEX_PAGE_CACHE, capacity,
                                  LRUCacheType::SIZE,
-                                 config::pk_index_page_cache_stale_sweep_time_sec, num_shards) {}
+                                 config::pk_index_page_cache_stale_sweep_time_sec, num_shards,
+                                 eviction_policy()) {}
+    };
+
+    // Cache of pages which are still compressed, see config::compressed_page_cache_limit.
+    class CompressedPageCache : public LRUCachePolicy {
+    public:
+        CompressedPageCache(size_t capacity, uint32_t num_shards)
+                : LRUCachePolicy(CachePolicy::CacheType::COMPRESSED_PAGE_CACHE, capacity,
+                                 LRUCacheType::SIZE, config::data_page_cache_stale_sweep_time_sec,
+                                 num_shards, eviction_policy()) {}
     };
 
     static constexpr uint32_t kDefaultNumShards = 16;
 
+    // Replacement policy of the page caches, see config::storage_page_cache_eviction_policy.
+    static CacheEvictionPolicy eviction_policy();
+
     // Create global instance of this class
     static StoragePageCache* create_global_cache(size_t capacity, int32_t index_cache_percentage,
                                                  int64_t pk_index_cache_capacity,
-                                                 uint32_t num_shards = kDefaultNumShards);
+                                                 uint32_t num_shards = kDefaultNumShards,
+                                                 int64_t compressed_cache_capacity = 0);
 
     // Return global instance.
     // Client should call create_global_cache before.
     static StoragePageCache* instance() { return ExecEnv::GetInstance()->get_storage_page_cache(); }
 
     StoragePageCache(size_t capacity, int32_t index_cache_percentage,
-                     int64_t pk_index_cache_capacity, uint32_t num_shards);
+                     int64_t pk_index_cache_capacity, uint32_t num_shards,
+                     int64_t compressed_cache_capacity = 0);
 
     // Lookup the given page in the cache.
     //
@@ -149,6 +164,10 @@ public:
     // Return true if entry is found, otherwise return false.
     bool lookup(const CacheKey& key, PageCacheHandle* handle, segment_v2::PageTypePB page_type);
 
+    // Return true if the page is in the cache. It is not counted as an access of the page,
+    // e.g. for checking which pages need to be prefetched.
+    bool contains(const CacheKey& key, segment_v2::PageTypePB page_type);
+
     // Insert a page with key into this cache.
     // Given handle will be set to valid reference.
     // This function is thread-safe, and when two clients insert two same key
@@ -163,6 +182,14 @@ public:
         return _get_page_cache(page_type) != nullptr;
     }
 
+    // Lookup and insert the compressed page of the given key, the page cached is the raw
+    // bytes read from file, including footer and checksum.
+    bool lookup_compressed(const CacheKey& key, PageCacheHandle* handle);
+    bool contains_compressed(const CacheKey& key);
+    void insert_compressed(const CacheKey& key, DataPage* data, PageCacheHandle* handle);
+
+    bool is_compressed_cache_available() { return _compressed_page_cache != nullptr; }
+
 private:
     StoragePageCache();
 
@@ -173,6 +200,8 @@ private:
     // page cache to make it for flexible. we need this cache When construct
     // delete bitmap in unique key with mow
     std::unique_ptr<PKIndexPageCache> _pk_index_page_cache = nullptr;
+    // Second tier holding the compressed pages, which are much smaller than decompressed ones.
+    std::unique_ptr<CompressedPageCache> _compressed_page_cache = nullptr;
 
     Cache* _get_page_cache(segment_v2::PageTypePB page_type) {
         switch (page_type) {
@@ -19,6 +19,8 @@
 
 #include <gen_cpp/segment_v2.pb.h>
 
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
 // IWYU pragma: no_include <opentelemetry/common/threadlocal.h>
@@ -30,6 +32,9 @@
 #include "olap/rowset/segment_v2/bloom_filter_index_writer.h"
 #include "olap/rowset/segment_v2/encoding_info.h"
 #include "olap/types.h"
+#include "vec/columns/column.h"
+#include "vec/data_types/data_type.h"
+#include "vec/data_types/data_type_factory.hpp"
 
 namespace doris {
 
@@ -115,4 +120,34 @@ Status PrimaryKeyIndexReader::parse_bf(io::FileReaderSPtr file_reader,
     return Status::OK();
 }
 
+Status PrimaryKeyHashIndex::build(const PrimaryKeyIndexReader& reader, size_t seq_col_length) {
+    static constexpr size_t BATCH_SIZE = 1024;
+    _seq_col_length = seq_col_length;
+    const uint32_t num_rows = reader.num_rows();
+    _rows.reserve(num_rows);
+
+    std::unique_ptr<segment_v2::IndexedColumnIterator> iter;
+    RETURN_IF_ERROR(reader.new_iterator(&iter));
+    auto index_type = vectorized::DataTypeFactory::instance().create_data_type(
+            reader.type_info()->type(), 1, 0);
+    uint32_t row_id = 0;
+    while (row_id < num_rows) {
+        RETURN_IF_ERROR(iter->seek_to_ordinal(row_id));
+        auto index_column = index_type->create_column();
+        size_t num_read = std::min<size_t>(BATCH_SIZE, num_rows - row_id);
+        RETURN_IF_ERROR(iter->next_batch(&num_read, index_column));
+        if (num_read == 0) {
+            return Status::Corruption("primary key index ends at row {} of {}", row_id, num_rows);
+        }
+        for (size_t i = 0; i < num_read; ++i, ++row_id) {
+            auto key = index_column->get_data_at(i);
+            DCHECK_GE(key.size, seq_col_length);
+            char* data = _arena.alloc(key.size);
+            memcpy(data, key.data, key.size);
+            _rows.emplace(StringRef(data, key.size - seq_col_length), row_id);
+        }
+    }
+    return Status::OK();
+}
+
 } // namespace doris
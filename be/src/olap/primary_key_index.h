@@ -18,6 +18,7 @@
 #pragma once
 
 #include <glog/logging.h>
+#include <parallel_hashmap/phmap.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -31,6 +32,8 @@
 #include "olap/rowset/segment_v2/indexed_column_writer.h"
 #include "util/faststring.h"
 #include "util/slice.h"
+#include "vec/common/arena.h"
+#include "vec/common/string_ref.h"
 
 namespace doris {
 class TypeInfo;
@@ -133,4 +136,34 @@ private:
     std::unique_ptr<segment_v2::BloomFilter> _bf;
 };
 
+// In-memory hash index from the primary keys of a segment, without the sequence column, to
+// their row ids. It is built from the primary key index of a loaded segment and finds a key
+// by one probe, instead of testing the bloom filter and seeking in the index pages.
+class PrimaryKeyHashIndex {
+public:
+    Status build(const PrimaryKeyIndexReader& reader, size_t seq_col_length);
+
+    // Return false if `key_without_seq` is not in the segment, otherwise set its row id and
+    // the whole key stored in the segment, which ends with the sequence column if any.
+    bool find(const Slice& key_without_seq, uint32_t* row_id, Slice* sought_key) const {
+        auto it = _rows.find(StringRef(key_without_seq.data, key_without_seq.size));
+        if (it == _rows.end()) {
+            return false;
+        }
+        *row_id = it->second;
+        *sought_key = Slice(it->first.data, it->first.size + _seq_col_length);
+        return true;
+    }
+
+    size_t memory_size() const { return _arena.size() + _rows.capacity() * sizeof(Entry); }
+
+private:
+    using Entry = std::pair<StringRef, uint32_t>;
+
+    size_t _seq_col_length = 0;
+    // holds the whole keys, the keys of `_rows` point into it
+    vectorized::Arena _arena;
+    phmap::flat_hash_map<StringRef, uint32_t, StringRefHash> _rows;
+};
+
 } // namespace doris
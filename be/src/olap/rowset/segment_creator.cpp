@@ -30,7 +30,9 @@
 #include "common/logging.h"
 #include "io/fs/file_writer.h"
 #include "olap/rowset/beta_rowset_writer.h" // SegmentStatistics
+#include "olap/memtable_flush_executor.h"
 #include "olap/rowset/segment_v2/segment_writer.h"
+#include "olap/storage_engine.h"
 #include "vec/core/block.h"
 
 namespace doris {
@@ -95,6 +97,12 @@ Status SegmentFlusher::_create_segment_writer(std::unique_ptr<segment_v2::Segmen
     if (no_compression) {
         writer_options.compression_type = NO_COMPRESSION;
     }
+    // memtables are flushed on the flush pool, whose idle threads help writing wide segments
+    auto* storage_engine = StorageEngine::instance();
+    if (_context.write_type == DataWriteType::TYPE_DIRECT && storage_engine != nullptr &&
+        storage_engine->memtable_flush_executor() != nullptr) {
+        writer_options.column_writer_pool = storage_engine->memtable_flush_executor()->flush_pool();
+    }
 
     const auto& tablet_schema = flush_schema ? flush_schema : _context.tablet_schema;
     writer.reset(new segment_v2::SegmentWriter(
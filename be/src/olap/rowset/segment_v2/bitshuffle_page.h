@@ -22,12 +22,14 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <ostream>
 
 // IWYU pragma: no_include <opentelemetry/common/threadlocal.h>
 #include "common/compiler_util.h" // IWYU pragma: keep
 #include "common/status.h"
 #include "gutil/port.h"
+#include "olap/column_predicate.h"
 #include "olap/olap_common.h"
 #include "olap/rowset/segment_v2/bitshuffle_wrapper.h"
 #include "olap/rowset/segment_v2/common.h"
@@ -389,6 +391,30 @@ public:
         return next_batch<>(n, dst);
     }
 
+    Status evaluate_and_vec(const std::vector<ColumnPredicate*>& predicates, size_t* n,
+                            bool* flags) override {
+        DCHECK(_parsed);
+        if (PREDICT_FALSE(*n == 0 || _cur_index >= _num_elements)) {
+            *n = 0;
+            return Status::OK();
+        }
+
+        size_t max_fetch = std::min(*n, static_cast<size_t>(_num_elements - _cur_index));
+        DCHECK_LE(max_fetch, std::numeric_limits<uint16_t>::max());
+        // the page is already decoded by BitShufflePagePreDecoder, so the values are a plain
+        // array here and the predicate can run on it without copying into a column
+        for (auto* predicate : predicates) {
+            if (!predicate->evaluate_and_raw(get_data(_cur_index), _size_of_element, max_fetch,
+                                             flags)) {
+                return Status::NotSupported("predicate {} can not be evaluated on page",
+                                            predicate->debug_string());
+            }
+        }
+        *n = max_fetch;
+        _cur_index += max_fetch;
+        return Status::OK();
+    }
+
     Status read_by_rowids(const rowid_t* rowids, ordinal_t page_first_ordinal, size_t* n,
                           vectorized::MutableColumnPtr& dst) override {
         DCHECK(_parsed);
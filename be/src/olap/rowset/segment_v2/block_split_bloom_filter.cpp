@@ -19,6 +19,10 @@
 
 #include <glog/logging.h>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace doris {
 namespace segment_v2 {
 
@@ -60,5 +64,40 @@ bool BlockSplitBloomFilter::test_hash(uint64_t hash) const {
     return true;
 }
 
+void BlockSplitBloomFilter::test_hashes(const uint64_t* hashes, size_t n, uint8_t* results) const {
+#ifdef __AVX2__
+    _test_hashes_avx2(hashes, n, results);
+#else
+    for (size_t i = 0; i < n; ++i) {
+        results[i] = test_hash(hashes[i]);
+    }
+#endif
+}
+
+#ifdef __AVX2__
+void BlockSplitBloomFilter::_test_hashes_avx2(const uint64_t* hashes, size_t n,
+                                              uint8_t* results) const {
+    const uint32_t bucket_mask = _num_bytes / BYTES_PER_BLOCK - 1;
+    const __m256i* buckets = reinterpret_cast<const __m256i*>(_data);
+    const __m256i salt = _mm256_setr_epi32(SALT[0], SALT[1], SALT[2], SALT[3], SALT[4], SALT[5],
+                                           SALT[6], SALT[7]);
+    const __m256i ones = _mm256_set1_epi32(1);
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t bucket_index = static_cast<uint32_t>(hashes[i] >> 32) & bucket_mask;
+        // same masks as _set_masks(): 1 << ((key * SALT[i]) >> 27) of every lane
+        __m256i mask = _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<uint32_t>(hashes[i])),
+                                          salt);
+        mask = _mm256_sllv_epi32(ones, _mm256_srli_epi32(mask, 27));
+        // the data is not aligned to 32 bytes
+        const __m256i bucket = _mm256_loadu_si256(buckets + bucket_index);
+        // testc: all bits of the mask are set in the bucket
+        results[i] = _mm256_testc_si256(bucket, mask);
+    }
+    // For SSE compatibility, unset the high bits of each YMM register so SSE instructions
+    // dont have to save them off before using XMM registers.
+    _mm256_zeroupper();
+}
+#endif
+
 } // namespace segment_v2
 } // namespace doris
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "olap/rowset/segment_v2/bloom_filter.h"
@@ -34,9 +35,15 @@ public:
     void add_hash(uint64_t hash) override;
 
     bool test_hash(uint64_t hash) const override;
+    void test_hashes(const uint64_t* hashes, size_t n, uint8_t* results) const override;
     bool contains(const BloomFilter&) const override { return true; }
 
 private:
+#ifdef __AVX2__
+    // The 8 salted bits of a block are one 32-byte AVX2 register.
+    void _test_hashes_avx2(const uint64_t* hashes, size_t n, uint8_t* results) const;
+#endif
+
     // Bytes in a tiny Bloom filter block.
     static constexpr int BYTES_PER_BLOCK = 32;
     // The number of bits to set in a tiny Bloom filter block
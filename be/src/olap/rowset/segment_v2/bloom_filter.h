@@ -21,6 +21,7 @@
 #include <glog/logging.h>
 #include <string.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -152,6 +153,29 @@ public:
     virtual void add_hash(uint64_t hash) = 0;
     virtual bool test_hash(uint64_t hash) const = 0;
 
+    // Test a batch of hashes, results[i] is set to whether hashes[i] may be in the filter.
+    virtual void test_hashes(const uint64_t* hashes, size_t n, uint8_t* results) const {
+        for (size_t i = 0; i < n; ++i) {
+            results[i] = test_hash(hashes[i]);
+        }
+    }
+
+    // Return whether any of the hashes may be in the filter, e.g. for IN predicate.
+    bool test_any_hash(const uint64_t* hashes, size_t n) const {
+        static constexpr size_t BATCH_SIZE = 64;
+        uint8_t results[BATCH_SIZE];
+        for (size_t i = 0; i < n; i += BATCH_SIZE) {
+            size_t batch = std::min(BATCH_SIZE, n - i);
+            test_hashes(hashes + i, batch, results);
+            for (size_t j = 0; j < batch; ++j) {
+                if (results[j]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
     Status merge(const BloomFilter* other) {
         DCHECK(other->size() == _size);
         for (uint32_t i = 0; i < other->size(); i++) {
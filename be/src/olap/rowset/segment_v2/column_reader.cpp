@@ -19,6 +19,7 @@
 
 #include <assert.h>
 #include <gen_cpp/segment_v2.pb.h>
+#include <roaring/roaring.hh>
 
 #include <algorithm>
 #include <memory>
@@ -27,6 +28,7 @@
 
 // IWYU pragma: no_include <opentelemetry/common/threadlocal.h>
 #include "common/compiler_util.h" // IWYU pragma: keep
+#include "common/config.h"
 #include "io/fs/file_reader.h"
 #include "olap/block_column_predicate.h"
 #include "olap/column_predicate.h"
@@ -34,6 +36,7 @@
 #include "olap/inverted_index_parser.h"
 #include "olap/iterators.h"
 #include "olap/olap_common.h"
+#include "olap/page_cache.h"
 #include "olap/rowset/segment_v2/binary_dict_page.h" // for BinaryDictPageDecoder
 #include "olap/rowset/segment_v2/binary_plain_page.h"
 #include "olap/rowset/segment_v2/bitmap_index_reader.h"
@@ -277,6 +280,41 @@ Status ColumnReader::read_page(const ColumnIteratorOptions& iter_opts, const Pag
     return PageIO::read_and_decompress_page(opts, handle, page_body, footer);
 }
 
+void ColumnReader::prefetch_pages(const ColumnIteratorOptions& iter_opts,
+                                  const std::vector<PagePointer>& pages) const {
+    auto cache = StoragePageCache::instance();
+    bool check_cache = iter_opts.use_page_cache && cache->is_cache_available(iter_opts.type);
+    bool check_compressed_cache =
+            iter_opts.use_page_cache && cache->is_compressed_cache_available();
+    const std::string& path = iter_opts.file_reader->path().native();
+    size_t file_size = iter_opts.file_reader->size();
+
+    uint64_t range_offset = 0;
+    uint64_t range_size = 0;
+    for (const auto& pp : pages) {
+        // a hint must not count as an access of the cached pages
+        StoragePageCache::CacheKey cache_key(path, file_size, pp.offset);
+        if (check_cache && cache->contains(cache_key, iter_opts.type)) {
+            continue;
+        }
+        if (check_compressed_cache && cache->contains_compressed(cache_key)) {
+            continue;
+        }
+        if (range_size > 0 && range_offset + range_size == pp.offset) {
+            range_size += pp.size;
+            continue;
+        }
+        if (range_size > 0) {
+            iter_opts.file_reader->prefetch_range(range_offset, range_size, &iter_opts.io_ctx);
+        }
+        range_offset = pp.offset;
+        range_size = pp.size;
+    }
+    if (range_size > 0) {
+        iter_opts.file_reader->prefetch_range(range_offset, range_size, &iter_opts.io_ctx);
+    }
+}
+
 Status ColumnReader::get_row_ranges_by_zone_map(
         const AndBlockColumnPredicate* col_predicates,
         const std::vector<const ColumnPredicate*>* delete_predicates, RowRanges* row_ranges) {
@@ -662,8 +700,11 @@ MapFileColumnIterator::MapFileColumnIterator(ColumnReader* reader, ColumnIterato
 }
 
 Status MapFileColumnIterator::init(const ColumnIteratorOptions& opts) {
-    RETURN_IF_ERROR(_key_iterator->init(opts));
-    RETURN_IF_ERROR(_val_iterator->init(opts));
+    // ordinals of keys and values are not row ids
+    ColumnIteratorOptions element_opts = opts;
+    element_opts.row_bitmap = nullptr;
+    RETURN_IF_ERROR(_key_iterator->init(element_opts));
+    RETURN_IF_ERROR(_val_iterator->init(element_opts));
     RETURN_IF_ERROR(_offsets_iterator->init(opts));
     if (_map_reader->is_nullable()) {
         RETURN_IF_ERROR(_null_iterator->init(opts));
@@ -880,7 +921,10 @@ ArrayFileColumnIterator::ArrayFileColumnIterator(ColumnReader* reader,
 
 Status ArrayFileColumnIterator::init(const ColumnIteratorOptions& opts) {
     RETURN_IF_ERROR(_offset_iterator->init(opts));
-    RETURN_IF_ERROR(_item_iterator->init(opts));
+    // ordinals of items are not row ids
+    ColumnIteratorOptions item_opts = opts;
+    item_opts.row_bitmap = nullptr;
+    RETURN_IF_ERROR(_item_iterator->init(item_opts));
     if (_array_reader->is_nullable()) {
         RETURN_IF_ERROR(_null_iterator->init(opts));
     }
@@ -998,10 +1042,18 @@ Status FileColumnIterator::seek_to_first() {
 }
 
 Status FileColumnIterator::seek_to_ordinal(ordinal_t ord) {
+    return _seek_to_ordinal(ord, true);
+}
+
+Status FileColumnIterator::_seek_to_ordinal(ordinal_t ord, bool read_ahead) {
     // if current page contains this row, we don't need to seek
     if (!_page || !_page.contains(ord) || !_page_iter.valid()) {
+        int32_t prev_page_index = _page ? _page_iter.page_index() : -1;
         RETURN_IF_ERROR(_reader->seek_at_or_before(ord, &_page_iter));
         RETURN_IF_ERROR(_read_data_page(_page_iter));
+        if (read_ahead) {
+            _read_ahead_pages(prev_page_index);
+        }
     }
     _seek_to_pos_in_page(&_page, ord - _page.first_ordinal);
     _current_ordinal = ord;
@@ -1102,13 +1154,102 @@ Status FileColumnIterator::next_batch(size_t* n, vectorized::MutableColumnPtr& d
     return Status::OK();
 }
 
+bool FileColumnIterator::can_evaluate_on_page() const {
+    // bit shuffle pages are pre-decoded into plain arrays when loaded
+    return _reader->encoding_info()->encoding() == BIT_SHUFFLE;
+}
+
+Status FileColumnIterator::evaluate_and_vec(const std::vector<ColumnPredicate*>& predicates,
+                                            size_t* n, bool* flags) {
+    size_t remaining = *n;
+    size_t evaluated = 0;
+    while (remaining > 0) {
+        if (!_page.has_remaining()) {
+            bool eos = false;
+            RETURN_IF_ERROR(_load_next_page(&eos));
+            if (eos) {
+                break;
+            }
+        }
+
+        // number of rows to be evaluated in this page
+        size_t nrows_in_page = std::min(remaining, _page.remaining());
+        size_t nrows_to_read = nrows_in_page;
+        if (_page.has_null) {
+            while (nrows_to_read > 0) {
+                bool is_null = false;
+                size_t this_run = _page.null_decoder.GetNextRun(&is_null, nrows_to_read);
+                size_t num_rows = this_run;
+                if (!is_null) {
+                    RETURN_IF_ERROR(_page.data_decoder->evaluate_and_vec(predicates, &num_rows,
+                                                                         flags + evaluated));
+                    DCHECK_EQ(this_run, num_rows);
+                } else {
+                    memset(flags + evaluated, 0, this_run);
+                }
+
+                evaluated += this_run;
+                nrows_to_read -= this_run;
+                _page.offset_in_page += this_run;
+                _current_ordinal += this_run;
+            }
+        } else {
+            RETURN_IF_ERROR(_page.data_decoder->evaluate_and_vec(predicates, &nrows_to_read,
+                                                                 flags + evaluated));
+            DCHECK_EQ(nrows_to_read, nrows_in_page);
+
+            evaluated += nrows_to_read;
+            _page.offset_in_page += nrows_to_read;
+            _current_ordinal += nrows_to_read;
+        }
+        remaining -= nrows_in_page;
+    }
+    *n -= remaining;
+    return Status::OK();
+}
+
+void FileColumnIterator::_prefetch_pages_by_rowids(const rowid_t* rowids, size_t count) {
+    if (!config::enable_local_file_prefetch || count == 0) {
+        return;
+    }
+    // rowids are sorted, so walk the ordinal index once and collect every page
+    // touched by this batch except the one we have already decoded
+    OrdinalPageIndexIterator iter;
+    if (!_reader->seek_at_or_before(rowids[0], &iter).ok()) {
+        return;
+    }
+    std::vector<PagePointer> pages;
+    size_t i = 0;
+    while (i < count && iter.valid()) {
+        if (iter.last_ordinal() < rowids[i]) {
+            iter.next();
+            continue;
+        }
+        if (!_page || !_page.contains(rowids[i])) {
+            pages.push_back(iter.page());
+        }
+        // skip rowids located in the same page
+        while (i < count && rowids[i] <= iter.last_ordinal()) {
+            ++i;
+        }
+        iter.next();
+    }
+    // a single page is read synchronously right away, no gain from prefetching it
+    if (pages.size() > 1) {
+        _reader->prefetch_pages(_opts, pages);
+    }
+}
+
 Status FileColumnIterator::read_by_rowids(const rowid_t* rowids, const size_t count,
                                           vectorized::MutableColumnPtr& dst) {
+    _prefetch_pages_by_rowids(rowids, count);
+
     size_t remaining = count;
     size_t total_read_count = 0;
     size_t nrows_to_read = 0;
     while (remaining > 0) {
-        RETURN_IF_ERROR(seek_to_ordinal(rowids[total_read_count]));
+        // pages of the batch have been prefetched by _prefetch_pages_by_rowids
+        RETURN_IF_ERROR(_seek_to_ordinal(rowids[total_read_count], false));
 
         // number of rows to be read from this page
         nrows_to_read = std::min(remaining, _page.remaining());
@@ -1178,7 +1319,53 @@ Status FileColumnIterator::read_by_rowids(const rowid_t* rowids, const size_t co
     return Status::OK();
 }
 
+void FileColumnIterator::_read_ahead_pages(int32_t prev_page_index) {
+    int32_t max_pages = config::segment_read_ahead_max_pages;
+    int32_t cur_page_index = _page_iter.page_index();
+    if (max_pages <= 0 || cur_page_index <= prev_page_index) {
+        // backward seek, it is not a sequential scan
+        _read_ahead_window = 0;
+        _read_ahead_end_page = 0;
+        return;
+    }
+    if (cur_page_index > _read_ahead_end_page) {
+        // jumped over the pages read ahead, start over with a small window
+        _read_ahead_window = 0;
+    } else if (cur_page_index + 1 < _read_ahead_end_page) {
+        // still enough pages in flight
+        return;
+    }
+    _read_ahead_window = std::clamp(_read_ahead_window * 2, 1, max_pages);
+
+    int32_t end_page = cur_page_index + 1 + _read_ahead_window;
+    std::vector<PagePointer> pages;
+    OrdinalPageIndexIterator iter = _page_iter;
+    for (iter.next(); iter.valid() && iter.page_index() < end_page; iter.next()) {
+        if (iter.page_index() < _read_ahead_end_page) {
+            continue;
+        }
+        if (_opts.row_bitmap != nullptr) {
+            // skip pages whose rows are all filtered out by indexes
+            auto it = _opts.row_bitmap->begin();
+            it.equalorlarger(static_cast<uint32_t>(iter.first_ordinal()));
+            if (it == _opts.row_bitmap->end() || *it > iter.last_ordinal()) {
+                continue;
+            }
+        }
+        pages.push_back(iter.page());
+    }
+    _read_ahead_end_page = std::max(_read_ahead_end_page, end_page);
+    if (pages.empty()) {
+        return;
+    }
+    if (_opts.stats != nullptr) {
+        _opts.stats->read_ahead_pages_num += pages.size();
+    }
+    _reader->prefetch_pages(_opts, pages);
+}
+
 Status FileColumnIterator::_load_next_page(bool* eos) {
+    int32_t prev_page_index = _page_iter.page_index();
     _page_iter.next();
     if (!_page_iter.valid()) {
         *eos = true;
@@ -1186,6 +1373,7 @@ Status FileColumnIterator::_load_next_page(bool* eos) {
     }
 
     RETURN_IF_ERROR(_read_data_page(_page_iter));
+    _read_ahead_pages(prev_page_index);
     _seek_to_pos_in_page(&_page, 0);
     *eos = false;
     return Status::OK();
@@ -46,6 +46,10 @@
 #include "vec/columns/column_array.h" // ColumnArray
 #include "vec/data_types/data_type.h"
 
+namespace roaring {
+class Roaring;
+} // namespace roaring
+
 namespace doris {
 
 class BlockCompressionCodec;
@@ -92,6 +96,8 @@ struct ColumnIteratorOptions {
     // reader statistics
     OlapReaderStatistics* stats = nullptr; // Ref
     io::IOContext io_ctx;
+    // rows to be read by the segment iterator, pages without any of them are not read ahead
+    const roaring::Roaring* row_bitmap = nullptr; // Ref
 
     void sanity_check() const {
         CHECK_NOTNULL(file_reader);
@@ -133,6 +139,11 @@ public:
                      PageHandle* handle, Slice* page_body, PageFooterPB* footer,
                      BlockCompressionCodec* codec) const;
 
+    // hint the file reader to load the given pages in background, pages already in
+    // page cache are skipped and adjacent pages are merged into one range
+    void prefetch_pages(const ColumnIteratorOptions& iter_opts,
+                        const std::vector<PagePointer>& pages) const;
+
     bool is_nullable() const { return _meta_is_nullable; }
 
     const EncodingInfo* encoding_info() const { return _encoding_info; }
@@ -287,6 +298,16 @@ public:
         return Status::NotSupported("read_by_rowids not implement");
     }
 
+    // Evaluate `predicates` on the next *n rows directly on the encoded pages and AND the
+    // result into `flags` without materializing the values, null rows never pass.
+    // Only valid when can_evaluate_on_page() returns true.
+    virtual Status evaluate_and_vec(const std::vector<ColumnPredicate*>& predicates, size_t* n,
+                                    bool* flags) {
+        return Status::NotSupported("evaluate_and_vec not implement");
+    }
+
+    virtual bool can_evaluate_on_page() const { return false; }
+
     virtual ordinal_t get_current_ordinal() const = 0;
 
     virtual Status get_row_ranges_by_zone_map(
@@ -333,6 +354,11 @@ public:
     Status read_by_rowids(const rowid_t* rowids, const size_t count,
                           vectorized::MutableColumnPtr& dst) override;
 
+    Status evaluate_and_vec(const std::vector<ColumnPredicate*>& predicates, size_t* n,
+                            bool* flags) override;
+
+    bool can_evaluate_on_page() const override;
+
     ordinal_t get_current_ordinal() const override { return _current_ordinal; }
 
     // get row ranges by zone map
@@ -356,9 +382,12 @@ public:
 
 private:
     void _seek_to_pos_in_page(ParsedPage* page, ordinal_t offset_in_page) const;
+    Status _seek_to_ordinal(ordinal_t ord, bool read_ahead);
     Status _load_next_page(bool* eos);
     Status _read_data_page(const OrdinalPageIndexIterator& iter);
     Status _read_dict_data();
+    void _prefetch_pages_by_rowids(const rowid_t* rowids, size_t count);
+    void _read_ahead_pages(int32_t prev_page_index);
 
     ColumnReader* _reader;
 
@@ -383,6 +412,12 @@ private:
     // current value ordinal
     ordinal_t _current_ordinal = 0;
 
+    // Adaptive read ahead of sequential scan: the number of pages to read ahead doubles each
+    // time the scan moves forward into the read ahead pages, and is reset by a random seek.
+    int32_t _read_ahead_window = 0;
+    // pages before this index have been read ahead
+    int32_t _read_ahead_end_page = 0;
+
     bool _is_all_dict_encoding = false;
 
     std::unique_ptr<StringRef[]> _dict_word_info;
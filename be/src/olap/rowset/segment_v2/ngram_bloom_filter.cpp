@@ -20,6 +20,10 @@
 #include <gen_cpp/segment_v2.pb.h>
 #include <glog/logging.h>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include "gutil/hash/city.h"
 #include "gutil/strings/substitute.h"
 
@@ -65,7 +69,20 @@ void NGramBloomFilter::add_bytes(const char* data, uint32_t len) {
 
 bool NGramBloomFilter::contains(const BloomFilter& bf_) const {
     const NGramBloomFilter& bf = static_cast<const NGramBloomFilter&>(bf_);
-    for (size_t i = 0; i < words; ++i) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= words; i += 4) {
+        const __m256i self = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&filter[i]));
+        const __m256i other = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&bf.filter[i]));
+        // testc: all bits of other are set in self
+        if (!_mm256_testc_si256(self, other)) {
+            _mm256_zeroupper();
+            return false;
+        }
+    }
+    _mm256_zeroupper();
+#endif
+    for (; i < words; ++i) {
         if ((filter[i] & bf.filter[i]) != bf.filter[i]) {
             return false;
         }
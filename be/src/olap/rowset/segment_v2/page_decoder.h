@@ -17,10 +17,14 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/status.h" // for Status
 #include "vec/columns/column.h"
 
 namespace doris {
+class ColumnPredicate;
+
 namespace segment_v2 {
 
 // PageDecoder is used to decode page.
@@ -78,6 +82,14 @@ public:
         return Status::NotSupported("not implement vec op now");
     }
 
+    // Evaluate `predicates` on the next *n values directly on the page data instead of
+    // materializing them, AND the result into `flags` and move forward the cursor.
+    // Return NotSupported if this encoding can not do it.
+    virtual Status evaluate_and_vec(const std::vector<ColumnPredicate*>& predicates, size_t* n,
+                                    bool* flags) {
+        return Status::NotSupported("evaluate predicates on page not supported");
+    }
+
     // Same as `next_batch` except for not moving forward the cursor.
     // When read array's ordinals in `ArrayFileColumnIterator`, we want to read one extra ordinal
     // but do not want to move forward the cursor.
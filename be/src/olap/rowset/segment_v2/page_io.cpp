@@ -143,23 +143,36 @@ Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle*
     }
 
     // hold compressed page at first, reset to decompressed page later
-    std::unique_ptr<DataPage> page = std::make_unique<DataPage>(page_size);
-    Slice page_slice(page->data(), page_size);
-    {
-        SCOPED_RAW_TIMER(&opts.stats->io_ns);
-        size_t bytes_read = 0;
-        RETURN_IF_ERROR(opts.file_reader->read_at(opts.page_pointer.offset, page_slice, &bytes_read,
-                                                  &opts.io_ctx));
-        DCHECK_EQ(bytes_read, page_size);
-        opts.stats->compressed_bytes_read += page_size;
-    }
+    std::unique_ptr<DataPage> page;
+    Slice page_slice;
+    // the compressed page is kept in compressed page cache if it's found there,
+    // then it's decompressed without reading file
+    PageCacheHandle compressed_cache_handle;
+    bool use_compressed_cache = opts.use_page_cache && cache->is_compressed_cache_available();
+    if (use_compressed_cache && cache->lookup_compressed(cache_key, &compressed_cache_handle)) {
+        // checksum was verified when the page was read from file
+        page_slice = compressed_cache_handle.data();
+        DCHECK_EQ(page_slice.size, page_size);
+        opts.stats->compressed_cached_pages_num++;
+    } else {
+        page = std::make_unique<DataPage>(page_size);
+        page_slice = Slice(page->data(), page_size);
+        {
+            SCOPED_RAW_TIMER(&opts.stats->io_ns);
+            size_t bytes_read = 0;
+            RETURN_IF_ERROR(opts.file_reader->read_at(opts.page_pointer.offset, page_slice,
+                                                      &bytes_read, &opts.io_ctx));
+            DCHECK_EQ(bytes_read, page_size);
+            opts.stats->compressed_bytes_read += page_size;
+        }
 
-    if (opts.verify_checksum) {
-        uint32_t expect = decode_fixed32_le((uint8_t*)page_slice.data + page_slice.size - 4);
-        uint32_t actual = crc32c::Value(page_slice.data, page_slice.size - 4);
-        if (expect != actual) {
-            return Status::Corruption("Bad page: checksum mismatch (actual={} vs expect={})",
-                                      actual, expect);
+        if (opts.verify_checksum) {
+            uint32_t expect = decode_fixed32_le((uint8_t*)page_slice.data + page_slice.size - 4);
+            uint32_t actual = crc32c::Value(page_slice.data, page_slice.size - 4);
+            if (expect != actual) {
+                return Status::Corruption("Bad page: checksum mismatch (actual={} vs expect={})",
+                                          actual, expect);
+            }
         }
     }
 
@@ -192,11 +205,21 @@ Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle*
         // append footer and footer size
         memcpy(decompressed_body.data + decompressed_body.size, page_slice.data + body_size,
                footer_size + 4);
+        if (use_compressed_cache && page != nullptr) {
+            // keep the compressed page read from file in compressed page cache
+            cache->insert_compressed(cache_key, page.release(), &compressed_cache_handle);
+        }
         // free memory of compressed page
         page = std::move(decompressed_page);
         page_slice = Slice(page->data(), footer->uncompressed_size() + footer_size + 4);
         opts.stats->uncompressed_bytes_read += page_slice.size;
     } else {
+        if (page == nullptr) {
+            // only compressed pages are put into compressed page cache, just in case
+            page = std::make_unique<DataPage>(page_slice.size);
+            memcpy(page->data(), page_slice.data, page_slice.size);
+            page_slice = Slice(page->data(), page_slice.size);
+        }
         opts.stats->uncompressed_bytes_read += body_size;
     }
 
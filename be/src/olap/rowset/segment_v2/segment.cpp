@@ -26,6 +26,7 @@
 #include <memory>
 #include <utility>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "common/status.h"
 #include "io/fs/file_reader.h"
@@ -223,6 +224,18 @@ Status Segment::_load_pk_bloom_filter() {
     });
 }
 
+Status Segment::_load_pk_hash_index(size_t seq_col_length) {
+    DCHECK(_pk_index_reader != nullptr);
+    return _load_pk_hash_index_once.call([this, seq_col_length] {
+        auto pk_hash_index = std::make_unique<PrimaryKeyHashIndex>();
+        RETURN_IF_ERROR(pk_hash_index->build(*_pk_index_reader, seq_col_length));
+        _meta_mem_usage += pk_hash_index->memory_size();
+        _segment_meta_mem_tracker->consume(pk_hash_index->memory_size());
+        _pk_hash_index = std::move(pk_hash_index);
+        return Status::OK();
+    });
+}
+
 Status Segment::load_pk_index_and_bf() {
     RETURN_IF_ERROR(load_index());
     RETURN_IF_ERROR(_load_pk_bloom_filter());
@@ -347,7 +360,22 @@ Status Segment::new_inverted_index_iterator(const TabletColumn& tablet_column,
     return Status::OK();
 }
 
-Status Segment::lookup_row_key(const Slice& key, bool with_seq_col, RowLocation* row_location) {
+// `key` and `sought_key` are the same key with their sequence columns, return
+// KEY_ALREADY_EXISTS if the one in the segment has a higher sequence id.
+static Status compare_sequence_id(const Slice& key, const Slice& sought_key,
+                                  size_t seq_col_length) {
+    Slice sequence_id = Slice(key.get_data() + key.get_size() - seq_col_length + 1,
+                              seq_col_length - 1);
+    Slice previous_sequence_id = Slice(
+            sought_key.get_data() + sought_key.get_size() - seq_col_length + 1, seq_col_length - 1);
+    if (sequence_id.compare(previous_sequence_id) < 0) {
+        return Status::Error<ErrorCode::KEY_ALREADY_EXISTS>("key with higher sequence id exists");
+    }
+    return Status::OK();
+}
+
+Status Segment::lookup_row_key(const Slice& key, bool with_seq_col, RowLocation* row_location,
+                               std::unique_ptr<IndexedColumnIterator>* index_iterator) {
     RETURN_IF_ERROR(load_pk_index_and_bf());
     bool has_seq_col = _tablet_schema->has_sequence_col();
     size_t seq_col_length = 0;
@@ -359,20 +387,42 @@ Status Segment::lookup_row_key(const Slice& key, bool with_seq_col, RowLocation*
             Slice(key.get_data(), key.get_size() - (with_seq_col ? seq_col_length : 0));
 
     DCHECK(_pk_index_reader != nullptr);
+    if (config::mow_pk_hash_index_max_rows > 0 &&
+        _num_rows <= static_cast<uint32_t>(config::mow_pk_hash_index_max_rows)) {
+        RETURN_IF_ERROR(_load_pk_hash_index(seq_col_length));
+        uint32_t row_id = 0;
+        Slice sought_key;
+        if (!_pk_hash_index->find(key_without_seq, &row_id, &sought_key)) {
+            return Status::Error<ErrorCode::KEY_NOT_FOUND>("Can't find key in the segment");
+        }
+        row_location->row_id = row_id;
+        row_location->segment_id = _segment_id;
+        row_location->rowset_id = _rowset_id;
+        if (has_seq_col && with_seq_col) {
+            return compare_sequence_id(key, sought_key, seq_col_length);
+        }
+        return Status::OK();
+    }
+
     if (!_pk_index_reader->check_present(key_without_seq)) {
         return Status::Error<ErrorCode::KEY_NOT_FOUND>("Can't find key in the segment");
     }
     bool exact_match = false;
-    std::unique_ptr<segment_v2::IndexedColumnIterator> index_iterator;
-    RETURN_IF_ERROR(_pk_index_reader->new_iterator(&index_iterator));
-    auto st = index_iterator->seek_at_or_after(&key_without_seq, &exact_match);
+    std::unique_ptr<segment_v2::IndexedColumnIterator> own_index_iterator;
+    if (index_iterator == nullptr) {
+        index_iterator = &own_index_iterator;
+    }
+    if (*index_iterator == nullptr) {
+        RETURN_IF_ERROR(_pk_index_reader->new_iterator(index_iterator));
+    }
+    auto st = (*index_iterator)->seek_at_or_after(&key_without_seq, &exact_match);
     if (!st.ok() && !st.is<ErrorCode::ENTRY_NOT_FOUND>()) {
         return st;
     }
     if (st.is<ErrorCode::ENTRY_NOT_FOUND>() || (!has_seq_col && !exact_match)) {
         return Status::Error<ErrorCode::KEY_NOT_FOUND>("Can't find key in the segment");
     }
-    row_location->row_id = index_iterator->get_current_ordinal();
+    row_location->row_id = (*index_iterator)->get_current_ordinal();
     row_location->segment_id = _segment_id;
     row_location->rowset_id = _rowset_id;
 
@@ -382,7 +432,7 @@ Status Segment::lookup_row_key(const Slice& key, bool with_seq_col, RowLocation*
                 _pk_index_reader->type_info()->type(), 1, 0);
         auto index_column = index_type->create_column();
         size_t num_read = num_to_read;
-        RETURN_IF_ERROR(index_iterator->next_batch(&num_read, index_column));
+        RETURN_IF_ERROR((*index_iterator)->next_batch(&num_read, index_column));
         DCHECK(num_to_read == num_read);
 
         Slice sought_key =
@@ -398,16 +448,7 @@ Status Segment::lookup_row_key(const Slice& key, bool with_seq_col, RowLocation*
         if (!with_seq_col) {
             return Status::OK();
         }
-
-        // compare sequence id
-        Slice sequence_id =
-                Slice(key.get_data() + key_without_seq.get_size() + 1, seq_col_length - 1);
-        Slice previous_sequence_id = Slice(
-                sought_key.get_data() + sought_key_without_seq.get_size() + 1, seq_col_length - 1);
-        if (sequence_id.compare(previous_sequence_id) < 0) {
-            return Status::Error<ErrorCode::KEY_ALREADY_EXISTS>(
-                    "key with higher sequence id exists");
-        }
+        return compare_sequence_id(key, sought_key, seq_col_length);
     }
 
     return Status::OK();
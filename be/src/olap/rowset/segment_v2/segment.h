@@ -47,12 +47,14 @@ class Schema;
 class StorageReadOptions;
 class MemTracker;
 class PrimaryKeyIndexReader;
+class PrimaryKeyHashIndex;
 class RowwiseIterator;
 struct RowLocation;
 
 namespace segment_v2 {
 
 class BitmapIndexIterator;
+class IndexedColumnIterator;
 class Segment;
 class InvertedIndexIterator;
 
@@ -104,7 +106,11 @@ public:
         return _pk_index_reader.get();
     }
 
-    Status lookup_row_key(const Slice& key, bool with_seq_col, RowLocation* row_location);
+    // `index_iterator` may keep the iterator of the primary key index across lookups, it is
+    // created by the first one. The iterator keeps its current data page, so looking up keys in
+    // ascending order reads every page of the index at most once.
+    Status lookup_row_key(const Slice& key, bool with_seq_col, RowLocation* row_location,
+                          std::unique_ptr<IndexedColumnIterator>* index_iterator = nullptr);
 
     Status read_key_by_rowid(uint32_t row_id, std::string* key);
 
@@ -133,6 +139,7 @@ private:
     Status _parse_footer(SegmentFooterPB* footer);
     Status _create_column_readers(const SegmentFooterPB& footer);
     Status _load_pk_bloom_filter();
+    Status _load_pk_hash_index(size_t seq_col_length);
 
 private:
     friend class SegmentIterator;
@@ -163,6 +170,9 @@ private:
     std::unique_ptr<ShortKeyIndexDecoder> _sk_index_decoder;
     // primary key index reader
     std::unique_ptr<PrimaryKeyIndexReader> _pk_index_reader;
+    // used to guarantee that primary key hash index will be built at most once in a thread-safe way
+    DorisCallOnce<Status> _load_pk_hash_index_once;
+    std::unique_ptr<PrimaryKeyHashIndex> _pk_hash_index;
     // Segment may be destructed after StorageEngine, in order to exit gracefully.
     std::shared_ptr<MemTracker> _segment_meta_mem_tracker;
     std::mutex _open_lock;
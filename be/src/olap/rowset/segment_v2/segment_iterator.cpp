@@ -380,6 +380,7 @@ Status SegmentIterator::_prepare_seek(const StorageReadOptions::KeyRange& key_ra
                     .file_reader = _file_reader.get(),
                     .stats = _opts.stats,
                     .io_ctx = _opts.io_ctx,
+                    .row_bitmap = &_row_bitmap,
             };
             RETURN_IF_ERROR(_column_iterators[cid]->init(iter_opts));
         }
@@ -1058,6 +1059,7 @@ Status SegmentIterator::_init_return_column_iterators() {
                     .file_reader = _file_reader.get(),
                     .stats = _opts.stats,
                     .io_ctx = _opts.io_ctx,
+                    .row_bitmap = &_row_bitmap,
             };
             RETURN_IF_ERROR(_column_iterators[cid]->init(iter_opts));
         }
@@ -1399,6 +1401,8 @@ Status SegmentIterator::_vec_init_lazy_materialization() {
         }
     }
 
+    _vec_init_page_eval_predicate(del_cond_id_set);
+
     // Step 3: fill non predicate columns and second read column
     // if _schema columns size equal to pred_column_ids size, lazy_materialization_read is false,
     // all columns are lazy materialization columns without non predicte column.
@@ -1465,6 +1469,68 @@ Status SegmentIterator::_vec_init_lazy_materialization() {
     return Status::OK();
 }
 
+void SegmentIterator::_vec_init_page_eval_predicate(const std::set<ColumnId>& del_cond_id_set) {
+    // same safety conditions as _need_read_data, the values of the column must not be needed
+    // by anything except the predicates themselves
+    if (!config::enable_page_predicate_evaluation || _pre_eval_block_predicate.empty() ||
+        _opts.output_columns == nullptr || _output_columns.count(-1) ||
+        _opts.tablet_schema->keys_type() != KeysType::DUP_KEYS ||
+        _opts.io_ctx.reader_type != ReaderType::READER_QUERY) {
+        return;
+    }
+
+    std::map<ColumnId, std::vector<ColumnPredicate*>> column_predicates;
+    for (auto* predicate : _pre_eval_block_predicate) {
+        column_predicates[predicate->column_id()].push_back(predicate);
+    }
+    for (auto& [cid, predicates] : column_predicates) {
+        if (std::find(_short_cir_pred_column_ids.begin(), _short_cir_pred_column_ids.end(),
+                      cid) != _short_cir_pred_column_ids.end() ||
+            del_cond_id_set.count(cid) > 0 || _is_common_expr_column[cid] ||
+            cid == _schema->version_col_idx() ||
+            _output_columns.count(_opts.tablet_schema->column(cid).unique_id()) > 0 ||
+            !_need_read_data(cid)) {
+            // the column is needed by something else, or its data is not read at all
+            continue;
+        }
+        // the predicate column of these types keeps the same layout as the data page
+        switch (_schema->column(cid)->type()) {
+        case FieldType::OLAP_FIELD_TYPE_TINYINT:
+        case FieldType::OLAP_FIELD_TYPE_SMALLINT:
+        case FieldType::OLAP_FIELD_TYPE_INT:
+        case FieldType::OLAP_FIELD_TYPE_BIGINT:
+        case FieldType::OLAP_FIELD_TYPE_LARGEINT:
+        case FieldType::OLAP_FIELD_TYPE_FLOAT:
+        case FieldType::OLAP_FIELD_TYPE_DOUBLE:
+        case FieldType::OLAP_FIELD_TYPE_DATEV2:
+        case FieldType::OLAP_FIELD_TYPE_DATETIMEV2:
+        case FieldType::OLAP_FIELD_TYPE_DECIMAL32:
+        case FieldType::OLAP_FIELD_TYPE_DECIMAL64:
+        case FieldType::OLAP_FIELD_TYPE_DECIMAL128I:
+            break;
+        default:
+            continue;
+        }
+        if (!_column_iterators[cid]->can_evaluate_on_page() ||
+            std::any_of(predicates.begin(), predicates.end(),
+                        [](const ColumnPredicate* pred) { return pred->opposite(); })) {
+            continue;
+        }
+        _page_eval_block_predicate.insert(_page_eval_block_predicate.end(), predicates.begin(),
+                                          predicates.end());
+        _page_eval_columns.emplace(cid, std::move(predicates));
+    }
+
+    if (!_page_eval_columns.empty()) {
+        _pre_eval_block_predicate.erase(
+                std::remove_if(_pre_eval_block_predicate.begin(), _pre_eval_block_predicate.end(),
+                               [this](const ColumnPredicate* pred) {
+                                   return _page_eval_columns.count(pred->column_id()) > 0;
+                               }),
+                _pre_eval_block_predicate.end());
+    }
+}
+
 bool SegmentIterator::_can_evaluated_by_vectorized(ColumnPredicate* predicate) {
     auto cid = predicate->column_id();
     FieldType field_type = _schema->column(cid)->type();
@@ -1520,6 +1586,12 @@ bool SegmentIterator::_prune_column(ColumnId cid, vectorized::MutableColumnPtr&
     if (!fill_defaults) {
         return true;
     }
+    _fill_column_defaults(column, num_of_defaults);
+    return true;
+}
+
+void SegmentIterator::_fill_column_defaults(vectorized::MutableColumnPtr& column,
+                                            size_t num_of_defaults) {
     if (column->is_nullable()) {
         auto nullable_col_ptr = reinterpret_cast<vectorized::ColumnNullable*>(column.get());
         nullable_col_ptr->get_null_map_column().insert_many_defaults(num_of_defaults);
@@ -1528,7 +1600,6 @@ bool SegmentIterator::_prune_column(ColumnId cid, vectorized::MutableColumnPtr&
         // assert(column->is_const());
         column->insert_many_defaults(num_of_defaults);
     }
-    return true;
 }
 
 Status SegmentIterator::_read_columns(const std::vector<ColumnId>& column_ids,
@@ -1536,6 +1607,11 @@ Status SegmentIterator::_read_columns(const std::vector<ColumnId>& column_ids,
     for (auto cid : column_ids) {
         auto& column = column_block[cid];
         size_t rows_read = nrows;
+        if (_page_eval_columns.count(cid) > 0) {
+            // evaluated on pages in _evaluate_predicates_on_page, the values are not needed
+            _fill_column_defaults(column, rows_read);
+            continue;
+        }
         if (_prune_column(cid, column, true, rows_read)) {
             continue;
         }
@@ -1610,6 +1686,9 @@ Status SegmentIterator::_read_columns_by_index(uint32_t nrows_read_limit, uint32
         size_t rows_to_read = range_to - range_from;
         RETURN_IF_ERROR(
                 _read_columns(_first_read_column_ids, _current_return_columns, rows_to_read));
+        if (!_page_eval_columns.empty()) {
+            RETURN_IF_ERROR(_evaluate_predicates_on_page(nrows_read, rows_to_read));
+        }
         _cur_rowid += rows_to_read;
         if (set_block_rowid) {
             // Here use std::iota is better performance than for-loop, maybe for-loop is not vectorized
@@ -1627,6 +1706,20 @@ Status SegmentIterator::_read_columns_by_index(uint32_t nrows_read_limit, uint32
     return Status::OK();
 }
 
+Status SegmentIterator::_evaluate_predicates_on_page(uint32_t row_offset, size_t nrows) {
+    auto* flags = reinterpret_cast<bool*>(_page_eval_flags.data() + row_offset);
+    memset(flags, 1, nrows);
+    for (auto& [cid, predicates] : _page_eval_columns) {
+        size_t rows_read = nrows;
+        RETURN_IF_ERROR(_column_iterators[cid]->evaluate_and_vec(predicates, &rows_read, flags));
+        if (nrows != rows_read) {
+            return Status::Error<ErrorCode::INTERNAL_ERROR>("nrows({}) != rows_read({})", nrows,
+                                                            rows_read);
+        }
+    }
+    return Status::OK();
+}
+
 void SegmentIterator::_replace_version_col(size_t num_rows) {
     // Only the rowset with single version need to replace the version column.
     // Doris can't determine the version before publish_version finished, so
@@ -1666,11 +1759,18 @@ uint16_t SegmentIterator::_evaluate_vectorization_predicate(uint16_t* sel_rowid_
 
     uint16_t original_size = selected_size;
     bool ret_flags[original_size];
-    DCHECK(_pre_eval_block_predicate.size() > 0);
-    auto column_id = _pre_eval_block_predicate[0]->column_id();
-    auto& column = _current_return_columns[column_id];
-    _pre_eval_block_predicate[0]->evaluate_vec(*column, original_size, ret_flags);
-    for (int i = 1; i < _pre_eval_block_predicate.size(); i++) {
+    int start = 0;
+    if (!_page_eval_columns.empty()) {
+        // already evaluated on pages while reading
+        memcpy(ret_flags, _page_eval_flags.data(), original_size);
+    } else {
+        DCHECK(_pre_eval_block_predicate.size() > 0);
+        auto column_id = _pre_eval_block_predicate[0]->column_id();
+        auto& column = _current_return_columns[column_id];
+        _pre_eval_block_predicate[0]->evaluate_vec(*column, original_size, ret_flags);
+        start = 1;
+    }
+    for (int i = start; i < _pre_eval_block_predicate.size(); i++) {
         auto column_id2 = _pre_eval_block_predicate[i]->column_id();
         auto& column2 = _current_return_columns[column_id2];
         _pre_eval_block_predicate[i]->evaluate_and_vec(*column2, original_size, ret_flags);
@@ -1778,6 +1878,9 @@ Status SegmentIterator::_next_batch_internal(vectorized::Block* block) {
         if (_lazy_materialization_read || _opts.record_rowids || _is_need_expr_eval) {
             _block_rowids.resize(_opts.block_row_max);
         }
+        if (!_page_eval_columns.empty()) {
+            _page_eval_flags.resize(_opts.block_row_max);
+        }
         _current_return_columns.resize(_schema->columns().size());
         for (size_t i = 0; i < _schema->num_column_ids(); i++) {
             auto cid = _schema->column_id(i);
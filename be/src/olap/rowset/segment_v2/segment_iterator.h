@@ -124,6 +124,7 @@ public:
         bool updated = false;
         updated |= _update_profile(profile, _short_cir_eval_predicate, "ShortCircuitPredicates");
         updated |= _update_profile(profile, _pre_eval_block_predicate, "PreEvaluatePredicates");
+        updated |= _update_profile(profile, _page_eval_block_predicate, "PageEvaluatePredicates");
 
         if (_opts.delete_condition_predicates != nullptr) {
             std::set<const ColumnPredicate*> delete_predicate_set;
@@ -201,6 +202,8 @@ private:
     // CHAR type in storage layer padding the 0 in length. But query engine need ignore the padding 0.
     // so segment iterator need to shrink char column before output it. only use in vec query engine.
     void _vec_init_char_column_id();
+    // pick out the vectorized predicates which can be evaluated on the encoded pages
+    void _vec_init_page_eval_predicate(const std::set<ColumnId>& del_cond_id_set);
 
     uint32_t segment_id() const { return _segment->id(); }
     uint32_t num_rows() const { return _segment->num_rows(); }
@@ -212,6 +215,9 @@ private:
                                        vectorized::MutableColumns& column_block, size_t nrows);
     [[nodiscard]] Status _read_columns_by_index(uint32_t nrows_read_limit, uint32_t& nrows_read,
                                                 bool set_block_rowid);
+    // evaluate the predicates of _page_eval_columns on pages for `nrows` rows, the result is
+    // written to _page_eval_flags at `row_offset`
+    [[nodiscard]] Status _evaluate_predicates_on_page(uint32_t row_offset, size_t nrows);
     void _replace_version_col(size_t num_rows);
     void _init_current_block(vectorized::Block* block,
                              std::vector<vectorized::MutableColumnPtr>& non_pred_vector);
@@ -267,6 +273,7 @@ private:
     bool _need_read_data(ColumnId cid);
     bool _prune_column(ColumnId cid, vectorized::MutableColumnPtr& column, bool fill_defaults,
                        size_t num_of_defaults);
+    void _fill_column_defaults(vectorized::MutableColumnPtr& column, size_t num_of_defaults);
 
     // return true means one column's predicates all pushed down
     bool _check_column_pred_all_push_down(const std::string& column_name, bool in_compound = false,
@@ -368,6 +375,12 @@ private:
     std::vector<bool> _is_common_expr_column;
     vectorized::MutableColumns _current_return_columns;
     std::vector<ColumnPredicate*> _pre_eval_block_predicate;
+    // vectorized predicates evaluated on the encoded pages while reading, their columns are
+    // only used by these predicates, so the values are never materialized
+    std::vector<ColumnPredicate*> _page_eval_block_predicate;
+    std::map<ColumnId, std::vector<ColumnPredicate*>> _page_eval_columns;
+    // result of _page_eval_block_predicate for the rows of current block
+    std::vector<uint8_t> _page_eval_flags;
     std::vector<ColumnPredicate*> _short_cir_eval_predicate;
     std::vector<uint32_t> _delete_range_column_ids;
     std::vector<uint32_t> _delete_bloom_filter_column_ids;
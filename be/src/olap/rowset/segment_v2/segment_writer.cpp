@@ -46,11 +46,13 @@
 #include "olap/tablet_schema.h"
 #include "olap/utils.h"
 #include "runtime/memory/mem_tracker.h"
+#include "runtime/thread_context.h"
 #include "service/point_query_executor.h"
 #include "util/coding.h"
 #include "util/crc32c.h"
 #include "util/faststring.h"
 #include "util/key_util.h"
+#include "util/threadpool.h"
 #include "vec/columns/column_nullable.h"
 #include "vec/common/schema_util.h"
 #include "vec/core/block.h"
@@ -175,6 +177,7 @@ Status SegmentWriter::init(const std::vector<uint32_t>& col_ids, bool has_key) {
         for (auto index : opts.indexes) {
             if (!skip_inverted_index && index && index->index_type() == IndexType::INVERTED) {
                 opts.inverted_index = index;
+                _has_inverted_index = true;
                 // TODO support multiple inverted index
                 break;
             }
@@ -390,6 +393,8 @@ Status SegmentWriter::append_block_with_partial_content(const vectorized::Block*
         specified_rowsets = _tablet->get_rowset_by_ids(&_mow_context->rowset_ids);
     }
     std::vector<std::unique_ptr<SegmentCacheHandle>> segment_caches(specified_rowsets.size());
+    // the rows of the block are sorted by key, so their lookups share the index iterators
+    PrimaryKeyIndexIterators index_iterators(specified_rowsets.size());
     // locate rows in base data
 
     int64_t num_rows_filtered = 0;
@@ -418,7 +423,8 @@ Status SegmentWriter::append_block_with_partial_content(const vectorized::Block*
         // save rowset shared ptr so this rowset wouldn't delete
         RowsetSharedPtr rowset;
         auto st = _tablet->lookup_row_key(key, have_input_seq_column, specified_rowsets, &loc,
-                                          _mow_context->max_version, segment_caches, &rowset);
+                                          _mow_context->max_version, segment_caches, &rowset,
+                                          &index_iterators);
         if (st.is<KEY_NOT_FOUND>()) {
             if (_tablet_schema->is_strict_mode()) {
                 ++num_rows_filtered;
@@ -708,23 +714,27 @@ Status SegmentWriter::append_block(const vectorized::Block* block, size_t row_po
     }
 
     // convert column data from engine format to storage layer format
-    std::vector<vectorized::IOlapColumnDataAccessor*> key_columns;
-    vectorized::IOlapColumnDataAccessor* seq_column = nullptr;
-    for (size_t id = 0; id < _column_writers.size(); ++id) {
+    std::vector<vectorized::IOlapColumnDataAccessor*> converted_columns(_column_writers.size());
+    RETURN_IF_ERROR(_for_each_column_writer([&](size_t id) {
         // olap data convertor alway start from id = 0
         auto converted_result = _olap_data_convertor->convert_column_data(id);
         if (!converted_result.first.ok()) {
             return converted_result.first;
         }
+        converted_columns[id] = converted_result.second;
+        return _column_writers[id]->append(converted_result.second->get_nullmap(),
+                                           converted_result.second->get_data(), num_rows);
+    }));
+    std::vector<vectorized::IOlapColumnDataAccessor*> key_columns;
+    vectorized::IOlapColumnDataAccessor* seq_column = nullptr;
+    for (size_t id = 0; id < _column_writers.size(); ++id) {
         auto cid = _column_ids[id];
         if (_has_key && cid < _num_key_columns) {
-            key_columns.push_back(converted_result.second);
+            key_columns.push_back(converted_columns[id]);
         } else if (_has_key && _tablet_schema->has_sequence_col() &&
                    cid == _tablet_schema->sequence_col_idx()) {
-            seq_column = converted_result.second;
+            seq_column = converted_columns[id];
         }
-        RETURN_IF_ERROR(_column_writers[id]->append(converted_result.second->get_nullmap(),
-                                                    converted_result.second->get_data(), num_rows));
     }
     if (_has_key) {
         if (_tablet_schema->keys_type() == UNIQUE_KEYS && _opts.enable_unique_key_merge_on_write) {
@@ -915,9 +925,8 @@ Status SegmentWriter::finalize_columns_data() {
     }
     _num_rows_written = 0;
 
-    for (auto& column_writer : _column_writers) {
-        RETURN_IF_ERROR(column_writer->finish());
-    }
+    RETURN_IF_ERROR(
+            _for_each_column_writer([&](size_t id) { return _column_writers[id]->finish(); }));
     RETURN_IF_ERROR(_write_data());
 
     return Status::OK();
@@ -992,6 +1001,42 @@ void SegmentWriter::clear() {
     _olap_data_convertor.reset();
 }
 
+Status SegmentWriter::_for_each_column_writer(const std::function<Status(size_t)>& func) {
+    const size_t num_columns = _column_writers.size();
+    size_t num_threads = 1;
+    if (_opts.column_writer_pool != nullptr && !_has_inverted_index &&
+        config::segment_writer_min_columns_per_thread > 0) {
+        num_threads = std::min(
+                num_columns / config::segment_writer_min_columns_per_thread,
+                static_cast<size_t>(_opts.column_writer_pool->num_idle_threads()) + 1);
+    }
+    if (num_threads <= 1) {
+        for (size_t id = 0; id < num_columns; ++id) {
+            RETURN_IF_ERROR(func(id));
+        }
+        return Status::OK();
+    }
+
+    // every thread takes one column out of num_threads, which balances the threads better than
+    // ranges of neighbouring columns of similar types
+    std::vector<Status> statuses(num_threads);
+    auto mem_tracker = thread_context()->thread_mem_tracker_mgr->limiter_mem_tracker();
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < num_threads; ++i) {
+        tasks.emplace_back([&, i] {
+            SCOPED_SWITCH_THREAD_MEM_TRACKER_LIMITER(mem_tracker);
+            for (size_t id = i; id < num_columns && statuses[i].ok(); id += num_threads) {
+                statuses[i] = func(id);
+            }
+        });
+    }
+    run_in_parallel(_opts.column_writer_pool, std::move(tasks));
+    for (const auto& st : statuses) {
+        RETURN_IF_ERROR(st);
+    }
+    return Status::OK();
+}
+
 // write column data to file one by one
 Status SegmentWriter::_write_data() {
     for (auto& column_writer : _column_writers) {
@@ -57,6 +57,7 @@ class ShortKeyIndexBuilder;
 class PrimaryKeyIndexBuilder;
 class KeyCoder;
 struct RowsetWriterContext;
+class ThreadPool;
 
 namespace io {
 class FileWriter;
@@ -74,6 +75,8 @@ struct SegmentWriterOptions {
 
     RowsetWriterContext* rowset_ctx = nullptr;
     DataWriteType write_type = DataWriteType::TYPE_DEFAULT;
+    // the idle threads of the pool help encoding and compressing the columns of wide segments
+    ThreadPool* column_writer_pool = nullptr;
 };
 
 using TabletSharedPtr = std::shared_ptr<Tablet>;
@@ -136,6 +139,10 @@ private:
     DISALLOW_COPY_AND_ASSIGN(SegmentWriter);
     Status _create_writers(const TabletSchema& tablet_schema, const std::vector<uint32_t>& col_ids,
                            std::function<Status(uint32_t, const TabletColumn&)> writer_creator);
+    // Call `func` with the index of every column writer, on the idle threads of the column
+    // writer pool too if the segment is wide enough. Return the error of the lowest numbered
+    // thread that failed, each thread stops at its first error.
+    Status _for_each_column_writer(const std::function<Status(size_t)>& func);
     Status _write_data();
     Status _write_ordinal_index();
     Status _write_zone_map();
@@ -191,6 +198,8 @@ private:
 
     std::vector<uint32_t> _column_ids;
     bool _has_key = true;
+    // the writers of inverted indexes are not run concurrently
+    bool _has_inverted_index = false;
     // _num_rows_written means row count already written in this current column group
     uint32_t _num_rows_written = 0;
     // number of rows filtered in strict mode partial update
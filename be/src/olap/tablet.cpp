@@ -2772,7 +2772,7 @@ Status Tablet::lookup_row_key(const Slice& encoded_key, bool with_seq_col,
                               const std::vector<RowsetSharedPtr>& specified_rowsets,
                               RowLocation* row_location, uint32_t version,
                               std::vector<std::unique_ptr<SegmentCacheHandle>>& segment_caches,
-                              RowsetSharedPtr* rowset) {
+                              RowsetSharedPtr* rowset, PrimaryKeyIndexIterators* index_iterators) {
     SCOPED_BVAR_LATENCY(g_tablet_lookup_rowkey_latency);
     size_t seq_col_length = 0;
     if (_schema->has_sequence_col() && with_seq_col) {
@@ -2805,9 +2805,17 @@ Status Tablet::lookup_row_key(const Slice& encoded_key, bool with_seq_col,
         }
         auto& segments = segment_caches[i]->get_segments();
         DCHECK_EQ(segments.size(), num_segments);
+        std::vector<std::unique_ptr<segment_v2::IndexedColumnIterator>>* segment_iterators =
+                nullptr;
+        if (index_iterators != nullptr) {
+            segment_iterators = &(*index_iterators)[i];
+            segment_iterators->resize(num_segments);
+        }
 
         for (auto id : picked_segments) {
-            Status s = segments[id]->lookup_row_key(encoded_key, with_seq_col, &loc);
+            Status s = segments[id]->lookup_row_key(
+                    encoded_key, with_seq_col, &loc,
+                    segment_iterators != nullptr ? &(*segment_iterators)[id] : nullptr);
             if (s.is<KEY_NOT_FOUND>()) {
                 continue;
             }
@@ -2915,6 +2923,9 @@ Status Tablet::calc_segment_delete_bitmap(RowsetSharedPtr rowset,
     // will update the lru cache, and there will be obvious lock competition in multithreading
     // scenarios, so using a segment_caches to cache SegmentCacheHandle.
     std::vector<std::unique_ptr<SegmentCacheHandle>> segment_caches(specified_rowsets.size());
+    // the keys of the segment are looked up in order, so the lookups share the index iterators
+    // of the segments they probe
+    PrimaryKeyIndexIterators index_iterators(specified_rowsets.size());
     while (remaining > 0) {
         std::unique_ptr<segment_v2::IndexedColumnIterator> iter;
         RETURN_IF_ERROR(pk_idx->new_iterator(&iter));
@@ -2951,7 +2962,7 @@ Status Tablet::calc_segment_delete_bitmap(RowsetSharedPtr rowset,
 
             RowsetSharedPtr rowset_find;
             auto st = lookup_row_key(key, true, specified_rowsets, &loc, dummy_version.first - 1,
-                                     segment_caches, &rowset_find);
+                                     segment_caches, &rowset_find, &index_iterators);
             bool expected_st = st.ok() || st.is<KEY_NOT_FOUND>() || st.is<KEY_ALREADY_EXISTS>();
             DCHECK(expected_st) << "unexpected error status while lookup_row_key:" << st;
             if (!expected_st) {
@@ -87,6 +87,11 @@ enum SortType : int;
 
 using TabletSharedPtr = std::shared_ptr<Tablet>;
 
+// The primary key index iterators of the segments of every rowset a batch of keys is looked up
+// in, indexed by the position of the rowset and the id of the segment.
+using PrimaryKeyIndexIterators =
+        std::vector<std::vector<std::unique_ptr<segment_v2::IndexedColumnIterator>>>;
+
 enum TabletStorageType { STORAGE_TYPE_LOCAL, STORAGE_TYPE_REMOTE, STORAGE_TYPE_REMOTE_AND_LOCAL };
 
 extern const std::chrono::seconds TRACE_TABLET_LOCK_THRESHOLD;
@@ -412,11 +417,14 @@ public:
     // Lookup the row location of `encoded_key`, the function sets `row_location` on success.
     // NOTE: the method only works in unique key model with primary key index, you will got a
     //       not supported error in other data model.
+    // A batch of keys sorted in ascending order should share `index_iterators`, the index
+    // pages of every segment are then read once for the whole batch instead of once per key.
     Status lookup_row_key(const Slice& encoded_key, bool with_seq_col,
                           const std::vector<RowsetSharedPtr>& specified_rowsets,
                           RowLocation* row_location, uint32_t version,
                           std::vector<std::unique_ptr<SegmentCacheHandle>>& segment_caches,
-                          RowsetSharedPtr* rowset = nullptr);
+                          RowsetSharedPtr* rowset = nullptr,
+                          PrimaryKeyIndexIterators* index_iterators = nullptr);
 
     // Lookup a row with TupleDescriptor and fill Block
     Status lookup_row_data(const Slice& encoded_key, const RowLocation& row_location,
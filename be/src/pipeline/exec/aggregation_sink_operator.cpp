@@ -572,6 +572,13 @@ void AggSinkLocalState<DependencyType, Derived>::_emplace_into_hash_table(
                 } else {
                     SCOPED_TIMER(_hash_table_emplace_timer);
                     for (size_t i = 0; i < num_rows; ++i) {
+                        if constexpr (HashTableTraits<HashTableType>::is_string_hash_table) {
+                            if (LIKELY(i + HASH_MAP_PREFETCH_DIST < num_rows)) {
+                                state.template prefetch_key<false>(
+                                        agg_method.data, i + HASH_MAP_PREFETCH_DIST,
+                                        *_agg_arena_pool);
+                            }
+                        }
                         vectorized::AggregateDataPtr mapped = nullptr;
                         if constexpr (vectorized::ColumnsHashing::IsSingleNullableColumnMethod<
                                               AggState>::value) {
@@ -623,6 +630,13 @@ void AggSinkLocalState<DependencyType, Derived>::_find_in_hash_table(
                             return state.find_key_with_hash(agg_method.data, _hash_values[i],
                                                             keys[i]);
                         } else {
+                            if constexpr (HashTableTraits<HashTableType>::is_string_hash_table) {
+                                if (LIKELY(i + HASH_MAP_PREFETCH_DIST < num_rows)) {
+                                    state.template prefetch_key<true>(
+                                            agg_method.data, i + HASH_MAP_PREFETCH_DIST,
+                                            *_agg_arena_pool);
+                                }
+                            }
                             return state.find_key(agg_method.data, i, *_agg_arena_pool);
                         }
                     }();
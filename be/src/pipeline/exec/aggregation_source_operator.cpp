@@ -19,6 +19,7 @@
 
 #include <string>
 
+#include "common/config.h"
 #include "pipeline/exec/operator.h"
 #include "pipeline/exec/streaming_aggregation_source_operator.h"
 #include "vec//utils/util.hpp"
@@ -262,9 +263,25 @@ Status AggLocalState::_get_with_serialized_key_result(RuntimeState* state, vecto
                                                       SourceState& source_state) {
     if (_shared_state->spill_context.has_data) {
         return _get_result_with_spilt_data(state, block, source_state);
-    } else {
-        return _get_result_with_serialized_key_non_spill(state, block, source_state);
     }
+    if (config::agg_finalize_parallelism > 1) {
+        if (_finalized_blocks.empty()) {
+            SCOPED_TIMER(_get_results_timer);
+            RETURN_IF_ERROR(vectorized::finalize_aggregate_results_in_parallel(
+                    state, _agg_data, _shared_state->aggregate_data_container.get(),
+                    _parent->cast<AggSourceOperatorX>()._row_descriptor,
+                    _shared_state->aggregate_evaluators, _dependency->offsets_of_aggregate_states(),
+                    _shared_state->probe_key_sz, config::agg_finalize_parallelism,
+                    &_finalized_blocks));
+        }
+        if (!_finalized_blocks.empty()) {
+            block->swap(_finalized_blocks.front());
+            _finalized_blocks.pop_front();
+            return Status::OK();
+        }
+    }
+    // the last batch and the null key
+    return _get_result_with_serialized_key_non_spill(state, block, source_state);
 }
 
 Status AggLocalState::_get_result_with_spilt_data(RuntimeState* state, vectorized::Block* block,
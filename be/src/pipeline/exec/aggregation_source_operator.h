@@ -110,6 +110,8 @@ protected:
     executor _executor;
 
     vectorized::AggregatedDataVariants* _agg_data;
+    // the result blocks finalized ahead by finalize_aggregate_results_in_parallel
+    std::deque<vectorized::Block> _finalized_blocks;
     bool _agg_data_created_without_key = false;
 };
 
@@ -37,12 +37,16 @@ Status AnalyticSinkLocalState::init(RuntimeState* state, LocalSinkStateInfo& inf
     _memory_usage_counter = ADD_LABEL_COUNTER(profile(), "MemoryUsage");
     _blocks_memory_usage = _profile->AddHighWaterMarkCounter("Blocks", TUnit::BYTES, "MemoryUsage");
     _evaluation_timer = ADD_TIMER(profile(), "EvaluationTime");
+    _shared_state->block_spiller.init(state->external_analytic_bytes_threshold(), profile());
+    _shared_state->spill_agg_input = p._spill_agg_input;
 
     size_t agg_size = p._agg_expr_ctxs.size();
     _agg_expr_ctxs.resize(agg_size);
     _shared_state->agg_input_columns.resize(agg_size);
+    _shared_state->agg_input_column_idxs.resize(agg_size);
     for (int i = 0; i < agg_size; ++i) {
         _shared_state->agg_input_columns[i].resize(p._num_agg_input[i]);
+        _shared_state->agg_input_column_idxs[i].resize(p._num_agg_input[i]);
         _agg_expr_ctxs[i].resize(p._agg_expr_ctxs[i].size());
         for (int j = 0; j < p._agg_expr_ctxs[i].size(); ++j) {
             RETURN_IF_ERROR(p._agg_expr_ctxs[i][j]->clone(state, _agg_expr_ctxs[i][j]));
@@ -71,7 +75,11 @@ AnalyticSinkOperatorX::AnalyticSinkOperatorX(ObjectPool* pool, const TPlanNode&
         : DataSinkOperatorX(tnode.node_id),
           _buffered_tuple_id(tnode.analytic_node.__isset.buffered_tuple_id
                                      ? tnode.analytic_node.buffered_tuple_id
-                                     : 0) {}
+                                     : 0),
+          _spill_agg_input(tnode.analytic_node.__isset.window &&
+                           tnode.analytic_node.window.type == TAnalyticWindowType::ROWS &&
+                           tnode.analytic_node.window.__isset.window_start &&
+                           tnode.analytic_node.window.__isset.window_end) {}
 
 Status AnalyticSinkOperatorX::init(const TPlanNode& tnode, RuntimeState* state) {
     RETURN_IF_ERROR(DataSinkOperatorX::init(tnode, state));
@@ -164,15 +172,15 @@ Status AnalyticSinkOperatorX::sink(doris::RuntimeState* state, vectorized::Block
         }
     }
 
-    for (size_t i = 0; i < _agg_functions_size;
-         ++i) { //insert _agg_input_columns, execute calculate for its
+    //record column idx in block
+    for (size_t i = 0; i < _agg_functions_size; ++i) {
         for (size_t j = 0; j < local_state._agg_expr_ctxs[i].size(); ++j) {
-            RETURN_IF_ERROR(_insert_range_column(
-                    input_block, local_state._agg_expr_ctxs[i][j],
-                    local_state._shared_state->agg_input_columns[i][j].get(), block_rows));
+            int result_col_id = -1;
+            RETURN_IF_ERROR(local_state._agg_expr_ctxs[i][j]->execute(input_block, &result_col_id));
+            DCHECK_GE(result_col_id, 0);
+            local_state._shared_state->agg_input_column_idxs[i][j] = result_col_id;
         }
     }
-    //record column idx in block
     for (size_t i = 0; i < local_state._shared_state->partition_by_eq_expr_ctxs.size(); ++i) {
         int result_col_id = -1;
         RETURN_IF_ERROR(local_state._shared_state->partition_by_eq_expr_ctxs[i]->execute(
@@ -191,6 +199,7 @@ Status AnalyticSinkOperatorX::sink(doris::RuntimeState* state, vectorized::Block
 
     local_state.mem_tracker()->consume(input_block->allocated_bytes());
     local_state._blocks_memory_usage->add(input_block->allocated_bytes());
+    local_state._shared_state->buffered_bytes += input_block->allocated_bytes();
 
     //TODO: if need improvement, the is a tips to maintain a free queue,
     //so the memory could reuse, no need to new/delete again;
@@ -200,18 +209,36 @@ Status AnalyticSinkOperatorX::sink(doris::RuntimeState* state, vectorized::Block
         local_state._shared_state->found_partition_end =
                 local_state._dependency->get_partition_by_end();
     }
+    RETURN_IF_ERROR(_spill_input_block_if_needed(
+            local_state, local_state._dependency->whether_need_next_partition(
+                                 local_state._shared_state->found_partition_end)));
     local_state._dependency->refresh_need_more_input();
     return Status::OK();
 }
 
-Status AnalyticSinkOperatorX::_insert_range_column(vectorized::Block* block,
-                                                   const vectorized::VExprContextSPtr& expr,
-                                                   vectorized::IColumn* dst_column, size_t length) {
-    int result_col_id = -1;
-    RETURN_IF_ERROR(expr->execute(block, &result_col_id));
-    DCHECK_GE(result_col_id, 0);
-    auto column = block->get_by_position(result_col_id).column->convert_to_full_column_if_const();
-    dst_column->insert_range_from(*column, 0, length);
+Status AnalyticSinkOperatorX::_spill_input_block_if_needed(AnalyticSinkLocalState& local_state,
+                                                          bool need_more_input) {
+    auto* shared_state = local_state._shared_state;
+    size_t block_idx = shared_state->input_blocks.size() - 1;
+    // only the blocks after the start of the partition whose end is not found yet are spilled,
+    // so all their rows are in this partition.
+    bool spill = need_more_input && block_idx > shared_state->partition_by_end.block_num &&
+                 shared_state->block_spiller.need_spill(shared_state->buffered_bytes);
+    if (shared_state->agg_input_end_block == block_idx &&
+        !(spill && shared_state->spill_agg_input)) {
+        local_state._dependency->append_agg_input(block_idx);
+    }
+    if (!spill) {
+        return Status::OK();
+    }
+    auto& block = shared_state->input_blocks[block_idx];
+    int64_t bytes = block.allocated_bytes();
+    RETURN_IF_ERROR(shared_state->block_spiller.spill(block_idx, &block,
+                                                      shared_state->partition_by_column_idxs));
+    int64_t released_bytes = bytes - block.allocated_bytes();
+    local_state.mem_tracker()->consume(-released_bytes);
+    local_state._blocks_memory_usage->add(-released_bytes);
+    shared_state->buffered_bytes -= released_bytes;
     return Status::OK();
 }
 
@@ -85,8 +85,8 @@ public:
     WriteDependency* wait_for_dependency(RuntimeState* state) override;
 
 private:
-    Status _insert_range_column(vectorized::Block* block, const vectorized::VExprContextSPtr& expr,
-                                vectorized::IColumn* dst_column, size_t length);
+    Status _spill_input_block_if_needed(AnalyticSinkLocalState& local_state,
+                                        bool need_more_input);
 
     friend class AnalyticSinkLocalState;
 
@@ -97,6 +97,8 @@ private:
     size_t _agg_functions_size = 0;
 
     const TTupleId _buffered_tuple_id;
+    // the frame of every row is bounded, e.g. ROWS [1 preceding, 1 following]
+    const bool _spill_agg_input;
 
     std::vector<size_t> _num_agg_input;
 };
@@ -168,8 +168,10 @@ void AnalyticLocalState::_execute_for_win_func(int64_t partition_start, int64_t
         for (int j = 0; j < _shared_state->agg_input_columns[i].size(); ++j) {
             agg_columns.push_back(_shared_state->agg_input_columns[i][j].get());
         }
+        int64_t start_pos = _shared_state->agg_input_start_pos;
         _agg_functions[i]->function()->add_range_single_place(
-                partition_start, partition_end, frame_start, frame_end,
+                partition_start - start_pos, partition_end - start_pos, frame_start - start_pos,
+                frame_end - start_pos,
                 _fn_place_ptr +
                         _parent->cast<AnalyticSourceOperatorX>()._offsets_of_aggregate_states[i],
                 agg_columns.data(), nullptr);
@@ -250,7 +252,7 @@ Status AnalyticLocalState::_get_next_for_range(size_t current_block_rows) {
     while (_shared_state->current_row_position < _shared_state->partition_by_end.pos &&
            _window_end_position < current_block_rows) {
         if (_shared_state->current_row_position >= _order_by_end.pos) {
-            _update_order_by_range();
+            RETURN_IF_ERROR(_update_order_by_range());
             _executor.execute(_order_by_start.pos, _order_by_end.pos, _order_by_start.pos,
                               _order_by_end.pos);
         }
@@ -259,9 +261,34 @@ Status AnalyticLocalState::_get_next_for_range(size_t current_block_rows) {
     return Status::OK();
 }
 
-void AnalyticLocalState::_update_order_by_range() {
+Status AnalyticLocalState::_update_order_by_range() {
     _order_by_start = _order_by_end;
     _order_by_end = _shared_state->partition_by_end;
+    // the peer group is searched in the blocks in memory, so read back the spilled blocks of
+    // the partition one by one as long as the peer group may extend to them.
+    for (size_t block_idx = _shared_state->block_spiller.first_spilled_block();
+         block_idx < _shared_state->input_blocks.size() &&
+         _shared_state->input_block_first_row_positions[block_idx] <
+                 _shared_state->partition_by_end.pos;
+         block_idx = _shared_state->block_spiller.first_spilled_block()) {
+        const auto& start_block = _shared_state->input_blocks[_order_by_start.block_num];
+        const auto& prev_block = _shared_state->input_blocks[block_idx - 1];
+        bool is_peer = true;
+        for (auto idx : _shared_state->ordey_by_column_idxs) {
+            if (vectorized::AnalyticBlockSpiller::compare_at(
+                        start_block.get_by_position(idx).column, _order_by_start.row_num,
+                        prev_block.get_by_position(idx).column, prev_block.rows() - 1) != 0) {
+                is_peer = false;
+                break;
+            }
+        }
+        if (!is_peer) {
+            _order_by_end.block_num = block_idx;
+            _order_by_end.row_num = 0;
+            break;
+        }
+        RETURN_IF_ERROR(_restore_block(block_idx));
+    }
     for (size_t i = 0; i < _shared_state->order_by_eq_expr_ctxs.size(); ++i) {
         _order_by_end = _dependency->compare_row_to_find_end(_shared_state->ordey_by_column_idxs[i],
                                                              _order_by_start, _order_by_end, true);
@@ -277,6 +304,43 @@ void AnalyticLocalState::_update_order_by_range() {
         _order_by_end.block_num++;
         _order_by_end.row_num = 0;
     }
+    return Status::OK();
+}
+
+Status AnalyticLocalState::_restore_block(size_t block_idx) {
+    if (!_shared_state->block_spiller.is_spilled(block_idx)) {
+        return Status::OK();
+    }
+    auto& block = _shared_state->input_blocks[block_idx];
+    int64_t bytes = block.allocated_bytes();
+    RETURN_IF_ERROR(_shared_state->block_spiller.restore(block_idx, &block));
+    mem_tracker()->consume(block.allocated_bytes() - bytes);
+    _blocks_memory_usage->add(block.allocated_bytes() - bytes);
+    _shared_state->buffered_bytes += block.allocated_bytes() - bytes;
+    return Status::OK();
+}
+
+// Read back the output block, and if the agg input of spilled blocks is spilled too, the
+// blocks up to the end of the frame of its last row, then drop the agg input before the frame
+// of the current row.
+Status AnalyticLocalState::_restore_blocks_for_frame() {
+    RETURN_IF_ERROR(_restore_block(_output_block_index));
+    if (!_shared_state->spill_agg_input) {
+        return Status::OK();
+    }
+    int64_t block_end = _shared_state->input_block_first_row_positions[_output_block_index] +
+                        _shared_state->input_blocks[_output_block_index].rows();
+    int64_t frame_end = std::min<int64_t>(_shared_state->partition_by_end.pos,
+                                          block_end + std::max<int64_t>(_rows_end_offset, 0));
+    while (_shared_state->agg_input_end_block < _shared_state->input_blocks.size() &&
+           _shared_state->input_block_first_row_positions[_shared_state->agg_input_end_block] <
+                   frame_end) {
+        RETURN_IF_ERROR(_restore_block(_shared_state->agg_input_end_block));
+        _dependency->append_agg_input(_shared_state->agg_input_end_block);
+    }
+    _dependency->trim_agg_input(std::max(_partition_by_start.pos,
+                                         _shared_state->current_row_position + _rows_start_offset));
+    return Status::OK();
 }
 
 Status AnalyticLocalState::init_result_columns() {
@@ -299,15 +363,19 @@ bool AnalyticLocalState::init_next_partition(vectorized::BlockRowPos found_parti
         _shared_state->partition_by_end = found_partition_end;
         _shared_state->current_row_position = _partition_by_start.pos;
         _reset_agg_status();
+        _dependency->trim_agg_input(_partition_by_start.pos);
         return true;
     }
     return false;
 }
 
 Status AnalyticLocalState::output_current_block(vectorized::Block* block) {
-    block->swap(std::move(_shared_state->input_blocks[_output_block_index]));
-    _blocks_memory_usage->add(-block->allocated_bytes());
-    mem_tracker()->consume(-block->allocated_bytes());
+    RETURN_IF_ERROR(_restore_block(_output_block_index));
+    auto& input_block = _shared_state->input_blocks[_output_block_index];
+    _blocks_memory_usage->add(-input_block.allocated_bytes());
+    mem_tracker()->consume(-input_block.allocated_bytes());
+    _shared_state->buffered_bytes -= input_block.allocated_bytes();
+    block->swap(std::move(input_block));
     if (_shared_state->origin_cols.size() < block->columns()) {
         block->erase_not_in(_shared_state->origin_cols);
     }
@@ -332,6 +400,7 @@ Status AnalyticLocalState::output_current_block(vectorized::Block* block) {
 
 void AnalyticLocalState::release_mem() {
     _agg_arena_pool = nullptr;
+    _shared_state->block_spiller.close();
 
     std::vector<vectorized::Block> tmp_input_blocks;
     _shared_state->input_blocks.swap(tmp_input_blocks);
@@ -413,9 +482,10 @@ Status AnalyticSourceOperatorX::get_block(RuntimeState* state, vectorized::Block
         local_state._next_partition =
                 local_state.init_next_partition(local_state._shared_state->found_partition_end);
         local_state.init_result_columns();
+        RETURN_IF_ERROR(local_state._restore_blocks_for_frame());
         size_t current_block_rows =
                 local_state._shared_state->input_blocks[local_state._output_block_index].rows();
-        local_state._executor.get_next(current_block_rows);
+        RETURN_IF_ERROR(local_state._executor.get_next(current_block_rows));
         if (local_state._window_end_position == current_block_rows) {
             break;
         }
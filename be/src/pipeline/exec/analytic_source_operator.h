@@ -72,7 +72,9 @@ private:
                                int64_t frame_end);
     void _insert_result_info(int64_t current_block_rows);
 
-    void _update_order_by_range();
+    Status _update_order_by_range();
+    Status _restore_block(size_t block_idx);
+    Status _restore_blocks_for_frame();
 
     Status _reset_agg_status();
     Status _create_agg_status();
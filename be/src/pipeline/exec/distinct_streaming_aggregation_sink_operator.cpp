@@ -20,6 +20,7 @@
 #include <gen_cpp/Metrics_types.h>
 
 #include <memory>
+#include <numeric>
 #include <utility>
 
 #include "common/compiler_util.h" // IWYU pragma: keep
@@ -124,8 +125,25 @@ Status DistinctStreamingAggSinkLocalState::_distinct_pre_agg_with_serialized_key
     _distinct_row.clear();
     _distinct_row.reserve(rows);
 
-    RETURN_IF_CATCH_EXCEPTION(
-            _emplace_into_hash_table_to_distinct(_distinct_row, key_columns, rows));
+    // Pass the rows which do not fit in the hash table through once the keys are not
+    // reduced enough, the duplicates are removed by the merge phase.
+    bool pass_through = false;
+    if (_parent->cast<DistinctStreamingAggSinkOperatorX>()._is_streaming_preagg) {
+        pass_through = std::visit(
+                [&](auto&& agg_method) -> bool {
+                    return agg_method.data.add_elem_size_overflow(rows) &&
+                           !_should_expand_preagg_hash_tables(key_columns, rows);
+                },
+                _agg_data->method_variant);
+    }
+    if (pass_through) {
+        _distinct_row.resize(rows);
+        std::iota(_distinct_row.begin(), _distinct_row.end(), 0);
+    } else {
+        RETURN_IF_CATCH_EXCEPTION(
+                _emplace_into_hash_table_to_distinct(_distinct_row, key_columns, rows));
+        _reduction_tracker.add_aggregated_rows(rows);
+    }
 
     bool mem_reuse = _dependency->make_nullable_keys().empty() && out_block->mem_reuse();
     if (mem_reuse) {
@@ -148,6 +166,17 @@ Status DistinctStreamingAggSinkLocalState::_distinct_pre_agg_with_serialized_key
     return Status::OK();
 }
 
+bool DistinctStreamingAggSinkLocalState::_should_expand_preagg_hash_tables(
+        const vectorized::ColumnRawPtrs& key_columns, size_t rows) {
+    return std::visit(
+            [&](auto&& agg_method) -> bool {
+                auto& hash_tbl = agg_method.data;
+                return _reduction_tracker.should_expand(
+                        key_columns, rows, hash_tbl.get_buffer_size_in_bytes(), hash_tbl.size());
+            },
+            _agg_data->method_variant);
+}
+
 void DistinctStreamingAggSinkLocalState::_emplace_into_hash_table_to_distinct(
         vectorized::IColumn::Selector& distinct_row, vectorized::ColumnRawPtrs& key_columns,
         const size_t num_rows) {
@@ -185,6 +214,13 @@ void DistinctStreamingAggSinkLocalState::_emplace_into_hash_table_to_distinct(
                 } else {
                     SCOPED_TIMER(_hash_table_emplace_timer);
                     for (size_t i = 0; i < num_rows; ++i) {
+                        if constexpr (HashTableTraits<HashTableType>::is_string_hash_table) {
+                            if (LIKELY(i + HASH_MAP_PREFETCH_DIST < num_rows)) {
+                                state.template prefetch_key<false>(
+                                        agg_method.data, i + HASH_MAP_PREFETCH_DIST,
+                                        *_agg_arena_pool);
+                            }
+                        }
                         auto result = state.emplace_key(agg_method.data, i, *_agg_arena_pool);
                         if (result.is_inserted()) {
                             result.set_mapped(dummy_mapped_data.get());
@@ -205,6 +241,9 @@ DistinctStreamingAggSinkOperatorX::DistinctStreamingAggSinkOperatorX(ObjectPool*
 Status DistinctStreamingAggSinkOperatorX::init(const TPlanNode& tnode, RuntimeState* state) {
     RETURN_IF_ERROR(AggSinkOperatorX<DistinctStreamingAggSinkLocalState>::init(tnode, state));
     _name = "DISTINCT_STREAMING_AGGREGATION_SINK_OPERATOR";
+    // only a pre-aggregation without limit may pass rows through
+    _is_streaming_preagg = tnode.agg_node.__isset.use_streaming_preaggregation &&
+                           tnode.agg_node.use_streaming_preaggregation && _limit == -1;
     return Status::OK();
 }
 
@@ -99,11 +99,14 @@ private:
     void _emplace_into_hash_table_to_distinct(vectorized::IColumn::Selector& distinct_row,
                                               vectorized::ColumnRawPtrs& key_columns,
                                               const size_t num_rows);
+    bool _should_expand_preagg_hash_tables(const vectorized::ColumnRawPtrs& key_columns,
+                                           size_t rows);
 
     std::unique_ptr<vectorized::Block> _output_block = vectorized::Block::create_unique();
     std::shared_ptr<char> dummy_mapped_data = nullptr;
     vectorized::IColumn::Selector _distinct_row;
     int64_t _output_distinct_rows = 0;
+    vectorized::StreamingAggReductionTracker _reduction_tracker;
 };
 
 class DistinctStreamingAggSinkOperatorX final
@@ -119,6 +122,11 @@ public:
         CREATE_SINK_LOCAL_STATE_RETURN_NULL_IF_ERROR(local_state);
         return local_state._dependency->write_blocked_by();
     }
+
+private:
+    friend class DistinctStreamingAggSinkLocalState;
+
+    bool _is_streaming_preagg = false;
 };
 
 } // namespace pipeline
@@ -37,6 +37,7 @@
 #include "common/status.h"
 #include "pipeline/exec/exchange_sink_operator.h"
 #include "pipeline/pipeline_fragment_context.h"
+#include "pipeline/task_scheduler.h"
 #include "runtime/exec_env.h"
 #include "runtime/thread_context.h"
 #include "service/backend_options.h"
@@ -237,8 +238,10 @@ Status ExchangeSinkBuffer<Parent>::_send_rpc(InstanceLoId id) {
         if (config::exchange_sink_ignore_eovercrowded) {
             closure->cntl.ignore_eovercrowded();
         }
-        closure->addFailedHandler(
-                [&](const InstanceLoId& id, const std::string& err) { _failed(id, err); });
+        closure->addFailedHandler([&](const InstanceLoId& id, const std::string& err) {
+            _failed(id, err);
+            BlockedTaskScheduler::wake_up();
+        });
         closure->start_rpc_time = GetCurrentTimeNanos();
         closure->addSuccessHandler([&](const InstanceLoId& id, const bool& eos,
                                        const PTransmitDataResult& result,
@@ -255,6 +258,7 @@ Status ExchangeSinkBuffer<Parent>::_send_rpc(InstanceLoId id) {
             } else {
                 _send_rpc(id);
             }
+            BlockedTaskScheduler::wake_up();
         });
         {
             SCOPED_SWITCH_THREAD_MEM_TRACKER_LIMITER(ExecEnv::GetInstance()->orphan_mem_tracker());
@@ -293,8 +297,10 @@ Status ExchangeSinkBuffer<Parent>::_send_rpc(InstanceLoId id) {
         if (config::exchange_sink_ignore_eovercrowded) {
             closure->cntl.ignore_eovercrowded();
         }
-        closure->addFailedHandler(
-                [&](const InstanceLoId& id, const std::string& err) { _failed(id, err); });
+        closure->addFailedHandler([&](const InstanceLoId& id, const std::string& err) {
+            _failed(id, err);
+            BlockedTaskScheduler::wake_up();
+        });
         closure->start_rpc_time = GetCurrentTimeNanos();
         closure->addSuccessHandler([&](const InstanceLoId& id, const bool& eos,
                                        const PTransmitDataResult& result,
@@ -311,6 +317,7 @@ Status ExchangeSinkBuffer<Parent>::_send_rpc(InstanceLoId id) {
             } else {
                 _send_rpc(id);
             }
+            BlockedTaskScheduler::wake_up();
         });
         {
             SCOPED_SWITCH_THREAD_MEM_TRACKER_LIMITER(ExecEnv::GetInstance()->orphan_mem_tracker());
@@ -106,6 +106,7 @@ Status ExchangeSinkLocalState::init(RuntimeState* state, LocalSinkStateInfo& inf
     _local_sent_rows = ADD_COUNTER(_profile, "LocalSentRows", TUnit::UNIT);
     _serialize_batch_timer = ADD_TIMER(_profile, "SerializeBatchTime");
     _compress_timer = ADD_TIMER(_profile, "CompressTime");
+    _column_encoding_counters.init(_profile);
     _brpc_send_timer = ADD_TIMER(_profile, "BrpcSendTime");
     _brpc_wait_timer = ADD_TIMER(_profile, "BrpcSendTime.Wait");
     _local_send_timer = ADD_TIMER(_profile, "LocalSendTime");
@@ -167,6 +168,9 @@ Status ExchangeSinkLocalState::init(RuntimeState* state, LocalSinkStateInfo& inf
             RETURN_IF_ERROR(p._partition_expr_ctxs[i]->clone(state, partition_expr_ctxs[i]));
         }
     }
+    if (p._part_type == TPartitionType::HASH_PARTITIONED) {
+        _hot_key_detector.init(channels.size(), _profile);
+    }
     only_local_exchange = local_size == channels.size();
 
     PUniqueId id;
@@ -406,14 +410,13 @@ Status ExchangeSinkOperatorX::sink(RuntimeState* state, vectorized::Block* block
                             .first->update_hashes_with_value(hashes);
                 }
 
-                for (int i = 0; i < rows; i++) {
-                    hashes[i] = hashes[i] % element_size;
-                }
+                local_state._hot_key_detector.assign_channels(hashes, rows);
 
                 {
                     SCOPED_CONSUME_MEM_TRACKER(_mem_tracker.get());
                     vectorized::Block::erase_useless_column(block, column_to_keep);
                 }
+                local_state._hot_key_detector.update_channel_bytes(hashes, rows, block->bytes());
             } else {
                 for (int j = 0; j < result_size; ++j) {
                     // complex type most not implement get_data_at() method which column_const will call
@@ -455,10 +458,12 @@ Status ExchangeSinkOperatorX::serialize_block(ExchangeSinkLocalState& state, vec
         size_t uncompressed_bytes = 0, compressed_bytes = 0;
         RETURN_IF_ERROR(src->serialize(_state->be_exec_version(), dest, &uncompressed_bytes,
                                        &compressed_bytes, _compression_type,
-                                       _transfer_large_data_by_brpc));
+                                       _transfer_large_data_by_brpc,
+                                       config::enable_exchange_column_encoding));
         COUNTER_UPDATE(state.bytes_sent_counter(), compressed_bytes * num_receivers);
         COUNTER_UPDATE(state.uncompressed_bytes_counter(), uncompressed_bytes * num_receivers);
         COUNTER_UPDATE(state.compress_timer(), src->get_compress_time());
+        state._column_encoding_counters.update(*src, num_receivers);
     }
 
     return Status::OK();
@@ -548,6 +553,7 @@ Status ExchangeSinkLocalState::close(RuntimeState* state, Status exec_status) {
     }
     _sink_buffer->update_profile(profile());
     _sink_buffer->close();
+    _hot_key_detector.close();
     return PipelineXSinkLocalState<>::close(state, exec_status);
 }
 
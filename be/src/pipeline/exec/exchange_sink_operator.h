@@ -207,6 +207,8 @@ private:
     int _broadcast_pb_block_idx;
 
     vectorized::BlockSerializer<ExchangeSinkLocalState> _serializer;
+    vectorized::HotKeyDetector _hot_key_detector;
+    vectorized::ColumnEncodingCounters _column_encoding_counters;
 
     std::shared_ptr<ExchangeSinkQueueDependency> _queue_dependency = nullptr;
     std::shared_ptr<AndDependency> _exchange_sink_dependency = nullptr;
@@ -100,6 +100,10 @@ Status OlapScanLocalState::_init_profile() {
 
     _total_pages_num_counter = ADD_COUNTER(_segment_profile, "TotalPagesNum", TUnit::UNIT);
     _cached_pages_num_counter = ADD_COUNTER(_segment_profile, "CachedPagesNum", TUnit::UNIT);
+    _compressed_cached_pages_num_counter =
+            ADD_COUNTER(_segment_profile, "CompressedCachedPagesNum", TUnit::UNIT);
+    _read_ahead_pages_num_counter =
+            ADD_COUNTER(_segment_profile, "ReadAheadPagesNum", TUnit::UNIT);
 
     _bitmap_index_filter_counter =
             ADD_COUNTER(_segment_profile, "RowsBitmapIndexFiltered", TUnit::UNIT);
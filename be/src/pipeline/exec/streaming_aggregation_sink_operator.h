@@ -92,7 +92,8 @@ private:
 
     Status _pre_agg_with_serialized_key(doris::vectorized::Block* in_block,
                                         doris::vectorized::Block* out_block);
-    bool _should_expand_preagg_hash_tables();
+    bool _should_expand_preagg_hash_tables(const vectorized::ColumnRawPtrs& key_columns,
+                                           size_t rows);
 
     vectorized::Block _preagg_block = vectorized::Block();
 
@@ -102,8 +103,7 @@ private:
     RuntimeProfile::Counter* _queue_size_counter;
     RuntimeProfile::Counter* _streaming_agg_timer;
 
-    bool _should_expand_hash_table = true;
-    int64_t _num_rows_returned = 0;
+    vectorized::StreamingAggReductionTracker _reduction_tracker;
 };
 
 class StreamingAggSinkOperatorX final : public AggSinkOperatorX<StreamingAggSinkLocalState> {
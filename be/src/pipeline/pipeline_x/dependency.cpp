@@ -17,6 +17,7 @@
 
 #include "dependency.h"
 
+#include "pipeline/task_scheduler.h"
 #include "runtime/memory/mem_tracker.h"
 
 namespace doris::pipeline {
@@ -33,6 +34,24 @@ template Status HashJoinDependency::extract_join_column<false>(
         std::vector<vectorized::IColumn const*, std::allocator<vectorized::IColumn const*>>&,
         std::vector<int, std::allocator<int>> const&);
 
+void Dependency::set_ready_for_read() {
+    if (_ready_for_read) {
+        return;
+    }
+    _read_dependency_watcher.stop();
+    _ready_for_read = true;
+    BlockedTaskScheduler::wake_up();
+}
+
+void WriteDependency::set_ready_for_write() {
+    if (_ready_for_write) {
+        return;
+    }
+    _write_dependency_watcher.stop();
+    _ready_for_write = true;
+    BlockedTaskScheduler::wake_up();
+}
+
 std::string Dependency::debug_string(int indentation_level) {
     fmt::memory_buffer debug_string_buffer;
     fmt::format_to(debug_string_buffer, "{}{}: id={}, done={}",
@@ -195,7 +214,8 @@ vectorized::BlockRowPos AnalyticDependency::compare_row_to_find_end(int idx,
         start_next_block_column =
                 _analytic_state.input_blocks[mid_blcok_num].get_by_position(idx).column;
         //Compares (*this)[n] and rhs[m], this: start[init_row]  rhs: mid[0]
-        if (start_column->compare_at(start_init_row_num, 0, *start_next_block_column, 1) == 0) {
+        if (vectorized::AnalyticBlockSpiller::compare_at(start_column, start_init_row_num,
+                                                         start_next_block_column, 0) == 0) {
             start_block_num = mid_blcok_num;
         } else {
             end_block_num = mid_blcok_num - 1;
@@ -208,8 +228,9 @@ vectorized::BlockRowPos AnalyticDependency::compare_row_to_find_end(int idx,
         start_next_block_column =
                 _analytic_state.input_blocks[end_block_num].get_by_position(idx).column;
         int64_t block_size = _analytic_state.input_blocks[end_block_num].rows();
-        if ((start_column->compare_at(start_init_row_num, block_size - 1, *start_next_block_column,
-                                      1) == 0)) {
+        if (vectorized::AnalyticBlockSpiller::compare_at(start_column, start_init_row_num,
+                                                         start_next_block_column,
+                                                         block_size - 1) == 0) {
             start.block_num = end_block_num + 1;
             start.row_num = 0;
             return start;
@@ -233,7 +254,8 @@ vectorized::BlockRowPos AnalyticDependency::compare_row_to_find_end(int idx,
     }
     while (start_pos < end_pos) {
         int64_t mid_pos = (start_pos + end_pos) >> 1;
-        if (start_column->compare_at(start_init_row_num, mid_pos, *start_column, 1)) {
+        if (vectorized::AnalyticBlockSpiller::compare_at(start_column, start_init_row_num,
+                                                         start_column, mid_pos)) {
             end_pos = mid_pos;
         } else {
             start_pos = mid_pos + 1;
@@ -243,6 +265,40 @@ vectorized::BlockRowPos AnalyticDependency::compare_row_to_find_end(int idx,
     return start;
 }
 
+void AnalyticDependency::append_agg_input(size_t block_idx) {
+    const auto& block = _analytic_state.input_blocks[block_idx];
+    for (size_t i = 0; i < _analytic_state.agg_input_columns.size(); ++i) {
+        for (size_t j = 0; j < _analytic_state.agg_input_column_idxs[i].size(); ++j) {
+            auto column = block.get_by_position(_analytic_state.agg_input_column_idxs[i][j])
+                                  .column->convert_to_full_column_if_const();
+            _analytic_state.agg_input_columns[i][j]->insert_range_from(*column, 0, block.rows());
+        }
+    }
+    ++_analytic_state.agg_input_end_block;
+}
+
+// Drop the agg input of the rows before pos once they are at least as many as the rows kept,
+// so every row is copied at most once on average.
+void AnalyticDependency::trim_agg_input(int64_t pos) {
+    int64_t end_pos = _analytic_state.agg_input_end_block <
+                                      _analytic_state.input_block_first_row_positions.size()
+                              ? _analytic_state.input_block_first_row_positions
+                                        [_analytic_state.agg_input_end_block]
+                              : _analytic_state.input_total_rows;
+    pos = std::min(pos, end_pos);
+    int64_t dropped_rows = pos - _analytic_state.agg_input_start_pos;
+    int64_t kept_rows = end_pos - pos;
+    if (dropped_rows <= 0 || dropped_rows < kept_rows) {
+        return;
+    }
+    for (auto& columns : _analytic_state.agg_input_columns) {
+        for (auto& column : columns) {
+            column = column->cut(dropped_rows, kept_rows)->assume_mutable();
+        }
+    }
+    _analytic_state.agg_input_start_pos = pos;
+}
+
 bool AnalyticDependency::whether_need_next_partition(vectorized::BlockRowPos& found_partition_end) {
     if (_analytic_state.input_eos ||
         (_analytic_state.current_row_position <
@@ -72,13 +72,7 @@ public:
     }
 
     // Notify downstream pipeline tasks this dependency is ready.
-    virtual void set_ready_for_read() {
-        if (_ready_for_read) {
-            return;
-        }
-        _read_dependency_watcher.stop();
-        _ready_for_read = true;
-    }
+    virtual void set_ready_for_read();
 
     // Notify downstream pipeline tasks this dependency is blocked.
     virtual void block_reading() { _ready_for_read = false; }
@@ -136,13 +130,7 @@ public:
         return _ready_for_write ? nullptr : this;
     }
 
-    virtual void set_ready_for_write() {
-        if (_ready_for_write) {
-            return;
-        }
-        _write_dependency_watcher.stop();
-        _ready_for_write = true;
-    }
+    virtual void set_ready_for_write();
 
     virtual void block_writing() { _ready_for_write = false; }
 
@@ -459,12 +447,23 @@ public:
     int64_t input_total_rows = 0;
     vectorized::BlockRowPos all_block_end;
     std::vector<vectorized::Block> input_blocks;
+    vectorized::AnalyticBlockSpiller block_spiller;
     bool input_eos = false;
     vectorized::BlockRowPos found_partition_end;
     std::vector<int64_t> origin_cols;
     vectorized::VExprContextSPtrs order_by_eq_expr_ctxs;
     std::vector<int64_t> input_block_first_row_positions;
     std::vector<std::vector<vectorized::MutableColumnPtr>> agg_input_columns;
+    std::vector<std::vector<int>> agg_input_column_idxs;
+    // the position of the first row in agg_input_columns, the rows before it are trimmed
+    int64_t agg_input_start_pos = 0;
+    // the rows of the input blocks before it are in agg_input_columns
+    size_t agg_input_end_block = 0;
+    // whether the agg input of spilled blocks is spilled too, true if the frame of every row
+    // is bounded, so only the rows around the output block are needed
+    bool spill_agg_input = false;
+    // the bytes of the input blocks in memory
+    int64_t buffered_bytes = 0;
 
     // TODO: maybe global?
     std::vector<int64_t> partition_by_column_idxs;
@@ -498,6 +497,9 @@ public:
                                                     vectorized::BlockRowPos end,
                                                     bool need_check_first = false);
 
+    void append_agg_input(size_t block_idx);
+    void trim_agg_input(int64_t pos);
+
 private:
     AnalyticSharedState _analytic_state;
 };
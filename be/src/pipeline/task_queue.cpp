@@ -21,8 +21,10 @@
 #include <chrono> // IWYU pragma: keep
 #include <string>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "pipeline/pipeline_task.h"
+#include "util/cpu_info.h"
 
 namespace doris {
 namespace pipeline {
@@ -91,22 +93,33 @@ int PriorityTaskQueue::_compute_level(uint64_t runtime) {
 }
 
 PipelineTask* PriorityTaskQueue::try_take(bool is_steal) {
-    // TODO other efficient lock? e.g. if get lock fail, return null_ptr
+    if (_total_task_size == 0) {
+        return nullptr;
+    }
+    if (is_steal) {
+        // the owner or another thief holds the queue, steal from the next one instead of
+        // waiting for it
+        std::unique_lock<std::mutex> lock(_work_size_mutex, std::try_to_lock);
+        return lock.owns_lock() ? _try_take_unprotected(true) : nullptr;
+    }
     std::unique_lock<std::mutex> lock(_work_size_mutex);
-    return _try_take_unprotected(is_steal);
+    return _try_take_unprotected(false);
 }
 
 PipelineTask* PriorityTaskQueue::take(uint32_t timeout_ms) {
     std::unique_lock<std::mutex> lock(_work_size_mutex);
     auto task = _try_take_unprotected(false);
-    if (task) {
+    // the queue may be closed before the worker waits, close() would not wake it then
+    if (task || _closed) {
         return task;
     } else {
+        ++_num_waiters;
         if (timeout_ms > 0) {
             _wait_task.wait_for(lock, std::chrono::milliseconds(timeout_ms));
         } else {
             _wait_task.wait(lock);
         }
+        --_num_waiters;
         return _try_take_unprotected(false);
     }
 }
@@ -126,7 +139,13 @@ Status PriorityTaskQueue::push(PipelineTask* task) {
 
     _sub_queues[level].push_back(task);
     _total_task_size++;
-    _wait_task.notify_one();
+    // most pushes find the worker busy, avoid the futex call then, and wake the waiter
+    // after releasing the lock so that it does not block on it right away
+    bool has_waiter = _num_waiters > 0;
+    lock.unlock();
+    if (has_waiter) {
+        _wait_task.notify_one();
+    }
     return Status::OK();
 }
 
@@ -139,6 +158,33 @@ MultiCoreTaskQueue::~MultiCoreTaskQueue() = default;
 
 MultiCoreTaskQueue::MultiCoreTaskQueue(size_t core_size) : TaskQueue(core_size), _closed(false) {
     _prio_task_queue_list.reset(new PriorityTaskQueue[core_size]);
+    if (config::enable_pipeline_numa_affinity && CpuInfo::get_max_num_numa_nodes() > 1) {
+        _init_numa_nodes();
+    }
+}
+
+void MultiCoreTaskQueue::_init_numa_nodes() {
+    // spread the workers over the nodes like the cores, worker i goes to the node of core i
+    std::vector<std::vector<size_t>> numa_node_cores(CpuInfo::get_max_num_numa_nodes());
+    _core_numa_node.resize(_core_size);
+    for (size_t i = 0; i < _core_size; ++i) {
+        int node = CpuInfo::get_numa_node_of_core(i % CpuInfo::num_cores());
+        _core_numa_node[i] = node;
+        numa_node_cores[node].push_back(i);
+    }
+    // nodes without cores, e.g. memory only nodes, get no tasks
+    for (auto& cores : numa_node_cores) {
+        if (!cores.empty()) {
+            _numa_node_cores.push_back(std::move(cores));
+        }
+    }
+    if (_numa_node_cores.size() < 2) {
+        _numa_node_cores.clear();
+        _core_numa_node.clear();
+        return;
+    }
+    LOG(INFO) << "bind " << _core_size << " pipeline workers to " << _numa_node_cores.size()
+              << " NUMA nodes";
 }
 
 void MultiCoreTaskQueue::close() {
@@ -174,17 +220,28 @@ PipelineTask* MultiCoreTaskQueue::take(size_t core_id) {
 
 PipelineTask* MultiCoreTaskQueue::_steal_take(size_t core_id) {
     DCHECK(core_id < _core_size);
-    size_t next_id = core_id;
-    for (size_t i = 1; i < _core_size; ++i) {
-        ++next_id;
-        if (next_id == _core_size) {
-            next_id = 0;
+    // with NUMA affinity, steal from the workers of the same node first, and only then from
+    // the other nodes, whose tasks work on memory of their node
+    int node = numa_node(core_id);
+    for (bool same_node : {true, false}) {
+        if (node < 0 && !same_node) {
+            break;
         }
-        DCHECK(next_id < _core_size);
-        auto task = _prio_task_queue_list[next_id].try_take(true);
-        if (task) {
-            task->set_core_id(next_id);
-            return task;
+        size_t next_id = core_id;
+        for (size_t i = 1; i < _core_size; ++i) {
+            ++next_id;
+            if (next_id == _core_size) {
+                next_id = 0;
+            }
+            DCHECK(next_id < _core_size);
+            if (node >= 0 && (_core_numa_node[next_id] == node) != same_node) {
+                continue;
+            }
+            auto task = _prio_task_queue_list[next_id].try_take(true);
+            if (task) {
+                task->set_core_id(next_id);
+                return task;
+            }
         }
     }
     return nullptr;
@@ -193,7 +250,17 @@ PipelineTask* MultiCoreTaskQueue::_steal_take(size_t core_id) {
 Status MultiCoreTaskQueue::push_back(PipelineTask* task) {
     int core_id = task->get_previous_core_id();
     if (core_id < 0) {
-        core_id = _next_core.fetch_add(1) % _core_size;
+        if (_numa_node_cores.empty()) {
+            core_id = _next_core.fetch_add(1) % _core_size;
+        } else {
+            // all the tasks of a fragment instance go to the same node, so the hash tables and
+            // blocks it builds are allocated and used on that node
+            const auto instance_id = task->instance_id();
+            auto node = static_cast<uint64_t>(instance_id.hi ^ instance_id.lo) %
+                        _numa_node_cores.size();
+            const auto& cores = _numa_node_cores[node];
+            core_id = cores[_next_core.fetch_add(1) % cores.size()];
+        }
     }
     return push_back(task, core_id);
 }
@@ -27,6 +27,7 @@
 #include <ostream>
 #include <queue>
 #include <set>
+#include <vector>
 
 #include "common/status.h"
 #include "pipeline_task.h"
@@ -55,6 +56,9 @@ public:
     virtual void update_tg_cpu_share(const taskgroup::TaskGroupInfo& task_group_info,
                                      taskgroup::TGPTEntityPtr entity) = 0;
 
+    // The NUMA node the worker of `core_id` should be bound to, -1 if it may run anywhere.
+    virtual int numa_node(size_t core_id) const { return -1; }
+
     int cores() const { return _core_size; }
 
 protected:
@@ -120,6 +124,10 @@ private:
                                                         60000000000, 300000000000};
     std::mutex _work_size_mutex;
     std::condition_variable _wait_task;
+    // workers blocked in take(), push only signals the condition variable if there are any
+    // protected by lock _work_size_mutex
+    int _num_waiters = 0;
+    // may be read without the lock to skip empty queues
     std::atomic<size_t> _total_task_size = 0;
     bool _closed;
 
@@ -159,10 +167,20 @@ public:
         LOG(FATAL) << "update_tg_cpu_share not implemented";
     }
 
+    int numa_node(size_t core_id) const override {
+        return _numa_node_cores.empty() ? -1 : _core_numa_node[core_id];
+    }
+
 private:
     PipelineTask* _steal_take(size_t core_id);
+    void _init_numa_nodes();
 
     std::unique_ptr<PriorityTaskQueue[]> _prio_task_queue_list;
+    // Only set if enable_pipeline_numa_affinity is true and there are several NUMA nodes.
+    // the NUMA node of each worker
+    std::vector<int> _core_numa_node;
+    // the workers of each NUMA node
+    std::vector<std::vector<size_t>> _numa_node_cores;
     std::atomic<size_t> _next_core = 0;
     std::atomic<bool> _closed;
 };
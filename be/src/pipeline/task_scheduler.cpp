@@ -21,6 +21,7 @@
 #include <gen_cpp/Types_types.h>
 #include <gen_cpp/types.pb.h>
 #include <glog/logging.h>
+#include <pthread.h>
 #include <sched.h>
 
 #include <algorithm>
@@ -31,11 +32,13 @@
 #include <string>
 #include <thread>
 
+#include "common/config.h"
 #include "common/signal_handler.h"
 #include "pipeline/pipeline_task.h"
 #include "pipeline/task_queue.h"
 #include "pipeline_fragment_context.h"
 #include "runtime/query_context.h"
+#include "util/cpu_info.h"
 #include "util/debug_util.h"
 #include "util/sse_util.hpp"
 #include "util/thread.h"
@@ -66,6 +69,8 @@ void BlockedTaskScheduler::shutdown() {
         this->_shutdown = true;
         if (_thread) {
             _task_cond.notify_one();
+            // unconditionally, the idle wait may have been turned off while it sleeps
+            _wake_up_idle_schedulers();
             _thread->join();
         }
     }
@@ -75,12 +80,32 @@ Status BlockedTaskScheduler::add_blocked_task(PipelineTask* task) {
     if (this->_shutdown) {
         return Status::InternalError("BlockedTaskScheduler shutdown");
     }
-    std::unique_lock<std::mutex> lock(_task_mutex);
-    _blocked_tasks.push_back(task);
-    _task_cond.notify_one();
+    {
+        std::unique_lock<std::mutex> lock(_task_mutex);
+        _blocked_tasks.push_back(task);
+        _task_cond.notify_one();
+    }
+    wake_up();
     return Status::OK();
 }
 
+void BlockedTaskScheduler::_wake_up_idle_schedulers() {
+    _s_wake_ups.fetch_add(1);
+    if (_s_idle_schedulers > 0) {
+        std::lock_guard<std::mutex> lock(_s_idle_mutex);
+        _s_idle_cond.notify_all();
+    }
+}
+
+void BlockedTaskScheduler::_wait_for_wake_up(uint64_t wake_ups) {
+    std::unique_lock<std::mutex> lock(_s_idle_mutex);
+    ++_s_idle_schedulers;
+    _s_idle_cond.wait_for(lock,
+                          std::chrono::microseconds(config::blocked_task_scheduler_idle_wait_us),
+                          [&] { return _s_wake_ups != wake_ups || _shutdown; });
+    --_s_idle_schedulers;
+}
+
 void BlockedTaskScheduler::_schedule() {
     _started.store(true);
     std::list<PipelineTask*> local_blocked_tasks;
@@ -104,6 +129,8 @@ void BlockedTaskScheduler::_schedule() {
             }
         }
 
+        // read before checking the tasks, any progress they make from now on changes it
+        uint64_t wake_ups = _s_wake_ups;
         auto origin_local_block_tasks_size = local_blocked_tasks.size();
         auto iter = local_blocked_tasks.begin();
         vectorized::VecDateTimeValue now = vectorized::VecDateTimeValue::local_time();
@@ -159,6 +186,12 @@ void BlockedTaskScheduler::_schedule() {
 
         if (origin_local_block_tasks_size == 0 ||
             local_blocked_tasks.size() == origin_local_block_tasks_size) {
+            if (config::blocked_task_scheduler_idle_wait_us > 0) {
+                // nothing became runnable, sleep until something makes progress instead of
+                // checking the same tasks again right away
+                _wait_for_wake_up(wake_ups);
+                continue;
+            }
             empty_times += 1;
         } else {
             empty_times = 0;
@@ -216,6 +249,10 @@ Status TaskScheduler::schedule_task(PipelineTask* task) {
 }
 
 void TaskScheduler::_do_work(size_t index) {
+    int numa_node = _task_queue->numa_node(index);
+    if (numa_node >= 0) {
+        _bind_to_numa_node(numa_node);
+    }
     const auto& marker = _markers[index];
     while (*marker) {
         auto* task = _task_queue->take(index);
@@ -320,6 +357,19 @@ void TaskScheduler::_do_work(size_t index) {
     }
 }
 
+void TaskScheduler::_bind_to_numa_node(int numa_node) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int core : CpuInfo::get_cores_of_numa_node(numa_node)) {
+        CPU_SET(core, &cpu_set);
+    }
+    int res = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (res != 0) {
+        LOG(WARNING) << "failed to bind pipeline worker to NUMA node " << numa_node
+                     << ", error: " << res;
+    }
+}
+
 void TaskScheduler::_try_close_task(PipelineTask* task, PipelineTaskState state,
                                     Status exec_status) {
     auto status = task->try_close(exec_status);
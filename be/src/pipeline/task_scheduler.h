@@ -27,6 +27,7 @@
 #include <utility>
 #include <vector>
 
+#include "common/config.h"
 #include "common/status.h"
 #include "gutil/ref_counted.h"
 #include "pipeline_task.h"
@@ -54,6 +55,16 @@ public:
     void shutdown();
     Status add_blocked_task(PipelineTask* task);
 
+    // Called when something a blocked task may wait for happened, e.g. a scanner produced a
+    // block or an exchange rpc returned, to wake up the schedulers sleeping in _schedule.
+    // Inline and a no-op while the schedulers keep polling, the default, so that the callers
+    // on the hot paths of scans and exchanges pay nothing for it.
+    static void wake_up() {
+        if (config::blocked_task_scheduler_idle_wait_us > 0) {
+            _wake_up_idle_schedulers();
+        }
+    }
+
 private:
     std::shared_ptr<TaskQueue> _task_queue;
 
@@ -67,8 +78,17 @@ private:
 
     static constexpr auto EMPTY_TIMES_TO_YIELD = 64;
 
+    // incremented by each wake_up, a scheduler only sleeps if it did not change since it
+    // started checking its tasks
+    inline static std::atomic<uint64_t> _s_wake_ups = 0;
+    inline static std::atomic<int> _s_idle_schedulers = 0;
+    inline static std::mutex _s_idle_mutex;
+    inline static std::condition_variable _s_idle_cond;
+
 private:
+    static void _wake_up_idle_schedulers();
     void _schedule();
+    void _wait_for_wake_up(uint64_t wake_ups);
     void _make_task_run(std::list<PipelineTask*>& local_tasks,
                         std::list<PipelineTask*>::iterator& task_itr,
                         PipelineTaskState state = PipelineTaskState::RUNNABLE);
@@ -105,6 +125,8 @@ private:
     CgroupCpuCtl* _cgroup_cpu_ctl = nullptr;
 
     void _do_work(size_t index);
+    // bind the calling worker to the cores of a NUMA node
+    static void _bind_to_numa_node(int numa_node);
     // after _try_close_task, task maybe destructed.
     void _try_close_task(PipelineTask* task, PipelineTaskState state,
                          Status exec_status = Status::OK());
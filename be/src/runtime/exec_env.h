@@ -164,6 +164,8 @@ public:
     }
     ThreadPool* send_report_thread_pool() { return _send_report_thread_pool.get(); }
     ThreadPool* join_node_thread_pool() { return _join_node_thread_pool.get(); }
+    ThreadPool* spill_sort_merge_thread_pool() { return _spill_sort_merge_thread_pool.get(); }
+    ThreadPool* agg_finalize_thread_pool() { return _agg_finalize_thread_pool.get(); }
 
     void set_serial_download_cache_thread_token() {
         _serial_download_cache_thread_token =
@@ -315,6 +317,10 @@ private:
     std::unique_ptr<ThreadPool> _send_report_thread_pool;
     // Pool used by join node to build hash table
     std::unique_ptr<ThreadPool> _join_node_thread_pool;
+    // Pool used by sort node to merge spilled sorted runs
+    std::unique_ptr<ThreadPool> _spill_sort_merge_thread_pool;
+    // Pool used by aggregation node to finalize the result groups
+    std::unique_ptr<ThreadPool> _agg_finalize_thread_pool;
     // ThreadPoolToken -> buffer
     std::unordered_map<ThreadPoolToken*, std::unique_ptr<char[]>> _download_cache_buf_map;
     FragmentMgr* _fragment_mgr = nullptr;
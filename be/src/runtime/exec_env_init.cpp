@@ -187,6 +187,16 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths,
             .set_max_threads(std::numeric_limits<int>::max())
             .set_max_queue_size(config::fragment_pool_queue_size)
             .build(&_join_node_thread_pool);
+
+    ThreadPoolBuilder("SpillSortMergeThreadPool")
+            .set_min_threads(1)
+            .set_max_threads(CpuInfo::num_cores())
+            .build(&_spill_sort_merge_thread_pool);
+
+    ThreadPoolBuilder("AggFinalizeThreadPool")
+            .set_min_threads(1)
+            .set_max_threads(CpuInfo::num_cores())
+            .build(&_agg_finalize_thread_pool);
     init_file_cache_factory();
     RETURN_IF_ERROR(init_pipeline_task_scheduler());
     _task_group_manager = new taskgroup::TaskGroupManager();
@@ -392,11 +402,20 @@ Status ExecEnv::_init_mem_env() {
     while (!is_percent && pk_storage_page_cache_limit > MemInfo::mem_limit() / 2) {
         pk_storage_page_cache_limit = storage_cache_limit / 2;
     }
+    int64_t compressed_page_cache_limit =
+            ParseUtil::parse_mem_spec(config::compressed_page_cache_limit, MemInfo::mem_limit(),
+                                      MemInfo::physical_mem(), &is_percent);
+    while (!is_percent && compressed_page_cache_limit > MemInfo::mem_limit() / 2) {
+        compressed_page_cache_limit = compressed_page_cache_limit / 2;
+    }
     _storage_page_cache = StoragePageCache::create_global_cache(
-            storage_cache_limit, index_percentage, pk_storage_page_cache_limit, num_shards);
+            storage_cache_limit, index_percentage, pk_storage_page_cache_limit, num_shards,
+            compressed_page_cache_limit);
     LOG(INFO) << "Storage page cache memory limit: "
               << PrettyPrinter::print(storage_cache_limit, TUnit::BYTES)
-              << ", origin config value: " << config::storage_page_cache_limit;
+              << ", origin config value: " << config::storage_page_cache_limit
+              << ", compressed page cache memory limit: "
+              << PrettyPrinter::print(compressed_page_cache_limit, TUnit::BYTES);
 
     // Init row cache
     int64_t row_cache_mem_limit =
@@ -550,6 +569,8 @@ void ExecEnv::destroy() {
     SAFE_STOP(_storage_engine);
     SAFE_SHUTDOWN(_buffered_reader_prefetch_thread_pool);
     SAFE_SHUTDOWN(_join_node_thread_pool);
+    SAFE_SHUTDOWN(_spill_sort_merge_thread_pool);
+    SAFE_SHUTDOWN(_agg_finalize_thread_pool);
     SAFE_SHUTDOWN(_send_report_thread_pool);
     SAFE_SHUTDOWN(_send_batch_thread_pool);
     SAFE_SHUTDOWN(_serial_download_cache_thread_token);
@@ -611,6 +632,8 @@ void ExecEnv::destroy() {
     SAFE_DELETE(_file_cache_factory);
     // TODO(zhiqiang): Maybe we should call shutdown before release thread pool?
     _join_node_thread_pool.reset(nullptr);
+    _spill_sort_merge_thread_pool.reset(nullptr);
+    _agg_finalize_thread_pool.reset(nullptr);
     _send_report_thread_pool.reset(nullptr);
     _buffered_reader_prefetch_thread_pool.reset(nullptr);
     _send_batch_thread_pool.reset(nullptr);
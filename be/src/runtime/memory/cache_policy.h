@@ -34,7 +34,8 @@ public:
         SEGMENT_CACHE = 4,
         INVERTEDINDEX_SEARCHER_CACHE = 5,
         INVERTEDINDEX_QUERY_CACHE = 6,
-        LOOKUP_CONNECTION_CACHE = 7
+        LOOKUP_CONNECTION_CACHE = 7,
+        COMPRESSED_PAGE_CACHE = 8
     };
 
     static std::string type_string(CacheType type) {
@@ -55,6 +56,8 @@ public:
             return "InvertedIndexQueryCache";
         case CacheType::LOOKUP_CONNECTION_CACHE:
             return "LookupConnectionCache";
+        case CacheType::COMPRESSED_PAGE_CACHE:
+            return "CompressedPageCache";
         default:
             LOG(FATAL) << "not match type of cache policy :" << static_cast<int>(type);
         }
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include "common/config.h"
+#include "gutil/strings/split.h"
 #include "olap/lru_cache.h"
 #include "runtime/memory/cache_policy.h"
 #include "util/time.h"
@@ -37,13 +39,25 @@ public:
     LRUCachePolicy(CacheType type, uint32_t stale_sweep_time_s)
             : CachePolicy(type, stale_sweep_time_s) {};
     LRUCachePolicy(CacheType type, size_t capacity, LRUCacheType lru_cache_type,
-                   uint32_t stale_sweep_time_s, uint32_t num_shards = -1)
+                   uint32_t stale_sweep_time_s, uint32_t num_shards = -1,
+                   CacheEvictionPolicy eviction_policy = CacheEvictionPolicy::LRU)
             : CachePolicy(type, stale_sweep_time_s) {
-        _cache = num_shards == -1
-                         ? std::unique_ptr<Cache>(
-                                   new_lru_cache(type_string(type), capacity, lru_cache_type))
-                         : std::unique_ptr<Cache>(new_lru_cache(type_string(type), capacity,
-                                                                lru_cache_type, num_shards));
+        _cache = std::unique_ptr<Cache>(new_lru_cache(
+                type_string(type), capacity, lru_cache_type,
+                num_shards == -1 ? DEFAULT_LRU_CACHE_NUM_SHARDS : num_shards, eviction_policy,
+                admission_policy(type)));
+    }
+
+    // TINY_LFU if the cache type is in config::tinylfu_admission_cache_types.
+    static CacheAdmissionPolicy admission_policy(CacheType type) {
+        std::vector<std::string> types = strings::Split(config::tinylfu_admission_cache_types,
+                                                        ",", strings::SkipWhitespace());
+        for (auto& t : types) {
+            if (t == type_string(type)) {
+                return CacheAdmissionPolicy::TINY_LFU;
+            }
+        }
+        return CacheAdmissionPolicy::NONE;
     }
 
     ~LRUCachePolicy() override = default;
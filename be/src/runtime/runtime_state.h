@@ -448,6 +448,18 @@ public:
                        : 0;
     }
 
+    int64_t external_join_bytes_threshold() const {
+        return _query_options.__isset.external_join_bytes_threshold
+                       ? _query_options.external_join_bytes_threshold
+                       : 0;
+    }
+
+    int64_t external_analytic_bytes_threshold() const {
+        return _query_options.__isset.external_analytic_bytes_threshold
+                       ? _query_options.external_analytic_bytes_threshold
+                       : 0;
+    }
+
     inline bool enable_delete_sub_pred_v2() const {
         return _query_options.__isset.enable_delete_sub_predicate_v2 &&
                _query_options.enable_delete_sub_predicate_v2;
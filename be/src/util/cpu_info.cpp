@@ -47,6 +47,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <array>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/trim.hpp>
 // IWYU pragma: no_include <bits/chrono.h>
@@ -362,6 +363,19 @@ void CpuInfo::_get_cache_info(long cache_sizes[NUM_CACHE_LEVELS],
 #endif
 }
 
+long CpuInfo::get_cache_size(CacheLevel level) {
+    static const std::array<long, NUM_CACHE_LEVELS> cache_sizes = [] {
+        std::array<long, NUM_CACHE_LEVELS> sizes;
+        long cache_line_sizes[NUM_CACHE_LEVELS];
+        _get_cache_info(sizes.data(), cache_line_sizes);
+        for (auto& size : sizes) {
+            size = std::max(size, 0L);
+        }
+        return sizes;
+    }();
+    return cache_sizes[level];
+}
+
 std::string CpuInfo::debug_string() {
     DCHECK(initialized_);
     std::stringstream stream;
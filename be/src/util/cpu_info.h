@@ -115,6 +115,10 @@ public:
         return core_to_numa_node_[core];
     }
 
+    /// Returns the size in bytes of the given cache level, or 0 if it could not be
+    /// determined. The sizes are queried once and cached.
+    static long get_cache_size(CacheLevel level);
+
     /// Returns the cores in a NUMA node. 'node' must be in the range
     /// [0, GetMaxNumNumaNodes()).
     static const std::vector<int>& get_cores_of_numa_node(int node) {
@@ -186,6 +186,7 @@ DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(s3_file_writer_total, MetricUnit::FILESYSTE
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(file_created_total, MetricUnit::FILESYSTEM);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(s3_file_created_total, MetricUnit::FILESYSTEM);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(local_bytes_read_total, MetricUnit::FILESYSTEM);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(local_bytes_prefetched_total, MetricUnit::FILESYSTEM);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(s3_bytes_read_total, MetricUnit::FILESYSTEM);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(local_bytes_written_total, MetricUnit::FILESYSTEM);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(s3_bytes_written_total, MetricUnit::FILESYSTEM);
@@ -316,6 +317,7 @@ DorisMetrics::DorisMetrics() : _metric_registry(_s_registry_name) {
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, file_created_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, s3_file_created_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, local_bytes_read_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, local_bytes_prefetched_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, s3_bytes_read_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, local_bytes_written_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, s3_bytes_written_total);
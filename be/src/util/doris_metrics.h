@@ -157,6 +157,7 @@ public:
     IntCounter* file_created_total;
     IntCounter* s3_file_created_total;
     IntCounter* local_bytes_read_total;
+    IntCounter* local_bytes_prefetched_total;
     IntCounter* s3_bytes_read_total;
     IntCounter* local_bytes_written_total;
     IntCounter* s3_bytes_written_total;
@@ -0,0 +1,128 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace doris {
+
+// Approximate access frequency of keys, used by the TinyLFU admission policy of caches.
+//
+// It is a count-min sketch of four 4-bit counters per key packed into 64-bit words. Counters
+// saturate at 15 and all counters are halved once the number of increments reaches ten times
+// the capacity, so the frequency of keys which are not accessed anymore decays over time.
+//
+// Not thread safe, callers are expected to hold the lock of the cache.
+class FrequencySketch {
+public:
+    FrequencySketch() = default;
+
+    // Resize the sketch for about `capacity` distinct keys. The estimated frequencies are kept
+    // when the sketch grows.
+    void ensure_capacity(size_t capacity) {
+        // one word (16 counters) per key keeps the error of the estimation low
+        size_t words = 1;
+        while (words < std::max<size_t>(capacity, MIN_CAPACITY)) {
+            words <<= 1;
+        }
+        size_t old_words = _table.size();
+        if (words <= old_words) {
+            return;
+        }
+        // The counters of a key are at the same offsets of the words `h & _mask`. The sizes are
+        // powers of two, so repeating the old table makes every new index of a key hold the
+        // counters of its old index.
+        _table.resize(words, 0);
+        if (old_words > 0) {
+            for (size_t i = old_words; i < words; ++i) {
+                _table[i] = _table[i & (old_words - 1)];
+            }
+        }
+        _mask = words - 1;
+        _sample_size = words * 10;
+    }
+
+    // Return the estimated access count of the key, in [0, 15].
+    uint32_t frequency(uint64_t hash) const {
+        if (_table.empty()) {
+            return 0;
+        }
+        uint32_t freq = MAX_COUNT;
+        for (int i = 0; i < NUM_HASHES; ++i) {
+            uint64_t h = _index_hash(hash, i);
+            freq = std::min(freq, (uint32_t)((_table[h & _mask] >> _offset(h)) & MAX_COUNT));
+        }
+        return freq;
+    }
+
+    // Record one access of the key.
+    void increment(uint64_t hash) {
+        if (_table.empty()) {
+            return;
+        }
+        bool added = false;
+        for (int i = 0; i < NUM_HASHES; ++i) {
+            uint64_t h = _index_hash(hash, i);
+            uint64_t& word = _table[h & _mask];
+            int offset = _offset(h);
+            if (((word >> offset) & MAX_COUNT) != MAX_COUNT) {
+                word += 1ULL << offset;
+                added = true;
+            }
+        }
+        if (added && ++_additions >= _sample_size) {
+            _reset();
+        }
+    }
+
+private:
+    static constexpr uint32_t MAX_COUNT = 15;
+    static constexpr int NUM_HASHES = 4;
+    static constexpr size_t MIN_CAPACITY = 1024;
+
+    static uint64_t _index_hash(uint64_t hash, int i) {
+        static constexpr uint64_t SEEDS[NUM_HASHES] = {0xc3a5c85c97cb3127ULL,
+                                                       0xb492b66fbe98f273ULL,
+                                                       0x9ae16a3b2f90404fULL,
+                                                       0xcbf29ce484222325ULL};
+        uint64_t h = (hash + SEEDS[i]) * 0x9e3779b97f4a7c15ULL;
+        return h ^ (h >> 32);
+    }
+
+    // the bit offset of the counter in the word, use the high bits which are not used by mask
+    static int _offset(uint64_t h) { return (int)((h >> 60) << 2); }
+
+    // Halve all counters, so the sketch keeps tracking the recent frequency.
+    void _reset() {
+        for (auto& word : _table) {
+            word = (word >> 1) & 0x7777777777777777ULL;
+        }
+        _additions /= 2;
+    }
+
+    std::vector<uint64_t> _table;
+    uint64_t _mask = 0;
+    size_t _sample_size = 0;
+    size_t _additions = 0;
+};
+
+} // namespace doris
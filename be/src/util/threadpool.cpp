@@ -674,4 +674,39 @@ std::ostream& operator<<(std::ostream& o, ThreadPoolToken::State s) {
     return o << ThreadPoolToken::state_to_string(s);
 }
 
+void run_in_parallel(ThreadPool* pool, std::vector<std::function<void()>> tasks) {
+    struct ParallelTasks {
+        std::vector<std::function<void()>> tasks;
+        std::unique_ptr<std::atomic<bool>[]> claimed;
+        std::mutex lock;
+        std::condition_variable finished_cv;
+        size_t finished = 0;
+
+        void run(size_t i) {
+            if (claimed[i].exchange(true)) {
+                return;
+            }
+            tasks[i]();
+            std::lock_guard<std::mutex> l(lock);
+            if (++finished == tasks.size()) {
+                finished_cv.notify_one();
+            }
+        }
+    };
+    auto state = std::make_shared<ParallelTasks>();
+    const size_t num_tasks = tasks.size();
+    state->tasks = std::move(tasks);
+    state->claimed = std::make_unique<std::atomic<bool>[]>(num_tasks);
+    for (size_t i = 1; i < num_tasks; ++i) {
+        if (!pool->submit_func([state, i] { state->run(i); }).ok()) {
+            break;
+        }
+    }
+    for (size_t i = 0; i < num_tasks; ++i) {
+        state->run(i);
+    }
+    std::unique_lock<std::mutex> l(state->lock);
+    state->finished_cv.wait(l, [&] { return state->finished == num_tasks; });
+}
+
 } // namespace doris
@@ -27,6 +27,8 @@
 #include <boost/intrusive/list.hpp>
 #include <boost/intrusive/list_hook.hpp>
 // IWYU pragma: no_include <bits/chrono.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono> // IWYU pragma: keep
 #include <condition_variable>
 #include <deque>
@@ -36,6 +38,7 @@
 #include <mutex>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "agent/cgroup_cpu_ctl.h"
 #include "common/status.h"
@@ -256,6 +259,12 @@ public:
         return _total_queued_tasks;
     }
 
+    // Return the number of threads which could start running a task right away.
+    int num_idle_threads() const {
+        std::lock_guard<std::mutex> l(_lock);
+        return std::max(_max_threads - _active_threads - _total_queued_tasks, 0);
+    }
+
 private:
     friend class ThreadPoolBuilder;
     friend class ThreadPoolToken;
@@ -514,4 +523,9 @@ private:
     void operator=(const ThreadPoolToken&) = delete;
 };
 
+// Run `tasks` on the threads of `pool` and wait for all of them. The calling thread runs the
+// tasks no thread of the pool has started yet, so it never waits for the tasks queued behind
+// other work of the pool, and may be a thread of `pool` itself.
+void run_in_parallel(ThreadPool* pool, std::vector<std::function<void()>> tasks);
+
 } // namespace doris
@@ -180,6 +180,13 @@ public:
         data.template prefetch_by_hash<READ>(hash_value);
     }
 
+    // Prefetch the bucket of the key of `row` in a StringHashTable, see StringHashTable::prefetch.
+    template <bool READ, typename Data>
+    ALWAYS_INLINE void prefetch_key(Data& data, size_t row, Arena& pool) {
+        auto key_holder = static_cast<Derived&>(*this).get_key_holder(row, pool);
+        data.template prefetch<READ>(key_holder_get_key(key_holder));
+    }
+
     ALWAYS_INLINE auto get_key_holder(size_t row, Arena& pool) {
         return static_cast<Derived&>(*this).get_key_holder(row, pool);
     }
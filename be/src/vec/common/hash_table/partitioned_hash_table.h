@@ -535,6 +535,34 @@ public:
         return !_is_partitioned && level0_sub_table.add_elem_size_overflow(row);
     }
 
+    bool is_partitioned() const { return _is_partitioned; }
+
+    /** Radix partition a batch of rows by the sub table their hash values fall into.
+      * `rows` is filled with the row indexes clustered by sub table, rows with `skip[row]` set
+      * are left out. Inserting or looking up the rows in this order works on one sub table at
+      * a time, so the sub table stays in cache instead of every row touching a random one.
+      */
+    void radix_partition(const size_t* hash_values, size_t num_rows, const uint8_t* skip,
+                         std::vector<uint32_t>& rows) const {
+        size_t offsets[NUM_LEVEL1_SUB_TABLES + 1] = {};
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (skip != nullptr && skip[i]) {
+                continue;
+            }
+            ++offsets[get_sub_table_from_hash(hash_values[i]) + 1];
+        }
+        for (size_t i = 1; i <= NUM_LEVEL1_SUB_TABLES; ++i) {
+            offsets[i] += offsets[i - 1];
+        }
+        rows.resize(offsets[NUM_LEVEL1_SUB_TABLES]);
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (skip != nullptr && skip[i]) {
+                continue;
+            }
+            rows[offsets[get_sub_table_from_hash(hash_values[i])]++] = i;
+        }
+    }
+
 private:
     void convert_to_partitioned() {
         SCOPED_RAW_TIMER(&_convert_timer_ns);
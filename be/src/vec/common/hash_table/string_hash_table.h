@@ -123,6 +123,10 @@ public:
     using LookupResult = Cell*;
     using ConstLookupResult = const Cell*;
 
+    // the only cell is always in the cache
+    template <bool READ>
+    void ALWAYS_INLINE prefetch_by_hash(size_t) {}
+
     template <typename KeyHolder>
     void ALWAYS_INLINE emplace(KeyHolder&& key_holder, LookupResult& it, bool& inserted,
                                size_t = 0) {
@@ -630,6 +634,22 @@ public:
         return dispatch(*this, x, FindCallable {}) != nullptr;
     }
 
+    template <bool READ>
+    struct PrefetchCallable {
+        template <typename Submap, typename SubmapKey>
+        void ALWAYS_INLINE operator()(Submap& map, const SubmapKey&, size_t hash) {
+            map.template prefetch_by_hash<READ>(hash);
+        }
+    };
+
+    // The sub table, and so the hash, depends on the length of the key, so unlike the other
+    // tables the keys of a block cannot be hashed ahead, the caller prefetches by key instead,
+    // some rows ahead of the one it looks up.
+    template <bool READ>
+    void ALWAYS_INLINE prefetch(const Key& x) {
+        dispatch(*this, x, PrefetchCallable<READ> {});
+    }
+
     size_t size() const { return m0.size() + m1.size() + m2.size() + m3.size() + ms.size(); }
 
     bool empty() const {
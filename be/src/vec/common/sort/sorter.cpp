@@ -26,10 +26,15 @@
 #include <string>
 #include <utility>
 
+#include "common/config.h"
+#include "common/exception.h"
 #include "common/object_pool.h"
 #include "runtime/block_spill_manager.h"
 #include "runtime/exec_env.h"
 #include "runtime/thread_context.h"
+#include "util/countdown_latch.h"
+#include "util/defer_op.h"
+#include "util/threadpool.h"
 #include "vec/columns/column.h"
 #include "vec/columns/column_nullable.h"
 #include "vec/core/block.h"
@@ -202,30 +207,116 @@ int MergeSorterState::_calc_spill_blocks_to_merge() const {
 
 // merge all the intermediate spilled blocks
 Status MergeSorterState::_merge_spilled_blocks(const SortDescription& sort_description) {
-    int num_of_blocks_to_merge = _calc_spill_blocks_to_merge();
-    while (true) {
-        // pick some spilled blocks to merge, and spill the merged result
-        // to disk, until all splled blocks can be merged in a run.
-        RETURN_IF_ERROR(_create_intermediate_merger(num_of_blocks_to_merge, sort_description));
-        if (spilled_sorted_block_streams_.empty()) {
-            break;
+    size_t num_of_blocks_to_merge = _calc_spill_blocks_to_merge();
+    size_t parallelism = std::max(1, config::spill_sort_merge_parallelism);
+    // pick some spilled blocks to merge, and spill the merged result to disk, until all
+    // spilled blocks can be merged in a run. The merges of disjoint groups of blocks are
+    // independent, so up to `parallelism` groups are merged concurrently in each round.
+    while (spilled_sorted_block_streams_.size() > num_of_blocks_to_merge) {
+        // only merge as many blocks as needed to fit the final merge
+        size_t excess = spilled_sorted_block_streams_.size() - num_of_blocks_to_merge;
+        // a stream is taken by its reader as soon as it leaves spilled_sorted_block_streams_,
+        // the reader deletes it when destroyed, also if the merge fails.
+        std::vector<std::vector<BlockSpillReaderUPtr>> groups;
+        while (excess > 0 && groups.size() < parallelism) {
+            size_t group_size = std::min(
+                    {num_of_blocks_to_merge, excess + 1, spilled_sorted_block_streams_.size()});
+            if (group_size < 2) {
+                break;
+            }
+            auto& group = groups.emplace_back();
+            for (size_t i = 0; i < group_size; ++i) {
+                BlockSpillReaderUPtr spilled_block_reader;
+                RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_reader(
+                        spilled_sorted_block_streams_.front(), spilled_block_reader,
+                        block_spill_profile_));
+                spilled_sorted_block_streams_.pop_front();
+                group.emplace_back(std::move(spilled_block_reader));
+            }
+            excess -= group_size - 1;
         }
 
-        bool eos = false;
-
-        BlockSpillWriterUPtr spill_block_writer;
-        RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_writer(
-                spill_block_batch_size_, spill_block_writer, block_spill_profile_));
+        std::vector<int64_t> merged_streams(groups.size(), -1);
+        std::vector<Status> statuses(groups.size());
+        auto merge_group = [&](size_t i) {
+            statuses[i] = [&]() -> Status {
+                RETURN_IF_ERROR_OR_CATCH_EXCEPTION(
+                        _merge_spilled_group(groups[i], sort_description, &merged_streams[i]));
+                return Status::OK();
+            }();
+        };
+        // the first group is merged by the current thread, which is already attached to the
+        // query, the others by the threads of the pool.
+        auto* thread_pool = ExecEnv::GetInstance()->spill_sort_merge_thread_pool();
+        CountDownLatch latch(groups.size() - 1);
+        for (size_t i = 1; i < groups.size(); ++i) {
+            Status st = Status::InternalError("no thread pool to merge spilled blocks");
+            if (thread_pool != nullptr) {
+                st = thread_pool->submit_func([&, i] {
+                    Defer defer {[&]() { latch.count_down(); }};
+                    SCOPED_ATTACH_TASK(state_);
+                    merge_group(i);
+                });
+            }
+            if (!st.ok()) {
+                merge_group(i);
+                latch.count_down();
+            }
+        }
+        merge_group(0);
+        latch.wait();
+        // the input streams are deleted by now, whatever the result of their merge
+        groups.clear();
 
-        while (!eos) {
-            merge_sorted_block_.clear_column_data();
-            RETURN_IF_ERROR(merger_->get_next(&merge_sorted_block_, &eos));
-            RETURN_IF_ERROR(spill_block_writer->write(merge_sorted_block_));
+        for (size_t i = 0; i < merged_streams.size(); ++i) {
+            if (merged_streams[i] < 0) {
+                continue;
+            }
+            if (statuses[i].ok()) {
+                spilled_sorted_block_streams_.emplace_back(merged_streams[i]);
+            } else {
+                // drop the partially merged stream
+                BlockSpillReaderUPtr reader;
+                static_cast<void>(ExecEnv::GetInstance()->block_spill_mgr()->get_reader(
+                        merged_streams[i], reader, block_spill_profile_));
+            }
+        }
+        for (const auto& st : statuses) {
+            RETURN_IF_ERROR(st);
         }
-        spilled_sorted_block_streams_.emplace_back(spill_block_writer->get_id());
-        RETURN_IF_ERROR(spill_block_writer->close());
     }
-    return Status::OK();
+    return _create_intermediate_merger(num_of_blocks_to_merge, sort_description);
+}
+
+Status MergeSorterState::_merge_spilled_group(std::vector<BlockSpillReaderUPtr>& readers,
+                                              const SortDescription& sort_description,
+                                              int64_t* merged_stream_id) {
+    std::vector<BlockSupplier> child_block_suppliers;
+    for (auto& spilled_block_reader : readers) {
+        child_block_suppliers.emplace_back(std::bind(std::mem_fn(&BlockSpillReader::read),
+                                                     spilled_block_reader.get(),
+                                                     std::placeholders::_1, std::placeholders::_2));
+    }
+
+    // the offset is applied by the final merge only, so the intermediate merge keeps
+    // limit + offset rows.
+    int64_t limit = limit_ < 0 ? limit_ : limit_ + offset_;
+    VSortedRunMerger merger(sort_description, spill_block_batch_size_, limit, 0, profile_);
+    RETURN_IF_ERROR(merger.prepare(child_block_suppliers));
+
+    BlockSpillWriterUPtr spill_block_writer;
+    RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_writer(
+            spill_block_batch_size_, spill_block_writer, block_spill_profile_));
+    *merged_stream_id = spill_block_writer->get_id();
+
+    Block merged_block = merge_sorted_block_.clone_empty();
+    bool eos = false;
+    while (!eos) {
+        merged_block.clear_column_data();
+        RETURN_IF_ERROR(merger.get_next(&merged_block, &eos));
+        RETURN_IF_ERROR(spill_block_writer->write(merged_block));
+    }
+    return spill_block_writer->close();
 }
 
 Status MergeSorterState::_create_intermediate_merger(int num_blocks,
@@ -58,6 +58,7 @@ public:
                       VectorizedUtils::create_empty_block(row_desc, true /*ignore invalid slot*/))),
               offset_(offset),
               limit_(limit),
+              state_(state),
               profile_(profile) {
         external_sort_bytes_threshold_ = state->external_sort_bytes_threshold();
         if (profile != nullptr) {
@@ -107,6 +108,11 @@ private:
 
     Status _create_intermediate_merger(int num_blocks, const SortDescription& sort_description);
 
+    // Merge the spilled blocks of `readers` and spill the merged result to a new stream.
+    Status _merge_spilled_group(std::vector<BlockSpillReaderUPtr>& readers,
+                                const SortDescription& sort_description,
+                                int64_t* merged_stream_id);
+
     std::priority_queue<MergeSortCursor> priority_queue_;
     std::vector<MergeSortCursorImpl> cursors_;
     std::vector<Block> sorted_blocks_;
@@ -126,6 +132,7 @@ private:
     Block merge_sorted_block_;
     std::unique_ptr<VSortedRunMerger> merger_;
 
+    RuntimeState* state_;
     RuntimeProfile* profile_;
     RuntimeProfile* block_spill_profile_;
     RuntimeProfile::Counter* spilled_block_count_;
@@ -51,6 +51,7 @@
 #include "vec/columns/column_vector.h"
 #include "vec/columns/columns_number.h"
 #include "vec/common/assert_cast.h"
+#include "vec/core/column_encoding.h"
 #include "vec/data_types/data_type_factory.hpp"
 
 class SipHash;
@@ -121,10 +122,16 @@ Status Block::deserialize(const PBlock& pblock) {
         buf = pblock.column_values().data();
     }
 
-    for (const auto& pcol_meta : pblock.column_metas()) {
+    for (int i = 0; i < pblock.column_metas_size(); ++i) {
+        const auto& pcol_meta = pblock.column_metas(i);
         DataTypePtr type = DataTypeFactory::instance().create_data_type(pcol_meta);
         MutableColumnPtr data_column = type->create_column();
-        buf = type->deserialize(buf, data_column.get(), pblock.be_exec_version());
+        if (i < pblock.column_encodings_size() &&
+            pblock.column_encodings(i) != COLUMN_ENCODING_PLAIN) {
+            RETURN_IF_ERROR(decode_column(pblock.column_encodings(i), &buf, data_column.get()));
+        } else {
+            buf = type->deserialize(buf, data_column.get(), pblock.be_exec_version());
+        }
         data.emplace_back(data_column->get_ptr(), type, pcol_meta.name());
     }
     initialize_index_by_name();
@@ -819,18 +826,23 @@ Status Block::filter_block(Block* block, int filter_column_id, int column_to_kee
 Status Block::serialize(int be_exec_version, PBlock* pblock,
                         /*std::string* compressed_buffer,*/ size_t* uncompressed_bytes,
                         size_t* compressed_bytes, segment_v2::CompressionTypePB compression_type,
-                        bool allow_transfer_large_data) const {
+                        bool allow_transfer_large_data, bool encode_columns) const {
     pblock->set_be_exec_version(be_exec_version);
 
     // calc uncompressed size for allocation
     size_t content_uncompressed_size = 0;
+    _column_encoding_stats.clear();
     for (const auto& c : *this) {
         PColumnMeta* pcm = pblock->add_column_metas();
         c.to_pb_column_meta(pcm);
         DCHECK(pcm->type() != PGenericType::UNKNOWN) << " forget to set pb type";
         // get serialized size
-        content_uncompressed_size +=
+        size_t column_size =
                 c.type->get_uncompressed_serialized_bytes(*(c.column), pblock->be_exec_version());
+        content_uncompressed_size += column_size;
+        if (encode_columns) {
+            _column_encoding_stats.push_back({column_size, column_size, 0});
+        }
     }
 
     // serialize data values
@@ -846,8 +858,34 @@ Status Block::serialize(int be_exec_version, PBlock* pblock,
     }
     char* buf = column_values.data();
 
-    for (const auto& c : *this) {
-        buf = c.type->serialize(*(c.column), buf, pblock->be_exec_version());
+    if (encode_columns) {
+        faststring encoded;
+        for (size_t i = 0; i < data.size(); ++i) {
+            const auto& c = data[i];
+            auto& stats = _column_encoding_stats[i];
+            PColumnEncoding encoding;
+            {
+                SCOPED_RAW_TIMER(&stats.encode_time_ns);
+                encoded.clear();
+                encoding = encode_column(*(c.column), &encoded);
+            }
+            // the encoded column is written in place of the plain one, it must not be larger
+            if (encoding != COLUMN_ENCODING_PLAIN && encoded.size() < stats.plain_bytes) {
+                memcpy(buf, encoded.data(), encoded.size());
+                buf += encoded.size();
+                stats.encoded_bytes = encoded.size();
+            } else {
+                encoding = COLUMN_ENCODING_PLAIN;
+                buf = c.type->serialize(*(c.column), buf, pblock->be_exec_version());
+            }
+            pblock->add_column_encodings(encoding);
+        }
+        content_uncompressed_size = buf - column_values.data();
+        column_values.resize(content_uncompressed_size);
+    } else {
+        for (const auto& c : *this) {
+            buf = c.type->serialize(*(c.column), buf, pblock->be_exec_version());
+        }
     }
     *uncompressed_bytes = content_uncompressed_size;
 
@@ -67,6 +67,15 @@ namespace vectorized {
   */
 class MutableBlock;
 
+// Sizes of one column of a block serialized with its columns encoded.
+struct ColumnEncodingStats {
+    // the size serialized by the data type
+    size_t plain_bytes = 0;
+    // the size actually serialized, equal to plain_bytes if the column is not encoded
+    size_t encoded_bytes = 0;
+    int64_t encode_time_ns = 0;
+};
+
 class Block {
     ENABLE_FACTORY_CREATOR(Block);
 
@@ -81,6 +90,7 @@ private:
     int64_t _decompressed_bytes = 0;
 
     mutable int64_t _compress_time_ns = 0;
+    mutable std::vector<ColumnEncodingStats> _column_encoding_stats;
 
 public:
     Block() = default;
@@ -309,9 +319,11 @@ public:
     }
 
     // serialize block to PBlock
+    // if encode_columns is true, the columns which are worth it are encoded by encode_column
+    // before the block is compressed, the receivers must support PBlock::column_encodings.
     Status serialize(int be_exec_version, PBlock* pblock, size_t* uncompressed_bytes,
                      size_t* compressed_bytes, segment_v2::CompressionTypePB compression_type,
-                     bool allow_transfer_large_data = false) const;
+                     bool allow_transfer_large_data = false, bool encode_columns = false) const;
 
     Status deserialize(const PBlock& pblock);
 
@@ -384,6 +396,10 @@ public:
     int64_t get_decompress_time() const { return _decompress_time_ns; }
     int64_t get_decompressed_bytes() const { return _decompressed_bytes; }
     int64_t get_compress_time() const { return _compress_time_ns; }
+    // the columns of the last serialize with encode_columns
+    const std::vector<ColumnEncodingStats>& get_column_encoding_stats() const {
+        return _column_encoding_stats;
+    }
 
     void set_same_bit(std::vector<bool>::const_iterator begin,
                       std::vector<bool>::const_iterator end) {
@@ -0,0 +1,306 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/core/column_encoding.h"
+
+#include <fmt/format.h>
+#include <gen_cpp/Metrics_types.h>
+#include <parallel_hashmap/phmap.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "util/coding.h"
+#include "util/faststring.h"
+#include "util/frame_of_reference_coding.h"
+#include "util/rle_encoding.h"
+#include "util/slice.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/string_ref.h"
+#include "vec/common/typeid_cast.h"
+#include "vec/core/block.h"
+
+namespace doris::vectorized {
+
+// the statistics are not worth collecting for smaller columns
+static constexpr size_t MIN_ENCODE_ROWS = 64;
+// rows whose distinct strings are counted before building the whole dictionary
+static constexpr size_t DICT_SAMPLE_ROWS = 1024;
+
+static void put_section(faststring* dst, const faststring& section) {
+    put_fixed32_le(dst, section.size());
+    dst->append(section.data(), section.size());
+}
+
+static Slice get_section(const char** buf) {
+    uint32_t len = decode_fixed32_le(reinterpret_cast<const uint8_t*>(*buf));
+    Slice section(*buf + sizeof(uint32_t), len);
+    *buf += sizeof(uint32_t) + len;
+    return section;
+}
+
+template <typename T>
+static bool encode_integer_column(const ColumnVector<T>& column, faststring* dst) {
+    using Unsigned = std::make_unsigned_t<T>;
+    const auto& data = column.get_data();
+    auto [min, max] = std::minmax_element(data.begin(), data.end());
+    // bit packing values spread over most of the type width saves too little
+    auto range = static_cast<Unsigned>(static_cast<Unsigned>(*max) - static_cast<Unsigned>(*min));
+    if (static_cast<size_t>(std::bit_width(range)) * 4 > sizeof(T) * 8 * 3) {
+        return false;
+    }
+
+    faststring values;
+    ForEncoder<T> encoder(&values);
+    encoder.put_batch(data.data(), data.size());
+    encoder.flush();
+    put_section(dst, values);
+    return true;
+}
+
+template <typename T>
+static Status decode_integer_column(const char** buf, size_t rows, ColumnVector<T>* column) {
+    Slice values = get_section(buf);
+    ForDecoder<T> decoder(reinterpret_cast<const uint8_t*>(values.data), values.size);
+    if (!decoder.init() || decoder.count() != rows) {
+        return Status::Corruption("invalid frame of reference encoded column of {} rows", rows);
+    }
+    auto& data = column->get_data();
+    data.resize(rows);
+    if (!decoder.get_batch(data.data(), rows)) {
+        return Status::Corruption("invalid frame of reference encoded column of {} rows", rows);
+    }
+    return Status::OK();
+}
+
+// The integer types whose columns are frame of reference encoded.
+template <typename T, typename... Ts>
+static bool encode_integers(const IColumn& column, faststring* dst) {
+    if (const auto* integers = check_and_get_column<ColumnVector<T>>(column)) {
+        return encode_integer_column(*integers, dst);
+    }
+    if constexpr (sizeof...(Ts) > 0) {
+        return encode_integers<Ts...>(column, dst);
+    }
+    return false;
+}
+
+template <typename T, typename... Ts>
+static Status decode_integers(const char** buf, size_t rows, IColumn* column) {
+    if (auto* integers = typeid_cast<ColumnVector<T>*>(column)) {
+        return decode_integer_column(buf, rows, integers);
+    }
+    if constexpr (sizeof...(Ts) > 0) {
+        return decode_integers<Ts...>(buf, rows, column);
+    }
+    return Status::Corruption("frame of reference encoding of unsupported column {}",
+                              column->get_name());
+}
+
+static bool encode_string_column(const ColumnString& column, faststring* dst) {
+    const size_t rows = column.size();
+    phmap::flat_hash_map<StringRef, uint32_t, StringRefHash> dict;
+    const size_t sample_rows = std::min(rows, DICT_SAMPLE_ROWS);
+    for (size_t i = 0; i < sample_rows; ++i) {
+        dict.emplace(column.get_data_at(i), 0);
+    }
+    if (dict.size() * 4 > sample_rows) {
+        return false;
+    }
+
+    dict.clear();
+    std::vector<StringRef> entries;
+    std::vector<uint32_t> codes(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        auto [it, inserted] = dict.try_emplace(column.get_data_at(i), entries.size());
+        if (inserted) {
+            // the sample missed most of the distinct strings
+            if (entries.size() >= rows / 2) {
+                return false;
+            }
+            entries.push_back(it->first);
+        }
+        codes[i] = it->second;
+    }
+
+    put_fixed32_le(dst, entries.size());
+    for (const auto& entry : entries) {
+        put_fixed32_le(dst, entry.size);
+        dst->append(entry.data, entry.size);
+    }
+    faststring encoded_codes;
+    ForEncoder<uint32_t> encoder(&encoded_codes);
+    encoder.put_batch(codes.data(), rows);
+    encoder.flush();
+    put_section(dst, encoded_codes);
+    return true;
+}
+
+static Status decode_string_column(const char** buf, size_t rows, ColumnString* column) {
+    uint32_t dict_size = decode_fixed32_le(reinterpret_cast<const uint8_t*>(*buf));
+    *buf += sizeof(uint32_t);
+    std::vector<StringRef> entries(dict_size);
+    for (auto& entry : entries) {
+        entry.size = decode_fixed32_le(reinterpret_cast<const uint8_t*>(*buf));
+        entry.data = *buf + sizeof(uint32_t);
+        *buf += sizeof(uint32_t) + entry.size;
+    }
+
+    Slice encoded_codes = get_section(buf);
+    ForDecoder<uint32_t> decoder(reinterpret_cast<const uint8_t*>(encoded_codes.data),
+                                 encoded_codes.size);
+    std::vector<uint32_t> codes(rows);
+    if (!decoder.init() || decoder.count() != rows || !decoder.get_batch(codes.data(), rows)) {
+        return Status::Corruption("invalid dictionary encoded column of {} rows", rows);
+    }
+    size_t chars_size = 0;
+    for (auto code : codes) {
+        if (code >= dict_size) {
+            return Status::Corruption("dictionary code {} out of {} entries", code, dict_size);
+        }
+        chars_size += entries[code].size;
+    }
+
+    auto& chars = column->get_chars();
+    auto& offsets = column->get_offsets();
+    chars.resize(chars_size);
+    offsets.resize(rows);
+    size_t offset = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        const auto& entry = entries[codes[i]];
+        memcpy(chars.data() + offset, entry.data, entry.size);
+        offset += entry.size;
+        offsets[i] = offset;
+    }
+    return Status::OK();
+}
+
+// Append the values of a column which is not nullable, return the encoding used.
+static PColumnEncoding encode_values(const IColumn& column, faststring* dst) {
+    if (const auto* strings = check_and_get_column<ColumnString>(column)) {
+        return encode_string_column(*strings, dst) ? COLUMN_ENCODING_DICTIONARY
+                                                   : COLUMN_ENCODING_PLAIN;
+    }
+    return encode_integers<Int8, Int16, Int32, Int64, UInt8, UInt16, UInt32, UInt64>(column, dst)
+                   ? COLUMN_ENCODING_FOR_BITPACK
+                   : COLUMN_ENCODING_PLAIN;
+}
+
+static Status decode_values(PColumnEncoding encoding, const char** buf, size_t rows,
+                            IColumn* column) {
+    switch (encoding) {
+    case COLUMN_ENCODING_FOR_BITPACK:
+        return decode_integers<Int8, Int16, Int32, Int64, UInt8, UInt16, UInt32, UInt64>(buf, rows,
+                                                                                         column);
+    case COLUMN_ENCODING_DICTIONARY:
+        if (auto* strings = typeid_cast<ColumnString*>(column)) {
+            return decode_string_column(buf, rows, strings);
+        }
+        return Status::Corruption("dictionary encoding of unsupported column {}",
+                                  column->get_name());
+    default:
+        return Status::Corruption("unknown column encoding {}", static_cast<int>(encoding));
+    }
+}
+
+static void encode_null_map(const NullMap& null_map, faststring* dst) {
+    faststring runs;
+    RleEncoder<bool> encoder(&runs, 1);
+    for (size_t i = 0; i < null_map.size();) {
+        size_t run_end = i + 1;
+        while (run_end < null_map.size() && null_map[run_end] == null_map[i]) {
+            ++run_end;
+        }
+        encoder.Put(null_map[i], run_end - i);
+        i = run_end;
+    }
+    encoder.Flush();
+    put_section(dst, runs);
+}
+
+static Status decode_null_map(const char** buf, size_t rows, NullMap* null_map) {
+    Slice runs = get_section(buf);
+    RleDecoder<bool> decoder(reinterpret_cast<const uint8_t*>(runs.data), runs.size, 1);
+    null_map->resize(rows);
+    for (size_t i = 0; i < rows;) {
+        bool is_null = false;
+        size_t run_length = decoder.GetNextRun(&is_null, rows - i);
+        if (run_length == 0) {
+            return Status::Corruption("null map of {} rows ends at row {}", rows, i);
+        }
+        memset(null_map->data() + i, is_null, run_length);
+        i += run_length;
+    }
+    return Status::OK();
+}
+
+PColumnEncoding encode_column(const IColumn& column, faststring* dst) {
+    const size_t rows = column.size();
+    if (rows < MIN_ENCODE_ROWS) {
+        return COLUMN_ENCODING_PLAIN;
+    }
+    const size_t start = dst->size();
+    put_fixed32_le(dst, rows);
+    const IColumn* values = &column;
+    if (const auto* nullable = check_and_get_column<ColumnNullable>(column)) {
+        encode_null_map(nullable->get_null_map_data(), dst);
+        values = &nullable->get_nested_column();
+    }
+    PColumnEncoding encoding = encode_values(*values, dst);
+    if (encoding == COLUMN_ENCODING_PLAIN) {
+        dst->resize(start);
+    }
+    return encoding;
+}
+
+Status decode_column(PColumnEncoding encoding, const char** buf, IColumn* column) {
+    DCHECK_EQ(column->size(), 0);
+    size_t rows = decode_fixed32_le(reinterpret_cast<const uint8_t*>(*buf));
+    *buf += sizeof(uint32_t);
+    if (auto* nullable = typeid_cast<ColumnNullable*>(column)) {
+        RETURN_IF_ERROR(decode_null_map(buf, rows, &nullable->get_null_map_data()));
+        return decode_values(encoding, buf, rows, &nullable->get_nested_column());
+    }
+    return decode_values(encoding, buf, rows, column);
+}
+
+void ColumnEncodingCounters::update(const Block& block, int num_receivers) {
+    const auto& stats = block.get_column_encoding_stats();
+    if (_profile == nullptr || stats.size() != block.columns()) {
+        return;
+    }
+    for (size_t i = _columns.size(); i < stats.size(); ++i) {
+        auto prefix = fmt::format("Column{}({})", i, block.get_by_position(i).name);
+        _columns.push_back({ADD_CHILD_COUNTER(_profile, prefix + ".UncompressedSize",
+                                              TUnit::BYTES, "UncompressedRowBatchSize"),
+                            ADD_CHILD_COUNTER(_profile, prefix + ".EncodedSize", TUnit::BYTES,
+                                              "UncompressedRowBatchSize"),
+                            ADD_CHILD_TIMER(_profile, prefix + ".EncodeTime", "CompressTime")});
+    }
+    for (size_t i = 0; i < stats.size(); ++i) {
+        COUNTER_UPDATE(_columns[i].plain_bytes, stats[i].plain_bytes * num_receivers);
+        COUNTER_UPDATE(_columns[i].encoded_bytes, stats[i].encoded_bytes * num_receivers);
+        COUNTER_UPDATE(_columns[i].encode_time, stats[i].encode_time_ns);
+    }
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,77 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <gen_cpp/data.pb.h>
+#include <stddef.h>
+
+#include <vector>
+
+#include "common/status.h"
+#include "util/runtime_profile.h"
+
+namespace doris {
+class faststring;
+
+namespace vectorized {
+class Block;
+class IColumn;
+
+// Lightweight encodings of the columns of a serialized block, applied before the whole block
+// is compressed by the generic codec:
+//  - integers are frame of reference encoded and bit packed (COLUMN_ENCODING_FOR_BITPACK);
+//  - low cardinality strings are replaced by codes into a dictionary (COLUMN_ENCODING_DICTIONARY);
+//  - the null map of a nullable column of those types is run length encoded.
+// The encoding is chosen from cheap statistics of the column, the value range of integers and
+// the distinct values of a sample of strings.
+//
+// An encoded column is laid out as the number of rows, the run length encoded null map if the
+// column is nullable, then the encoded values.
+
+// Encode `column` and append it to `dst` if one of the encodings pays off. Return the encoding
+// used, COLUMN_ENCODING_PLAIN if nothing was appended and the column should be serialized by
+// its data type.
+PColumnEncoding encode_column(const IColumn& column, faststring* dst);
+
+// Decode a column encoded by encode_column from `*buf` into the empty `column`, created by the
+// data type of the column, and advance `*buf` past it.
+Status decode_column(PColumnEncoding encoding, const char** buf, IColumn* column);
+
+// Per column counters of the blocks a sender serializes with their columns encoded, added
+// under the UncompressedRowBatchSize and CompressTime counters of the sender profile.
+class ColumnEncodingCounters {
+public:
+    void init(RuntimeProfile* profile) { _profile = profile; }
+
+    // Add the sizes of the columns of `block`, which was just serialized, sent to
+    // `num_receivers` receivers.
+    void update(const Block& block, int num_receivers);
+
+private:
+    struct Counters {
+        RuntimeProfile::Counter* plain_bytes;
+        RuntimeProfile::Counter* encoded_bytes;
+        RuntimeProfile::Counter* encode_time;
+    };
+
+    RuntimeProfile* _profile = nullptr;
+    std::vector<Counters> _columns;
+};
+
+} // namespace vectorized
+} // namespace doris
@@ -17,6 +17,8 @@
 
 #include "vec/exec/distinct_vaggregation_node.h"
 
+#include <numeric>
+
 #include "runtime/runtime_state.h"
 #include "vec/aggregate_functions/aggregate_function_uniq.h"
 #include "vec/exec/vaggregation_node.h"
@@ -56,8 +58,26 @@ Status DistinctAggregationNode::_distinct_pre_agg_with_serialized_key(
     _distinct_row.clear();
     _distinct_row.reserve(rows);
 
-    RETURN_IF_CATCH_EXCEPTION(
-            _emplace_into_hash_table_to_distinct(_distinct_row, key_columns, rows));
+    // Like the streaming pre-aggregation, stop expanding the hash table once the keys are
+    // not reduced enough and pass the rows which do not fit in it through, the duplicates
+    // are removed by the merge phase. Only without limit, the limit counts distinct rows.
+    bool pass_through = false;
+    if (_is_streaming_preagg && _limit == -1) {
+        pass_through = std::visit(
+                [&](auto&& agg_method) -> bool {
+                    return agg_method.data.add_elem_size_overflow(rows) &&
+                           !_should_expand_preagg_hash_tables(key_columns, rows);
+                },
+                _agg_data->method_variant);
+    }
+    if (pass_through) {
+        _distinct_row.resize(rows);
+        std::iota(_distinct_row.begin(), _distinct_row.end(), 0);
+    } else {
+        RETURN_IF_CATCH_EXCEPTION(
+                _emplace_into_hash_table_to_distinct(_distinct_row, key_columns, rows));
+        _reduction_tracker.add_aggregated_rows(rows);
+    }
 
     bool mem_reuse = _make_nullable_keys.empty() && out_block->mem_reuse();
     if (mem_reuse) {
@@ -116,6 +136,13 @@ void DistinctAggregationNode::_emplace_into_hash_table_to_distinct(IColumn::Sele
                 } else {
                     SCOPED_TIMER(_hash_table_emplace_timer);
                     for (size_t i = 0; i < num_rows; ++i) {
+                        if constexpr (HashTableTraits<HashTableType>::is_string_hash_table) {
+                            if (LIKELY(i + HASH_MAP_PREFETCH_DIST < num_rows)) {
+                                state.template prefetch_key<false>(
+                                        agg_method.data, i + HASH_MAP_PREFETCH_DIST,
+                                        *_agg_arena_pool);
+                            }
+                        }
                         auto result = state.emplace_key(agg_method.data, i, *_agg_arena_pool);
                         if (result.is_inserted()) {
                             result.set_mapped(dummy_mapped_data);
@@ -87,8 +87,10 @@ struct ProcessHashTableProbe {
     ForwardIterator<Mapped>& _probe_row_match(int& current_offset, int& probe_index,
                                               size_t& probe_size, bool& all_match_one);
 
-    template <bool need_null_map_for_probe, typename HashTableType, typename Keys>
-    void _probe_hash(const Keys& keys, HashTableType& hash_table_ctx, ConstNullMapPtr null_map);
+    template <bool need_null_map_for_probe, typename HashTableType, typename KeyGetter,
+              typename Keys>
+    void _probe_hash(KeyGetter& key_getter, const Keys& keys, HashTableType& hash_table_ctx,
+                     ConstNullMapPtr null_map);
 
     // Process full outer join/ right join / right semi/anti join to output the join result
     // in hash table
@@ -116,6 +118,9 @@ struct ProcessHashTableProbe {
     std::unique_ptr<Arena> _serialize_key_arena;
     std::vector<size_t> _probe_side_hash_values;
     std::vector<char> _probe_side_find_result;
+    // mapped value of each probe row looked up in radix partitioned order, nullptr if not found
+    std::vector<void*> _probe_side_mapped;
+    std::vector<uint32_t> _probe_side_radix_rows;
 
     std::vector<bool*> _visited_map;
     std::vector<bool> _same_to_prev;
@@ -244,8 +244,9 @@ KeyGetter ProcessHashTableProbe<JoinOpType>::_init_probe_side(size_t probe_rows,
 }
 
 template <int JoinOpType>
-template <bool need_null_map_for_probe, typename HashTableType, typename Keys>
-void ProcessHashTableProbe<JoinOpType>::_probe_hash(const Keys& keys, HashTableType& hash_table_ctx,
+template <bool need_null_map_for_probe, typename HashTableType, typename KeyGetter, typename Keys>
+void ProcessHashTableProbe<JoinOpType>::_probe_hash(KeyGetter& key_getter, const Keys& keys,
+                                                    HashTableType& hash_table_ctx,
                                                     ConstNullMapPtr null_map) {
     if (*_join_context->_ready_probe) {
         return;
@@ -260,6 +261,30 @@ void ProcessHashTableProbe<JoinOpType>::_probe_hash(const Keys& keys, HashTableT
         }
         _probe_side_hash_values[k] = hash_table_ctx.hash_table.hash(keys[k]);
     }
+
+    _probe_side_mapped.clear();
+    if (config::enable_hash_join_radix_partition && hash_table_ctx.hash_table.is_partitioned()) {
+        // look up the whole block sub table by sub table, the results are consumed in the
+        // order of probe rows
+        hash_table_ctx.hash_table.radix_partition(
+                _probe_side_hash_values.data(), keys.size(),
+                need_null_map_for_probe ? null_map->data() : nullptr, _probe_side_radix_rows);
+        _probe_side_mapped.resize(keys.size(), nullptr);
+        size_t num_rows = _probe_side_radix_rows.size();
+        for (size_t i = 0; i < num_rows; ++i) {
+            auto row = _probe_side_radix_rows[i];
+            if (LIKELY(i + HASH_MAP_PREFETCH_DIST < num_rows)) {
+                auto next = _probe_side_radix_rows[i + HASH_MAP_PREFETCH_DIST];
+                key_getter.template prefetch_by_hash<true>(hash_table_ctx.hash_table,
+                                                           _probe_side_hash_values[next]);
+            }
+            auto find_result = key_getter.find_key_with_hash(
+                    hash_table_ctx.hash_table, _probe_side_hash_values[row], keys[row]);
+            if (find_result.is_found()) {
+                _probe_side_mapped[row] = &find_result.get_mapped();
+            }
+        }
+    }
     *_join_context->_ready_probe = true;
 }
 
@@ -351,12 +376,22 @@ Status ProcessHashTableProbe<JoinOpType>::do_process(HashTableType& hash_table_c
 
     const auto& keys = key_getter.get_keys();
 
-    _probe_hash<need_null_map_for_probe, HashTableType>(keys, hash_table_ctx, null_map);
+    _probe_hash<need_null_map_for_probe, HashTableType>(key_getter, keys, hash_table_ctx,
+                                                        null_map);
 
     {
         SCOPED_TIMER(_search_hashtable_timer);
         using FindResult = decltype(key_getter.find_key(hash_table_ctx.hash_table, 0, *_arena));
         FindResult empty = {nullptr, false};
+        bool radix_partitioned = !_probe_side_mapped.empty();
+        auto find_key = [&](int row) -> FindResult {
+            if (radix_partitioned) {
+                auto* mapped = static_cast<Mapped*>(_probe_side_mapped[row]);
+                return {mapped, mapped != nullptr};
+            }
+            return key_getter.find_key_with_hash(hash_table_ctx.hash_table,
+                                                 _probe_side_hash_values[row], keys[row]);
+        };
         while (current_offset < _batch_size && probe_index < probe_rows) {
             if constexpr (ignore_null && need_null_map_for_probe) {
                 if ((*null_map)[probe_index]) {
@@ -377,13 +412,11 @@ Status ProcessHashTableProbe<JoinOpType>::do_process(HashTableType& hash_table_c
                 }
             }
 
-            const auto& find_result =
-                    need_null_map_for_probe && (*null_map)[probe_index]
-                            ? empty
-                            : key_getter.find_key_with_hash(hash_table_ctx.hash_table,
-                                                            _probe_side_hash_values[probe_index],
-                                                            keys[probe_index]);
-            if (LIKELY(probe_index + HASH_MAP_PREFETCH_DIST < probe_rows) &&
+            const auto& find_result = need_null_map_for_probe && (*null_map)[probe_index]
+                                              ? empty
+                                              : find_key(probe_index);
+            if (!radix_partitioned &&
+                LIKELY(probe_index + HASH_MAP_PREFETCH_DIST < probe_rows) &&
                 !(need_null_map_for_probe && (*null_map)[probe_index + HASH_MAP_PREFETCH_DIST])) {
                 key_getter.template prefetch_by_hash<true>(
                         hash_table_ctx.hash_table,
@@ -20,6 +20,7 @@
 #include <gen_cpp/Metrics_types.h>
 #include <gen_cpp/Opcodes_types.h>
 #include <gen_cpp/PlanNodes_types.h>
+#include <fmt/format.h>
 #include <glog/logging.h>
 #include <opentelemetry/nostd/shared_ptr.h>
 
@@ -27,6 +28,7 @@
 #include <array>
 #include <boost/iterator/iterator_facade.hpp>
 #include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <new>
@@ -45,8 +47,10 @@
 #include "gutil/strings/substitute.h"
 #include "pipeline/exec/hashjoin_build_sink.h"
 #include "pipeline/exec/hashjoin_probe_operator.h"
+#include "runtime/block_spill_manager.h"
 #include "runtime/define_primitive_type.h"
 #include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
 #include "runtime/query_context.h"
 #include "runtime/runtime_filter_mgr.h"
 #include "runtime/runtime_state.h"
@@ -74,6 +78,13 @@
 
 namespace doris::vectorized {
 
+// When spilling, rows of each partition are buffered until they reach this size, and then
+// written to the spill file of the partition as one block.
+static constexpr size_t HASH_JOIN_SPILL_BATCH_BYTES = 1024 * 1024;
+// A partition is split again by the next bits of the hash at most this many times, which uses
+// up to the top 32 bits of the hash with the maximum `external_join_partition_bits` of 8.
+static constexpr size_t HASH_JOIN_SPILL_MAX_LEVEL = 3;
+
 template Status HashJoinNode::_extract_join_column<true>(
         Block&, COW<IColumn>::mutable_ptr<ColumnVector<unsigned char>>&,
         std::vector<IColumn const*, std::allocator<IColumn const*>>&,
@@ -369,6 +380,26 @@ Status HashJoinNode::prepare(RuntimeState* state) {
 
     _build_collisions_counter = ADD_COUNTER(runtime_profile(), "BuildCollisions", TUnit::UNIT);
 
+    _external_join_bytes_threshold = state->external_join_bytes_threshold();
+    if (_external_join_bytes_threshold > 0) {
+        if (state->query_options().__isset.external_join_partition_bits) {
+            _spill_partition_count_bits = state->query_options().external_join_partition_bits;
+        }
+        // Spilling needs to drain the probe side before any partition is joined, so the probe
+        // side can not start early, and the hash table can not be shared by other instances.
+        // Null aware left anti join and mark join need to know whether the whole build side
+        // contains null, which can not be answered by a single partition.
+        _can_spill = _shared_hashtable_controller == nullptr && !_is_mark_join &&
+                     _join_op != TJoinOp::NULL_AWARE_LEFT_ANTI_JOIN &&
+                     _join_op != TJoinOp::CROSS_JOIN &&
+                     !_enable_hash_join_early_start_probe(state);
+        _spill_build_rows_counter = ADD_COUNTER(runtime_profile(), "SpillBuildRows", TUnit::UNIT);
+        _spill_probe_rows_counter = ADD_COUNTER(runtime_profile(), "SpillProbeRows", TUnit::UNIT);
+        _spill_partition_timer = ADD_TIMER(runtime_profile(), "SpillPartitionTime");
+        _spill_repartition_counter =
+                ADD_COUNTER(runtime_profile(), "SpillRepartitions", TUnit::UNIT);
+    }
+
     RETURN_IF_ERROR(VExpr::prepare(_build_expr_ctxs, state, child(1)->row_desc()));
     RETURN_IF_ERROR(VExpr::prepare(_probe_expr_ctxs, state, child(0)->row_desc()));
 
@@ -417,6 +448,14 @@ Status HashJoinNode::close(RuntimeState* state) {
 }
 
 bool HashJoinNode::need_more_input_data() const {
+    if (_spill_context.spilled) {
+        // the spilled partitions are joined after the whole probe side has been partitioned
+        return !_spill_context.probe_partitioned;
+    }
+    return _need_more_input_data_in_memory();
+}
+
+bool HashJoinNode::_need_more_input_data_in_memory() const {
     return (_probe_block.rows() == 0 || _probe_index == _probe_block.rows()) && !_probe_eos &&
            (!_short_circuit_for_probe || _is_mark_join);
 }
@@ -428,6 +467,13 @@ void HashJoinNode::prepare_for_next() {
 }
 
 Status HashJoinNode::pull(doris::RuntimeState* state, vectorized::Block* output_block, bool* eos) {
+    if (_spill_context.spilled) {
+        return _pull_spilled(state, output_block, eos);
+    }
+    return _pull_in_memory(state, output_block, eos);
+}
+
+Status HashJoinNode::_pull_in_memory(RuntimeState* state, Block* output_block, bool* eos) {
     SCOPED_TIMER(_probe_timer);
     if (_short_circuit_for_probe) {
         /// If `_short_circuit_for_probe` is true, this indicates no rows
@@ -603,7 +649,14 @@ Status HashJoinNode::_filter_data_and_build_output(RuntimeState* state,
     return Status::OK();
 }
 
-Status HashJoinNode::push(RuntimeState* /*state*/, vectorized::Block* input_block, bool eos) {
+Status HashJoinNode::push(RuntimeState* state, vectorized::Block* input_block, bool eos) {
+    if (_spill_context.spilled) {
+        return _spill_probe_block(state, input_block, eos);
+    }
+    return _push_in_memory(input_block, eos);
+}
+
+Status HashJoinNode::_push_in_memory(Block* input_block, bool eos) {
     _probe_eos = eos;
     if (input_block->rows() > 0) {
         COUNTER_UPDATE(_probe_rows_counter, input_block->rows());
@@ -641,6 +694,13 @@ Status HashJoinNode::push(RuntimeState* /*state*/, vectorized::Block* input_bloc
 Status HashJoinNode::get_next(RuntimeState* state, Block* output_block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
 
+    if (_spill_context.spilled) {
+        if (!_spill_context.probe_partitioned) {
+            RETURN_IF_ERROR(_partition_probe_side(state));
+        }
+        return _pull_spilled(state, output_block, eos);
+    }
+
     if (_is_hash_join_early_start_probe_eos(state)) {
         *eos = true;
         return Status::OK();
@@ -853,6 +913,14 @@ Status HashJoinNode::sink(doris::RuntimeState* state, vectorized::Block* in_bloc
         // data from probe side.
         _build_side_mem_used += in_block->allocated_bytes();
 
+        if (_spill_context.spilled && !_spill_context.probe_partitioned) {
+            return _spill_build_block(state, in_block, eos);
+        }
+        if (_should_spill_build_side()) {
+            RETURN_IF_ERROR(_start_spill(state));
+            return _spill_build_block(state, in_block, eos);
+        }
+
         if (in_block->rows() != 0) {
             SCOPED_TIMER(_build_side_merge_block_timer);
             RETURN_IF_ERROR(_build_side_mutable_block.merge(*in_block));
@@ -896,6 +964,11 @@ Status HashJoinNode::sink(doris::RuntimeState* state, vectorized::Block* in_bloc
                                             __builtin_unreachable();
                                         },
                                         [&](auto&& arg) -> Status {
+                                            // runtime filters have been ignored when spilling,
+                                            // the hash table only holds one partition here.
+                                            if (_spill_context.spilled) {
+                                                return Status::OK();
+                                            }
                                             using HashTableCtxType = std::decay_t<decltype(arg)>;
                                             RuntimeFilterContext context(this);
                                             ProcessRuntimeFilterBuild<HashTableCtxType>
@@ -979,6 +1052,340 @@ Status HashJoinNode::sink(doris::RuntimeState* state, vectorized::Block* in_bloc
     return Status::OK();
 }
 
+bool HashJoinNode::_should_spill_build_side() const {
+    // Only decide to spill before any build block has been inserted into the hash table, so the
+    // whole build side can be partitioned.
+    return _can_spill && !_spill_context.spilled && _build_blocks->empty() &&
+           _build_side_mem_used > _external_join_bytes_threshold;
+}
+
+Status HashJoinNode::_start_spill(RuntimeState* state) {
+    RETURN_IF_ERROR(_spill_context.init(_spill_partition_count_bits,
+                                        runtime_profile()->create_child("Spill", true, true)));
+    _spill_context.spilled = true;
+    runtime_profile()->add_info_string("Spilled", "true");
+
+    // Partitions are only joined after the whole probe side has been consumed, runtime filters
+    // built from them would come too late, so release the waiting consumers right now.
+    RETURN_IF_ERROR(_ignore_runtime_filters(state));
+
+    if (!_build_side_mutable_block.empty()) {
+        auto block = _build_side_mutable_block.to_block();
+        _build_side_mutable_block = MutableBlock();
+        COUNTER_UPDATE(_spill_build_rows_counter, block.rows());
+        RETURN_IF_ERROR(_partition_block(block, true));
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_ignore_runtime_filters(RuntimeState* state) {
+    for (auto* runtime_filter : _runtime_filters) {
+        if (runtime_filter->has_remote_target()) {
+            std::string msg = fmt::format(
+                    "fragment instance {} ignore runtime filter(id {}) because: build side of "
+                    "hash join is spilled",
+                    print_id(state->fragment_instance_id()), runtime_filter->filter_id());
+            runtime_filter->set_ignored();
+            runtime_filter->set_ignored_msg(msg);
+            RETURN_IF_ERROR(runtime_filter->publish());
+        } else {
+            std::vector<IRuntimeFilter*> filters;
+            RETURN_IF_ERROR(state->runtime_filter_mgr()->get_consume_filters(
+                    runtime_filter->filter_id(), filters));
+            for (auto* filter : filters) {
+                filter->set_ignored();
+                filter->signal();
+            }
+        }
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_spill_build_block(RuntimeState* state, Block* block, bool eos) {
+    COUNTER_UPDATE(_spill_build_rows_counter, block->rows());
+    RETURN_IF_ERROR(_partition_block(*block, true));
+    if (eos) {
+        RETURN_IF_ERROR(_flush_spill_buffers(true, true));
+        for (auto& writer : _spill_context.build_writers) {
+            RETURN_IF_ERROR(writer->close());
+        }
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_partition_block(Block& block, bool build_side) {
+    const size_t rows = block.rows();
+    if (rows == 0) {
+        return Status::OK();
+    }
+    SCOPED_TIMER(_spill_partition_timer);
+    auto& buffers = build_side ? _spill_context.build_buffers : _spill_context.probe_buffers;
+
+    const size_t origin_columns = block.columns();
+    auto& exprs = build_side ? _build_expr_ctxs : _probe_expr_ctxs;
+    auto* expr_call_timer = build_side ? _build_expr_call_timer : _probe_expr_call_timer;
+    std::vector<int> res_col_ids(exprs.size());
+    RETURN_IF_ERROR(_do_evaluate(block, exprs, *expr_call_timer, res_col_ids));
+
+    // The hash of a nullable column equals the hash of its nested column for not null rows,
+    // so equal keys of both sides always fall into the same partition.
+    std::vector<uint64_t> hash_values(rows, 0);
+    for (auto col_id : res_col_ids) {
+        block.get_by_position(col_id).column->update_hashes_with_value(hash_values.data());
+    }
+    block.erase_tail(origin_columns);
+
+    std::vector<std::vector<int>> partition_rows(_spill_context.partition_count);
+    for (size_t i = 0; i < rows; ++i) {
+        partition_rows[_spill_context.get_index(hash_values[i])].push_back(i);
+    }
+
+    for (size_t i = 0; i < _spill_context.partition_count; ++i) {
+        const auto& selector = partition_rows[i];
+        if (selector.empty()) {
+            continue;
+        }
+        if (buffers[i].columns() == 0) {
+            buffers[i] = MutableBlock(block.clone_empty());
+        }
+        RETURN_IF_CATCH_EXCEPTION(
+                buffers[i].add_rows(&block, selector.data(), selector.data() + selector.size()));
+    }
+    return _flush_spill_buffers(build_side, false);
+}
+
+Status HashJoinNode::_flush_spill_buffers(bool build_side, bool force) {
+    auto& buffers = build_side ? _spill_context.build_buffers : _spill_context.probe_buffers;
+    auto& writers = build_side ? _spill_context.build_writers : _spill_context.probe_writers;
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        if (buffers[i].empty()) {
+            continue;
+        }
+        if (force || buffers[i].allocated_bytes() >= HASH_JOIN_SPILL_BATCH_BYTES) {
+            if (build_side) {
+                _spill_context.build_bytes[i] += buffers[i].allocated_bytes();
+            }
+            RETURN_IF_ERROR(writers[i]->write(buffers[i].to_block()));
+            buffers[i] = MutableBlock();
+        }
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_spill_probe_block(RuntimeState* state, Block* block, bool eos) {
+    DCHECK(!_spill_context.probe_partitioned);
+    COUNTER_UPDATE(_spill_probe_rows_counter, block->rows());
+    RETURN_IF_ERROR(_partition_block(*block, false));
+    if (eos) {
+        RETURN_IF_ERROR(_flush_spill_buffers(false, true));
+        for (auto& writer : _spill_context.probe_writers) {
+            RETURN_IF_ERROR(writer->close());
+        }
+        _spill_context.finish_writers();
+        _spill_context.probe_partitioned = true;
+        RETURN_IF_ERROR(_prepare_spilled_partition(state));
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_partition_probe_side(RuntimeState* state) {
+    Block block;
+    bool eos = false;
+    while (!eos) {
+        RETURN_IF_CANCELLED(state);
+        block.clear_column_data();
+        {
+            SCOPED_TIMER(_probe_next_timer);
+            RETURN_IF_ERROR(child(0)->get_next_after_projects(
+                    state, &block, &eos,
+                    std::bind((Status(ExecNode::*)(RuntimeState*, vectorized::Block*, bool*)) &
+                                      ExecNode::get_next,
+                              _children[0], std::placeholders::_1, std::placeholders::_2,
+                              std::placeholders::_3)));
+        }
+        RETURN_IF_ERROR(_spill_probe_block(state, &block, eos));
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_repartition(RuntimeState* state, const HashJoinSpillPartition& partition) {
+    COUNTER_UPDATE(_spill_repartition_counter, 1);
+    // the streams are removed by the readers once opened
+    auto* manager = ExecEnv::GetInstance()->block_spill_mgr();
+    BlockSpillReaderUPtr build_reader;
+    BlockSpillReaderUPtr probe_reader;
+    RETURN_IF_ERROR(manager->get_reader(partition.build_stream_id, build_reader,
+                                        _spill_context.runtime_profile));
+    RETURN_IF_ERROR(manager->get_reader(partition.probe_stream_id, probe_reader,
+                                        _spill_context.runtime_profile));
+
+    RETURN_IF_ERROR(_spill_context.open_writers(partition.level + 1));
+    for (bool build_side : {true, false}) {
+        auto& reader = build_side ? build_reader : probe_reader;
+        Block block;
+        bool eos = false;
+        while (!eos) {
+            RETURN_IF_CANCELLED(state);
+            RETURN_IF_ERROR(reader->read(&block, &eos));
+            RETURN_IF_ERROR(_partition_block(block, build_side));
+        }
+        RETURN_IF_ERROR(reader->close());
+        RETURN_IF_ERROR(_flush_spill_buffers(build_side, true));
+        for (auto& writer :
+             build_side ? _spill_context.build_writers : _spill_context.probe_writers) {
+            RETURN_IF_ERROR(writer->close());
+        }
+    }
+    _spill_context.finish_writers();
+    return Status::OK();
+}
+
+Status HashJoinNode::_prepare_spilled_partition(RuntimeState* state) {
+    auto& partitions = _spill_context.partitions;
+    DCHECK(!partitions.empty());
+    // Split a partition again while its build rows do not fit in memory, unless the bits of the
+    // hash are used up, e.g. most of its rows have the same join key.
+    while (static_cast<int64_t>(partitions.back().build_bytes) > _external_join_bytes_threshold &&
+           partitions.back().level < HASH_JOIN_SPILL_MAX_LEVEL) {
+        auto partition = partitions.back();
+        partitions.pop_back();
+        RETURN_IF_ERROR(_repartition(state, partition));
+    }
+    auto partition = partitions.back();
+    partitions.pop_back();
+    // the streams are removed by the readers once opened
+    auto* manager = ExecEnv::GetInstance()->block_spill_mgr();
+    BlockSpillReaderUPtr build_reader;
+    RETURN_IF_ERROR(manager->get_reader(partition.build_stream_id, build_reader,
+                                        _spill_context.runtime_profile));
+    RETURN_IF_ERROR(manager->get_reader(partition.probe_stream_id, _spill_context.probe_reader,
+                                        _spill_context.runtime_profile));
+
+    // reset the build side, the probe context is recreated by `sink` at eos.
+    _arena = std::make_shared<Arena>();
+    _build_blocks.reset(new std::vector<Block>());
+    _build_blocks->reserve(HASH_JOIN_MAX_BUILD_BLOCK_COUNT);
+    _build_block_idx = 0;
+    _build_side_mem_used = 0;
+    _build_side_last_mem_used = 0;
+    _build_side_mutable_block = MutableBlock();
+    _inserted_rows.clear();
+    _hash_table_variants = std::make_shared<HashTableVariants>();
+    _hash_table_init(state);
+
+    Block block;
+    bool eos = false;
+    while (!eos) {
+        RETURN_IF_CANCELLED(state);
+        RETURN_IF_ERROR(build_reader->read(&block, &eos));
+        RETURN_IF_ERROR(sink(state, &block, eos));
+    }
+    RETURN_IF_ERROR(build_reader->close());
+
+    // reset the probe side, the probe block of last partition may have been cleared by the
+    // spill reader at eos.
+    _probe_column_disguise_null.clear();
+    _probe_column_convert_to_null.clear();
+    _probe_block.clear();
+    _probe_index = 0;
+    _ready_probe = false;
+    _probe_eos = false;
+    _is_any_probe_match_row_output = false;
+    return Status::OK();
+}
+
+Status HashJoinNode::_pull_spilled(RuntimeState* state, Block* output_block, bool* eos) {
+    DCHECK(_spill_context.probe_partitioned);
+    bool partition_eos = false;
+    if (_short_circuit_for_probe) {
+        partition_eos = true;
+    } else {
+        while (_need_more_input_data_in_memory()) {
+            prepare_for_next();
+            SCOPED_TIMER(_probe_next_timer);
+            RETURN_IF_ERROR(_spill_context.probe_reader->read(&_probe_block, &_probe_eos));
+            RETURN_IF_ERROR(_push_in_memory(&_probe_block, _probe_eos));
+        }
+        RETURN_IF_ERROR(_pull_in_memory(state, output_block, &partition_eos));
+    }
+
+    if (reached_limit()) {
+        *eos = true;
+        return Status::OK();
+    }
+    if (partition_eos) {
+        RETURN_IF_ERROR(_spill_context.probe_reader->close());
+        _spill_context.probe_reader.reset();
+        if (_spill_context.partitions.empty()) {
+            *eos = true;
+        } else {
+            RETURN_IF_ERROR(_prepare_spilled_partition(state));
+        }
+    }
+    return Status::OK();
+}
+
+Status HashJoinSpillContext::init(size_t bits, RuntimeProfile* profile) {
+    partition_count_bits = bits;
+    partition_count = 1 << partition_count_bits;
+    runtime_profile = profile;
+    build_buffers.resize(partition_count);
+    probe_buffers.resize(partition_count);
+    build_writers.resize(partition_count);
+    probe_writers.resize(partition_count);
+    return open_writers(0);
+}
+
+Status HashJoinSpillContext::open_writers(size_t partition_level) {
+    level = partition_level;
+    build_bytes.assign(partition_count, 0);
+    // blocks are buffered per partition before being written, so do not split them again.
+    auto* manager = ExecEnv::GetInstance()->block_spill_mgr();
+    for (size_t i = 0; i < partition_count; ++i) {
+        RETURN_IF_ERROR(manager->get_writer(std::numeric_limits<int32_t>::max(), build_writers[i],
+                                            runtime_profile));
+        RETURN_IF_ERROR(manager->get_writer(std::numeric_limits<int32_t>::max(), probe_writers[i],
+                                            runtime_profile));
+    }
+    return Status::OK();
+}
+
+void HashJoinSpillContext::finish_writers() {
+    for (size_t i = partition_count; i-- > 0;) {
+        partitions.push_back({build_writers[i]->get_id(), probe_writers[i]->get_id(),
+                              build_bytes[i], level});
+        build_writers[i].reset();
+        probe_writers[i].reset();
+    }
+}
+
+HashJoinSpillContext::~HashJoinSpillContext() {
+    if (probe_reader) {
+        probe_reader->close();
+    }
+    // remove the files of partitions which were never joined, e.g. limit reached or cancelled.
+    std::vector<int64_t> stream_ids;
+    for (auto writers : {&build_writers, &probe_writers}) {
+        for (auto& writer : *writers) {
+            if (writer) {
+                writer->close();
+                stream_ids.emplace_back(writer->get_id());
+            }
+        }
+    }
+    for (const auto& partition : partitions) {
+        stream_ids.emplace_back(partition.build_stream_id);
+        stream_ids.emplace_back(partition.probe_stream_id);
+    }
+    auto* manager = ExecEnv::GetInstance()->block_spill_mgr();
+    for (auto stream_id : stream_ids) {
+        BlockSpillReaderUPtr reader;
+        if (manager->get_reader(stream_id, reader, runtime_profile).ok()) {
+            reader->close();
+        }
+    }
+}
+
 void HashJoinNode::debug_string(int indentation_level, std::stringstream* out) const {
     *out << string(indentation_level * 2, ' ');
     *out << "HashJoin(need_more_input_data=" << (need_more_input_data() ? "true" : "false")
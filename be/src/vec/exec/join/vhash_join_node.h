@@ -42,6 +42,8 @@
 #include "vec/common/hash_table/partitioned_hash_map.h"
 #include "vec/common/string_ref.h"
 #include "vec/core/block.h"
+#include "vec/core/block_spill_reader.h"
+#include "vec/core/block_spill_writer.h"
 #include "vec/core/types.h"
 #include "vec/exec/join/join_op.h" // IWYU pragma: keep
 #include "vec/exprs/vexpr_fwd.h"
@@ -251,12 +253,25 @@ struct ProcessHashTableBuild {
             }
         }
 
+        // insert the rows sub table by sub table if the hash table is already partitioned
+        bool radix_partition = config::enable_hash_join_radix_partition &&
+                               hash_table_ctx.hash_table.is_partitioned();
+        size_t num_rows_to_insert = _rows;
+        if (radix_partition) {
+            SCOPED_TIMER(_build_side_compute_hash_timer);
+            hash_table_ctx.hash_table.radix_partition(
+                    _build_side_hash_values.data(), _rows,
+                    ignore_null ? null_map->data() : nullptr, _build_side_radix_rows);
+            num_rows_to_insert = _build_side_radix_rows.size();
+        }
+
         bool build_unique = _join_context->_build_unique;
 #define EMPLACE_IMPL(stmt)                                                                    \
-    for (size_t k = 0; k < _rows; ++k) {                                                      \
-        if (k % CHECK_FRECUENCY == 0) {                                                       \
+    for (size_t i = 0; i < num_rows_to_insert; ++i) {                                         \
+        if (i % CHECK_FRECUENCY == 0) {                                                       \
             RETURN_IF_CANCELLED(_state);                                                      \
         }                                                                                     \
+        size_t k = radix_partition ? _build_side_radix_rows[i] : i;                           \
         if constexpr (ignore_null) {                                                          \
             if ((*null_map)[k]) {                                                             \
                 continue;                                                                     \
@@ -264,10 +279,11 @@ struct ProcessHashTableBuild {
         }                                                                                     \
         auto emplace_result = key_getter.emplace_with_key(hash_table_ctx.hash_table, keys[k], \
                                                           _build_side_hash_values[k]);        \
-        if (LIKELY(k + HASH_MAP_PREFETCH_DIST < _rows)) {                                     \
-            key_getter.template prefetch_by_hash<false>(                                      \
-                    hash_table_ctx.hash_table,                                                \
-                    _build_side_hash_values[k + HASH_MAP_PREFETCH_DIST]);                     \
+        if (LIKELY(i + HASH_MAP_PREFETCH_DIST < num_rows_to_insert)) {                        \
+            size_t next = i + HASH_MAP_PREFETCH_DIST;                                         \
+            next = radix_partition ? _build_side_radix_rows[next] : next;                     \
+            key_getter.template prefetch_by_hash<false>(hash_table_ctx.hash_table,            \
+                                                        _build_side_hash_values[next]);       \
         }                                                                                     \
         stmt;                                                                                 \
     }
@@ -324,6 +340,7 @@ private:
 
     ProfileCounter* _build_side_compute_hash_timer;
     std::vector<size_t> _build_side_hash_values;
+    std::vector<uint32_t> _build_side_radix_rows;
 };
 
 template <typename RowRefListType>
@@ -482,6 +499,52 @@ using HashTableIteratorVariants =
 
 static constexpr auto HASH_JOIN_MAX_BUILD_BLOCK_COUNT = 128;
 
+// Grace hash join: once the build side exceeds `external_join_bytes_threshold`, rows of
+// both sides are hash partitioned by their join keys into spill streams, and every partition
+// is then joined independently with an in-memory hash table of its own build rows. A partition
+// whose build rows still exceed the threshold is partitioned again by the next bits of the hash.
+struct HashJoinSpillPartition {
+    int64_t build_stream_id = -1;
+    int64_t probe_stream_id = -1;
+    size_t build_bytes = 0;
+    size_t level = 0;
+};
+
+struct HashJoinSpillContext {
+    bool spilled = false;
+    bool probe_partitioned = false;
+    size_t partition_count_bits = 0;
+    size_t partition_count = 0;
+    // level of the partitions being written, 0 for the ones of the children
+    size_t level = 0;
+
+    std::vector<MutableBlock> build_buffers;
+    std::vector<MutableBlock> probe_buffers;
+    std::vector<BlockSpillWriterUPtr> build_writers;
+    std::vector<BlockSpillWriterUPtr> probe_writers;
+    // allocated bytes of the build rows written to each partition
+    std::vector<size_t> build_bytes;
+
+    // partitions waiting to be joined, the last one is joined first
+    std::vector<HashJoinSpillPartition> partitions;
+
+    BlockSpillReaderUPtr probe_reader;
+    RuntimeProfile* runtime_profile = nullptr;
+
+    Status init(size_t bits, RuntimeProfile* profile);
+
+    // Create the writers of the partitions of `partition_level`.
+    Status open_writers(size_t partition_level);
+    // Move the closed writers of all partitions to `partitions`.
+    void finish_writers();
+
+    size_t get_index(uint64_t hash_value) const {
+        return (hash_value >> (32 + level * partition_count_bits)) & (partition_count - 1);
+    }
+
+    ~HashJoinSpillContext();
+};
+
 struct HashJoinProbeContext {
     HashJoinProbeContext(HashJoinNode* join_node);
     HashJoinProbeContext(pipeline::HashJoinProbeLocalState* local_state);
@@ -595,6 +658,22 @@ private:
     bool _enable_hash_join_early_start_probe(RuntimeState* state) const;
     bool _is_hash_join_early_start_probe_eos(RuntimeState* state) const;
 
+    bool _should_spill_build_side() const;
+    Status _start_spill(RuntimeState* state);
+    Status _spill_build_block(RuntimeState* state, Block* block, bool eos);
+    Status _partition_block(Block& block, bool build_side);
+    Status _flush_spill_buffers(bool build_side, bool force);
+    Status _spill_probe_block(RuntimeState* state, Block* block, bool eos);
+    Status _partition_probe_side(RuntimeState* state);
+    Status _repartition(RuntimeState* state, const HashJoinSpillPartition& partition);
+    Status _prepare_spilled_partition(RuntimeState* state);
+    Status _pull_spilled(RuntimeState* state, Block* output_block, bool* eos);
+
+    bool _need_more_input_data_in_memory() const;
+    Status _push_in_memory(Block* input_block, bool eos);
+    Status _pull_in_memory(RuntimeState* state, Block* output_block, bool* eos);
+    Status _ignore_runtime_filters(RuntimeState* state);
+
     // probe expr
     VExprContextSPtrs _probe_expr_ctxs;
     // build expr
@@ -738,6 +817,17 @@ private:
     std::atomic_bool _probe_open_finish = false;
 
     std::unique_ptr<HashJoinProbeContext> _probe_context;
+
+    // spill build and probe side to disk when the build side exceeds this threshold,
+    // 0 means spill is disabled
+    int64_t _external_join_bytes_threshold = 0;
+    size_t _spill_partition_count_bits = 4;
+    bool _can_spill = false;
+    HashJoinSpillContext _spill_context;
+    RuntimeProfile::Counter* _spill_build_rows_counter = nullptr;
+    RuntimeProfile::Counter* _spill_probe_rows_counter = nullptr;
+    RuntimeProfile::Counter* _spill_partition_timer = nullptr;
+    RuntimeProfile::Counter* _spill_repartition_counter = nullptr;
 };
 } // namespace vectorized
 } // namespace doris
@@ -174,6 +174,8 @@ private:
     // page read from cache
     // used by segment v2
     RuntimeProfile::Counter* _cached_pages_num_counter = nullptr;
+    RuntimeProfile::Counter* _compressed_cached_pages_num_counter = nullptr;
+    RuntimeProfile::Counter* _read_ahead_pages_num_counter = nullptr;
 
     // row count filtered by bitmap inverted index
     RuntimeProfile::Counter* _bitmap_index_filter_counter = nullptr;
@@ -608,6 +608,9 @@ void NewOlapScanner::_update_counters_before_close() {
     COUNTER_UPDATE(Parent->_key_range_filtered_counter, stats.rows_key_range_filtered);           \
     COUNTER_UPDATE(Parent->_total_pages_num_counter, stats.total_pages_num);                      \
     COUNTER_UPDATE(Parent->_cached_pages_num_counter, stats.cached_pages_num);                    \
+    COUNTER_UPDATE(Parent->_compressed_cached_pages_num_counter,                                  \
+                   stats.compressed_cached_pages_num);                                            \
+    COUNTER_UPDATE(Parent->_read_ahead_pages_num_counter, stats.read_ahead_pages_num);            \
     COUNTER_UPDATE(Parent->_bitmap_index_filter_counter, stats.rows_bitmap_index_filtered);       \
     COUNTER_UPDATE(Parent->_bitmap_index_filter_timer, stats.bitmap_index_filter_timer);          \
     COUNTER_UPDATE(Parent->_inverted_index_filter_counter, stats.rows_inverted_index_filtered);   \
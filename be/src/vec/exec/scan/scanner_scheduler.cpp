@@ -33,6 +33,7 @@
 #include "common/config.h"
 #include "common/logging.h"
 #include "olap/tablet.h"
+#include "pipeline/task_scheduler.h"
 #include "runtime/exec_env.h"
 #include "runtime/runtime_state.h"
 #include "runtime/thread_context.h"
@@ -436,6 +437,7 @@ void ScannerScheduler::_scanner_scan(ScannerScheduler* scheduler, ScannerContext
         scanner->mark_to_need_to_close();
     }
     ctx->push_back_scanner_and_reschedule(scanner);
+    pipeline::BlockedTaskScheduler::wake_up();
 }
 
 void ScannerScheduler::_task_group_scanner_scan(ScannerScheduler* scheduler,
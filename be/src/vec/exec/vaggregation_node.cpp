@@ -28,16 +28,22 @@
 #include <memory>
 #include <string>
 
+#include "common/config.h"
 #include "common/status.h"
 #include "exec/exec_node.h"
 #include "runtime/block_spill_manager.h"
 #include "runtime/define_primitive_type.h"
 #include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
 #include "runtime/memory/mem_tracker.h"
 #include "runtime/primitive_type.h"
 #include "runtime/runtime_state.h"
 #include "runtime/thread_context.h"
+#include "util/cpu_info.h"
+#include "util/countdown_latch.h"
+#include "util/defer_op.h"
 #include "util/telemetry/telemetry.h"
+#include "util/threadpool.h"
 #include "vec/common/hash_table/hash.h"
 #include "vec/common/hash_table/hash_table_key_holder.h"
 #include "vec/common/hash_table/hash_table_utils.h"
@@ -57,10 +63,20 @@ class ObjectPool;
 } // namespace doris
 
 namespace doris::vectorized {
+StreamingAggReductionTracker::StreamingAggReductionTracker() {
+    // Fall back to the typical sizes if the cache sizes can not be determined, the L2 cache is
+    // generally 1024k or more and the L3 cache is generally 16MB or more.
+    const long l2_cache_size = CpuInfo::get_cache_size(CpuInfo::L2_CACHE);
+    const long l3_cache_size = CpuInfo::get_cache_size(CpuInfo::L3_CACHE);
+    _l2_cache_size = l2_cache_size > 0 ? l2_cache_size : 1024 * 1024;
+    _l3_cache_size = std::max<size_t>(l3_cache_size > 0 ? l3_cache_size : 16 * 1024 * 1024,
+                                      _l2_cache_size);
+}
+
 /// The minimum reduction factor (input rows divided by output rows) to grow hash tables
 /// in a streaming preaggregation, given that the hash tables are currently the given
 /// size or above. The sizes roughly correspond to hash table sizes where the bucket
-/// arrays will fit in  a cache level. Intuitively, we don't want the working set of the
+/// arrays will fit in a cache level. Intuitively, we don't want the working set of the
 /// aggregation to expand to the next level of cache unless we're reducing the input
 /// enough to outweigh the increased memory latency we'll incur for each hash table
 /// lookup.
@@ -72,33 +88,67 @@ namespace doris::vectorized {
 /// increases as more input is processed.  If the input order is correlated with the
 /// key, skew may bias the estimate. If high cardinality keys appear first, we
 /// may overestimate and if low cardinality keys appear first, we underestimate.
-/// To estimate the eventual reduction achieved, we estimate the final reduction
-/// using the planner's estimated input cardinality and the assumption that input
-/// is in a random order. This means that we assume that the reduction factor will
-/// increase over time.
-struct StreamingHtMinReductionEntry {
-    // Use 'streaming_ht_min_reduction' if the total size of hash table bucket directories in
-    // bytes is greater than this threshold.
-    int min_ht_mem;
-    // The minimum reduction factor to expand the hash tables.
-    double streaming_ht_min_reduction;
-};
-
-// TODO: experimentally tune these values and also programmatically get the cache size
-// of the machine that we're running on.
-static constexpr StreamingHtMinReductionEntry STREAMING_HT_MIN_REDUCTION[] = {
-        // Expand up to L2 cache always.
-        {0, 0.0},
-        // Expand into L3 cache if we look like we're getting some reduction.
-        // At present, The L2 cache is generally 1024k or more
-        {1024 * 1024, 1.1},
+/// Only the reduction since the aggregation (re)started is considered, so a change in
+/// the locality of the input is noticed quickly instead of being averaged away.
+double StreamingAggReductionTracker::_min_reduction(size_t ht_mem) const {
+    if (ht_mem >= _l3_cache_size) {
         // Expand into main memory if we're getting a significant reduction.
-        // The L3 cache is generally 16MB or more
-        {16 * 1024 * 1024, 2.0},
-};
+        return 2.0;
+    }
+    if (ht_mem >= _l2_cache_size) {
+        // Expand into L3 cache if we look like we're getting some reduction.
+        return 1.1;
+    }
+    // Expand up to L2 cache always.
+    return 0.0;
+}
+
+double StreamingAggReductionTracker::_sample_reduction(const ColumnRawPtrs& key_columns,
+                                                       size_t rows) {
+    if (rows == 0) {
+        return 0.0;
+    }
+    std::vector<uint64_t> hashes(rows, 0);
+    for (const auto* column : key_columns) {
+        column->update_hashes_with_value(hashes.data(), nullptr);
+    }
+    std::sort(hashes.begin(), hashes.end());
+    const size_t distinct_rows = std::unique(hashes.begin(), hashes.end()) - hashes.begin();
+    return static_cast<double>(rows) / distinct_rows;
+}
+
+bool StreamingAggReductionTracker::should_expand(const ColumnRawPtrs& key_columns, size_t rows,
+                                                 size_t ht_mem, size_t ht_rows) {
+    if (!_expanding) {
+        const int64_t sample_interval = config::streaming_agg_sample_interval;
+        if (sample_interval <= 0 || ++_passed_blocks % sample_interval != 0) {
+            return false;
+        }
+        // The reduction of one block on its own underestimates the reduction of the hash
+        // table, so it is safe to grow the table again once the block alone is reduced enough.
+        if (_sample_reduction(key_columns, rows) <= _min_reduction(ht_mem)) {
+            return false;
+        }
+        _expanding = true;
+        _aggregated_rows = 0;
+        _start_ht_rows = ht_rows;
+        return true;
+    }
 
-static constexpr int STREAMING_HT_MIN_REDUCTION_SIZE =
-        sizeof(STREAMING_HT_MIN_REDUCTION) / sizeof(STREAMING_HT_MIN_REDUCTION[0]);
+    // Need some rows in tables to have valid statistics.
+    if (ht_rows <= _start_ht_rows || _aggregated_rows == 0) {
+        return true;
+    }
+
+    // Compare the number of groups added to the hash table with the number of input rows
+    // that were aggregated into it since the aggregation (re)started, the reduction of the
+    // earlier input says little about the current locality of the keys.
+    const double current_reduction =
+            static_cast<double>(_aggregated_rows) / (ht_rows - _start_ht_rows);
+    _expanding = current_reduction > _min_reduction(ht_mem);
+    _passed_blocks = 0;
+    return _expanding;
+}
 
 AggregationNode::AggregationNode(ObjectPool* pool, const TPlanNode& tnode,
                                  const DescriptorTbl& descs)
@@ -772,61 +822,13 @@ void AggregationNode::_make_nullable_output_key(Block* block) {
     }
 }
 
-bool AggregationNode::_should_expand_preagg_hash_tables() {
-    if (!_should_expand_hash_table) {
-        return false;
-    }
-
+bool AggregationNode::_should_expand_preagg_hash_tables(const ColumnRawPtrs& key_columns,
+                                                        size_t rows) {
     return std::visit(
             [&](auto&& agg_method) -> bool {
                 auto& hash_tbl = agg_method.data;
-                auto [ht_mem, ht_rows] =
-                        std::pair {hash_tbl.get_buffer_size_in_bytes(), hash_tbl.size()};
-
-                // Need some rows in tables to have valid statistics.
-                if (ht_rows == 0) {
-                    return true;
-                }
-
-                // Find the appropriate reduction factor in our table for the current hash table sizes.
-                int cache_level = 0;
-                while (cache_level + 1 < STREAMING_HT_MIN_REDUCTION_SIZE &&
-                       ht_mem >= STREAMING_HT_MIN_REDUCTION[cache_level + 1].min_ht_mem) {
-                    ++cache_level;
-                }
-
-                // Compare the number of rows in the hash table with the number of input rows that
-                // were aggregated into it. Exclude passed through rows from this calculation since
-                // they were not in hash tables.
-                const int64_t input_rows = _children[0]->rows_returned();
-                const int64_t aggregated_input_rows = input_rows - _num_rows_returned;
-                // TODO chenhao
-                //  const int64_t expected_input_rows = estimated_input_cardinality_ - num_rows_returned_;
-                double current_reduction = static_cast<double>(aggregated_input_rows) / ht_rows;
-
-                // TODO: workaround for IMPALA-2490: subplan node rows_returned counter may be
-                // inaccurate, which could lead to a divide by zero below.
-                if (aggregated_input_rows <= 0) {
-                    return true;
-                }
-
-                // Extrapolate the current reduction factor (r) using the formula
-                // R = 1 + (N / n) * (r - 1), where R is the reduction factor over the full input data
-                // set, N is the number of input rows, excluding passed-through rows, and n is the
-                // number of rows inserted or merged into the hash tables. This is a very rough
-                // approximation but is good enough to be useful.
-                // TODO: consider collecting more statistics to better estimate reduction.
-                //  double estimated_reduction = aggregated_input_rows >= expected_input_rows
-                //      ? current_reduction
-                //      : 1 + (expected_input_rows / aggregated_input_rows) * (current_reduction - 1);
-                double min_reduction =
-                        STREAMING_HT_MIN_REDUCTION[cache_level].streaming_ht_min_reduction;
-
-                //  COUNTER_SET(preagg_estimated_reduction_, estimated_reduction);
-                //    COUNTER_SET(preagg_streaming_ht_min_reduction_, min_reduction);
-                //  return estimated_reduction > min_reduction;
-                _should_expand_hash_table = current_reduction > min_reduction;
-                return _should_expand_hash_table;
+                return _reduction_tracker.should_expand(
+                        key_columns, rows, hash_tbl.get_buffer_size_in_bytes(), hash_tbl.size());
             },
             _agg_data->method_variant);
 }
@@ -954,6 +956,13 @@ void AggregationNode::_emplace_into_hash_table(AggregateDataPtr* places, ColumnR
                 } else {
                     SCOPED_TIMER(_hash_table_emplace_timer);
                     for (size_t i = 0; i < num_rows; ++i) {
+                        if constexpr (HashTableTraits<HashTableType>::is_string_hash_table) {
+                            if (LIKELY(i + HASH_MAP_PREFETCH_DIST < num_rows)) {
+                                state.template prefetch_key<false>(
+                                        agg_method.data, i + HASH_MAP_PREFETCH_DIST,
+                                        *_agg_arena_pool);
+                            }
+                        }
                         AggregateDataPtr mapped = nullptr;
                         if constexpr (ColumnsHashing::IsSingleNullableColumnMethod<
                                               AggState>::value) {
@@ -1002,6 +1011,13 @@ void AggregationNode::_find_in_hash_table(AggregateDataPtr* places, ColumnRawPtr
                             return state.find_key_with_hash(agg_method.data, _hash_values[i],
                                                             keys[i]);
                         } else {
+                            if constexpr (HashTableTraits<HashTableType>::is_string_hash_table) {
+                                if (LIKELY(i + HASH_MAP_PREFETCH_DIST < num_rows)) {
+                                    state.template prefetch_key<true>(
+                                            agg_method.data, i + HASH_MAP_PREFETCH_DIST,
+                                            *_agg_arena_pool);
+                                }
+                            }
                             return state.find_key(agg_method.data, i, *_agg_arena_pool);
                         }
                     }();
@@ -1056,7 +1072,8 @@ Status AggregationNode::_pre_agg_with_serialized_key(doris::vectorized::Block* i
                             (_external_agg_bytes_threshold > 0 &&
                              _memory_usage() > _external_agg_bytes_threshold);
                     // do not try to do agg, just init and serialize directly return the out_block
-                    if (!_should_expand_preagg_hash_tables() || used_too_much_memory) {
+                    if (used_too_much_memory ||
+                        !_should_expand_preagg_hash_tables(key_columns, rows)) {
                         SCOPED_TIMER(_streaming_agg_timer);
                         ret_flag = true;
 
@@ -1123,8 +1140,9 @@ Status AggregationNode::_pre_agg_with_serialized_key(doris::vectorized::Block* i
         for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
             RETURN_IF_ERROR(_aggregate_evaluators[i]->execute_batch_add(
                     in_block, _offsets_of_aggregate_states[i], _places.data(),
-                    _agg_arena_pool.get(), _should_expand_hash_table));
+                    _agg_arena_pool.get(), _reduction_tracker.is_expanding()));
         }
+        _reduction_tracker.add_aggregated_rows(rows);
     }
 
     return Status::OK();
@@ -1359,13 +1377,132 @@ Status AggregationNode::_get_result_with_spilt_data(RuntimeState* state, Block*
     return Status::OK();
 }
 
+Status finalize_aggregate_results_in_parallel(RuntimeState* state,
+                                              AggregatedDataVariants* agg_data,
+                                              AggregateDataContainer* container,
+                                              const RowDescriptor& row_desc,
+                                              const std::vector<AggFnEvaluator*>& evaluators,
+                                              const Sizes& offsets_of_aggregate_states,
+                                              const Sizes& probe_key_sz, int parallelism,
+                                              std::deque<Block>* blocks) {
+    container->init_once();
+    auto& iter = container->iterator;
+    const size_t batch_size = state->batch_size();
+    const size_t begin = iter.get_index();
+    const size_t remaining = container->end().get_index() - begin;
+    const size_t num_batches =
+            std::min<size_t>(std::max(parallelism, 1), (remaining + batch_size - 1) / batch_size);
+    if (num_batches <= 1) {
+        return Status::OK();
+    }
+
+    std::vector<Block> batch_blocks(num_batches);
+    std::vector<Status> statuses(num_batches);
+    std::visit(
+            [&](auto&& agg_method) -> void {
+                using KeyType = std::decay_t<decltype(agg_method.iterator->get_first())>;
+                auto finalize_batch = [&](size_t batch) {
+                    const size_t batch_begin = begin + batch * batch_size;
+                    const size_t num_rows = std::min(batch_size, begin + remaining - batch_begin);
+                    std::vector<KeyType> keys(num_rows);
+                    std::vector<AggregateDataPtr> values(num_rows);
+                    AggregateDataContainer::Iterator batch_iter(container, batch_begin);
+                    for (size_t i = 0; i < num_rows; ++i, ++batch_iter) {
+                        keys[i] = batch_iter.template get_key<KeyType>();
+                        values[i] = batch_iter.get_aggregate_data();
+                    }
+
+                    auto columns_with_schema =
+                            VectorizedUtils::create_columns_with_type_and_name(row_desc);
+                    MutableColumns columns;
+                    for (const auto& column_with_schema : columns_with_schema) {
+                        columns.emplace_back(column_with_schema.type->create_column());
+                    }
+                    MutableColumns key_columns;
+                    MutableColumns value_columns;
+                    for (size_t i = 0; i < columns.size(); ++i) {
+                        (i < probe_key_sz.size() ? key_columns : value_columns)
+                                .emplace_back(std::move(columns[i]));
+                    }
+                    statuses[batch] = [&]() -> Status {
+                        RETURN_IF_CATCH_EXCEPTION({
+                            agg_method.insert_keys_into_columns(keys, key_columns, num_rows,
+                                                                probe_key_sz);
+                            for (size_t i = 0; i < evaluators.size(); ++i) {
+                                evaluators[i]->insert_result_info_vec(
+                                        values, offsets_of_aggregate_states[i],
+                                        value_columns[i].get(), num_rows);
+                            }
+                        });
+                        return Status::OK();
+                    }();
+
+                    columns.clear();
+                    for (auto& column : key_columns) {
+                        columns.emplace_back(std::move(column));
+                    }
+                    for (auto& column : value_columns) {
+                        columns.emplace_back(std::move(column));
+                    }
+                    batch_blocks[batch] = columns_with_schema;
+                    batch_blocks[batch].set_columns(std::move(columns));
+                };
+
+                // the first batch is finalized by the current thread, which is already
+                // attached to the query, the others by the threads of the pool.
+                auto* thread_pool = ExecEnv::GetInstance()->agg_finalize_thread_pool();
+                CountDownLatch latch(num_batches - 1);
+                for (size_t batch = 1; batch < num_batches; ++batch) {
+                    Status st = Status::InternalError("no thread pool to finalize aggregation");
+                    if (thread_pool != nullptr) {
+                        st = thread_pool->submit_func([&, batch] {
+                            Defer defer {[&]() { latch.count_down(); }};
+                            SCOPED_ATTACH_TASK(state);
+                            finalize_batch(batch);
+                        });
+                    }
+                    if (!st.ok()) {
+                        finalize_batch(batch);
+                        latch.count_down();
+                    }
+                }
+                finalize_batch(0);
+                latch.wait();
+            },
+            agg_data->method_variant);
+
+    for (const auto& st : statuses) {
+        RETURN_IF_ERROR(st);
+    }
+    iter = AggregateDataContainer::Iterator(
+            container, begin + std::min(remaining, num_batches * batch_size));
+    for (auto& batch_block : batch_blocks) {
+        blocks->emplace_back(std::move(batch_block));
+    }
+    return Status::OK();
+}
+
 Status AggregationNode::_get_with_serialized_key_result(RuntimeState* state, Block* block,
                                                         bool* eos) {
     if (_spill_context.has_data) {
         return _get_result_with_spilt_data(state, block, eos);
-    } else {
-        return _get_result_with_serialized_key_non_spill(state, block, eos);
     }
+    if (config::agg_finalize_parallelism > 1) {
+        if (_finalized_blocks.empty()) {
+            SCOPED_TIMER(_get_results_timer);
+            RETURN_IF_ERROR(finalize_aggregate_results_in_parallel(
+                    state, _agg_data.get(), _aggregate_data_container.get(), _row_descriptor,
+                    _aggregate_evaluators, _offsets_of_aggregate_states, _probe_key_sz,
+                    config::agg_finalize_parallelism, &_finalized_blocks));
+        }
+        if (!_finalized_blocks.empty()) {
+            block->swap(_finalized_blocks.front());
+            _finalized_blocks.pop_front();
+            return Status::OK();
+        }
+    }
+    // the last batch and the null key
+    return _get_result_with_serialized_key_non_spill(state, block, eos);
 }
 
 Status AggregationNode::_get_result_with_serialized_key_non_spill(RuntimeState* state, Block* block,
@@ -23,6 +23,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <ostream>
@@ -621,6 +622,8 @@ public:
         bool operator==(const IteratorBase& rhs) const { return index == rhs.index; }
         bool operator!=(const IteratorBase& rhs) const { return index != rhs.index; }
 
+        uint32_t get_index() const { return index; }
+
         Derived& operator++() {
             index++;
             index_in_sub_container++;
@@ -736,6 +739,57 @@ struct SpillPartitionHelper {
     }
 };
 
+// Finalize the groups after the current position of the container concurrently, the groups
+// are split into batches of batch size, up to `parallelism` batches are finalized by the
+// threads of AggFinalizeThreadPool, each into its own block appended to `blocks` in order.
+// The iterator of the container is moved past the finalized groups. Nothing is finalized if
+// the remaining groups fit in one batch, the caller finalizes them (and the null key) itself.
+Status finalize_aggregate_results_in_parallel(RuntimeState* state,
+                                              AggregatedDataVariants* agg_data,
+                                              AggregateDataContainer* container,
+                                              const RowDescriptor& row_desc,
+                                              const std::vector<AggFnEvaluator*>& evaluators,
+                                              const Sizes& offsets_of_aggregate_states,
+                                              const Sizes& probe_key_sz, int parallelism,
+                                              std::deque<Block>* blocks);
+
+// Decides whether a streaming pre-aggregation keeps growing its hash table or passes the rows
+// which do not fit in the table through. The table only grows out of a level of the cache
+// hierarchy if the reduction achieved since the aggregation (re)started outweighs the slower
+// lookups. While passing rows through, the keys of one block out of
+// `streaming_agg_sample_interval` are sampled and the aggregation resumes once they repeat
+// enough, so near unique keys are streamed while repeated keys are still reduced.
+class StreamingAggReductionTracker {
+public:
+    StreamingAggReductionTracker();
+
+    // Return true if the hash table of `ht_mem` bytes holding `ht_rows` groups should grow to
+    // aggregate the `rows` rows of `key_columns`, false if the rows should be passed through.
+    bool should_expand(const ColumnRawPtrs& key_columns, size_t rows, size_t ht_mem,
+                       size_t ht_rows);
+
+    // Record the rows aggregated into the hash table.
+    void add_aggregated_rows(size_t rows) { _aggregated_rows += rows; }
+
+    bool is_expanding() const { return _expanding; }
+
+private:
+    double _min_reduction(size_t ht_mem) const;
+
+    // the reduction factor of aggregating the rows of one block on their own
+    static double _sample_reduction(const ColumnRawPtrs& key_columns, size_t rows);
+
+    size_t _l2_cache_size;
+    size_t _l3_cache_size;
+
+    bool _expanding = true;
+    // the aggregated rows and the groups in the hash table when the aggregation (re)started
+    size_t _aggregated_rows = 0;
+    size_t _start_ht_rows = 0;
+    // blocks passed through since the aggregation stopped
+    int64_t _passed_blocks = 0;
+};
+
 // not support spill
 class AggregationNode : public ::doris::ExecNode {
 public:
@@ -778,6 +832,7 @@ protected:
     RuntimeProfile::Counter* _build_timer;
     RuntimeProfile::Counter* _expr_timer;
     RuntimeProfile::Counter* _exec_timer;
+    StreamingAggReductionTracker _reduction_tracker;
 
 private:
     friend class pipeline::AggSinkOperator;
@@ -828,7 +883,6 @@ private:
     RuntimeProfile::Counter* _hash_table_memory_usage;
     RuntimeProfile::HighWaterMarkCounter* _serialize_key_arena_memory_usage;
 
-    bool _should_expand_hash_table = true;
     bool _should_limit_output = false;
     bool _reach_limit = false;
     bool _agg_data_created_without_key = false;
@@ -837,11 +891,10 @@ private:
     std::vector<char> _deserialize_buffer;
     std::vector<AggregateDataPtr> _values;
     std::unique_ptr<AggregateDataContainer> _aggregate_data_container;
+    // the result blocks finalized ahead by finalize_aggregate_results_in_parallel
+    std::deque<Block> _finalized_blocks;
 
     void _release_self_resource(RuntimeState* state);
-    /// Return true if we should keep expanding hash tables in the preagg. If false,
-    /// the preagg should pass through any rows it can't fit in its tables.
-    bool _should_expand_preagg_hash_tables();
 
     size_t _get_hash_table_size();
 
@@ -876,6 +929,10 @@ private:
     void _init_hash_method(const VExprContextSPtrs& probe_exprs);
 
 protected:
+    /// Return true if we should keep expanding hash tables in the preagg. If false,
+    /// the preagg should pass through any rows it can't fit in its tables.
+    bool _should_expand_preagg_hash_tables(const ColumnRawPtrs& key_columns, size_t rows);
+
     template <typename AggState, typename AggMethod>
     void _pre_serialize_key_if_need(AggState& state, AggMethod& agg_method,
                                     const ColumnRawPtrs& key_columns, const size_t num_rows) {
@@ -23,6 +23,7 @@
 #include <thrift/protocol/TDebugProtocol.h>
 
 #include <algorithm>
+#include <limits>
 #include <ostream>
 #include <utility>
 
@@ -30,10 +31,13 @@
 #include "common/compiler_util.h" // IWYU pragma: keep
 #include "common/exception.h"
 #include "common/logging.h"
+#include "runtime/block_spill_manager.h"
 #include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
 #include "runtime/memory/mem_tracker.h"
 #include "runtime/runtime_state.h"
 #include "util/telemetry/telemetry.h"
+#include "vec/columns/column_const.h"
 #include "vec/columns/column_nullable.h"
 #include "vec/core/column_with_type_and_name.h"
 #include "vec/data_types/data_type.h"
@@ -48,6 +52,114 @@ class ObjectPool;
 
 namespace doris::vectorized {
 
+void AnalyticBlockSpiller::init(int64_t bytes_threshold, RuntimeProfile* profile) {
+    _bytes_threshold = bytes_threshold;
+    _profile = profile;
+    _spill_stream_count = ADD_COUNTER(profile, "SpillStreamCount", TUnit::UNIT);
+    _spilled_block_count = ADD_COUNTER(profile, "SpilledBlockCount", TUnit::UNIT);
+    _spilled_bytes = ADD_COUNTER(profile, "SpilledBytes", TUnit::BYTES);
+    _spill_released_bytes = ADD_COUNTER(profile, "SpillReleasedBytes", TUnit::BYTES);
+}
+
+Status AnalyticBlockSpiller::spill(size_t block_idx, Block* block,
+                                   const std::vector<int64_t>& partition_by_column_idxs) {
+    DCHECK(_spilled_block_idxs.empty() || _spilled_block_idxs.back() < block_idx);
+    if (_writer == nullptr) {
+        // the blocks are always read back as a whole, so do not split them to sub blocks.
+        RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_writer(
+                std::numeric_limits<int32_t>::max(), _writer, _profile));
+        _writer_block_count = 0;
+        COUNTER_UPDATE(_spill_stream_count, 1);
+    }
+    size_t written_bytes = _writer->get_written_bytes();
+    RETURN_IF_ERROR(_writer->write(*block));
+    ++_writer_block_count;
+    _spilled_block_idxs.push_back(block_idx);
+    COUNTER_UPDATE(_spilled_block_count, 1);
+    COUNTER_UPDATE(_spilled_bytes, _writer->get_written_bytes() - written_bytes);
+
+    size_t rows = block->rows();
+    int64_t bytes = block->allocated_bytes();
+    for (int64_t i = 0; i < block->columns(); ++i) {
+        auto& column = block->get_by_position(i);
+        if (std::find(partition_by_column_idxs.begin(), partition_by_column_idxs.end(), i) !=
+            partition_by_column_idxs.end()) {
+            column.column = ColumnConst::create(unpack_if_const(column.column).first->cut(0, 1),
+                                                rows);
+        } else {
+            column.column = column.type->create_column_const_with_default_value(rows);
+        }
+    }
+    COUNTER_UPDATE(_spill_released_bytes, bytes - block->allocated_bytes());
+    return Status::OK();
+}
+
+Status AnalyticBlockSpiller::_finish_writing() {
+    if (_writer != nullptr) {
+        _streams.emplace_back(_writer->get_id(), _writer_block_count);
+        RETURN_IF_ERROR(_writer->close());
+        _writer.reset();
+    }
+    return Status::OK();
+}
+
+Status AnalyticBlockSpiller::restore(size_t block_idx, Block* block) {
+    if (!is_spilled(block_idx)) {
+        return Status::OK();
+    }
+    if (_spilled_block_idxs.front() != block_idx) {
+        return Status::InternalError("analytic block {} is restored before block {}", block_idx,
+                                     _spilled_block_idxs.front());
+    }
+    if (_reader == nullptr) {
+        if (_streams.empty()) {
+            // the partition being buffered is read back, so its end has been found and no more
+            // blocks are spilled to its stream.
+            RETURN_IF_ERROR(_finish_writing());
+        }
+        auto [stream_id, block_count] = _streams.front();
+        _streams.pop_front();
+        RETURN_IF_ERROR(ExecEnv::GetInstance()->block_spill_mgr()->get_reader(stream_id, _reader,
+                                                                              _profile));
+        _reader_block_count = block_count;
+    }
+    _spilled_block_idxs.pop_front();
+    bool eos = false;
+    RETURN_IF_ERROR(_reader->read(block, &eos));
+    if (--_reader_block_count == 0) {
+        RETURN_IF_ERROR(_reader->close());
+        _reader.reset();
+    }
+    return Status::OK();
+}
+
+int AnalyticBlockSpiller::compare_at(const ColumnPtr& lhs, size_t n, const ColumnPtr& rhs,
+                                     size_t m) {
+    auto [lhs_data, lhs_is_const] = unpack_if_const(lhs);
+    auto [rhs_data, rhs_is_const] = unpack_if_const(rhs);
+    return lhs_data->compare_at(index_check_const(n, lhs_is_const),
+                                index_check_const(m, rhs_is_const), *rhs_data, 1);
+}
+
+void AnalyticBlockSpiller::close() {
+    if (_writer != nullptr) {
+        static_cast<void>(_finish_writing());
+    }
+    if (_reader != nullptr) {
+        static_cast<void>(_reader->close());
+        _reader.reset();
+    }
+    auto* manager = ExecEnv::GetInstance()->block_spill_mgr();
+    for (auto [stream_id, block_count] : _streams) {
+        BlockSpillReaderUPtr reader;
+        if (manager->get_reader(stream_id, reader, _profile).ok()) {
+            static_cast<void>(reader->close());
+        }
+    }
+    _streams.clear();
+    _spilled_block_idxs.clear();
+}
+
 VAnalyticEvalNode::VAnalyticEvalNode(ObjectPool* pool, const TPlanNode& tnode,
                                      const DescriptorTbl& descs)
         : ExecNode(pool, tnode, descs),
@@ -116,6 +228,8 @@ VAnalyticEvalNode::VAnalyticEvalNode(ObjectPool* pool, const TPlanNode& tnode,
             }
 
             _fn_scope = AnalyticFnScope::ROWS;
+            // the frame of every row is bounded, e.g. [1 preceding, 1 following]
+            _spill_agg_input = _window.__isset.window_start && _window.__isset.window_end;
             _executor.get_next = std::bind<Status>(&VAnalyticEvalNode::_get_next_for_rows, this,
                                                    std::placeholders::_1);
         }
@@ -131,11 +245,13 @@ Status VAnalyticEvalNode::init(const TPlanNode& tnode, RuntimeState* state) {
     size_t agg_size = analytic_node.analytic_functions.size();
     _agg_expr_ctxs.resize(agg_size);
     _agg_intput_columns.resize(agg_size);
+    _agg_input_column_idxs.resize(agg_size);
 
     for (int i = 0; i < agg_size; ++i) {
         const TExpr& desc = analytic_node.analytic_functions[i];
         int node_idx = 0;
         _agg_intput_columns[i].resize(desc.nodes[0].num_children);
+        _agg_input_column_idxs[i].resize(desc.nodes[0].num_children);
         for (int j = 0; j < desc.nodes[0].num_children; ++j) {
             ++node_idx;
             VExprSPtr expr;
@@ -172,6 +288,7 @@ Status VAnalyticEvalNode::prepare(RuntimeState* state) {
             runtime_profile()->AddHighWaterMarkCounter("Blocks", TUnit::BYTES, "MemoryUsage");
     _evaluation_timer = ADD_TIMER(runtime_profile(), "EvaluationTime");
     SCOPED_TIMER(_evaluation_timer);
+    _block_spiller.init(state->external_analytic_bytes_threshold(), runtime_profile());
 
     _intermediate_tuple_desc = state->desc_tbl().get_tuple_descriptor(_intermediate_tuple_id);
     _output_tuple_desc = state->desc_tbl().get_tuple_descriptor(_output_tuple_id);
@@ -277,8 +394,9 @@ Status VAnalyticEvalNode::pull(doris::RuntimeState* /*state*/, vectorized::Block
         }
         _next_partition = _init_next_partition(_found_partition_end);
         _init_result_columns();
+        RETURN_IF_ERROR(_restore_blocks_for_frame());
         size_t current_block_rows = _input_blocks[_output_block_index].rows();
-        _executor.get_next(current_block_rows);
+        RETURN_IF_ERROR(_executor.get_next(current_block_rows));
         if (_window_end_position == current_block_rows) {
             break;
         }
@@ -329,6 +447,7 @@ Status VAnalyticEvalNode::get_next(RuntimeState* state, vectorized::Block* block
         if (*eos) {
             return Status::OK();
         }
+        RETURN_IF_ERROR(_restore_blocks_for_frame());
         size_t current_block_rows = _input_blocks[_output_block_index].rows();
         RETURN_IF_ERROR(_executor.get_next(current_block_rows));
         if (_window_end_position == current_block_rows) {
@@ -354,7 +473,7 @@ Status VAnalyticEvalNode::_get_next_for_range(size_t current_block_rows) {
     while (_current_row_position < _partition_by_end.pos &&
            _window_end_position < current_block_rows) {
         if (_current_row_position >= _order_by_end.pos) {
-            _update_order_by_range();
+            RETURN_IF_ERROR(_update_order_by_range());
             _executor.execute(_order_by_start.pos, _order_by_end.pos, _order_by_start.pos,
                               _order_by_end.pos);
         }
@@ -458,7 +577,8 @@ BlockRowPos VAnalyticEvalNode::_compare_row_to_find_end(int idx, BlockRowPos sta
         mid_blcok_num = (start_block_num + end_block_num + 1) >> 1;
         start_next_block_column = _input_blocks[mid_blcok_num].get_by_position(idx).column;
         //Compares (*this)[n] and rhs[m], this: start[init_row]  rhs: mid[0]
-        if (start_column->compare_at(start_init_row_num, 0, *start_next_block_column, 1) == 0) {
+        if (AnalyticBlockSpiller::compare_at(start_column, start_init_row_num,
+                                             start_next_block_column, 0) == 0) {
             start_block_num = mid_blcok_num;
         } else {
             end_block_num = mid_blcok_num - 1;
@@ -470,8 +590,8 @@ BlockRowPos VAnalyticEvalNode::_compare_row_to_find_end(int idx, BlockRowPos sta
     if (end_block_num == mid_blcok_num - 1) {
         start_next_block_column = _input_blocks[end_block_num].get_by_position(idx).column;
         int64_t block_size = _input_blocks[end_block_num].rows();
-        if ((start_column->compare_at(start_init_row_num, block_size - 1, *start_next_block_column,
-                                      1) == 0)) {
+        if (AnalyticBlockSpiller::compare_at(start_column, start_init_row_num,
+                                             start_next_block_column, block_size - 1) == 0) {
             start.block_num = end_block_num + 1;
             start.row_num = 0;
             return start;
@@ -495,7 +615,8 @@ BlockRowPos VAnalyticEvalNode::_compare_row_to_find_end(int idx, BlockRowPos sta
     }
     while (start_pos < end_pos) {
         int64_t mid_pos = (start_pos + end_pos) >> 1;
-        if (start_column->compare_at(start_init_row_num, mid_pos, *start_column, 1)) {
+        if (AnalyticBlockSpiller::compare_at(start_column, start_init_row_num, start_column,
+                                             mid_pos)) {
             end_pos = mid_pos;
         } else {
             start_pos = mid_pos + 1;
@@ -560,14 +681,15 @@ Status VAnalyticEvalNode::sink(doris::RuntimeState* /*state*/, vectorized::Block
         }
     }
 
-    for (size_t i = 0; i < _agg_functions_size;
-         ++i) { //insert _agg_intput_columns, execute calculate for its
+    //record column idx in block
+    for (size_t i = 0; i < _agg_functions_size; ++i) {
         for (size_t j = 0; j < _agg_expr_ctxs[i].size(); ++j) {
-            RETURN_IF_ERROR(_insert_range_column(input_block, _agg_expr_ctxs[i][j],
-                                                 _agg_intput_columns[i][j].get(), block_rows));
+            int result_col_id = -1;
+            RETURN_IF_ERROR(_agg_expr_ctxs[i][j]->execute(input_block, &result_col_id));
+            DCHECK_GE(result_col_id, 0);
+            _agg_input_column_idxs[i][j] = result_col_id;
         }
     }
-    //record column idx in block
     for (size_t i = 0; i < _partition_by_eq_expr_ctxs.size(); ++i) {
         int result_col_id = -1;
         RETURN_IF_ERROR(_partition_by_eq_expr_ctxs[i]->execute(input_block, &result_col_id));
@@ -590,20 +712,94 @@ Status VAnalyticEvalNode::sink(doris::RuntimeState* /*state*/, vectorized::Block
     _input_blocks.emplace_back(std::move(*input_block));
     _found_partition_end = _get_partition_by_end();
     _need_more_input = whether_need_next_partition(_found_partition_end);
+    return _spill_input_block_if_needed();
+}
+
+Status VAnalyticEvalNode::_spill_input_block_if_needed() {
+    size_t block_idx = _input_blocks.size() - 1;
+    // only the blocks after the start of the partition whose end is not found yet are spilled,
+    // so all their rows are in this partition.
+    bool spill = _need_more_input && block_idx > _partition_by_end.block_num &&
+                 _block_spiller.need_spill(_blocks_memory_usage->current_value());
+    if (_agg_input_end_block == block_idx && !(spill && _spill_agg_input)) {
+        _append_agg_input(_input_blocks[block_idx]);
+    }
+    if (!spill) {
+        return Status::OK();
+    }
+    auto& block = _input_blocks[block_idx];
+    int64_t bytes = block.allocated_bytes();
+    RETURN_IF_ERROR(_block_spiller.spill(block_idx, &block, _partition_by_column_idxs));
+    int64_t released_bytes = bytes - block.allocated_bytes();
+    mem_tracker()->consume(-released_bytes);
+    _blocks_memory_usage->add(-released_bytes);
+    return Status::OK();
+}
+
+Status VAnalyticEvalNode::_restore_block(size_t block_idx) {
+    if (!_block_spiller.is_spilled(block_idx)) {
+        return Status::OK();
+    }
+    auto& block = _input_blocks[block_idx];
+    int64_t bytes = block.allocated_bytes();
+    RETURN_IF_ERROR(_block_spiller.restore(block_idx, &block));
+    mem_tracker()->consume(block.allocated_bytes() - bytes);
+    _blocks_memory_usage->add(block.allocated_bytes() - bytes);
     return Status::OK();
 }
 
-Status VAnalyticEvalNode::_insert_range_column(vectorized::Block* block,
-                                               const VExprContextSPtr& expr, IColumn* dst_column,
-                                               size_t length) {
-    int result_col_id = -1;
-    RETURN_IF_ERROR(expr->execute(block, &result_col_id));
-    DCHECK_GE(result_col_id, 0);
-    auto column = block->get_by_position(result_col_id).column->convert_to_full_column_if_const();
-    dst_column->insert_range_from(*column, 0, length);
+// Read back the output block, and if the agg input of spilled blocks is spilled too, the
+// blocks up to the end of the frame of its last row, then drop the agg input before the frame
+// of the current row.
+Status VAnalyticEvalNode::_restore_blocks_for_frame() {
+    RETURN_IF_ERROR(_restore_block(_output_block_index));
+    if (!_spill_agg_input) {
+        return Status::OK();
+    }
+    int64_t block_end = input_block_first_row_positions[_output_block_index] +
+                        _input_blocks[_output_block_index].rows();
+    int64_t frame_end = std::min<int64_t>(_partition_by_end.pos,
+                                          block_end + std::max<int64_t>(_rows_end_offset, 0));
+    while (_agg_input_end_block < _input_blocks.size() &&
+           input_block_first_row_positions[_agg_input_end_block] < frame_end) {
+        RETURN_IF_ERROR(_restore_block(_agg_input_end_block));
+        _append_agg_input(_input_blocks[_agg_input_end_block]);
+    }
+    _trim_agg_input(std::max(_partition_by_start.pos, _current_row_position + _rows_start_offset));
     return Status::OK();
 }
 
+void VAnalyticEvalNode::_append_agg_input(const Block& block) {
+    for (size_t i = 0; i < _agg_functions_size; ++i) {
+        for (size_t j = 0; j < _agg_input_column_idxs[i].size(); ++j) {
+            auto column = block.get_by_position(_agg_input_column_idxs[i][j])
+                                  .column->convert_to_full_column_if_const();
+            _agg_intput_columns[i][j]->insert_range_from(*column, 0, block.rows());
+        }
+    }
+    ++_agg_input_end_block;
+}
+
+// Drop the agg input of the rows before pos once they are at least as many as the rows kept,
+// so every row is copied at most once on average.
+void VAnalyticEvalNode::_trim_agg_input(int64_t pos) {
+    int64_t end_pos = _agg_input_end_block < input_block_first_row_positions.size()
+                              ? input_block_first_row_positions[_agg_input_end_block]
+                              : _input_total_rows;
+    pos = std::min(pos, end_pos);
+    int64_t dropped_rows = pos - _agg_input_start_pos;
+    int64_t kept_rows = end_pos - pos;
+    if (dropped_rows <= 0 || dropped_rows < kept_rows) {
+        return;
+    }
+    for (auto& columns : _agg_intput_columns) {
+        for (auto& column : columns) {
+            column = column->cut(dropped_rows, kept_rows)->assume_mutable();
+        }
+    }
+    _agg_input_start_pos = pos;
+}
+
 //calculate pos have arrive partition end, so it's needed to init next partition, and update the boundary of partition
 bool VAnalyticEvalNode::_init_next_partition(BlockRowPos found_partition_end) {
     if ((_current_row_position >= _partition_by_end.pos) &&
@@ -612,6 +808,7 @@ bool VAnalyticEvalNode::_init_next_partition(BlockRowPos found_partition_end) {
         _partition_by_end = found_partition_end;
         _current_row_position = _partition_by_start.pos;
         _reset_agg_status();
+        _trim_agg_input(_partition_by_start.pos);
         return true;
     }
     return false;
@@ -644,9 +841,11 @@ void VAnalyticEvalNode::_insert_result_info(int64_t current_block_rows) {
 }
 
 Status VAnalyticEvalNode::_output_current_block(Block* block) {
-    block->swap(std::move(_input_blocks[_output_block_index]));
-    _blocks_memory_usage->add(-block->allocated_bytes());
-    mem_tracker()->consume(-block->allocated_bytes());
+    RETURN_IF_ERROR(_restore_block(_output_block_index));
+    auto& input_block = _input_blocks[_output_block_index];
+    _blocks_memory_usage->add(-input_block.allocated_bytes());
+    mem_tracker()->consume(-input_block.allocated_bytes());
+    block->swap(std::move(input_block));
     if (_origin_cols.size() < block->columns()) {
         block->erase_not_in(_origin_cols);
     }
@@ -678,15 +877,41 @@ void VAnalyticEvalNode::_execute_for_win_func(int64_t partition_start, int64_t p
             _agg_columns.push_back(_agg_intput_columns[i][j].get());
         }
         _agg_functions[i]->function()->add_range_single_place(
-                partition_start, partition_end, frame_start, frame_end,
+                partition_start - _agg_input_start_pos, partition_end - _agg_input_start_pos,
+                frame_start - _agg_input_start_pos, frame_end - _agg_input_start_pos,
                 _fn_place_ptr + _offsets_of_aggregate_states[i], _agg_columns.data(), nullptr);
     }
 }
 
 //binary search for range to calculate peer group
-void VAnalyticEvalNode::_update_order_by_range() {
+Status VAnalyticEvalNode::_update_order_by_range() {
     _order_by_start = _order_by_end;
     _order_by_end = _partition_by_end;
+    // the peer group is searched in the blocks in memory, so read back the spilled blocks of
+    // the partition one by one as long as the peer group may extend to them.
+    for (size_t block_idx = _block_spiller.first_spilled_block();
+         block_idx < _input_blocks.size() &&
+         input_block_first_row_positions[block_idx] < _partition_by_end.pos;
+         block_idx = _block_spiller.first_spilled_block()) {
+        const auto& start_block = _input_blocks[_order_by_start.block_num];
+        const auto& prev_block = _input_blocks[block_idx - 1];
+        bool is_peer = true;
+        for (auto idx : _ordey_by_column_idxs) {
+            if (AnalyticBlockSpiller::compare_at(start_block.get_by_position(idx).column,
+                                                 _order_by_start.row_num,
+                                                 prev_block.get_by_position(idx).column,
+                                                 prev_block.rows() - 1) != 0) {
+                is_peer = false;
+                break;
+            }
+        }
+        if (!is_peer) {
+            _order_by_end.block_num = block_idx;
+            _order_by_end.row_num = 0;
+            break;
+        }
+        RETURN_IF_ERROR(_restore_block(block_idx));
+    }
     for (size_t i = 0; i < _order_by_eq_expr_ctxs.size(); ++i) {
         _order_by_end = _compare_row_to_find_end(_ordey_by_column_idxs[i], _order_by_start,
                                                  _order_by_end, true);
@@ -701,6 +926,7 @@ void VAnalyticEvalNode::_update_order_by_range() {
         _order_by_end.block_num++;
         _order_by_end.row_num = 0;
     }
+    return Status::OK();
 }
 
 Status VAnalyticEvalNode::_init_result_columns() {
@@ -796,6 +1022,7 @@ std::string VAnalyticEvalNode::debug_window_bound_string(TAnalyticWindowBoundary
 
 void VAnalyticEvalNode::_release_mem() {
     _agg_arena_pool = nullptr;
+    _block_spiller.close();
 
     std::vector<Block> tmp_input_blocks;
     _input_blocks.swap(tmp_input_blocks);
@@ -22,10 +22,14 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <atomic>
+#include <deque>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/global_types.h"
@@ -36,6 +40,8 @@
 #include "vec/columns/column.h"
 #include "vec/common/arena.h"
 #include "vec/core/block.h"
+#include "vec/core/block_spill_reader.h"
+#include "vec/core/block_spill_writer.h"
 #include "vec/data_types/data_type.h"
 #include "vec/exprs/vexpr_fwd.h"
 
@@ -65,6 +71,74 @@ struct BlockRowPos {
     }
 };
 
+// Pages the buffered input blocks of analytic node out to local disk once they exceed
+// the memory threshold, so the rows of a huge partition do not have to be kept in memory
+// while its end is searched.
+//
+// A partition is output only once its end is found, the blocks in the middle of the
+// partition being buffered are written as a whole to one spill stream, and read back from
+// it in the order they were added. A spilled block leaves a stand-in of the same rows and
+// columns which are all const: the partition by columns keep the value of the first row,
+// which is the value of all the rows, so the end of the partition can still be searched
+// across the stand-ins, the other columns must not be read until the block is restored.
+class AnalyticBlockSpiller {
+public:
+    AnalyticBlockSpiller() = default;
+
+    void init(int64_t bytes_threshold, RuntimeProfile* profile);
+
+    bool need_spill(int64_t buffered_bytes) const {
+        return _bytes_threshold > 0 && buffered_bytes >= _bytes_threshold;
+    }
+
+    // Spill the block_idx-th input block, whose rows all belong to the partition being
+    // buffered, and replace it with its stand-in.
+    Status spill(size_t block_idx, Block* block,
+                 const std::vector<int64_t>& partition_by_column_idxs);
+
+    bool is_spilled(size_t block_idx) const {
+        return std::binary_search(_spilled_block_idxs.begin(), _spilled_block_idxs.end(),
+                                  block_idx);
+    }
+
+    // The first block which is still spilled, SIZE_MAX if there is none.
+    size_t first_spilled_block() const {
+        return _spilled_block_idxs.empty() ? std::numeric_limits<size_t>::max()
+                                           : _spilled_block_idxs.front();
+    }
+
+    // Read the block_idx-th input block back if it was spilled, `block` is left unchanged
+    // otherwise. The spilled blocks must be read back in order.
+    Status restore(size_t block_idx, Block* block);
+
+    // Compares lhs[n] with rhs[m], either of them may be a column of a stand-in.
+    static int compare_at(const ColumnPtr& lhs, size_t n, const ColumnPtr& rhs, size_t m);
+
+    // Remove the files of blocks which were never output, e.g. limit reached or cancelled.
+    void close();
+
+private:
+    Status _finish_writing();
+
+    int64_t _bytes_threshold = 0;
+    RuntimeProfile* _profile = nullptr;
+    // the stream of the partition being buffered
+    BlockSpillWriterUPtr _writer;
+    size_t _writer_block_count = 0;
+    // the finished streams and their number of blocks, in order
+    std::deque<std::pair<int64_t, size_t>> _streams;
+    // the stream being read back
+    BlockSpillReaderUPtr _reader;
+    size_t _reader_block_count = 0;
+    // the blocks which are not read back yet, in order
+    std::deque<size_t> _spilled_block_idxs;
+
+    RuntimeProfile::Counter* _spill_stream_count = nullptr;
+    RuntimeProfile::Counter* _spilled_block_count = nullptr;
+    RuntimeProfile::Counter* _spilled_bytes = nullptr;
+    RuntimeProfile::Counter* _spill_released_bytes = nullptr;
+};
+
 class AggFnEvaluator;
 
 enum AnalyticFnScope { PARTITION, RANGE, ROWS };
@@ -102,10 +176,8 @@ private:
     Status _init_result_columns();
     Status _create_agg_status();
     Status _destroy_agg_status();
-    Status _insert_range_column(vectorized::Block* block, const VExprContextSPtr& expr,
-                                IColumn* dst_column, size_t length);
 
-    void _update_order_by_range();
+    Status _update_order_by_range();
     bool _init_next_partition(BlockRowPos found_partition_end);
     void _insert_result_info(int64_t current_block_rows);
     Status _output_current_block(Block* block);
@@ -135,14 +207,29 @@ private:
 
     void _release_mem();
 
+    Status _spill_input_block_if_needed();
+    Status _restore_block(size_t block_idx);
+    Status _restore_blocks_for_frame();
+    void _append_agg_input(const Block& block);
+    void _trim_agg_input(int64_t pos);
+
 private:
     std::vector<Block> _input_blocks;
+    AnalyticBlockSpiller _block_spiller;
     std::vector<int64_t> input_block_first_row_positions;
     std::vector<AggFnEvaluator*> _agg_functions;
     std::vector<VExprContextSPtrs> _agg_expr_ctxs;
     VExprContextSPtrs _partition_by_eq_expr_ctxs;
     VExprContextSPtrs _order_by_eq_expr_ctxs;
     std::vector<std::vector<MutableColumnPtr>> _agg_intput_columns;
+    std::vector<std::vector<int>> _agg_input_column_idxs;
+    // the position of the first row in _agg_intput_columns, the rows before it are trimmed
+    int64_t _agg_input_start_pos = 0;
+    // the rows of the input blocks before it are in _agg_intput_columns
+    size_t _agg_input_end_block = 0;
+    // whether the agg input of spilled blocks is spilled too, true if the frame of every row
+    // is bounded, so only the rows around the output block are needed
+    bool _spill_agg_input = false;
     std::vector<MutableColumnPtr> _result_window_columns;
 
     BlockRowPos _order_by_start;
@@ -29,6 +29,7 @@
 #include "common/logging.h"
 #include "pipeline/exec/exchange_sink_operator.h"
 #include "pipeline/exec/exchange_source_operator.h"
+#include "pipeline/task_scheduler.h"
 #include "runtime/memory/mem_tracker.h"
 #include "runtime/runtime_state.h"
 #include "runtime/thread_context.h"
@@ -187,6 +188,7 @@ Status VDataStreamRecvr::SenderQueue::add_block(const PBlock& pblock, int be_num
     _recvr->update_blocks_memory_usage(block_byte_size);
     if (!empty) {
         _data_arrival_cv.notify_one();
+        pipeline::BlockedTaskScheduler::wake_up();
     }
     return Status::OK();
 }
@@ -232,6 +234,7 @@ void VDataStreamRecvr::SenderQueue::add_block(Block* block, bool use_move) {
             _dependency->set_ready_for_read();
         }
         _data_arrival_cv.notify_one();
+        pipeline::BlockedTaskScheduler::wake_up();
     }
 
     // Careful: Accessing members of _recvr that are allocated by Object pool
@@ -270,6 +273,7 @@ void VDataStreamRecvr::SenderQueue::decrement_senders(int be_number) {
             _dependency->set_always_done();
         }
         _data_arrival_cv.notify_one();
+        pipeline::BlockedTaskScheduler::wake_up();
     }
 }
 
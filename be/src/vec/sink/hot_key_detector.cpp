@@ -0,0 +1,140 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/sink/hot_key_detector.h"
+
+#include <gen_cpp/Metrics_types.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "common/config.h"
+#include "util/pretty_printer.h"
+
+namespace doris::vectorized {
+
+void HotKeyDetector::init(size_t num_channels, RuntimeProfile* profile) {
+    _num_channels = num_channels;
+    _enabled = config::enable_exchange_hot_key_detection && num_channels > 1;
+    if (_enabled) {
+        _sketch.assign(SKETCH_DEPTH * SKETCH_WIDTH, 0);
+        _block_channel_rows.assign(num_channels, 0);
+        _channel_bytes.assign(num_channels, 0);
+    }
+    _profile = profile;
+    _hot_keys_counter = ADD_COUNTER(profile, "HotKeys", TUnit::UNIT);
+    _hot_key_rows_counter = ADD_COUNTER(profile, "HotKeyRows", TUnit::UNIT);
+}
+
+size_t HotKeyDetector::_index(uint64_t hash, int row) {
+    static constexpr uint64_t SEEDS[SKETCH_DEPTH] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+                                                     0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL};
+    return ((hash ^ SEEDS[row]) * 0x9e3779b97f4a7c15ULL) >> (64 - SKETCH_WIDTH_BITS);
+}
+
+uint64_t HotKeyDetector::_estimate(uint64_t hash) const {
+    uint32_t estimate = UINT32_MAX;
+    for (int row = 0; row < SKETCH_DEPTH; ++row) {
+        estimate = std::min(estimate, _sketch[row * SKETCH_WIDTH + _index(hash, row)]);
+    }
+    return estimate;
+}
+
+bool HotKeyDetector::_is_hot(uint64_t estimate) const {
+    // The estimation of a count-min sketch exceeds the real count by about
+    // sampled rows / sketch width, do not report keys hidden in that error.
+    const uint64_t min_share = std::min<uint64_t>(_num_channels, SKETCH_WIDTH / 4);
+    return _sampled_rows >= MIN_SAMPLED_ROWS && estimate * min_share > _sampled_rows;
+}
+
+void HotKeyDetector::_sample(uint64_t hash) {
+    uint32_t estimate = UINT32_MAX;
+    for (int row = 0; row < SKETCH_DEPTH; ++row) {
+        auto& counter = _sketch[row * SKETCH_WIDTH + _index(hash, row)];
+        estimate = std::min(estimate, ++counter);
+    }
+    ++_sampled_rows;
+    if (_hot_keys.size() < MAX_HOT_KEYS && _is_hot(estimate) && _hot_keys.insert(hash).second) {
+        COUNTER_UPDATE(_hot_keys_counter, 1);
+    }
+    if (_sampled_rows >= DECAY_SAMPLED_ROWS) {
+        _decay();
+    }
+}
+
+void HotKeyDetector::_decay() {
+    for (auto& counter : _sketch) {
+        counter >>= 1;
+    }
+    _sampled_rows >>= 1;
+    for (auto it = _hot_keys.begin(); it != _hot_keys.end();) {
+        if (_is_hot(_estimate(*it))) {
+            ++it;
+        } else {
+            _hot_keys.erase(it++);
+        }
+    }
+}
+
+void HotKeyDetector::assign_channels(uint64_t* __restrict hashes, int rows) {
+    if (_enabled) {
+        for (int i = 0; i < rows; i += SAMPLE_STRIDE) {
+            _sample(hashes[i]);
+        }
+    }
+    if (_hot_keys.empty()) {
+        for (int i = 0; i < rows; ++i) {
+            hashes[i] = hashes[i] % _num_channels;
+        }
+        return;
+    }
+
+    int64_t hot_key_rows = 0;
+    for (int i = 0; i < rows; ++i) {
+        hot_key_rows += _hot_keys.contains(hashes[i]);
+        hashes[i] = hashes[i] % _num_channels;
+    }
+    COUNTER_UPDATE(_hot_key_rows_counter, hot_key_rows);
+}
+
+void HotKeyDetector::update_channel_bytes(const uint64_t* __restrict channel_ids, int rows,
+                                          size_t block_bytes) {
+    if (!_enabled || rows == 0) {
+        return;
+    }
+    for (int i = 0; i < rows; ++i) {
+        ++_block_channel_rows[channel_ids[i]];
+    }
+    for (size_t i = 0; i < _num_channels; ++i) {
+        _channel_bytes[i] += block_bytes * _block_channel_rows[i] / rows;
+        _block_channel_rows[i] = 0;
+    }
+}
+
+void HotKeyDetector::close() {
+    if (!_enabled || _profile == nullptr) {
+        return;
+    }
+    std::stringstream ss;
+    for (size_t i = 0; i < _num_channels; ++i) {
+        ss << (i == 0 ? "" : ", ") << PrettyPrinter::print(_channel_bytes[i], TUnit::BYTES);
+    }
+    _profile->add_info_string("ChannelBytesSent", ss.str());
+    _profile = nullptr;
+}
+
+} // namespace doris::vectorized
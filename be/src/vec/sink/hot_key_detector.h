@@ -0,0 +1,90 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <parallel_hashmap/phmap.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "util/runtime_profile.h"
+
+namespace doris::vectorized {
+
+// Finds the partition keys of a hash partitioned exchange which alone take more than the fair
+// share of one channel and reports them in the profile, together with the bytes sent to each
+// channel. The rows of hot keys still go to the channel of their hash, spreading them needs
+// the planner to make the receivers tolerate it.
+//
+// One row out of SAMPLE_STRIDE is counted in a count-min sketch of the key hashes, a key is hot
+// once its estimated count exceeds the sampled rows divided by the number of channels. The
+// counters are halved periodically, so keys which cool down are forgotten.
+//
+// Not thread safe, each sender instance owns its detector.
+class HotKeyDetector {
+public:
+    HotKeyDetector() = default;
+
+    void init(size_t num_channels, RuntimeProfile* profile);
+
+    // Map the key hashes of `rows` rows to channel ids in place.
+    void assign_channels(uint64_t* __restrict hashes, int rows);
+
+    // Record the rows sent to each channel, `block_bytes` is the size of the sent columns.
+    void update_channel_bytes(const uint64_t* __restrict channel_ids, int rows,
+                              size_t block_bytes);
+
+    // Publish the bytes sent to each channel to the profile.
+    void close();
+
+    bool is_hot_key(uint64_t hash) const { return _hot_keys.contains(hash); }
+
+private:
+    static constexpr int SKETCH_DEPTH = 4;
+    static constexpr int SKETCH_WIDTH_BITS = 10;
+    static constexpr size_t SKETCH_WIDTH = 1 << SKETCH_WIDTH_BITS;
+    static constexpr int SAMPLE_STRIDE = 8;
+    // sampled rows needed before any key is reported hot
+    static constexpr uint64_t MIN_SAMPLED_ROWS = 1024;
+    // the counters are halved once this many rows are sampled
+    static constexpr uint64_t DECAY_SAMPLED_ROWS = 64 * 1024;
+    static constexpr size_t MAX_HOT_KEYS = 64;
+
+    static size_t _index(uint64_t hash, int row);
+    uint64_t _estimate(uint64_t hash) const;
+    bool _is_hot(uint64_t estimate) const;
+    void _sample(uint64_t hash);
+    void _decay();
+
+    bool _enabled = false;
+    size_t _num_channels = 0;
+
+    std::vector<uint32_t> _sketch;
+    uint64_t _sampled_rows = 0;
+    phmap::flat_hash_set<uint64_t> _hot_keys;
+
+    std::vector<uint32_t> _block_channel_rows;
+    std::vector<int64_t> _channel_bytes;
+
+    RuntimeProfile* _profile = nullptr;
+    RuntimeProfile::Counter* _hot_keys_counter = nullptr;
+    RuntimeProfile::Counter* _hot_key_rows_counter = nullptr;
+};
+
+} // namespace doris::vectorized
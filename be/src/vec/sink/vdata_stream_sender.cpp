@@ -459,6 +459,7 @@ Status VDataStreamSender::prepare(RuntimeState* state) {
     _local_sent_rows = ADD_COUNTER(profile(), "LocalSentRows", TUnit::UNIT);
     _serialize_batch_timer = ADD_TIMER(profile(), "SerializeBatchTime");
     _compress_timer = ADD_TIMER(profile(), "CompressTime");
+    _column_encoding_counters.init(profile());
     _brpc_send_timer = ADD_TIMER(profile(), "BrpcSendTime");
     _brpc_wait_timer = ADD_TIMER(profile(), "BrpcSendTime.Wait");
     _local_send_timer = ADD_TIMER(profile(), "LocalSendTime");
@@ -476,6 +477,9 @@ Status VDataStreamSender::prepare(RuntimeState* state) {
     _memory_usage_counter = ADD_LABEL_COUNTER(profile(), "MemoryUsage");
     _peak_memory_usage_counter =
             profile()->AddHighWaterMarkCounter("PeakMemoryUsage", TUnit::BYTES, "MemoryUsage");
+    if (_part_type == TPartitionType::HASH_PARTITIONED) {
+        _hot_key_detector.init(_channels.size(), profile());
+    }
     return Status::OK();
 }
 
@@ -643,14 +647,13 @@ Status VDataStreamSender::send(RuntimeState* state, Block* block, bool eos) {
                             .first->update_hashes_with_value(hashes);
                 }
 
-                for (int i = 0; i < rows; i++) {
-                    hashes[i] = hashes[i] % element_size;
-                }
+                _hot_key_detector.assign_channels(hashes, rows);
 
                 {
                     SCOPED_CONSUME_MEM_TRACKER(_mem_tracker.get());
                     Block::erase_useless_column(block, column_to_keep);
                 }
+                _hot_key_detector.update_channel_bytes(hashes, rows, block->bytes());
             } else {
                 for (int j = 0; j < result_size; ++j) {
                     // complex type most not implement get_data_at() method which column_const will call
@@ -741,6 +744,7 @@ Status VDataStreamSender::close(RuntimeState* state, Status exec_status) {
     if (_peak_memory_usage_counter) {
         _peak_memory_usage_counter->set(_mem_tracker->peak_consumption());
     }
+    _hot_key_detector.close();
     DataSink::close(state, exec_status);
     return final_st;
 }
@@ -807,10 +811,12 @@ Status BlockSerializer<Parent>::serialize_block(const Block* src, PBlock* dest,
         size_t uncompressed_bytes = 0, compressed_bytes = 0;
         RETURN_IF_ERROR(src->serialize(
                 _parent->_state->be_exec_version(), dest, &uncompressed_bytes, &compressed_bytes,
-                _parent->compression_type(), _parent->transfer_large_data_by_brpc()));
+                _parent->compression_type(), _parent->transfer_large_data_by_brpc(),
+                config::enable_exchange_column_encoding));
         COUNTER_UPDATE(_parent->_bytes_sent_counter, compressed_bytes * num_receivers);
         COUNTER_UPDATE(_parent->_uncompressed_bytes_counter, uncompressed_bytes * num_receivers);
         COUNTER_UPDATE(_parent->_compress_timer, src->get_compress_time());
+        _parent->_column_encoding_counters.update(*src, num_receivers);
     }
 
     return Status::OK();
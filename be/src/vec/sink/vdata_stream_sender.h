@@ -45,8 +45,10 @@
 #include "util/runtime_profile.h"
 #include "util/uid_util.h"
 #include "vec/core/block.h"
+#include "vec/core/column_encoding.h"
 #include "vec/exprs/vexpr_context.h"
 #include "vec/runtime/vdata_stream_recvr.h"
+#include "vec/sink/hot_key_detector.h"
 
 namespace doris {
 class ObjectPool;
@@ -224,6 +226,9 @@ protected:
     bool _only_local_exchange = false;
     bool _enable_pipeline_exec = false;
 
+    HotKeyDetector _hot_key_detector;
+    ColumnEncodingCounters _column_encoding_counters;
+
     BlockSerializer<VDataStreamSender> _serializer;
 };
 
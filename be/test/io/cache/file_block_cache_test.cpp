@@ -961,4 +961,58 @@ TEST(LRUFileCache, fd_cache_evict) {
     }
 }
 
+TEST(LRUFileCache, tinylfu_counts_each_access_once) {
+    if (fs::exists(cache_base_path)) {
+        fs::remove_all(cache_base_path);
+    }
+    fs::create_directories(cache_base_path);
+    bool enable_file_cache_tinylfu_admission = config::enable_file_cache_tinylfu_admission;
+    config::enable_file_cache_tinylfu_admission = true;
+    io::FileCacheSettings settings;
+    settings.index_queue_elements = 0;
+    settings.index_queue_size = 0;
+    settings.disposable_queue_size = 0;
+    settings.disposable_queue_elements = 0;
+    settings.query_queue_size = 30;
+    settings.query_queue_elements = 5;
+    settings.max_file_segment_size = 10;
+    settings.max_query_cache_size = 30;
+    settings.total_size = 30;
+    io::LRUFileCache cache(cache_base_path, settings);
+    ASSERT_TRUE(cache.initialize());
+    // the sketch is sized when the cache is built, the first access is already counted
+    EXPECT_FALSE(cache._sketch._table.empty());
+    io::CacheContext context;
+    context.cache_type = io::CacheType::NORMAL;
+    auto key = io::LRUFileCache::hash("key1");
+    uint64_t hash = io::LRUFileCache::sketch_hash(key, 0);
+    {
+        auto holder = cache.get_or_set(key, 0, 9, context); /// Add range [0, 8]
+        auto segments = fromHolder(holder);
+        ASSERT_EQ(segments.size(), 1U);
+        assert_range(1, segments[0], io::FileBlock::Range(0, 8), io::FileBlock::State::EMPTY);
+        EXPECT_EQ(cache._sketch.frequency(hash), 1U);
+        // reserving the space of the new segment is not another access
+        complete(holder);
+        EXPECT_EQ(cache._sketch.frequency(hash), 1U);
+    }
+    {
+        io::CacheContext prefetch_context = context;
+        prefetch_context.is_prefetch = true;
+        auto holder = cache.get_or_set(key, 0, 9, prefetch_context);
+        EXPECT_EQ(cache._sketch.frequency(hash), 1U);
+    }
+    {
+        auto holder = cache.get_or_set(key, 0, 9, context);
+        auto segments = fromHolder(holder);
+        assert_range(2, segments[0], io::FileBlock::Range(0, 8),
+                     io::FileBlock::State::DOWNLOADED);
+        EXPECT_EQ(cache._sketch.frequency(hash), 2U);
+    }
+    config::enable_file_cache_tinylfu_admission = enable_file_cache_tinylfu_admission;
+    if (fs::exists(cache_base_path)) {
+        fs::remove_all(cache_base_path);
+    }
+}
+
 } // namespace doris::io
@@ -26,6 +26,7 @@
 #include <filesystem>
 #include <vector>
 
+#include "common/config.h"
 #include "common/status.h"
 #include "gtest/gtest_pred_impl.h"
 #include "io/fs/file_reader.h"
@@ -556,6 +557,40 @@ TEST_F(LocalFileSystemTest, TestRandomAccess) {
     }
 }
 
+TEST_F(LocalFileSystemTest, TestPrefetchRange) {
+    std::string fname = "./ut_dir/local_filesystem/prefetch_range";
+    EXPECT_TRUE(io::global_local_filesystem()->create_directory("./ut_dir/local_filesystem/").ok());
+    std::string content;
+    for (int i = 0; i < 64 * 1024; ++i) {
+        content.push_back(static_cast<char>(i * 31));
+    }
+    EXPECT_TRUE(save_string_file(fname, content).ok());
+
+    bool enable_local_file_prefetch = config::enable_local_file_prefetch;
+    config::enable_local_file_prefetch = true;
+    io::FileReaderSPtr file_reader;
+    EXPECT_TRUE(io::global_local_filesystem()->open_file(fname, &file_reader).ok());
+    // a range in the file, a range crossing its end and a range after it
+    file_reader->prefetch_range(4096, 16384);
+    file_reader->prefetch_range(content.size() - 100, 4096);
+    file_reader->prefetch_range(content.size() + 100, 4096);
+
+    std::string buf(16384, 0);
+    size_t bytes_read = 0;
+    EXPECT_TRUE(file_reader->read_at(4096, Slice(buf.data(), buf.size()), &bytes_read).ok());
+    EXPECT_EQ(buf.size(), bytes_read);
+    EXPECT_EQ(content.substr(4096, 16384), buf);
+    EXPECT_TRUE(
+            file_reader->read_at(content.size() - 100, Slice(buf.data(), 100), &bytes_read).ok());
+    EXPECT_EQ(100, bytes_read);
+    EXPECT_EQ(content.substr(content.size() - 100), buf.substr(0, 100));
+
+    // the hint is ignored once the reader is closed
+    EXPECT_TRUE(file_reader->close().ok());
+    file_reader->prefetch_range(0, 4096);
+    config::enable_local_file_prefetch = enable_local_file_prefetch;
+}
+
 TEST_F(LocalFileSystemTest, TestRandomWrite) {
     std::string fname = "./ut_dir/env_posix/random_rw";
     EXPECT_TRUE(io::global_local_filesystem()->create_directory("./ut_dir/env_posix").ok());
@@ -272,4 +272,34 @@ TEST_F(BlockColumnPredicateTest, AND_OR_MUTI_COLUMN_VEC) {
     EXPECT_EQ(pred_col->get_data()[sel_idx[0]], 4);
 }
 
+TEST_F(BlockColumnPredicateTest, EVALUATE_ON_RAW_DATA) {
+    int rows = 10;
+    int col_idx = 0;
+    int32_t data[rows];
+    for (int i = 0; i < rows; i++) {
+        data[i] = i;
+    }
+
+    std::unique_ptr<ColumnPredicate> less_pred(
+            new ComparisonPredicateBase<TYPE_INT, PredicateType::LT>(col_idx, 5));
+    std::unique_ptr<ColumnPredicate> great_pred(
+            new ComparisonPredicateBase<TYPE_INT, PredicateType::GT>(col_idx, 3));
+
+    // column < 5 and column > 3
+    bool flags[rows];
+    memset(flags, 1, rows);
+    EXPECT_TRUE(less_pred->evaluate_and_raw(data, sizeof(int32_t), rows, flags));
+    EXPECT_TRUE(great_pred->evaluate_and_raw(data, sizeof(int32_t), rows, flags));
+    for (int i = 0; i < rows; i++) {
+        EXPECT_EQ(flags[i], i == 4);
+    }
+
+    // layout of the data does not match the predicate type
+    EXPECT_FALSE(less_pred->evaluate_and_raw(data, sizeof(int64_t), rows, flags));
+
+    std::unique_ptr<ColumnPredicate> opposite_pred(
+            new ComparisonPredicateBase<TYPE_INT, PredicateType::LT>(col_idx, 5, true));
+    EXPECT_FALSE(opposite_pred->evaluate_and_raw(data, sizeof(int32_t), rows, flags));
+}
+
 } // namespace doris
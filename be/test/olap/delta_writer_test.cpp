@@ -23,11 +23,18 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/object_pool.h"
@@ -459,6 +466,104 @@ static void generate_data(vectorized::Block* block, int8_t k1, int16_t k2, int32
     columns[4]->insert_data((const char*)&c5, sizeof(c2));
 }
 
+static void create_tablet_request_with_dup_keys(int64_t tablet_id, int32_t schema_hash,
+                                                TCreateTabletReq* request) {
+    request->tablet_id = tablet_id;
+    request->__set_version(1);
+    request->tablet_schema.schema_hash = schema_hash;
+    request->tablet_schema.short_key_column_count = 1;
+    request->tablet_schema.keys_type = TKeysType::DUP_KEYS;
+    request->tablet_schema.storage_type = TStorageType::COLUMN;
+    request->__set_storage_format(TStorageFormat::V2);
+
+    TColumn k1;
+    k1.column_name = "k1";
+    k1.__set_is_key(true);
+    k1.column_type.type = TPrimitiveType::INT;
+    request->tablet_schema.columns.push_back(k1);
+
+    TColumn v1;
+    v1.column_name = "v1";
+    v1.__set_is_key(false);
+    v1.column_type.type = TPrimitiveType::BIGINT;
+    v1.__set_aggregation_type(TAggregationType::NONE);
+    request->tablet_schema.columns.push_back(v1);
+}
+
+static TDescriptorTable create_descriptor_tablet_with_dup_keys() {
+    TDescriptorTableBuilder dtb;
+    TTupleDescriptorBuilder tuple_builder;
+
+    tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                   .type(TYPE_INT)
+                                   .column_name("k1")
+                                   .column_pos(0)
+                                   .nullable(false)
+                                   .build());
+    tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                   .type(TYPE_BIGINT)
+                                   .column_name("v1")
+                                   .column_pos(1)
+                                   .nullable(false)
+                                   .build());
+    tuple_builder.build(&dtb);
+
+    return dtb.desc_tbl();
+}
+
+// The rows with keys [begin, begin + rows) of the duplicate key tablet, the value of a row is
+// twice its key.
+static vectorized::Block create_dup_keys_block(TupleDescriptor* tuple_desc, int32_t begin,
+                                               int32_t rows) {
+    vectorized::Block block;
+    for (const auto& slot_desc : tuple_desc->slots()) {
+        block.insert(vectorized::ColumnWithTypeAndName(slot_desc->get_empty_mutable_column(),
+                                                       slot_desc->get_data_type_ptr(),
+                                                       slot_desc->col_name()));
+    }
+    auto columns = block.mutate_columns();
+    for (int32_t k1 = begin; k1 < begin + rows; ++k1) {
+        int64_t v1 = int64_t(k1) * 2;
+        columns[0]->insert_data((const char*)&k1, sizeof(k1));
+        columns[1]->insert_data((const char*)&v1, sizeof(v1));
+    }
+    block.set_columns(std::move(columns));
+    return block;
+}
+
+// Read every segment of a rowset of the duplicate key tablet, check the value of every row and
+// return the keys sorted.
+static void read_dup_keys(const RowsetSharedPtr& rowset, std::vector<int32_t>* keys) {
+    std::vector<segment_v2::SegmentSharedPtr> segments;
+    auto res = ((BetaRowset*)rowset.get())->load_segments(&segments);
+    ASSERT_TRUE(res.ok()) << res;
+    ASSERT_EQ(rowset->num_segments(), static_cast<int64_t>(segments.size()));
+    std::shared_ptr<Schema> schema = std::make_shared<Schema>(rowset->tablet_schema());
+    for (auto& segment : segments) {
+        OlapReaderStatistics stats;
+        StorageReadOptions opts;
+        opts.stats = &stats;
+        opts.tablet_schema = rowset->tablet_schema();
+        std::unique_ptr<RowwiseIterator> iter;
+        res = segment->new_iterator(schema, opts, &iter);
+        ASSERT_TRUE(res.ok()) << res;
+        while (true) {
+            auto read_block = rowset->tablet_schema()->create_block();
+            res = iter->next_batch(&read_block);
+            if (res.is<ErrorCode::END_OF_FILE>()) {
+                break;
+            }
+            ASSERT_TRUE(res.ok()) << res;
+            for (size_t i = 0; i < read_block.rows(); ++i) {
+                auto k1 = read_block.get_by_position(0).column->get_int(i);
+                ASSERT_EQ(k1 * 2, read_block.get_by_position(1).column->get_int(i));
+                keys->push_back(static_cast<int32_t>(k1));
+            }
+        }
+    }
+    std::sort(keys->begin(), keys->end());
+}
+
 class TestDeltaWriter : public ::testing::Test {
 public:
     TestDeltaWriter() {}
@@ -1045,4 +1150,216 @@ TEST_F(TestDeltaWriter, vec_sequence_col_concurrent_write) {
     delete delta_writer1;
     delete delta_writer2;
 }
+
+TEST_F(TestDeltaWriter, vec_dup_keys_concurrent_write) {
+    auto memtable_writer_shard_num = config::memtable_writer_shard_num;
+    auto write_buffer_size = config::write_buffer_size;
+    config::memtable_writer_shard_num = 4;
+    // flush memtables while they are written, besides the flushes requested below
+    config::write_buffer_size = 64 * 1024;
+
+    RuntimeProfile profile("CreateTablet");
+    TCreateTabletReq request;
+    create_tablet_request_with_dup_keys(10007, 270068378, &request);
+    Status res = k_engine->create_tablet(request, &profile);
+    ASSERT_TRUE(res.ok());
+
+    TDescriptorTable tdesc_tbl = create_descriptor_tablet_with_dup_keys();
+    ObjectPool obj_pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    OlapTableSchemaParam param;
+
+    PUniqueId load_id;
+    load_id.set_hi(0);
+    load_id.set_lo(0);
+    WriteRequest write_req;
+    write_req.tablet_id = 10007;
+    write_req.schema_hash = 270068378;
+    write_req.txn_id = 20004;
+    write_req.partition_id = 30004;
+    write_req.load_id = load_id;
+    write_req.tuple_desc = tuple_desc;
+    write_req.slots = &(tuple_desc->slots());
+    write_req.is_high_priority = false;
+    write_req.table_schema_param = &param;
+    DeltaWriter* delta_writer = nullptr;
+    auto load_profile = std::make_unique<RuntimeProfile>("LoadChannels");
+    DeltaWriter::open(&write_req, &delta_writer, load_profile.get(), TUniqueId());
+    ASSERT_NE(delta_writer, nullptr);
+
+    const int32_t num_threads = 8;
+    const int32_t blocks_per_thread = 50;
+    const int32_t rows_per_block = 100;
+    std::vector<int> row_idxs(rows_per_block);
+    std::iota(row_idxs.begin(), row_idxs.end(), 0);
+    std::atomic<bool> writing = true;
+    // flushes like the memtable memory limiter does
+    std::thread flusher([&]() {
+        while (writing) {
+            EXPECT_TRUE(delta_writer->_memtable_writer->flush_async().ok());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int32_t t = 0; t < num_threads; ++t) {
+        writers.emplace_back([&, t]() {
+            for (int32_t b = 0; b < blocks_per_thread; ++b) {
+                auto block = create_dup_keys_block(
+                        tuple_desc, (t * blocks_per_thread + b) * rows_per_block, rows_per_block);
+                auto st = delta_writer->write(&block, row_idxs);
+                EXPECT_TRUE(st.ok()) << st;
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    writing = false;
+    flusher.join();
+
+    res = delta_writer->close();
+    ASSERT_TRUE(res.ok()) << res;
+    res = delta_writer->wait_flush();
+    ASSERT_TRUE(res.ok()) << res;
+    res = delta_writer->build_rowset();
+    ASSERT_TRUE(res.ok()) << res;
+
+    // every row is written to one of the segments exactly once
+    const int32_t total_rows = num_threads * blocks_per_thread * rows_per_block;
+    RowsetSharedPtr rowset = delta_writer->_rowset_builder.rowset();
+    ASSERT_EQ(static_cast<size_t>(total_rows), rowset->num_rows());
+    EXPECT_GT(rowset->num_segments(), 1);
+    std::vector<int32_t> keys;
+    read_dup_keys(rowset, &keys);
+    std::vector<int32_t> expected(total_rows);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(expected, keys);
+
+    delete delta_writer;
+    res = k_engine->tablet_manager()->drop_tablet(request.tablet_id, request.replica_id, false);
+    ASSERT_TRUE(res.ok());
+    config::memtable_writer_shard_num = memtable_writer_shard_num;
+    config::write_buffer_size = write_buffer_size;
+}
+
+TEST_F(TestDeltaWriter, vec_dup_keys_close_and_cancel_during_write) {
+    auto memtable_writer_shard_num = config::memtable_writer_shard_num;
+    auto write_buffer_size = config::write_buffer_size;
+    config::memtable_writer_shard_num = 4;
+    config::write_buffer_size = 256 * 1024;
+
+    RuntimeProfile profile("CreateTablet");
+    TCreateTabletReq request;
+    create_tablet_request_with_dup_keys(10008, 270068379, &request);
+    Status res = k_engine->create_tablet(request, &profile);
+    ASSERT_TRUE(res.ok());
+
+    TDescriptorTable tdesc_tbl = create_descriptor_tablet_with_dup_keys();
+    ObjectPool obj_pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    OlapTableSchemaParam param;
+
+    const int32_t num_threads = 8;
+    const int32_t max_blocks_per_thread = 1000;
+    const int32_t rows_per_block = 100;
+    std::vector<int> row_idxs(rows_per_block);
+    std::iota(row_idxs.begin(), row_idxs.end(), 0);
+
+    // Writes blocks from several threads until a write fails with `error`, which `stop` causes
+    // once some blocks are written. Returns the keys of the blocks written successfully.
+    auto write_until_stopped = [&](DeltaWriter* delta_writer, int error,
+                                   const std::function<Status()>& stop) {
+        std::atomic<int32_t> written_blocks = 0;
+        std::vector<std::vector<int32_t>> written_keys(num_threads);
+        std::vector<std::thread> writers;
+        for (int32_t t = 0; t < num_threads; ++t) {
+            writers.emplace_back([&, t]() {
+                for (int32_t b = 0; b < max_blocks_per_thread; ++b) {
+                    int32_t begin = (t * max_blocks_per_thread + b) * rows_per_block;
+                    auto block = create_dup_keys_block(tuple_desc, begin, rows_per_block);
+                    auto st = delta_writer->write(&block, row_idxs);
+                    if (!st.ok()) {
+                        EXPECT_EQ(error, st.code()) << st;
+                        break;
+                    }
+                    for (int32_t k1 = begin; k1 < begin + rows_per_block; ++k1) {
+                        written_keys[t].push_back(k1);
+                    }
+                    ++written_blocks;
+                }
+            });
+        }
+        while (written_blocks < 20) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        auto st = stop();
+        EXPECT_TRUE(st.ok()) << st;
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        std::vector<int32_t> keys;
+        for (auto& thread_keys : written_keys) {
+            keys.insert(keys.end(), thread_keys.begin(), thread_keys.end());
+        }
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    };
+
+    PUniqueId load_id;
+    load_id.set_hi(0);
+    load_id.set_lo(0);
+    WriteRequest write_req;
+    write_req.tablet_id = 10008;
+    write_req.schema_hash = 270068379;
+    write_req.txn_id = 20005;
+    write_req.partition_id = 30005;
+    write_req.load_id = load_id;
+    write_req.tuple_desc = tuple_desc;
+    write_req.slots = &(tuple_desc->slots());
+    write_req.is_high_priority = false;
+    write_req.table_schema_param = &param;
+
+    // the rows written before the close are all in the rowset, the later writes fail
+    {
+        DeltaWriter* delta_writer = nullptr;
+        auto load_profile = std::make_unique<RuntimeProfile>("LoadChannels");
+        DeltaWriter::open(&write_req, &delta_writer, load_profile.get(), TUniqueId());
+        ASSERT_NE(delta_writer, nullptr);
+        auto written_keys = write_until_stopped(delta_writer, ErrorCode::ALREADY_CLOSED,
+                                                [&]() { return delta_writer->close(); });
+        res = delta_writer->wait_flush();
+        ASSERT_TRUE(res.ok()) << res;
+        res = delta_writer->build_rowset();
+        ASSERT_TRUE(res.ok()) << res;
+        RowsetSharedPtr rowset = delta_writer->_rowset_builder.rowset();
+        ASSERT_EQ(written_keys.size(), rowset->num_rows());
+        std::vector<int32_t> keys;
+        read_dup_keys(rowset, &keys);
+        EXPECT_EQ(written_keys, keys);
+        delete delta_writer;
+    }
+
+    // the writes after the cancel fail with its status, and so does the close
+    {
+        write_req.txn_id = 20006;
+        DeltaWriter* delta_writer = nullptr;
+        auto load_profile = std::make_unique<RuntimeProfile>("LoadChannels");
+        DeltaWriter::open(&write_req, &delta_writer, load_profile.get(), TUniqueId());
+        ASSERT_NE(delta_writer, nullptr);
+        write_until_stopped(delta_writer, ErrorCode::CANCELLED,
+                            [&]() { return delta_writer->cancel(); });
+        res = delta_writer->close();
+        EXPECT_TRUE(res.is<ErrorCode::CANCELLED>()) << res;
+        delete delta_writer;
+    }
+
+    res = k_engine->tablet_manager()->drop_tablet(request.tablet_id, request.replica_id, false);
+    ASSERT_TRUE(res.ok());
+    config::memtable_writer_shard_num = memtable_writer_shard_num;
+    config::write_buffer_size = write_buffer_size;
+}
 } // namespace doris
@@ -21,7 +21,11 @@
 #include <gtest/gtest-message.h>
 #include <gtest/gtest-test-part.h>
 
+#include <atomic>
 #include <iosfwd>
+#include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest_pred_impl.h"
@@ -368,6 +372,294 @@ TEST_F(CacheTest, PruneIfLazyMode) {
     EXPECT_EQ(4, cache.get_usage());
 }
 
+static int lookup_LRUCache(LRUCache& cache, const CacheKey& key) {
+    uint32_t hash = key.hash(key.data(), key.size(), 0);
+    Cache::Handle* handle = cache.lookup(key, hash);
+    if (handle == nullptr) {
+        return -1;
+    }
+    int value = DecodeValue(reinterpret_cast<LRUHandle*>(handle)->value);
+    cache.release(handle);
+    return value;
+}
+
+TEST_F(CacheTest, TinyLFUAdmission) {
+    LRUCache cache(LRUCacheType::NUMBER);
+    cache.set_capacity(3);
+    cache.set_admission_policy(CacheAdmissionPolicy::TINY_LFU);
+
+    for (int i = 1; i <= 3; ++i) {
+        insert_LRUCache(cache, CacheKey {std::to_string(i)}, i, CachePriority::NORMAL);
+    }
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 1; i <= 3; ++i) {
+            EXPECT_EQ(i, lookup_LRUCache(cache, CacheKey {std::to_string(i)}));
+        }
+    }
+
+    // a scan of cold keys can not evict the hot keys
+    for (int i = 100; i < 110; ++i) {
+        insert_LRUCache(cache, CacheKey {std::to_string(i)}, i, CachePriority::NORMAL);
+        EXPECT_EQ(-1, lookup_LRUCache(cache, CacheKey {std::to_string(i)}));
+    }
+    EXPECT_EQ(10, cache.get_admission_reject_count());
+    EXPECT_EQ(3, cache.get_usage());
+    for (int i = 1; i <= 3; ++i) {
+        EXPECT_EQ(i, lookup_LRUCache(cache, CacheKey {std::to_string(i)}));
+    }
+
+    // a key accessed frequently enough is admitted and evicts the LRU entry
+    CacheKey key("100");
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(-1, lookup_LRUCache(cache, key));
+    }
+    insert_LRUCache(cache, key, 100, CachePriority::NORMAL);
+    EXPECT_EQ(10, cache.get_admission_reject_count());
+    EXPECT_EQ(3, cache.get_usage());
+    EXPECT_EQ(100, lookup_LRUCache(cache, key));
+    EXPECT_EQ(-1, lookup_LRUCache(cache, CacheKey("1")));
+}
+
+TEST_F(CacheTest, TinyLFUCountsEachAccessOnce) {
+    LRUCache cache(LRUCacheType::NUMBER);
+    cache.set_capacity(3);
+    cache.set_admission_policy(CacheAdmissionPolicy::TINY_LFU);
+    // the sketch is sized when the policy is set, the first access is already counted
+    EXPECT_FALSE(cache._sketch._table.empty());
+
+    // a missed lookup and the insert after it are one access
+    CacheKey key("1");
+    uint32_t hash = key.hash(key.data(), key.size(), 0);
+    EXPECT_EQ(-1, lookup_LRUCache(cache, key));
+    EXPECT_EQ(1U, cache._sketch.frequency(hash));
+    insert_LRUCache(cache, key, 1, CachePriority::NORMAL);
+    EXPECT_EQ(1U, cache._sketch.frequency(hash));
+    EXPECT_EQ(1, lookup_LRUCache(cache, key));
+    EXPECT_EQ(2U, cache._sketch.frequency(hash));
+}
+
+static MemTrackerLimiter* clock_cache_tracker() {
+    static std::unique_ptr<MemTrackerLimiter> tracker = std::make_unique<MemTrackerLimiter>(
+            MemTrackerLimiter::Type::GLOBAL, "TestClockCache");
+    return tracker.get();
+}
+
+static void insert_ClockCache(ClockCache& cache, const CacheKey& key, int value,
+                              CachePriority priority) {
+    uint32_t hash = key.hash(key.data(), key.size(), 0);
+    cache.release(cache.insert(key, hash, EncodeValue(value), value, &deleter,
+                               clock_cache_tracker(), priority, value));
+}
+
+static int lookup_ClockCache(ClockCache& cache, const CacheKey& key) {
+    uint32_t hash = key.hash(key.data(), key.size(), 0);
+    Cache::Handle* handle = cache.lookup(key, hash);
+    if (handle == nullptr) {
+        return -1;
+    }
+    int value = DecodeValue(reinterpret_cast<LRUHandle*>(handle)->value);
+    cache.release(handle);
+    return value;
+}
+
+TEST_F(CacheTest, ClockCacheSecondChance) {
+    ClockCache cache(LRUCacheType::NUMBER);
+    cache.set_capacity(3);
+
+    insert_ClockCache(cache, CacheKey("100"), 100, CachePriority::NORMAL);
+    insert_ClockCache(cache, CacheKey("200"), 200, CachePriority::NORMAL);
+    insert_ClockCache(cache, CacheKey("300"), 300, CachePriority::NORMAL);
+    EXPECT_EQ(3, cache.get_usage());
+
+    // 100 is referenced, so it gets a second chance and 200 is evicted
+    EXPECT_EQ(100, lookup_ClockCache(cache, CacheKey("100")));
+    insert_ClockCache(cache, CacheKey("400"), 400, CachePriority::NORMAL);
+    EXPECT_EQ(3, cache.get_usage());
+    EXPECT_EQ(100, lookup_ClockCache(cache, CacheKey("100")));
+    EXPECT_EQ(-1, lookup_ClockCache(cache, CacheKey("200")));
+    EXPECT_EQ(300, lookup_ClockCache(cache, CacheKey("300")));
+    EXPECT_EQ(400, lookup_ClockCache(cache, CacheKey("400")));
+
+    EXPECT_EQ(5, cache.get_lookup_count());
+    EXPECT_EQ(4, cache.get_hit_count());
+}
+
+TEST_F(CacheTest, ContainsIsNotAnAccess) {
+    LRUCache lru_cache(LRUCacheType::NUMBER);
+    lru_cache.set_capacity(3);
+    ClockCache clock_cache(LRUCacheType::NUMBER);
+    clock_cache.set_capacity(3);
+    for (int i = 1; i <= 3; ++i) {
+        insert_LRUCache(lru_cache, CacheKey {std::to_string(i)}, i, CachePriority::NORMAL);
+        insert_ClockCache(clock_cache, CacheKey {std::to_string(i)}, i, CachePriority::NORMAL);
+    }
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 1; i <= 4; ++i) {
+            CacheKey key(std::to_string(i));
+            uint32_t hash = key.hash(key.data(), key.size(), 0);
+            EXPECT_EQ(i <= 3, lru_cache.contains(key, hash));
+            EXPECT_EQ(i <= 3, clock_cache.contains(key, hash));
+        }
+    }
+    EXPECT_EQ(0, lru_cache.get_lookup_count());
+    EXPECT_EQ(0, clock_cache.get_lookup_count());
+
+    // 1 is still the least recently used entry, and it is not given a second chance
+    insert_LRUCache(lru_cache, CacheKey("4"), 4, CachePriority::NORMAL);
+    insert_ClockCache(clock_cache, CacheKey("4"), 4, CachePriority::NORMAL);
+    EXPECT_EQ(-1, lookup_LRUCache(lru_cache, CacheKey("1")));
+    EXPECT_EQ(-1, lookup_ClockCache(clock_cache, CacheKey("1")));
+    EXPECT_EQ(2, lookup_LRUCache(lru_cache, CacheKey("2")));
+    EXPECT_EQ(2, lookup_ClockCache(clock_cache, CacheKey("2")));
+
+    // the access frequency of TinyLFU admission is not changed
+    LRUCache tinylfu_cache(LRUCacheType::NUMBER);
+    tinylfu_cache.set_capacity(3);
+    tinylfu_cache.set_admission_policy(CacheAdmissionPolicy::TINY_LFU);
+    insert_LRUCache(tinylfu_cache, CacheKey("1"), 1, CachePriority::NORMAL);
+    auto sketch = tinylfu_cache._sketch._table;
+    for (int i = 0; i < 10; ++i) {
+        CacheKey key("1");
+        EXPECT_TRUE(tinylfu_cache.contains(key, key.hash(key.data(), key.size(), 0)));
+    }
+    EXPECT_EQ(sketch, tinylfu_cache._sketch._table);
+}
+
+TEST_F(CacheTest, ClockCacheDurableAndPinned) {
+    ClockCache cache(LRUCacheType::NUMBER);
+    cache.set_capacity(2);
+
+    insert_ClockCache(cache, CacheKey("100"), 100, CachePriority::DURABLE);
+    CacheKey key2("200");
+    uint32_t hash2 = key2.hash(key2.data(), key2.size(), 0);
+    Cache::Handle* pinned = cache.insert(key2, hash2, EncodeValue(200), 200, &deleter,
+                                         clock_cache_tracker(), CachePriority::NORMAL, 200);
+
+    // 200 is in use and 100 is durable, durable entry is evicted as the last resort
+    insert_ClockCache(cache, CacheKey("300"), 300, CachePriority::NORMAL);
+    EXPECT_EQ(-1, lookup_ClockCache(cache, CacheKey("100")));
+    EXPECT_EQ(200, DecodeValue(reinterpret_cast<LRUHandle*>(pinned)->value));
+
+    // erased entry stays valid until it is released
+    cache.erase(key2, hash2);
+    EXPECT_EQ(-1, lookup_ClockCache(cache, key2));
+    EXPECT_EQ(1, cache.get_usage());
+    EXPECT_EQ(200, DecodeValue(reinterpret_cast<LRUHandle*>(pinned)->value));
+    cache.release(pinned);
+    EXPECT_EQ(300, lookup_ClockCache(cache, CacheKey("300")));
+}
+
+TEST_F(CacheTest, ClockCachePrune) {
+    ClockCache cache(LRUCacheType::NUMBER);
+    cache.set_capacity(5);
+
+    for (int i = 1; i <= 5; ++i) {
+        insert_ClockCache(cache, CacheKey {std::to_string(i)}, i, CachePriority::NORMAL);
+        EXPECT_EQ(i, cache.get_usage());
+    }
+
+    auto pred = [](const void* value) -> bool { return DecodeValue((void*)value) > 3; };
+    // in lazy mode, the oldest item does not satisfy pred, so nothing is removed
+    EXPECT_EQ(0, cache.prune_if(pred, true));
+    EXPECT_EQ(5, cache.get_usage());
+    EXPECT_EQ(2, cache.prune_if(pred));
+    EXPECT_EQ(3, cache.get_usage());
+
+    EXPECT_EQ(3, cache.prune());
+    EXPECT_EQ(0, cache.get_usage());
+}
+
+TEST_F(CacheTest, ShardedClockCache) {
+    delete _cache;
+    _cache = new_lru_cache("test", kCacheSize, LRUCacheType::SIZE, DEFAULT_LRU_CACHE_NUM_SHARDS,
+                           CacheEvictionPolicy::CLOCK);
+
+    EXPECT_EQ(-1, Lookup(100));
+    Insert(100, 101, 1);
+    EXPECT_EQ(101, Lookup(100));
+    Insert(100, 102, 1);
+    EXPECT_EQ(102, Lookup(100));
+    EXPECT_EQ(1, _deleted_keys.size());
+    EXPECT_EQ(100, _deleted_keys[0]);
+    EXPECT_EQ(101, _deleted_values[0]);
+
+    Erase(100);
+    EXPECT_EQ(-1, Lookup(100));
+    EXPECT_EQ(2, _deleted_keys.size());
+
+    for (int i = 0; i < kCacheSize + 100; i++) {
+        Insert(1000 + i, 2000 + i, 1);
+        EXPECT_EQ(2000 + i, Lookup(1000 + i));
+    }
+    EXPECT_LE(_cache->get_usage(), kCacheSize);
+}
+
+static std::atomic<int64_t> s_clock_cache_deleted {0};
+
+static void counting_deleter(const CacheKey& key, void* v) {
+    EXPECT_EQ(DecodeKey(key), DecodeValue(v));
+    s_clock_cache_deleted.fetch_add(1);
+}
+
+TEST_F(CacheTest, ShardedClockCacheConcurrentAccess) {
+    // one shard and far more keys than entries, so that releases often find the shard over
+    // capacity while other threads erase and evict the same entries
+    std::unique_ptr<Cache> cache(new_lru_cache("concurrent_clock_test", 16, LRUCacheType::NUMBER,
+                                               1, CacheEvictionPolicy::CLOCK));
+    s_clock_cache_deleted = 0;
+    std::atomic<int64_t> inserted {0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t]() {
+            std::vector<Cache::Handle*> pinned;
+            uint32_t seed = t;
+            for (int i = 0; i < 20000; ++i) {
+                seed = seed * 1103515245 + 12345;
+                int key = (seed >> 8) % 64;
+                std::string buf;
+                CacheKey cache_key = EncodeKey(&buf, key);
+                Cache::Handle* handle = nullptr;
+                switch ((seed >> 20) % 4) {
+                case 0:
+                    handle = cache->insert(cache_key, EncodeValue(key), 1, &counting_deleter,
+                                           CachePriority::NORMAL, 1);
+                    inserted.fetch_add(1);
+                    break;
+                case 1:
+                case 2:
+                    handle = cache->lookup(cache_key);
+                    break;
+                default:
+                    cache->erase(cache_key);
+                    break;
+                }
+                if (handle != nullptr) {
+                    EXPECT_EQ(key, DecodeValue(cache->value(handle)));
+                    pinned.push_back(handle);
+                }
+                // keep a few entries in use for a while, they may be erased or replaced meanwhile
+                if (pinned.size() > 4) {
+                    for (auto* h : pinned) {
+                        cache->release(h);
+                    }
+                    pinned.clear();
+                }
+            }
+            for (auto* h : pinned) {
+                cache->release(h);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    cache->prune();
+    EXPECT_EQ(0, cache->get_usage());
+    cache.reset();
+    // every entry is freed exactly once
+    EXPECT_EQ(inserted.load(), s_clock_cache_deleted.load());
+}
+
 TEST_F(CacheTest, HeavyEntries) {
     // Add a bunch of light and heavy entries and then count the combined
     // size of items still in the cache, which must be approximately the
@@ -15,13 +15,137 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include "olap/memtable.h"
+
+#include <gen_cpp/olap_file.pb.h>
 #include <gtest/gtest.h>
 
-#include "olap/memtable.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+#include "common/object_pool.h"
+#include "olap/tablet_meta.h"
+#include "olap/tablet_schema.h"
+#include "runtime/descriptors.h"
+#include "runtime/memory/mem_tracker.h"
+#include "testutil/desc_tbl_builder.h"
+#include "util/threadpool.h"
+#include "vec/columns/columns_number.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
 
 namespace doris {
 
-class MemTableSortTest : public ::testing::Test {};
+class MemTableSortTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        _memtable_sort_parallelism = config::memtable_sort_parallelism;
+        _memtable_parallel_sort_min_rows = config::memtable_parallel_sort_min_rows;
+        config::memtable_sort_parallelism = 4;
+        config::memtable_parallel_sort_min_rows = 1000;
+        static_cast<void>(ThreadPoolBuilder("MemTableSortPool")
+                                  .set_min_threads(4)
+                                  .set_max_threads(4)
+                                  .build(&_sort_pool));
+    }
+
+    void TearDown() override {
+        _sort_pool->shutdown();
+        config::memtable_sort_parallelism = _memtable_sort_parallelism;
+        config::memtable_parallel_sort_min_rows = _memtable_parallel_sort_min_rows;
+    }
+
+    // (k1 INT, k2 INT, v INT[, __DORIS_SEQUENCE_COL__ INT]), the values are summed for AGG_KEYS
+    // and replaced otherwise.
+    static TabletSchemaSPtr create_schema(KeysType keys_type, bool has_sequence_col) {
+        TabletSchemaPB tablet_schema_pb;
+        tablet_schema_pb.set_keys_type(keys_type);
+        tablet_schema_pb.set_num_short_key_columns(2);
+        int32_t unique_id = 0;
+        auto add_column = [&](const std::string& name, bool is_key) {
+            ColumnPB* column = tablet_schema_pb.add_column();
+            column->set_unique_id(++unique_id);
+            column->set_name(name);
+            column->set_type("INT");
+            column->set_is_key(is_key);
+            column->set_length(4);
+            column->set_index_length(4);
+            column->set_is_nullable(false);
+            if (!is_key && keys_type != DUP_KEYS) {
+                column->set_aggregation(keys_type == AGG_KEYS ? "SUM" : "REPLACE");
+            }
+        };
+        add_column("k1", true);
+        add_column("k2", true);
+        add_column("v", false);
+        if (has_sequence_col) {
+            add_column(SEQUENCE_COL, false);
+        }
+        auto tablet_schema = std::make_shared<TabletSchema>();
+        tablet_schema->init_from_pb(tablet_schema_pb);
+        return tablet_schema;
+    }
+
+    // Row i has keys (i * 7919 % 1000, i % 3), value i and sequence i * 31 % 97.
+    static vectorized::Block create_block(int begin, int end, size_t num_columns) {
+        auto type = std::make_shared<vectorized::DataTypeInt32>();
+        vectorized::ColumnsWithTypeAndName columns;
+        for (size_t cid = 0; cid < num_columns; ++cid) {
+            auto column = vectorized::ColumnInt32::create();
+            for (int i = begin; i < end; ++i) {
+                int values[] = {i * 7919 % 1000, i % 3, i, i * 31 % 97};
+                column->insert_value(values[cid]);
+            }
+            columns.emplace_back(std::move(column), type, "c" + std::to_string(cid));
+        }
+        return vectorized::Block(columns);
+    }
+
+    // Insert 20000 rows in two rounds, aggregated in between unless the keys are duplicate,
+    // flush them and return the flushed rows in order.
+    std::vector<std::string> flush(KeysType keys_type, bool has_sequence_col, bool parallel) {
+        auto tablet_schema = create_schema(keys_type, has_sequence_col);
+        ObjectPool pool;
+        DescriptorTblBuilder builder(&pool);
+        auto& tuple_builder = builder.declare_tuple();
+        for (size_t cid = 0; cid < tablet_schema->num_columns(); ++cid) {
+            tuple_builder << TYPE_INT;
+        }
+        auto* tuple_desc = builder.build()->get_tuple_descriptor(0);
+        auto insert_mem_tracker = std::make_shared<MemTracker>("MemTableSortTest:insert");
+        auto flush_mem_tracker = std::make_shared<MemTracker>("MemTableSortTest:flush");
+        MemTable memtable(0, tablet_schema.get(), &tuple_desc->slots(), tuple_desc, false,
+                          insert_mem_tracker, flush_mem_tracker);
+
+        for (int begin : {0, 10000}) {
+            auto block = create_block(begin, begin + 10000, tablet_schema->num_columns());
+            memtable.insert(&block, {}, true);
+            if (begin == 0) {
+                memtable.shrink_memtable_by_agg();
+            }
+        }
+        if (parallel) {
+            // the number of chunks is capped by the idle threads of the pool
+            while (_sort_pool->num_idle_threads() < 4) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        auto block = memtable.to_block(parallel ? _sort_pool.get() : nullptr);
+        std::vector<std::string> rows;
+        for (size_t i = 0; i < block->rows(); ++i) {
+            rows.push_back(block->dump_one_line(i, block->columns()));
+        }
+        return rows;
+    }
+
+    std::unique_ptr<ThreadPool> _sort_pool;
+    int32_t _memtable_sort_parallelism;
+    int32_t _memtable_parallel_sort_min_rows;
+};
 
 TEST_F(MemTableSortTest, Tie) {
     auto t0 = Tie {0, 0};
@@ -80,4 +204,21 @@ TEST_F(MemTableSortTest, Tie) {
     EXPECT_FALSE(it3.next());
 }
 
+TEST_F(MemTableSortTest, ParallelSortMatchesSerialSort) {
+    auto expected = flush(DUP_KEYS, false, false);
+    EXPECT_EQ(20000U, expected.size());
+    EXPECT_EQ(expected, flush(DUP_KEYS, false, true));
+
+    for (bool has_sequence_col : {false, true}) {
+        expected = flush(UNIQUE_KEYS, has_sequence_col, false);
+        EXPECT_EQ(3000U, expected.size());
+        EXPECT_EQ(expected, flush(UNIQUE_KEYS, has_sequence_col, true))
+                << "has sequence column " << has_sequence_col;
+    }
+
+    expected = flush(AGG_KEYS, false, false);
+    EXPECT_EQ(3000U, expected.size());
+    EXPECT_EQ(expected, flush(AGG_KEYS, false, true));
+}
+
 } // namespace doris
@@ -258,4 +258,36 @@ TEST(StoragePageCacheTest, mixed_pages) {
     }
 }
 
+// Compressed pages are cached separately from the decompressed pages
+TEST(StoragePageCacheTest, compressed_page) {
+    StoragePageCache cache(kNumShards * 2048, 0, 0, kNumShards, kNumShards * 2048);
+    EXPECT_TRUE(cache.is_compressed_cache_available());
+
+    StoragePageCache::CacheKey key("abc", 0, 0);
+    segment_v2::PageTypePB page_type = segment_v2::DATA_PAGE;
+
+    {
+        PageCacheHandle handle;
+        DataPage* data = new DataPage(256);
+        cache.insert_compressed(key, data, &handle);
+        EXPECT_EQ(handle.data().data, data->data());
+
+        auto found = cache.lookup_compressed(key, &handle);
+        EXPECT_TRUE(found);
+        EXPECT_EQ(data->data(), handle.data().data);
+        EXPECT_EQ(256, handle.data().size);
+    }
+
+    {
+        // not in the decompressed page cache
+        PageCacheHandle handle;
+        EXPECT_FALSE(cache.lookup(key, &handle, page_type));
+        StoragePageCache::CacheKey miss_key("abc", 0, 1);
+        EXPECT_FALSE(cache.lookup_compressed(miss_key, &handle));
+    }
+
+    StoragePageCache no_compressed_cache(kNumShards * 2048, 0, 0, kNumShards);
+    EXPECT_FALSE(no_compressed_cache.is_compressed_cache_available());
+}
+
 } // namespace doris
@@ -167,4 +167,44 @@ TEST_F(PrimaryKeyIndexTest, builder) {
     }
 }
 
+TEST_F(PrimaryKeyIndexTest, hash_index) {
+    std::string filename = kTestDir + "/hash_index";
+    io::FileWriterPtr file_writer;
+    auto fs = io::global_local_filesystem();
+    EXPECT_TRUE(fs->create_file(filename, &file_writer).ok());
+
+    // the keys end with a one byte sequence column after its null marker
+    const size_t seq_col_length = 2;
+    PrimaryKeyIndexBuilder builder(file_writer.get(), seq_col_length);
+    builder.init();
+    std::vector<std::string> keys;
+    for (int i = 1000; i < 10000; i += 2) {
+        keys.push_back(std::to_string(i) + '\1' + static_cast<char>('a' + i % 26));
+        builder.add_item(keys.back());
+    }
+    segment_v2::PrimaryKeyIndexMetaPB index_meta;
+    EXPECT_TRUE(builder.finalize(&index_meta));
+    EXPECT_TRUE(file_writer->close().ok());
+
+    PrimaryKeyIndexReader index_reader;
+    io::FileReaderSPtr file_reader;
+    EXPECT_TRUE(fs->open_file(filename, &file_reader).ok());
+    EXPECT_TRUE(index_reader.parse_index(file_reader, index_meta).ok());
+
+    PrimaryKeyHashIndex hash_index;
+    EXPECT_TRUE(hash_index.build(index_reader, seq_col_length).ok());
+    EXPECT_GT(hash_index.memory_size(), 0U);
+    uint32_t row_id = 0;
+    Slice sought_key;
+    for (size_t i = 0; i < keys.size(); i++) {
+        Slice key_without_seq(keys[i].data(), keys[i].size() - seq_col_length);
+        EXPECT_TRUE(hash_index.find(key_without_seq, &row_id, &sought_key));
+        EXPECT_EQ(i, row_id);
+        EXPECT_EQ(keys[i], sought_key.to_string());
+    }
+    for (std::string key : {"8701", "87", "9999", "1000\1a"}) {
+        EXPECT_FALSE(hash_index.find(key, &row_id, &sought_key));
+    }
+}
+
 } // namespace doris
@@ -212,5 +212,42 @@ TEST_F(BlockBloomFilterTest, contains) {
     ASSERT_FALSE(bf2->contains(*bf1));
 }
 
+TEST_F(BlockBloomFilterTest, test_hashes) {
+    std::unique_ptr<BloomFilter> bf;
+    auto st = BloomFilter::create(BLOCK_BLOOM_FILTER, &bf);
+    ASSERT_TRUE(st.ok());
+    st = bf->init(_expected_num, _fpp, HASH_MURMUR3_X64_64);
+    ASSERT_TRUE(st.ok());
+
+    int num = 1000;
+    std::vector<uint64_t> hashes;
+    for (int i = 0; i < num * 2; ++i) {
+        uint32_t value = random();
+        hashes.push_back(bf->hash((char*)&value, sizeof(value)));
+        if (i < num) {
+            bf->add_hash(hashes.back());
+        }
+    }
+
+    std::vector<uint8_t> results(hashes.size());
+    bf->test_hashes(hashes.data(), hashes.size(), results.data());
+    for (int i = 0; i < hashes.size(); ++i) {
+        EXPECT_EQ(bf->test_hash(hashes[i]), results[i]);
+        if (i < num) {
+            EXPECT_TRUE(results[i]);
+        }
+    }
+
+    EXPECT_TRUE(bf->test_any_hash(hashes.data(), hashes.size()));
+    std::vector<uint64_t> missed_hashes;
+    for (int i = num; i < hashes.size(); ++i) {
+        if (!results[i]) {
+            missed_hashes.push_back(hashes[i]);
+        }
+    }
+    EXPECT_FALSE(missed_hashes.empty());
+    EXPECT_FALSE(bf->test_any_hash(missed_hashes.data(), missed_hashes.size()));
+}
+
 } // namespace segment_v2
 } // namespace doris
@@ -0,0 +1,276 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/column_reader.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <numeric>
+#include <roaring/roaring.hh>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "io/fs/file_reader.h"
+#include "io/fs/file_writer.h"
+#include "io/fs/local_file_system.h"
+#include "olap/lru_cache.h"
+#include "olap/olap_common.h"
+#include "olap/page_cache.h"
+#include "olap/rowset/segment_v2/column_writer.h"
+#include "olap/tablet_schema.h"
+#include "runtime/exec_env.h"
+#include "util/doris_metrics.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+
+namespace doris {
+namespace segment_v2 {
+
+static const std::string kTestDir = "./ut_dir/column_reader_test";
+
+class ColumnReaderTest : public testing::Test {
+protected:
+    void SetUp() override {
+        EXPECT_TRUE(io::global_local_filesystem()->delete_and_create_directory(kTestDir).ok());
+    }
+
+    void TearDown() override {
+        EXPECT_TRUE(io::global_local_filesystem()->delete_directory(kTestDir).ok());
+    }
+
+    // Write `num_rows` not null ints, each the id of its row, into data pages of about 4KB.
+    static void write_int_column(const std::string& fname, int num_rows, ColumnMetaPB* meta) {
+        io::FileWriterPtr file_writer;
+        ASSERT_TRUE(io::global_local_filesystem()->create_file(fname, &file_writer).ok());
+        ColumnWriterOptions writer_opts;
+        writer_opts.meta = meta;
+        meta->set_column_id(0);
+        meta->set_unique_id(0);
+        meta->set_type(FieldType::OLAP_FIELD_TYPE_INT);
+        meta->set_length(0);
+        meta->set_encoding(BIT_SHUFFLE);
+        meta->set_compression(segment_v2::CompressionTypePB::LZ4F);
+        meta->set_is_nullable(false);
+        writer_opts.data_page_size = 4096;
+
+        TabletColumn column(OLAP_FIELD_AGGREGATION_NONE, FieldType::OLAP_FIELD_TYPE_INT);
+        std::unique_ptr<ColumnWriter> writer;
+        ASSERT_TRUE(ColumnWriter::create(writer_opts, &column, file_writer.get(), &writer).ok());
+        ASSERT_TRUE(writer->init().ok());
+        std::vector<int32_t> values(num_rows);
+        std::iota(values.begin(), values.end(), 0);
+        const auto* data = reinterpret_cast<const uint8_t*>(values.data());
+        ASSERT_TRUE(writer->append_data(&data, num_rows).ok());
+        ASSERT_TRUE(writer->finish().ok());
+        ASSERT_TRUE(writer->write_data().ok());
+        ASSERT_TRUE(writer->write_ordinal_index().ok());
+        ASSERT_TRUE(file_writer->close().ok());
+    }
+};
+
+TEST_F(ColumnReaderTest, test_read_by_rowids_with_prefetch) {
+    const int num_rows = 64 * 1024;
+    std::string fname = kTestDir + "/read_by_rowids_with_prefetch";
+    ColumnMetaPB meta;
+    write_int_column(fname, num_rows, &meta);
+    io::FileReaderSPtr file_reader;
+    ASSERT_TRUE(io::global_local_filesystem()->open_file(fname, &file_reader).ok());
+
+    bool enable_local_file_prefetch = config::enable_local_file_prefetch;
+    config::enable_local_file_prefetch = true;
+    for (int step : {1, 7, 3000}) {
+        ColumnReaderOptions reader_opts;
+        std::unique_ptr<ColumnReader> reader;
+        ASSERT_TRUE(ColumnReader::create(reader_opts, meta, num_rows, file_reader, &reader).ok());
+        ColumnIterator* iter = nullptr;
+        ASSERT_TRUE(reader->new_iterator(&iter).ok());
+        std::unique_ptr<ColumnIterator> iter_guard(iter);
+        ColumnIteratorOptions iter_opts;
+        OlapReaderStatistics stats;
+        iter_opts.stats = &stats;
+        iter_opts.file_reader = file_reader.get();
+        ASSERT_TRUE(iter->init(iter_opts).ok());
+
+        std::vector<rowid_t> rowids;
+        for (int rowid = 5; rowid < num_rows; rowid += step) {
+            rowids.push_back(rowid);
+        }
+        int64_t prefetched_bytes = DorisMetrics::instance()->local_bytes_prefetched_total->value();
+        vectorized::MutableColumnPtr dst = vectorized::ColumnInt32::create();
+        ASSERT_TRUE(iter->read_by_rowids(rowids.data(), rowids.size(), dst).ok());
+        EXPECT_GT(DorisMetrics::instance()->local_bytes_prefetched_total->value(),
+                  prefetched_bytes);
+
+        const auto& values = assert_cast<const vectorized::ColumnInt32&>(*dst).get_data();
+        ASSERT_EQ(rowids.size(), values.size());
+        for (size_t i = 0; i < rowids.size(); ++i) {
+            EXPECT_EQ(static_cast<int32_t>(rowids[i]), values[i]);
+        }
+    }
+    config::enable_local_file_prefetch = enable_local_file_prefetch;
+}
+
+TEST_F(ColumnReaderTest, test_sequential_read_ahead) {
+    const int num_rows = 64 * 1024;
+    std::string fname = kTestDir + "/sequential_read_ahead";
+    ColumnMetaPB meta;
+    write_int_column(fname, num_rows, &meta);
+    io::FileReaderSPtr file_reader;
+    ASSERT_TRUE(io::global_local_filesystem()->open_file(fname, &file_reader).ok());
+
+    // scan the whole column in batches and return the number of pages read ahead
+    auto scan = [&](int32_t max_pages, const roaring::Roaring* row_bitmap) -> int64_t {
+        int32_t segment_read_ahead_max_pages = config::segment_read_ahead_max_pages;
+        config::segment_read_ahead_max_pages = max_pages;
+        ColumnReaderOptions reader_opts;
+        std::unique_ptr<ColumnReader> reader;
+        EXPECT_TRUE(ColumnReader::create(reader_opts, meta, num_rows, file_reader, &reader).ok());
+        ColumnIterator* iter = nullptr;
+        EXPECT_TRUE(reader->new_iterator(&iter).ok());
+        std::unique_ptr<ColumnIterator> iter_guard(iter);
+        ColumnIteratorOptions iter_opts;
+        OlapReaderStatistics stats;
+        iter_opts.stats = &stats;
+        iter_opts.file_reader = file_reader.get();
+        iter_opts.row_bitmap = row_bitmap;
+        EXPECT_TRUE(iter->init(iter_opts).ok());
+        EXPECT_TRUE(iter->seek_to_first().ok());
+
+        int32_t expected = 0;
+        while (expected < num_rows) {
+            vectorized::MutableColumnPtr dst = vectorized::ColumnInt32::create();
+            size_t rows_read = 1024;
+            bool has_null = false;
+            EXPECT_TRUE(iter->next_batch(&rows_read, dst, &has_null).ok());
+            EXPECT_GT(rows_read, 0U);
+            if (rows_read == 0) {
+                break;
+            }
+            const auto& values = assert_cast<const vectorized::ColumnInt32&>(*dst).get_data();
+            for (auto value : values) {
+                EXPECT_EQ(expected++, value);
+            }
+        }
+        config::segment_read_ahead_max_pages = segment_read_ahead_max_pages;
+        return stats.read_ahead_pages_num;
+    };
+
+    EXPECT_GT(scan(4, nullptr), 0);
+    EXPECT_EQ(0, scan(0, nullptr));
+    // only the first and the last page have rows left, no page in between is read ahead
+    roaring::Roaring row_bitmap;
+    row_bitmap.addRange(0, 10);
+    row_bitmap.add(num_rows - 1);
+    EXPECT_LE(scan(4, &row_bitmap), 1);
+}
+
+TEST_F(ColumnReaderTest, test_read_ahead_leaves_page_cache_unchanged) {
+    const int num_rows = 64 * 1024;
+    std::string fname = kTestDir + "/read_ahead_leaves_page_cache_unchanged";
+    ColumnMetaPB meta;
+    write_int_column(fname, num_rows, &meta);
+    io::FileReaderSPtr file_reader;
+    ASSERT_TRUE(io::global_local_filesystem()->open_file(fname, &file_reader).ok());
+
+    struct CacheState {
+        uint64_t lookup_count = 0;
+        uint64_t hit_count = 0;
+        // keys of the cached pages, from the least recently used one
+        std::vector<std::string> keys;
+        std::vector<uint64_t> sketch;
+    };
+    // Scan the first `rows` rows of the column through the page cache.
+    auto scan = [&](int rows) {
+        ColumnReaderOptions reader_opts;
+        std::unique_ptr<ColumnReader> reader;
+        EXPECT_TRUE(ColumnReader::create(reader_opts, meta, num_rows, file_reader, &reader).ok());
+        ColumnIterator* iter = nullptr;
+        EXPECT_TRUE(reader->new_iterator(&iter).ok());
+        std::unique_ptr<ColumnIterator> iter_guard(iter);
+        ColumnIteratorOptions iter_opts;
+        OlapReaderStatistics stats;
+        iter_opts.stats = &stats;
+        iter_opts.file_reader = file_reader.get();
+        iter_opts.use_page_cache = true;
+        iter_opts.type = DATA_PAGE;
+        EXPECT_TRUE(iter->init(iter_opts).ok());
+        EXPECT_TRUE(iter->seek_to_first().ok());
+        for (int read = 0; read < rows;) {
+            vectorized::MutableColumnPtr dst = vectorized::ColumnInt32::create();
+            size_t rows_read = 1024;
+            bool has_null = false;
+            EXPECT_TRUE(iter->next_batch(&rows_read, dst, &has_null).ok());
+            EXPECT_GT(rows_read, 0U);
+            if (rows_read == 0) {
+                break;
+            }
+            read += static_cast<int>(rows_read);
+        }
+        return stats.read_ahead_pages_num;
+    };
+    // With all pages cached by a full scan, scan the first quarter of the column again with
+    // read ahead of up to `max_pages` pages, and return the state of the page cache.
+    auto scan_cached = [&](int32_t max_pages, int64_t* read_ahead_pages) {
+        // a single shard of the data page cache, large enough for all pages
+        StoragePageCache cache(4 * 1024 * 1024, 0, 0, 1);
+        auto* old_cache = ExecEnv::GetInstance()->get_storage_page_cache();
+        ExecEnv::GetInstance()->set_storage_page_cache(&cache);
+        int32_t segment_read_ahead_max_pages = config::segment_read_ahead_max_pages;
+        config::segment_read_ahead_max_pages = 0;
+        scan(num_rows);
+        config::segment_read_ahead_max_pages = max_pages;
+        *read_ahead_pages = scan(num_rows / 4);
+        config::segment_read_ahead_max_pages = segment_read_ahead_max_pages;
+        ExecEnv::GetInstance()->set_storage_page_cache(old_cache);
+
+        auto* shard = static_cast<ShardedLRUCache*>(cache._data_page_cache->get())->_shards[0];
+        CacheState state;
+        state.lookup_count = shard->get_lookup_count();
+        state.hit_count = shard->get_hit_count();
+        for (auto* e = shard->_lru_normal.next; e != &shard->_lru_normal; e = e->next) {
+            state.keys.emplace_back(e->key().data(), e->key().size());
+        }
+        state.sketch = shard->_sketch._table;
+        return state;
+    };
+
+    std::string eviction_policy = config::storage_page_cache_eviction_policy;
+    std::string tinylfu_admission_cache_types = config::tinylfu_admission_cache_types;
+    config::storage_page_cache_eviction_policy = "LRU";
+    config::tinylfu_admission_cache_types = "DataPageCache";
+    int64_t read_ahead_pages = 0;
+    auto expected = scan_cached(0, &read_ahead_pages);
+    EXPECT_EQ(0, read_ahead_pages);
+    auto state = scan_cached(8, &read_ahead_pages);
+    config::storage_page_cache_eviction_policy = eviction_policy;
+    config::tinylfu_admission_cache_types = tinylfu_admission_cache_types;
+
+    // the pages read ahead are all cached, they are neither looked up nor moved in the LRU list
+    EXPECT_GT(read_ahead_pages, 0);
+    EXPECT_GT(expected.hit_count, 0U);
+    EXPECT_GT(expected.keys.size(), 16U);
+    EXPECT_FALSE(expected.sketch.empty());
+    EXPECT_EQ(expected.lookup_count, state.lookup_count);
+    EXPECT_EQ(expected.hit_count, state.hit_count);
+    EXPECT_EQ(expected.keys, state.keys);
+    EXPECT_EQ(expected.sketch, state.sketch);
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,358 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gen_cpp/olap_file.pb.h>
+#include <gen_cpp/segment_v2.pb.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "io/fs/file_reader.h"
+#include "io/fs/file_writer.h"
+#include "io/fs/local_file_system.h"
+#include "olap/column_predicate.h"
+#include "olap/comparison_predicate.h"
+#include "olap/iterators.h"
+#include "olap/olap_common.h"
+#include "olap/page_cache.h"
+#include "olap/rowset/segment_v2/bitshuffle_page.h"
+#include "olap/rowset/segment_v2/bitshuffle_page_pre_decoder.h"
+#include "olap/rowset/segment_v2/column_reader.h"
+#include "olap/rowset/segment_v2/column_writer.h"
+#include "olap/rowset/segment_v2/options.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/rowset/segment_v2/segment_iterator.h"
+#include "olap/rowset/segment_v2/segment_writer.h"
+#include "olap/schema.h"
+#include "olap/tablet_schema.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
+#include "vec/columns/predicate_column.h"
+#include "vec/core/block.h"
+
+namespace doris {
+namespace segment_v2 {
+
+static const std::string kTestDir = "./ut_dir/page_predicate_evaluation_test";
+
+// Predicates on the INT values evaluated on pages, each test compares them with the evaluation
+// on the materialized predicate column, the path taken when enable_page_predicate_evaluation is
+// false.
+class PagePredicateEvaluationTest : public testing::Test {
+protected:
+    void SetUp() override {
+        EXPECT_TRUE(io::global_local_filesystem()->delete_and_create_directory(kTestDir).ok());
+        _enable_page_predicate_evaluation = config::enable_page_predicate_evaluation;
+    }
+
+    void TearDown() override {
+        config::enable_page_predicate_evaluation = _enable_page_predicate_evaluation;
+        EXPECT_TRUE(io::global_local_filesystem()->delete_directory(kTestDir).ok());
+    }
+
+    // value >= 1000 and value < 8000
+    void create_predicates(ColumnId cid) {
+        _predicates.emplace_back(
+                new ComparisonPredicateBase<TYPE_INT, PredicateType::GE>(cid, 1000));
+        _predicates.emplace_back(
+                new ComparisonPredicateBase<TYPE_INT, PredicateType::LT>(cid, 8000));
+        for (auto& predicate : _predicates) {
+            _raw_predicates.push_back(predicate.get());
+        }
+    }
+
+    // value of row i, a permutation of 0..10006
+    static int32_t value_of(int i) { return static_cast<int32_t>(i * 7919L % 10007); }
+    // runs of 50 nulls after every 100 not null rows
+    static bool is_null_of(int i) { return i / 50 % 3 == 2; }
+
+    bool _enable_page_predicate_evaluation;
+    std::vector<std::unique_ptr<ColumnPredicate>> _predicates;
+    std::vector<ColumnPredicate*> _raw_predicates;
+};
+
+TEST_F(PagePredicateEvaluationTest, BitShufflePageDecoder) {
+    const size_t num_values = 3000;
+    std::vector<int32_t> values(num_values);
+    for (size_t i = 0; i < num_values; ++i) {
+        values[i] = value_of(static_cast<int>(i));
+    }
+    PageBuilderOptions builder_options;
+    builder_options.data_page_size = 256 * 1024;
+    BitshufflePageBuilder<FieldType::OLAP_FIELD_TYPE_INT> page_builder(builder_options);
+    size_t count = num_values;
+    ASSERT_TRUE(page_builder.add(reinterpret_cast<const uint8_t*>(values.data()), &count).ok());
+    OwnedSlice page = page_builder.finish();
+    BitShufflePagePreDecoder<false> pre_decoder;
+    Slice page_slice = page.slice();
+    std::unique_ptr<DataPage> decoded_page;
+    ASSERT_TRUE(pre_decoder.decode(&decoded_page, &page_slice, 0).ok());
+
+    create_predicates(0);
+    PageDecoderOptions decoder_options;
+    BitShufflePageDecoder<FieldType::OLAP_FIELD_TYPE_INT> page_decoder(page_slice,
+                                                                       decoder_options);
+    BitShufflePageDecoder<FieldType::OLAP_FIELD_TYPE_INT> column_decoder(page_slice,
+                                                                         decoder_options);
+    ASSERT_TRUE(page_decoder.init().ok());
+    ASSERT_TRUE(column_decoder.init().ok());
+    // start in the middle of the page, batches end past the last value
+    ASSERT_TRUE(page_decoder.seek_to_position_in_page(17).ok());
+    ASSERT_TRUE(column_decoder.seek_to_position_in_page(17).ok());
+    size_t num_passed = 0;
+    for (size_t offset = 17; offset < num_values;) {
+        size_t n = 1000;
+        bool page_flags[1000];
+        memset(page_flags, 1, n);
+        ASSERT_TRUE(page_decoder.evaluate_and_vec(_raw_predicates, &n, page_flags).ok());
+        ASSERT_EQ(std::min<size_t>(1000, num_values - offset), n);
+
+        size_t rows_read = n;
+        vectorized::MutableColumnPtr column = vectorized::PredicateColumnType<TYPE_INT>::create();
+        ASSERT_TRUE(column_decoder.next_batch(&rows_read, column).ok());
+        ASSERT_EQ(n, rows_read);
+        bool column_flags[1000];
+        memset(column_flags, 1, n);
+        for (auto* predicate : _raw_predicates) {
+            predicate->evaluate_and_vec(*column, static_cast<uint16_t>(n), column_flags);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(column_flags[i], page_flags[i]) << "value " << offset + i;
+            num_passed += page_flags[i];
+        }
+        EXPECT_EQ(offset + n, page_decoder.current_index());
+        offset += n;
+    }
+    EXPECT_GT(num_passed, 0U);
+    EXPECT_LT(num_passed, num_values - 17);
+
+    size_t n = 10;
+    bool flags[10];
+    EXPECT_TRUE(page_decoder.evaluate_and_vec(_raw_predicates, &n, flags).ok());
+    EXPECT_EQ(0U, n);
+
+    // the predicate of a NOT can not be evaluated on the page
+    ComparisonPredicateBase<TYPE_INT, PredicateType::LT> opposite(0, 8000, true);
+    std::vector<ColumnPredicate*> opposite_predicates {&opposite};
+    ASSERT_TRUE(page_decoder.seek_to_position_in_page(0).ok());
+    n = 10;
+    EXPECT_TRUE(page_decoder.evaluate_and_vec(opposite_predicates, &n, flags)
+                        .is<ErrorCode::NOT_IMPLEMENTED_ERROR>());
+}
+
+TEST_F(PagePredicateEvaluationTest, FileColumnIteratorWithNullRuns) {
+    // a nullable INT column in pages of about 4KB, the null runs cross the page boundaries
+    const int num_rows = 20000;
+    std::string fname = kTestDir + "/nullable_int_column";
+    ColumnMetaPB meta;
+    {
+        io::FileWriterPtr file_writer;
+        ASSERT_TRUE(io::global_local_filesystem()->create_file(fname, &file_writer).ok());
+        ColumnWriterOptions writer_opts;
+        writer_opts.meta = &meta;
+        meta.set_column_id(0);
+        meta.set_unique_id(0);
+        meta.set_type(FieldType::OLAP_FIELD_TYPE_INT);
+        meta.set_length(0);
+        meta.set_encoding(BIT_SHUFFLE);
+        meta.set_compression(segment_v2::CompressionTypePB::LZ4F);
+        meta.set_is_nullable(true);
+        writer_opts.data_page_size = 4096;
+
+        TabletColumn column(OLAP_FIELD_AGGREGATION_NONE, FieldType::OLAP_FIELD_TYPE_INT, true);
+        std::unique_ptr<ColumnWriter> writer;
+        ASSERT_TRUE(ColumnWriter::create(writer_opts, &column, file_writer.get(), &writer).ok());
+        ASSERT_TRUE(writer->init().ok());
+        std::vector<int32_t> values(num_rows);
+        std::vector<uint8_t> null_map(num_rows);
+        for (int i = 0; i < num_rows; ++i) {
+            values[i] = value_of(i);
+            null_map[i] = is_null_of(i);
+        }
+        const auto* data = reinterpret_cast<const uint8_t*>(values.data());
+        ASSERT_TRUE(writer->append_nullable(null_map.data(), &data, num_rows).ok());
+        ASSERT_TRUE(writer->finish().ok());
+        ASSERT_TRUE(writer->write_data().ok());
+        ASSERT_TRUE(writer->write_ordinal_index().ok());
+        ASSERT_TRUE(file_writer->close().ok());
+    }
+    io::FileReaderSPtr file_reader;
+    ASSERT_TRUE(io::global_local_filesystem()->open_file(fname, &file_reader).ok());
+    ColumnReaderOptions reader_opts;
+    std::unique_ptr<ColumnReader> reader;
+    ASSERT_TRUE(ColumnReader::create(reader_opts, meta, num_rows, file_reader, &reader).ok());
+    create_predicates(0);
+
+    // iterators positioned at row `ordinal`
+    OlapReaderStatistics stats;
+    auto new_iterator = [&](ordinal_t ordinal) {
+        ColumnIterator* iter = nullptr;
+        EXPECT_TRUE(reader->new_iterator(&iter).ok());
+        std::unique_ptr<ColumnIterator> iter_guard(iter);
+        ColumnIteratorOptions iter_opts;
+        iter_opts.stats = &stats;
+        iter_opts.file_reader = file_reader.get();
+        EXPECT_TRUE(iter->init(iter_opts).ok());
+        EXPECT_TRUE(iter->seek_to_ordinal(ordinal).ok());
+        return iter_guard;
+    };
+    // the first row is inside a null run, and a batch of 999 rows never ends at a page boundary
+    const ordinal_t first = 120;
+    auto page_iter = new_iterator(first);
+    auto column_iter = new_iterator(first);
+    ASSERT_TRUE(page_iter->can_evaluate_on_page());
+    size_t num_passed = 0;
+    for (size_t row = first; row < num_rows;) {
+        size_t n = 999;
+        bool page_flags[999];
+        memset(page_flags, 1, n);
+        ASSERT_TRUE(page_iter->evaluate_and_vec(_raw_predicates, &n, page_flags).ok());
+        ASSERT_EQ(std::min<size_t>(999, num_rows - row), n);
+
+        size_t rows_read = n;
+        bool has_null = false;
+        vectorized::MutableColumnPtr column = vectorized::ColumnNullable::create(
+                vectorized::PredicateColumnType<TYPE_INT>::create(),
+                vectorized::ColumnUInt8::create());
+        ASSERT_TRUE(column_iter->next_batch(&rows_read, column, &has_null).ok());
+        ASSERT_EQ(n, rows_read);
+        bool column_flags[999];
+        memset(column_flags, 1, n);
+        for (auto* predicate : _raw_predicates) {
+            predicate->evaluate_and_vec(*column, static_cast<uint16_t>(n), column_flags);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(column_flags[i], page_flags[i]) << "row " << row + i;
+            if (is_null_of(static_cast<int>(row + i))) {
+                ASSERT_FALSE(page_flags[i]) << "row " << row + i;
+            }
+            num_passed += page_flags[i];
+        }
+        EXPECT_EQ(row + n, page_iter->get_current_ordinal());
+        row += n;
+    }
+    EXPECT_GT(num_passed, 0U);
+}
+
+TEST_F(PagePredicateEvaluationTest, SegmentIterator) {
+    // (k INT, v INT, p INT), v and p are nullable, a duplicate key table
+    TabletSchemaPB tablet_schema_pb;
+    tablet_schema_pb.set_keys_type(DUP_KEYS);
+    tablet_schema_pb.set_num_short_key_columns(1);
+    for (int cid = 0; cid < 3; ++cid) {
+        ColumnPB* column = tablet_schema_pb.add_column();
+        column->set_unique_id(cid);
+        column->set_name(std::string(1, "kvp"[cid]));
+        column->set_type("INT");
+        column->set_is_key(cid == 0);
+        column->set_length(4);
+        column->set_index_length(4);
+        column->set_is_nullable(cid != 0);
+    }
+    auto tablet_schema = std::make_shared<TabletSchema>();
+    tablet_schema->init_from_pb(tablet_schema_pb);
+
+    // rows of k = i, v = i % 13 and p = value_of(i) in more than one block and data page
+    const int num_rows = 50000;
+    std::string path = kTestDir + "/segment.dat";
+    {
+        io::FileWriterPtr file_writer;
+        ASSERT_TRUE(io::global_local_filesystem()->create_file(path, &file_writer).ok());
+        SegmentWriterOptions opts;
+        SegmentWriter writer(file_writer.get(), 0, tablet_schema, nullptr, nullptr, INT32_MAX,
+                             opts, nullptr);
+        ASSERT_TRUE(writer.init().ok());
+        auto block = tablet_schema->create_block();
+        auto columns = block.mutate_columns();
+        for (int i = 0; i < num_rows; ++i) {
+            int values[] = {i, i % 13, value_of(i)};
+            for (int cid = 0; cid < 3; ++cid) {
+                if (cid == 2 && is_null_of(i)) {
+                    columns[cid]->insert_data(nullptr, 0);
+                } else {
+                    columns[cid]->insert_data((const char*)&values[cid], sizeof(int));
+                }
+            }
+        }
+        block.set_columns(std::move(columns));
+        ASSERT_TRUE(writer.append_block(&block, 0, block.rows()).ok());
+        uint64_t file_size = 0;
+        uint64_t index_size = 0;
+        ASSERT_TRUE(writer.finalize(&file_size, &index_size).ok());
+        ASSERT_TRUE(file_writer->close().ok());
+    }
+    std::shared_ptr<Segment> segment;
+    ASSERT_TRUE(Segment::open(io::global_local_filesystem(), path, 0, RowsetId(), tablet_schema,
+                              io::FileReaderOptions {}, &segment)
+                        .ok());
+
+    // p >= 1000 and p < 8000 and v != 7, p is only read by the predicates
+    create_predicates(2);
+    ComparisonPredicateBase<TYPE_INT, PredicateType::NE> v_predicate(1, 7);
+    const std::set<int32_t> output_columns {0, 1};
+    // return the (k, v) rows of the scan and the number of columns evaluated on pages
+    auto scan = [&](bool enable_page_predicate_evaluation, size_t* num_page_eval_columns) {
+        config::enable_page_predicate_evaluation = enable_page_predicate_evaluation;
+        OlapReaderStatistics stats;
+        StorageReadOptions opts;
+        opts.stats = &stats;
+        opts.tablet_schema = tablet_schema;
+        opts.io_ctx.reader_type = ReaderType::READER_QUERY;
+        opts.column_predicates = _raw_predicates;
+        opts.column_predicates.push_back(&v_predicate);
+        opts.output_columns = &output_columns;
+        std::unique_ptr<RowwiseIterator> iter;
+        auto st = segment->new_iterator(std::make_shared<Schema>(tablet_schema), opts, &iter);
+        EXPECT_TRUE(st.ok()) << st;
+        std::vector<std::string> rows;
+        while (st.ok()) {
+            auto block = tablet_schema->create_block();
+            st = iter->next_batch(&block);
+            EXPECT_TRUE(st.ok() || st.is<ErrorCode::END_OF_FILE>()) << st;
+            for (size_t i = 0; i < block.rows(); ++i) {
+                rows.push_back(block.dump_one_line(i, 2));
+            }
+        }
+        auto* segment_iter = static_cast<SegmentIterator*>(iter.get());
+        *num_page_eval_columns = segment_iter->_page_eval_columns.size();
+        return rows;
+    };
+
+    size_t num_page_eval_columns = 0;
+    auto expected = scan(false, &num_page_eval_columns);
+    EXPECT_EQ(0U, num_page_eval_columns);
+    auto rows = scan(true, &num_page_eval_columns);
+    EXPECT_EQ(1U, num_page_eval_columns);
+    EXPECT_EQ(expected, rows);
+
+    size_t num_passed = 0;
+    for (int i = 0; i < num_rows; ++i) {
+        int32_t p = value_of(i);
+        num_passed += !is_null_of(i) && p >= 1000 && p < 8000 && i % 13 != 7;
+    }
+    EXPECT_GT(num_passed, 0U);
+    EXPECT_EQ(num_passed, rows.size());
+}
+
+} // namespace segment_v2
+} // namespace doris
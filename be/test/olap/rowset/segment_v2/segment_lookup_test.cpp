@@ -0,0 +1,262 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <fmt/format.h>
+#include <gen_cpp/olap_file.pb.h>
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <memory>
+#include <string>
+
+#include "common/config.h"
+#include "gtest/gtest_pred_impl.h"
+#include "io/fs/file_writer.h"
+#include "io/fs/local_file_system.h"
+#include "olap/olap_common.h"
+#include "olap/primary_key_index.h"
+#include "olap/rowset/segment_v2/indexed_column_reader.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/rowset/segment_v2/segment_writer.h"
+#include "olap/tablet_schema.h"
+#include "olap/utils.h"
+#include "vec/core/block.h"
+
+namespace doris {
+namespace segment_v2 {
+
+static const std::string kSegmentDir = "./ut_dir/segment_lookup_test";
+
+class SegmentLookupTest : public testing::Test {
+protected:
+    void SetUp() override {
+        EXPECT_TRUE(io::global_local_filesystem()->delete_and_create_directory(kSegmentDir).ok());
+        // small pages of the primary key index, so that the lookups cross many of them
+        _primary_key_data_page_size = config::primary_key_data_page_size;
+        config::primary_key_data_page_size = 1024;
+        _mow_pk_hash_index_max_rows = config::mow_pk_hash_index_max_rows;
+        config::mow_pk_hash_index_max_rows = 0;
+    }
+
+    void TearDown() override {
+        config::primary_key_data_page_size = _primary_key_data_page_size;
+        config::mow_pk_hash_index_max_rows = _mow_pk_hash_index_max_rows;
+        EXPECT_TRUE(io::global_local_filesystem()->delete_directory(kSegmentDir).ok());
+    }
+
+    // (k INT, v INT[, __DORIS_SEQUENCE_COL__ INT]) of a merge-on-write unique key table
+    static TabletSchemaSPtr create_schema(bool has_sequence_col) {
+        TabletSchemaPB tablet_schema_pb;
+        tablet_schema_pb.set_keys_type(UNIQUE_KEYS);
+        tablet_schema_pb.set_num_short_key_columns(1);
+        int32_t unique_id = 0;
+        auto add_column = [&](const std::string& name, bool is_key) {
+            ColumnPB* column = tablet_schema_pb.add_column();
+            column->set_unique_id(++unique_id);
+            column->set_name(name);
+            column->set_type("INT");
+            column->set_is_key(is_key);
+            column->set_length(4);
+            column->set_index_length(4);
+            column->set_is_nullable(false);
+            if (!is_key) {
+                column->set_aggregation("REPLACE");
+            }
+        };
+        add_column("k", true);
+        add_column("v", false);
+        if (has_sequence_col) {
+            add_column(SEQUENCE_COL, false);
+        }
+        auto tablet_schema = std::make_shared<TabletSchema>();
+        tablet_schema->init_from_pb(tablet_schema_pb);
+        return tablet_schema;
+    }
+
+    // A segment of the keys `step`, 2 * `step`, ... up to `max_key`, the sequence of key k is
+    // k % `seq_mod`.
+    static std::shared_ptr<Segment> create_segment(const TabletSchemaSPtr& tablet_schema,
+                                                   const std::string& name, int step, int max_key,
+                                                   int seq_mod) {
+        std::string path = kSegmentDir + "/" + name;
+        auto fs = io::global_local_filesystem();
+        io::FileWriterPtr file_writer;
+        EXPECT_TRUE(fs->create_file(path, &file_writer).ok());
+        SegmentWriterOptions opts;
+        opts.enable_unique_key_merge_on_write = true;
+        SegmentWriter writer(file_writer.get(), 0, tablet_schema, nullptr, nullptr, INT32_MAX,
+                             opts, nullptr);
+        EXPECT_TRUE(writer.init().ok());
+        auto block = tablet_schema->create_block();
+        auto columns = block.mutate_columns();
+        for (int k = step; k <= max_key; k += step) {
+            int values[] = {k, k * 3, k % seq_mod};
+            for (size_t cid = 0; cid < columns.size(); ++cid) {
+                columns[cid]->insert_data((const char*)&values[cid], sizeof(int));
+            }
+        }
+        block.set_columns(std::move(columns));
+        auto st = writer.append_block(&block, 0, block.rows());
+        EXPECT_TRUE(st.ok()) << st;
+        uint64_t file_size = 0;
+        uint64_t index_size = 0;
+        st = writer.finalize(&file_size, &index_size);
+        EXPECT_TRUE(st.ok()) << st;
+        EXPECT_TRUE(file_writer->close().ok());
+
+        std::shared_ptr<Segment> segment;
+        st = Segment::open(fs, path, 0, RowsetId(), tablet_schema, io::FileReaderOptions {},
+                           &segment);
+        EXPECT_TRUE(st.ok()) << st;
+        return segment;
+    }
+
+    // Look up every key of 1..10001 in a segment of the even keys 2..10000, in ascending order
+    // with one shared index iterator, and compare every result with a lookup by a fresh one.
+    // The odd keys and 10001 miss, the hits include the first and last keys of every page.
+    void lookup_keys(bool has_sequence_col, bool with_seq_col) {
+        auto tablet_schema = create_schema(has_sequence_col);
+        std::string suffix = fmt::format("{}_{}.dat", has_sequence_col, with_seq_col);
+        auto segment = create_segment(tablet_schema, "target_" + suffix, 2, 10000, 7);
+        // the keys to look up are read from a segment of the same schema, so they are encoded
+        // like the ones the delete bitmap calculation reads
+        auto probe_segment = create_segment(tablet_schema, "probe_" + suffix, 1, 10001, 5);
+        ASSERT_NE(nullptr, segment);
+        ASSERT_NE(nullptr, probe_segment);
+        ASSERT_TRUE(segment->load_pk_index_and_bf().ok());
+        auto* index_reader = segment->get_primary_key_index()->_index_reader.get();
+        ASSERT_TRUE(index_reader->_has_index_page);
+        ASSERT_GT(index_reader->_ordinal_index_reader.count(), 10U);
+
+        const size_t seq_col_length = has_sequence_col ? sizeof(int) + 1 : 0;
+        std::unique_ptr<IndexedColumnIterator> index_iterator;
+        size_t num_hits = 0;
+        for (uint32_t row_id = 0; row_id < probe_segment->num_rows(); ++row_id) {
+            int k = static_cast<int>(row_id) + 1;
+            std::string key;
+            ASSERT_TRUE(probe_segment->read_key_by_rowid(row_id, &key).ok());
+            if (!with_seq_col) {
+                key.resize(key.size() - seq_col_length);
+            }
+            RowLocation shared_loc;
+            auto shared_st =
+                    segment->lookup_row_key(key, with_seq_col, &shared_loc, &index_iterator);
+            RowLocation fresh_loc;
+            auto fresh_st = segment->lookup_row_key(key, with_seq_col, &fresh_loc);
+            ASSERT_EQ(fresh_st.code(), shared_st.code()) << "key " << k << ": " << shared_st;
+            if (k % 2 == 1 || k > 10000) {
+                EXPECT_TRUE(shared_st.is<ErrorCode::KEY_NOT_FOUND>()) << "key " << k;
+                continue;
+            }
+            if (with_seq_col && k % 5 < k % 7) {
+                EXPECT_TRUE(shared_st.is<ErrorCode::KEY_ALREADY_EXISTS>())
+                        << "key " << k << ": " << shared_st;
+            } else {
+                EXPECT_TRUE(shared_st.ok()) << "key " << k << ": " << shared_st;
+            }
+            EXPECT_EQ(static_cast<uint32_t>(k / 2 - 1), shared_loc.row_id);
+            EXPECT_EQ(fresh_loc.row_id, shared_loc.row_id);
+            EXPECT_EQ(fresh_loc.segment_id, shared_loc.segment_id);
+            ++num_hits;
+        }
+        EXPECT_EQ(5000U, num_hits);
+        EXPECT_NE(nullptr, index_iterator);
+    }
+
+    // Look up every key of 1..10001 in a segment of the even keys 2..10000 by the primary key
+    // hash index of the segment, and compare every result with a lookup by seeking the index.
+    void lookup_keys_by_hash_index(bool has_sequence_col, bool with_seq_col) {
+        auto tablet_schema = create_schema(has_sequence_col);
+        std::string suffix = fmt::format("hash_{}_{}.dat", has_sequence_col, with_seq_col);
+        auto segment = create_segment(tablet_schema, "target_" + suffix, 2, 10000, 7);
+        auto probe_segment = create_segment(tablet_schema, "probe_" + suffix, 1, 10001, 5);
+        ASSERT_NE(nullptr, segment);
+        ASSERT_NE(nullptr, probe_segment);
+
+        const size_t seq_col_length = has_sequence_col ? sizeof(int) + 1 : 0;
+        size_t num_hits = 0;
+        for (uint32_t row_id = 0; row_id < probe_segment->num_rows(); ++row_id) {
+            int k = static_cast<int>(row_id) + 1;
+            std::string key;
+            ASSERT_TRUE(probe_segment->read_key_by_rowid(row_id, &key).ok());
+            if (!with_seq_col) {
+                key.resize(key.size() - seq_col_length);
+            }
+            config::mow_pk_hash_index_max_rows = 0;
+            RowLocation seek_loc;
+            auto seek_st = segment->lookup_row_key(key, with_seq_col, &seek_loc);
+            config::mow_pk_hash_index_max_rows = 10000;
+            RowLocation hash_loc;
+            auto hash_st = segment->lookup_row_key(key, with_seq_col, &hash_loc);
+            ASSERT_EQ(seek_st.code(), hash_st.code()) << "key " << k << ": " << hash_st;
+            if (k % 2 == 1 || k > 10000) {
+                EXPECT_TRUE(hash_st.is<ErrorCode::KEY_NOT_FOUND>()) << "key " << k;
+                continue;
+            }
+            if (with_seq_col && k % 5 < k % 7) {
+                EXPECT_TRUE(hash_st.is<ErrorCode::KEY_ALREADY_EXISTS>())
+                        << "key " << k << ": " << hash_st;
+            } else {
+                EXPECT_TRUE(hash_st.ok()) << "key " << k << ": " << hash_st;
+            }
+            EXPECT_EQ(static_cast<uint32_t>(k / 2 - 1), hash_loc.row_id);
+            EXPECT_EQ(seek_loc.row_id, hash_loc.row_id);
+            EXPECT_EQ(seek_loc.segment_id, hash_loc.segment_id);
+            ++num_hits;
+        }
+        EXPECT_EQ(5000U, num_hits);
+        EXPECT_NE(nullptr, segment->_pk_hash_index);
+    }
+
+    int32_t _primary_key_data_page_size;
+    int32_t _mow_pk_hash_index_max_rows;
+};
+
+TEST_F(SegmentLookupTest, SharedIteratorWithoutSequenceColumn) {
+    lookup_keys(false, false);
+}
+
+TEST_F(SegmentLookupTest, SharedIteratorWithSequenceColumn) {
+    lookup_keys(true, true);
+    lookup_keys(true, false);
+}
+
+TEST_F(SegmentLookupTest, HashIndexWithoutSequenceColumn) {
+    lookup_keys_by_hash_index(false, false);
+}
+
+TEST_F(SegmentLookupTest, HashIndexWithSequenceColumn) {
+    lookup_keys_by_hash_index(true, true);
+    lookup_keys_by_hash_index(true, false);
+}
+
+TEST_F(SegmentLookupTest, HashIndexOnlyForSmallSegments) {
+    // a segment of more rows than the limit is looked up by seeking its index
+    config::mow_pk_hash_index_max_rows = 100;
+    auto tablet_schema = create_schema(false);
+    auto segment = create_segment(tablet_schema, "large.dat", 2, 10000, 7);
+    ASSERT_NE(nullptr, segment);
+    std::string key;
+    ASSERT_TRUE(segment->read_key_by_rowid(10, &key).ok());
+    RowLocation loc;
+    EXPECT_TRUE(segment->lookup_row_key(key, false, &loc).ok());
+    EXPECT_EQ(10U, loc.row_id);
+    EXPECT_EQ(nullptr, segment->_pk_hash_index);
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,206 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/segment_writer.h"
+
+#include <gen_cpp/olap_file.pb.h>
+#include <gen_cpp/segment_v2.pb.h>
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+#include "gtest/gtest_pred_impl.h"
+#include "io/fs/file_writer.h"
+#include "io/fs/local_file_system.h"
+#include "olap/iterators.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/schema.h"
+#include "olap/tablet_schema.h"
+#include "util/threadpool.h"
+#include "vec/core/block.h"
+
+namespace doris {
+namespace segment_v2 {
+
+static const std::string kSegmentDir = "./ut_dir/segment_writer_test";
+
+class SegmentWriterTest : public testing::Test {
+protected:
+    void SetUp() override {
+        EXPECT_TRUE(io::global_local_filesystem()->delete_and_create_directory(kSegmentDir).ok());
+        _min_columns_per_thread = config::segment_writer_min_columns_per_thread;
+        config::segment_writer_min_columns_per_thread = 8;
+        static_cast<void>(ThreadPoolBuilder("SegmentWriterTestPool")
+                                  .set_min_threads(4)
+                                  .set_max_threads(4)
+                                  .build(&_pool));
+    }
+
+    void TearDown() override {
+        _pool->shutdown();
+        config::segment_writer_min_columns_per_thread = _min_columns_per_thread;
+        EXPECT_TRUE(io::global_local_filesystem()->delete_directory(kSegmentDir).ok());
+    }
+
+    // (k INT, then `num_values` nullable values, alternately INT and VARCHAR)
+    static TabletSchemaSPtr create_schema(int num_values) {
+        TabletSchemaPB tablet_schema_pb;
+        tablet_schema_pb.set_keys_type(DUP_KEYS);
+        tablet_schema_pb.set_num_short_key_columns(1);
+        tablet_schema_pb.set_compression_type(segment_v2::CompressionTypePB::LZ4F);
+        for (int cid = 0; cid <= num_values; ++cid) {
+            ColumnPB* column = tablet_schema_pb.add_column();
+            column->set_unique_id(cid);
+            column->set_name("c" + std::to_string(cid));
+            bool is_int = cid % 2 == 0;
+            column->set_type(is_int ? "INT" : "VARCHAR");
+            column->set_is_key(cid == 0);
+            column->set_length(is_int ? 4 : 32);
+            column->set_index_length(is_int ? 4 : 32);
+            column->set_is_nullable(cid != 0);
+        }
+        auto tablet_schema = std::make_shared<TabletSchema>();
+        tablet_schema->init_from_pb(tablet_schema_pb);
+        return tablet_schema;
+    }
+
+    // Rows [begin, end), row i has key i, the INT value of column c is i * c % 1009 and the
+    // VARCHAR one repeats it up to 3 times, every 11th value is null.
+    static vectorized::Block create_block(const TabletSchemaSPtr& tablet_schema, int begin,
+                                          int end) {
+        auto block = tablet_schema->create_block();
+        auto columns = block.mutate_columns();
+        for (int i = begin; i < end; ++i) {
+            columns[0]->insert_data((const char*)&i, sizeof(i));
+            for (int cid = 1; cid < static_cast<int>(columns.size()); ++cid) {
+                int value = i * cid % 1009;
+                if ((i + cid) % 11 == 0) {
+                    columns[cid]->insert_data(nullptr, 0);
+                } else if (cid % 2 == 0) {
+                    columns[cid]->insert_data((const char*)&value, sizeof(value));
+                } else {
+                    std::string str;
+                    for (int n = 0; n <= value % 3; ++n) {
+                        str += std::to_string(value);
+                    }
+                    columns[cid]->insert_data(str.data(), str.size());
+                }
+            }
+        }
+        block.set_columns(std::move(columns));
+        return block;
+    }
+
+    // Write 10000 rows to a segment, with the column writers on the idle threads of `pool`
+    // if it is not null, and return the bytes of the segment file.
+    std::string write_segment(const TabletSchemaSPtr& tablet_schema, const std::string& path,
+                              ThreadPool* pool) {
+        io::FileWriterPtr file_writer;
+        EXPECT_TRUE(io::global_local_filesystem()->create_file(path, &file_writer).ok());
+        SegmentWriterOptions opts;
+        opts.column_writer_pool = pool;
+        SegmentWriter writer(file_writer.get(), 0, tablet_schema, nullptr, nullptr, INT32_MAX,
+                             opts, nullptr);
+        EXPECT_TRUE(writer.init().ok());
+        for (int begin = 0; begin < 10000; begin += 1000) {
+            if (pool != nullptr) {
+                // the number of threads writing the columns is capped by the idle ones
+                while (pool->num_idle_threads() < 4) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+            auto block = create_block(tablet_schema, begin, begin + 1000);
+            auto st = writer.append_block(&block, 0, block.rows());
+            EXPECT_TRUE(st.ok()) << st;
+        }
+        uint64_t file_size = 0;
+        uint64_t index_size = 0;
+        auto st = writer.finalize(&file_size, &index_size);
+        EXPECT_TRUE(st.ok()) << st;
+        EXPECT_TRUE(file_writer->close().ok());
+
+        std::ifstream file(path, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(file_size, bytes.size());
+        return bytes;
+    }
+
+    // Read every row of the segment.
+    static std::vector<std::string> read_segment(const TabletSchemaSPtr& tablet_schema,
+                                                 const std::string& path) {
+        std::shared_ptr<Segment> segment;
+        auto st = Segment::open(io::global_local_filesystem(), path, 0, RowsetId(), tablet_schema,
+                                io::FileReaderOptions {}, &segment);
+        EXPECT_TRUE(st.ok()) << st;
+        std::vector<std::string> rows;
+        if (!st.ok()) {
+            return rows;
+        }
+        OlapReaderStatistics stats;
+        StorageReadOptions opts;
+        opts.stats = &stats;
+        opts.tablet_schema = tablet_schema;
+        std::unique_ptr<RowwiseIterator> iter;
+        st = segment->new_iterator(std::make_shared<Schema>(tablet_schema), opts, &iter);
+        EXPECT_TRUE(st.ok()) << st;
+        while (st.ok()) {
+            auto block = tablet_schema->create_block();
+            st = iter->next_batch(&block);
+            EXPECT_TRUE(st.ok() || st.is<ErrorCode::END_OF_FILE>()) << st;
+            for (size_t i = 0; i < block.rows(); ++i) {
+                rows.push_back(block.dump_one_line(i, block.columns()));
+            }
+        }
+        return rows;
+    }
+
+    int32_t _min_columns_per_thread;
+    std::unique_ptr<ThreadPool> _pool;
+};
+
+TEST_F(SegmentWriterTest, ParallelColumnWritersMatchSerialWrite) {
+    // 96 columns are written by up to 96 / 8 threads, as many as the idle ones of the pool
+    auto tablet_schema = create_schema(95);
+    auto serial_path = kSegmentDir + "/serial.dat";
+    auto parallel_path = kSegmentDir + "/parallel.dat";
+    auto serial_bytes = write_segment(tablet_schema, serial_path, nullptr);
+    auto parallel_bytes = write_segment(tablet_schema, parallel_path, _pool.get());
+    ASSERT_FALSE(serial_bytes.empty());
+    EXPECT_TRUE(serial_bytes == parallel_bytes);
+
+    auto expected = read_segment(tablet_schema, serial_path);
+    ASSERT_EQ(10000U, expected.size());
+    for (int begin = 0; begin < 10000; begin += 1000) {
+        auto block = create_block(tablet_schema, begin, begin + 1000);
+        for (size_t i = 0; i < block.rows(); ++i) {
+            EXPECT_EQ(block.dump_one_line(i, block.columns()), expected[begin + i]);
+        }
+    }
+    EXPECT_EQ(expected, read_segment(tablet_schema, parallel_path));
+}
+
+} // namespace segment_v2
+} // namespace doris
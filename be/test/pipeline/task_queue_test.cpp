@@ -0,0 +1,310 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "pipeline/task_queue.h"
+
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/Types_types.h>
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "gtest/gtest_pred_impl.h"
+#include "pipeline/pipeline.h"
+#include "pipeline/pipeline_task.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "util/cpu_info.h"
+
+namespace doris::pipeline {
+
+class TaskQueueTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _pipeline = std::make_shared<Pipeline>(0, std::weak_ptr<PipelineFragmentContext>());
+    }
+
+    // a task without operators, enough for the task queues, of the fragment instance `instance`
+    PipelineTask* create_task(int64_t instance) {
+        TUniqueId instance_id;
+        instance_id.__set_hi(instance);
+        instance_id.__set_lo(instance);
+        auto& state = _states.emplace_back(std::make_unique<RuntimeState>(
+                instance_id, TQueryOptions(), TQueryGlobals(), ExecEnv::GetInstance()));
+        auto& task = _tasks.emplace_back(std::make_unique<PipelineTask>(
+                _pipeline, _tasks.size(), state.get(), nullptr, nullptr));
+        return task.get();
+    }
+
+    PipelinePtr _pipeline;
+    std::vector<std::unique_ptr<RuntimeState>> _states;
+    std::vector<std::unique_ptr<PipelineTask>> _tasks;
+};
+
+// Fakes a NUMA topology for the lifetime of the object and restores the real one afterwards.
+class FakeNumaTopology {
+public:
+    FakeNumaTopology(int num_numa_nodes, const std::vector<int>& core_to_numa_node) {
+        _max_num_numa_nodes = CpuInfo::get_max_num_numa_nodes();
+        for (int core = 0; core < CpuInfo::get_max_num_cores(); ++core) {
+            _core_to_numa_node.push_back(CpuInfo::get_numa_node_of_core(core));
+        }
+        CpuInfo::_init_fake_numa_for_test(num_numa_nodes, core_to_numa_node);
+        _enable_pipeline_numa_affinity = config::enable_pipeline_numa_affinity;
+        config::enable_pipeline_numa_affinity = true;
+    }
+
+    ~FakeNumaTopology() {
+        CpuInfo::_init_fake_numa_for_test(_max_num_numa_nodes, _core_to_numa_node);
+        config::enable_pipeline_numa_affinity = _enable_pipeline_numa_affinity;
+    }
+
+private:
+    int _max_num_numa_nodes;
+    std::vector<int> _core_to_numa_node;
+    bool _enable_pipeline_numa_affinity;
+};
+
+TEST_F(TaskQueueTest, NumaAffinityFallback) {
+    const size_t num_workers = 8;
+    {
+        // disabled by config
+        std::vector<int> core_to_numa_node(CpuInfo::get_max_num_cores());
+        for (size_t core = 0; core < core_to_numa_node.size(); ++core) {
+            core_to_numa_node[core] = core % 2;
+        }
+        FakeNumaTopology topology(2, core_to_numa_node);
+        config::enable_pipeline_numa_affinity = false;
+        MultiCoreTaskQueue queue(num_workers);
+        for (size_t i = 0; i < num_workers; ++i) {
+            EXPECT_EQ(-1, queue.numa_node(i));
+        }
+    }
+    {
+        // a single NUMA node
+        FakeNumaTopology topology(1, std::vector<int>(CpuInfo::get_max_num_cores(), 0));
+        MultiCoreTaskQueue queue(num_workers);
+        for (size_t i = 0; i < num_workers; ++i) {
+            EXPECT_EQ(-1, queue.numa_node(i));
+        }
+    }
+    {
+        // several NUMA nodes, but only one of them has cores
+        FakeNumaTopology topology(3, std::vector<int>(CpuInfo::get_max_num_cores(), 1));
+        MultiCoreTaskQueue queue(num_workers);
+        for (size_t i = 0; i < num_workers; ++i) {
+            EXPECT_EQ(-1, queue.numa_node(i));
+        }
+        // tasks are still spread round robin over all the workers
+        for (size_t i = 0; i < num_workers; ++i) {
+            EXPECT_TRUE(queue.push_back(create_task(1)).ok());
+        }
+        for (size_t i = 0; i < num_workers; ++i) {
+            EXPECT_EQ(1, queue._prio_task_queue_list[i].task_size());
+        }
+        queue.close();
+    }
+}
+
+TEST_F(TaskQueueTest, NumaAffinity) {
+    if (CpuInfo::num_cores() < 2) {
+        GTEST_SKIP() << "needs at least 2 cores to fake 2 NUMA nodes";
+    }
+    // cores alternate between node 0 and node 2, node 1 is a memory only node
+    std::vector<int> core_to_numa_node(CpuInfo::get_max_num_cores());
+    for (size_t core = 0; core < core_to_numa_node.size(); ++core) {
+        core_to_numa_node[core] = core % 2 == 0 ? 0 : 2;
+    }
+    FakeNumaTopology topology(3, core_to_numa_node);
+    const size_t num_workers = 8;
+    MultiCoreTaskQueue queue(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        EXPECT_EQ(CpuInfo::get_numa_node_of_core(i % CpuInfo::num_cores()), queue.numa_node(i));
+    }
+
+    // all the tasks of an instance are pushed to the workers of one node
+    for (int64_t instance = 0; instance < 4; ++instance) {
+        for (size_t i = 0; i < num_workers; ++i) {
+            EXPECT_TRUE(queue.push_back(create_task(instance)).ok());
+        }
+        std::set<int> nodes;
+        for (size_t i = 0; i < num_workers; ++i) {
+            while (auto* task = queue._prio_task_queue_list[i].try_take(false)) {
+                EXPECT_EQ(instance, task->instance_id().hi);
+                nodes.insert(queue.numa_node(i));
+            }
+        }
+        EXPECT_EQ(1U, nodes.size());
+    }
+
+    // an idle worker steals from its own node before the other nodes
+    size_t worker = 0;
+    size_t same_node_worker = 0;
+    size_t other_node_worker = 0;
+    for (size_t i = 1; i < num_workers; ++i) {
+        if (queue.numa_node(i) == queue.numa_node(worker)) {
+            same_node_worker = i;
+        } else if (other_node_worker == 0) {
+            other_node_worker = i;
+        }
+    }
+    ASSERT_NE(0U, same_node_worker);
+    ASSERT_NE(0U, other_node_worker);
+    auto* other_node_task = create_task(0);
+    auto* same_node_task = create_task(0);
+    EXPECT_TRUE(queue.push_back(other_node_task, other_node_worker).ok());
+    EXPECT_TRUE(queue.push_back(same_node_task, same_node_worker).ok());
+    EXPECT_EQ(same_node_task, queue.take(worker));
+    EXPECT_EQ(other_node_task, queue.take(worker));
+    queue.close();
+}
+
+// Takes tasks for the worker `core_id` until the queue is closed, counting every take.
+static void take_until_closed(MultiCoreTaskQueue& queue, size_t core_id,
+                              const std::unordered_map<PipelineTask*, size_t>& task_index,
+                              std::vector<std::atomic<int>>& take_counts,
+                              std::atomic<size_t>& num_taken) {
+    while (auto* task = queue.take(core_id)) {
+        ++take_counts[task_index.at(task)];
+        ++num_taken;
+    }
+}
+
+TEST_F(TaskQueueTest, StealTakesEveryTaskOnce) {
+    const size_t num_workers = 4;
+    const size_t num_tasks = 512;
+    std::unordered_map<PipelineTask*, size_t> task_index;
+    for (size_t i = 0; i < num_tasks; ++i) {
+        task_index[create_task(i)] = i;
+    }
+    std::vector<std::atomic<int>> take_counts(num_tasks);
+    std::atomic<size_t> num_taken = 0;
+
+    // all the tasks are pushed to worker 0, which does not run, the others steal them
+    MultiCoreTaskQueue queue(num_workers);
+    for (auto& task : _tasks) {
+        EXPECT_TRUE(queue.push_back(task.get(), 0).ok());
+    }
+    std::vector<std::thread> workers;
+    for (size_t core_id = 1; core_id < num_workers; ++core_id) {
+        workers.emplace_back(take_until_closed, std::ref(queue), core_id, std::cref(task_index),
+                             std::ref(take_counts), std::ref(num_taken));
+    }
+    while (num_taken < num_tasks) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    queue.close();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(0, queue._prio_task_queue_list[0].task_size());
+    for (size_t i = 0; i < num_tasks; ++i) {
+        EXPECT_EQ(1, take_counts[i].load()) << "task " << i;
+    }
+}
+
+TEST_F(TaskQueueTest, ConcurrentPushAndTake) {
+    const size_t num_workers = 8;
+    const size_t num_producers = 4;
+    const size_t num_tasks = 1024;
+    std::unordered_map<PipelineTask*, size_t> task_index;
+    for (size_t i = 0; i < num_tasks; ++i) {
+        task_index[create_task(i)] = i;
+    }
+    std::vector<std::atomic<int>> take_counts(num_tasks);
+    std::atomic<size_t> num_taken = 0;
+
+    MultiCoreTaskQueue queue(num_workers);
+    std::vector<std::thread> workers;
+    for (size_t core_id = 0; core_id < num_workers; ++core_id) {
+        workers.emplace_back(take_until_closed, std::ref(queue), core_id, std::cref(task_index),
+                             std::ref(take_counts), std::ref(num_taken));
+    }
+    // the producers push like the scheduler, round robin, and like the workers, to a core
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&, p] {
+            for (size_t i = p; i < num_tasks; i += num_producers) {
+                auto* task = _tasks[i].get();
+                EXPECT_TRUE((i % 2 == 0 ? queue.push_back(task)
+                                        : queue.push_back(task, i % num_workers))
+                                    .ok());
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    while (num_taken < num_tasks) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    queue.close();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (size_t i = 0; i < num_tasks; ++i) {
+        EXPECT_EQ(1, take_counts[i].load()) << "task " << i;
+    }
+}
+
+TEST_F(TaskQueueTest, NoLostWakeUp) {
+    // a worker waiting without timeout gets every task pushed one by one
+    PriorityTaskQueue queue;
+    const int num_tasks = 1000;
+    auto consumer = std::async(std::launch::async, [&] {
+        int num_taken = 0;
+        while (num_taken < num_tasks) {
+            if (queue.take() != nullptr) {
+                ++num_taken;
+            }
+        }
+        return num_taken;
+    });
+    auto* task = create_task(0);
+    for (int i = 0; i < num_tasks; ++i) {
+        EXPECT_TRUE(queue.push(task).ok());
+        if (i % 10 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    ASSERT_EQ(std::future_status::ready, consumer.wait_for(std::chrono::seconds(30)));
+    EXPECT_EQ(num_tasks, consumer.get());
+
+    // close wakes all the workers waiting without timeout
+    std::vector<std::future<PipelineTask*>> waiters;
+    for (int i = 0; i < 4; ++i) {
+        waiters.push_back(std::async(std::launch::async, [&] { return queue.take(); }));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.close();
+    for (auto& waiter : waiters) {
+        ASSERT_EQ(std::future_status::ready, waiter.wait_for(std::chrono::seconds(30)));
+        EXPECT_EQ(nullptr, waiter.get());
+    }
+    EXPECT_FALSE(queue.push(task).ok());
+}
+
+} // namespace doris::pipeline
@@ -0,0 +1,129 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "pipeline/task_scheduler.h"
+
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/Types_types.h>
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "common/config.h"
+#include "gtest/gtest_pred_impl.h"
+#include "pipeline/pipeline.h"
+#include "pipeline/pipeline_task.h"
+#include "pipeline/task_queue.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+
+namespace doris::pipeline {
+
+// A task waiting for its operators to finish until `finish` is called.
+class PendingFinishTask : public PipelineTask {
+public:
+    PendingFinishTask(PipelinePtr& pipeline, RuntimeState* state)
+            : PipelineTask(pipeline, 0, state, nullptr, nullptr) {
+        _cur_state = PipelineTaskState::PENDING_FINISH;
+    }
+
+    bool is_pending_finish() override { return _pending_finish; }
+
+    void finish() { _pending_finish = false; }
+
+private:
+    std::atomic<bool> _pending_finish = true;
+};
+
+class BlockedTaskSchedulerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _idle_wait_us = config::blocked_task_scheduler_idle_wait_us;
+        _pipeline = std::make_shared<Pipeline>(0, std::weak_ptr<PipelineFragmentContext>());
+        _state = std::make_unique<RuntimeState>(TUniqueId(), TQueryOptions(), TQueryGlobals(),
+                                                ExecEnv::GetInstance());
+        _task_queue = std::make_shared<MultiCoreTaskQueue>(1);
+        _scheduler = std::make_unique<BlockedTaskScheduler>(_task_queue);
+        ASSERT_TRUE(_scheduler->start().ok());
+    }
+
+    void TearDown() override {
+        _scheduler->shutdown();
+        _task_queue->close();
+        config::blocked_task_scheduler_idle_wait_us = _idle_wait_us;
+    }
+
+    // Finish the blocked task, return how long it takes until a worker gets it.
+    std::chrono::milliseconds reschedule(PendingFinishTask& task, bool wake_up) {
+        auto start = std::chrono::steady_clock::now();
+        task.finish();
+        if (wake_up) {
+            BlockedTaskScheduler::wake_up();
+        }
+        EXPECT_EQ(&task, _task_queue->take(0));
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+    }
+
+    int32_t _idle_wait_us;
+    PipelinePtr _pipeline;
+    std::unique_ptr<RuntimeState> _state;
+    std::shared_ptr<MultiCoreTaskQueue> _task_queue;
+    std::unique_ptr<BlockedTaskScheduler> _scheduler;
+};
+
+TEST_F(BlockedTaskSchedulerTest, RescheduleWithoutWakeUp) {
+    // by default the scheduler keeps checking its tasks, so it does not depend on the events
+    // the tasks wait for waking it up
+    PendingFinishTask task(_pipeline, _state.get());
+    EXPECT_TRUE(_scheduler->add_blocked_task(&task).ok());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(0, _task_queue->_prio_task_queue_list[0].task_size());
+    EXPECT_LT(reschedule(task, false).count(), 1000);
+}
+
+TEST_F(BlockedTaskSchedulerTest, WakeUpIsNoOpWhilePolling) {
+    config::blocked_task_scheduler_idle_wait_us = 0;
+    uint64_t wake_ups = BlockedTaskScheduler::_s_wake_ups;
+    BlockedTaskScheduler::wake_up();
+    EXPECT_EQ(wake_ups, BlockedTaskScheduler::_s_wake_ups);
+
+    config::blocked_task_scheduler_idle_wait_us = 1000;
+    BlockedTaskScheduler::wake_up();
+    EXPECT_NE(wake_ups, BlockedTaskScheduler::_s_wake_ups);
+}
+
+TEST_F(BlockedTaskSchedulerTest, IdleWaitEndsOnWakeUp) {
+    config::blocked_task_scheduler_idle_wait_us = 60 * 1000 * 1000;
+    PendingFinishTask task(_pipeline, _state.get());
+    EXPECT_TRUE(_scheduler->add_blocked_task(&task).ok());
+    while (BlockedTaskScheduler::_s_idle_schedulers == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // an idle scheduler does not notice the task finished
+    task.finish();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(0, _task_queue->_prio_task_queue_list[0].task_size());
+    // until it is woken up
+    EXPECT_LT(reschedule(task, true).count(), 1000);
+}
+
+} // namespace doris::pipeline
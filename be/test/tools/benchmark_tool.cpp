@@ -16,10 +16,14 @@
 // under the License.
 
 #include <benchmark/benchmark.h>
+#include <gen_cpp/Exprs_types.h>
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/PlanNodes_types.h>
 #include <gflags/gflags.h>
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -27,10 +31,14 @@
 #include <random>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "common/compiler_util.h"
+#include "common/config.h"
 #include "common/logging.h"
+#include "common/object_pool.h"
+#include "exec/exec_node.h"
 #include "gutil/strings/split.h"
 #include "gutil/strings/substitute.h"
 #include "io/fs/file_system.h"
@@ -39,6 +47,7 @@
 #include "olap/comparison_predicate.h"
 #include "olap/data_dir.h"
 #include "olap/in_list_predicate.h"
+#include "olap/lru_cache.h"
 #include "olap/olap_common.h"
 #include "olap/row_cursor.h"
 #include "olap/rowset/segment_v2/binary_dict_page.h"
@@ -50,11 +59,22 @@
 #include "olap/tablet_schema.h"
 #include "olap/tablet_schema_helper.h"
 #include "olap/types.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "runtime/thread_context.h"
+#include "testutil/desc_tbl_builder.h"
 #include "testutil/test_util.h"
 #include "util/debug_util.h"
+#include "util/threadpool.h"
+#include "vec/core/block.h"
+#include "vec/exec/join/vhash_join_node.h"
+#include "vec/exec/vaggregation_node.h"
+#include "vec/utils/util.hpp"
 
 DEFINE_string(operation, "Custom",
-              "valid operation: Custom, BinaryDictPageEncode, BinaryDictPageDecode, SegmentScan, "
+              "valid operation: Custom, BinaryDictPageEncode, BinaryDictPageDecode, CacheLookup, "
+              "HashJoin, AggFinalize, SegmentScan, "
               "SegmentWrite, "
               "SegmentScanByFile, SegmentWriteByFile");
 DEFINE_string(input_file, "./sample.dat", "input file directory");
@@ -76,6 +96,9 @@ std::string get_usage(const std::string& progname) {
           "--rows_number=10000 --iterations=40\n";
     ss << "./benchmark_tool --operation=BinaryDictPageDecode "
           "--rows_number=10000 --iterations=40\n";
+    ss << "./benchmark_tool --operation=CacheLookup --rows_number=100000 --iterations=10\n";
+    ss << "./benchmark_tool --operation=HashJoin --rows_number=1500000 --iterations=10\n";
+    ss << "./benchmark_tool --operation=AggFinalize --rows_number=4000000 --iterations=10\n";
     ss << "./benchmark_tool --operation=SegmentScan --column_type=int,varchar "
           "--rows_number=10000 --iterations=0\n";
     ss << "./benchmark_tool --operation=SegmentWrite --column_type=int "
@@ -229,6 +252,374 @@ private:
     int _rows_number;
 }; // namespace doris
 
+// Lookup a ShardedLRUCache from several threads with zipfian distributed keys, a miss
+// inserts the key. Used to compare LRU and CLOCK eviction policy.
+// Call method: ./benchmark_tool --operation=CacheLookup --rows_number=100000
+class CacheLookupBenchmark : public BaseBenchmark {
+public:
+    CacheLookupBenchmark(const std::string& name, int iterations, int key_count,
+                         CacheEvictionPolicy eviction_policy)
+            : BaseBenchmark(name, iterations),
+              _key_count(key_count),
+              _eviction_policy(eviction_policy) {
+        // zipfian with skew 0.99, the cache holds 10% of the keys
+        _cdf.resize(_key_count);
+        double sum = 0;
+        for (int i = 0; i < _key_count; ++i) {
+            sum += 1.0 / std::pow(i + 1, 0.99);
+            _cdf[i] = sum;
+        }
+        for (auto& p : _cdf) {
+            p /= sum;
+        }
+        _cache.reset(new_lru_cache(name, std::max(_key_count / 10, 1),
+                                   LRUCacheType::NUMBER, DEFAULT_LRU_CACHE_NUM_SHARDS,
+                                   _eviction_policy));
+    }
+
+    void run() override {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreadNum; ++t) {
+            threads.emplace_back([this, t]() {
+                std::mt19937 gen(t);
+                std::uniform_real_distribution<double> dis(0, 1);
+                for (int i = 0; i < kLookupPerThread; ++i) {
+                    int key = std::lower_bound(_cdf.begin(), _cdf.end(), dis(gen)) - _cdf.begin();
+                    CacheKey cache_key(reinterpret_cast<const char*>(&key), sizeof(key));
+                    Cache::Handle* handle = _cache->lookup(cache_key);
+                    if (handle == nullptr) {
+                        handle = _cache->insert(cache_key, nullptr, 1,
+                                                [](const CacheKey&, void*) {},
+                                                CachePriority::NORMAL, sizeof(key));
+                    }
+                    _cache->release(handle);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    static constexpr int kThreadNum = 16;
+    static constexpr int kLookupPerThread = 100000;
+
+    int _key_count;
+    CacheEvictionPolicy _eviction_policy;
+    std::vector<double> _cdf;
+    std::unique_ptr<Cache> _cache;
+};
+
+// Returns the given blocks one by one, then an empty block with eos.
+class BlocksSourceNode : public ExecNode {
+public:
+    BlocksSourceNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                     std::vector<vectorized::Block> blocks)
+            : ExecNode(pool, tnode, descs), _blocks(std::move(blocks)) {}
+
+    Status get_next(RuntimeState* state, vectorized::Block* block, bool* eos) override {
+        if (_next < _blocks.size()) {
+            block->swap(_blocks[_next++]);
+            *eos = false;
+        } else {
+            block->clear_column_data();
+            *eos = true;
+        }
+        return Status::OK();
+    }
+
+private:
+    std::vector<vectorized::Block> _blocks;
+    size_t _next = 0;
+};
+
+// Inner join a build side of `rows_number` rows with a probe side of 4x rows through the hash
+// join node, in blocks of 4096 rows, half of the probe keys match, like the orders/lineitem
+// join of TPC-H. The hash table is split into sub tables once it has 64K buckets, used to
+// compare the row order insert/lookup with the radix partitioned one.
+// Call method: ./benchmark_tool --operation=HashJoin --rows_number=1500000
+class HashJoinBenchmark : public BaseBenchmark {
+public:
+    HashJoinBenchmark(const std::string& name, int iterations, int build_rows, bool radix_partition)
+            : BaseBenchmark(name, iterations), _radix_partition(radix_partition) {
+        // tuple 0 is the probe side, tuple 1 the build side and tuple 2 the output, every
+        // tuple has a key and a value slot of nullable int.
+        DescriptorTblBuilder builder(&_pool);
+        builder.declare_tuple() << TYPE_INT << TYPE_INT;
+        builder.declare_tuple() << TYPE_INT << TYPE_INT;
+        builder.declare_tuple() << TYPE_INT << TYPE_INT << TYPE_INT << TYPE_INT;
+        _desc_tbl = builder.build();
+
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<int32_t> key_dis;
+        _build_keys.resize(build_rows);
+        for (auto& key : _build_keys) {
+            key = key_dis(gen);
+        }
+        _probe_keys.resize(build_rows * 4L);
+        std::uniform_int_distribution<int> row_dis(0, build_rows - 1);
+        for (size_t i = 0; i < _probe_keys.size(); ++i) {
+            _probe_keys[i] = i % 2 == 0 ? _build_keys[row_dis(gen)] : key_dis(gen);
+        }
+    }
+
+    void init() override {
+        _join_node.reset();
+        _probe_node.reset();
+        _build_node.reset();
+        TQueryOptions query_options;
+        query_options.__set_batch_size(kBlockRows);
+        query_options.__set_partitioned_hash_join_rows_threshold(65536);
+        _state = std::make_unique<RuntimeState>(TUniqueId(), query_options, TQueryGlobals(),
+                                                ExecEnv::GetInstance());
+        _state->set_desc_tbl(_desc_tbl);
+
+        TPlanNode probe_tnode;
+        probe_tnode.__set_node_id(0);
+        probe_tnode.__set_node_type(TPlanNodeType::EMPTY_SET_NODE);
+        probe_tnode.__set_row_tuples({0});
+        probe_tnode.__set_nullable_tuples({false});
+        probe_tnode.__set_limit(-1);
+        TPlanNode build_tnode = probe_tnode;
+        build_tnode.__set_node_id(1);
+        build_tnode.__set_row_tuples({1});
+
+        TPlanNode join_tnode;
+        join_tnode.__set_node_id(2);
+        join_tnode.__set_node_type(TPlanNodeType::HASH_JOIN_NODE);
+        join_tnode.__set_row_tuples({2});
+        join_tnode.__set_nullable_tuples({false});
+        join_tnode.__set_limit(-1);
+        THashJoinNode hash_join_node;
+        hash_join_node.__set_join_op(TJoinOp::INNER_JOIN);
+        TEqJoinCondition eq_join_conjunct;
+        eq_join_conjunct.__set_left(_slot_ref(0, 0));
+        eq_join_conjunct.__set_right(_slot_ref(1, 2));
+        hash_join_node.__set_eq_join_conjuncts({eq_join_conjunct});
+        hash_join_node.__set_vintermediate_tuple_id_list({0, 1});
+        hash_join_node.__set_voutput_tuple_id(2);
+        join_tnode.__set_hash_join_node(hash_join_node);
+
+        _probe_node = std::make_unique<BlocksSourceNode>(&_pool, probe_tnode, *_desc_tbl,
+                                                         _create_blocks(0, _probe_keys));
+        _build_node = std::make_unique<BlocksSourceNode>(&_pool, build_tnode, *_desc_tbl,
+                                                         _create_blocks(1, _build_keys));
+        _join_node = std::make_unique<vectorized::HashJoinNode>(&_pool, join_tnode, *_desc_tbl);
+        _join_node->_children = {_probe_node.get(), _build_node.get()};
+        CHECK(_probe_node->init(probe_tnode, _state.get()).ok());
+        CHECK(_build_node->init(build_tnode, _state.get()).ok());
+        CHECK(_join_node->init(join_tnode, _state.get()).ok());
+        CHECK(_join_node->prepare(_state.get()).ok());
+        CHECK(_join_node->alloc_resource(_state.get()).ok());
+    }
+
+    void run() override {
+        config::enable_hash_join_radix_partition = _radix_partition;
+        // the build side is materialized on the calling thread, `open` would need the join
+        // node thread pool of a running BE.
+        CHECK(_join_node->_materialize_build_side(_state.get()).ok());
+        size_t matched = 0;
+        bool eos = false;
+        while (!eos) {
+            vectorized::Block block;
+            CHECK(_join_node->get_next(_state.get(), &block, &eos).ok());
+            matched += block.rows();
+        }
+        benchmark::DoNotOptimize(matched);
+        CHECK(_join_node->close(_state.get()).ok());
+    }
+
+private:
+    static constexpr int kBlockRows = 4096;
+
+    static TExpr _slot_ref(TupleId tuple_id, SlotId slot_id) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::SLOT_REF);
+        node.__set_type(TypeDescriptor(TYPE_INT).to_thrift());
+        node.__set_num_children(0);
+        node.__set_is_nullable(true);
+        TSlotRef slot;
+        slot.__set_slot_id(slot_id);
+        slot.__set_tuple_id(tuple_id);
+        node.__set_slot_ref(slot);
+        TExpr expr;
+        expr.nodes.push_back(node);
+        return expr;
+    }
+
+    // Blocks of the given keys, the value of a row is its index.
+    std::vector<vectorized::Block> _create_blocks(TupleId tuple_id,
+                                                  const std::vector<int32_t>& keys) {
+        RowDescriptor row_desc(*_desc_tbl, {tuple_id}, {false});
+        std::vector<vectorized::Block> blocks;
+        for (size_t begin = 0; begin < keys.size(); begin += kBlockRows) {
+            auto block = vectorized::VectorizedUtils::create_empty_columnswithtypename(row_desc);
+            auto columns = block.mutate_columns();
+            for (size_t i = begin; i < std::min(begin + kBlockRows, keys.size()); ++i) {
+                auto value = static_cast<int32_t>(i);
+                columns[0]->insert_data((const char*)&keys[i], sizeof(int32_t));
+                columns[1]->insert_data((const char*)&value, sizeof(int32_t));
+            }
+            block.set_columns(std::move(columns));
+            blocks.push_back(std::move(block));
+        }
+        return blocks;
+    }
+
+    bool _radix_partition;
+    ObjectPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::vector<int32_t> _build_keys;
+    std::vector<int32_t> _probe_keys;
+    std::unique_ptr<RuntimeState> _state;
+    std::unique_ptr<BlocksSourceNode> _probe_node;
+    std::unique_ptr<BlocksSourceNode> _build_node;
+    std::unique_ptr<vectorized::HashJoinNode> _join_node;
+};
+
+// Aggregate `rows_number` rows of distinct keys by `sum(v) group by k` through the aggregation
+// node and time only reading the results out of the hash table, with the result batches
+// finalized serially or `parallelism` at a time by AggFinalizeThreadPool. The partial states
+// are merged by `open` in `init`, serially in both cases.
+// Call method: ./benchmark_tool --operation=AggFinalize --rows_number=4000000
+class AggFinalizeBenchmark : public BaseBenchmark {
+public:
+    AggFinalizeBenchmark(const std::string& name, int iterations, int rows, int parallelism)
+            : BaseBenchmark(name, iterations), _rows(rows), _parallelism(parallelism) {
+        // tuple 0 is the input (k, v), tuples 1 and 2 the intermediate and output tuples of
+        // the aggregation, all the slots are nullable.
+        DescriptorTblBuilder builder(&_pool);
+        builder.declare_tuple() << TYPE_INT << TYPE_INT;
+        builder.declare_tuple() << TYPE_INT << TYPE_BIGINT;
+        builder.declare_tuple() << TYPE_INT << TYPE_BIGINT;
+        _desc_tbl = builder.build();
+    }
+
+    void init() override {
+        _agg_node.reset();
+        _input_node.reset();
+        TQueryOptions query_options;
+        query_options.__set_batch_size(kBlockRows);
+        query_options.__set_enable_pipeline_engine(false);
+        _state = std::make_unique<RuntimeState>(TUniqueId(), query_options, TQueryGlobals(),
+                                                ExecEnv::GetInstance());
+        _state->init_mem_trackers();
+        _state->set_desc_tbl(_desc_tbl);
+
+        TPlanNode input_tnode;
+        input_tnode.__set_node_id(0);
+        input_tnode.__set_node_type(TPlanNodeType::EMPTY_SET_NODE);
+        input_tnode.__set_row_tuples({0});
+        input_tnode.__set_nullable_tuples({false});
+        input_tnode.__set_limit(-1);
+
+        TPlanNode agg_tnode;
+        agg_tnode.__set_node_id(1);
+        agg_tnode.__set_node_type(TPlanNodeType::AGGREGATION_NODE);
+        agg_tnode.__set_row_tuples({2});
+        agg_tnode.__set_nullable_tuples({false});
+        agg_tnode.__set_limit(-1);
+        TAggregationNode agg_node;
+        agg_node.__set_grouping_exprs({_slot_ref(0)});
+        agg_node.__set_aggregate_functions({_sum_expr()});
+        agg_node.__set_intermediate_tuple_id(1);
+        agg_node.__set_output_tuple_id(2);
+        agg_node.__set_need_finalize(true);
+        agg_node.__set_use_streaming_preaggregation(false);
+        agg_tnode.__set_agg_node(agg_node);
+
+        _input_node = std::make_unique<BlocksSourceNode>(&_pool, input_tnode, *_desc_tbl,
+                                                         _create_blocks());
+        _agg_node = std::make_unique<vectorized::AggregationNode>(&_pool, agg_tnode, *_desc_tbl);
+        _agg_node->_children = {_input_node.get()};
+        CHECK(_input_node->init(input_tnode, _state.get()).ok());
+        CHECK(_agg_node->init(agg_tnode, _state.get()).ok());
+        CHECK(_agg_node->prepare(_state.get()).ok());
+        CHECK(_agg_node->open(_state.get()).ok());
+    }
+
+    void run() override {
+        config::agg_finalize_parallelism = _parallelism;
+        size_t groups = 0;
+        bool eos = false;
+        while (!eos) {
+            vectorized::Block block;
+            CHECK(_agg_node->get_next(_state.get(), &block, &eos).ok());
+            groups += block.rows();
+        }
+        benchmark::DoNotOptimize(groups);
+        CHECK(_agg_node->close(_state.get()).ok());
+    }
+
+private:
+    static constexpr int kBlockRows = 4096;
+
+    static TExpr _slot_ref(SlotId slot_id) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::SLOT_REF);
+        node.__set_type(TypeDescriptor(TYPE_INT).to_thrift());
+        node.__set_num_children(0);
+        node.__set_is_nullable(true);
+        TSlotRef slot;
+        slot.__set_slot_id(slot_id);
+        slot.__set_tuple_id(0);
+        node.__set_slot_ref(slot);
+        TExpr expr;
+        expr.nodes.push_back(node);
+        return expr;
+    }
+
+    // sum(v) of the input tuple
+    static TExpr _sum_expr() {
+        TFunctionName name;
+        name.__set_function_name("sum");
+        TFunction fn;
+        fn.__set_name(name);
+        fn.__set_binary_type(TFunctionBinaryType::BUILTIN);
+        fn.__set_arg_types({TypeDescriptor(TYPE_INT).to_thrift()});
+        fn.__set_ret_type(TypeDescriptor(TYPE_BIGINT).to_thrift());
+        fn.__set_has_var_args(false);
+        TAggregateExpr agg_expr;
+        agg_expr.__set_is_merge_agg(false);
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::AGG_EXPR);
+        node.__set_type(TypeDescriptor(TYPE_BIGINT).to_thrift());
+        node.__set_num_children(1);
+        node.__set_is_nullable(true);
+        node.__set_fn(fn);
+        node.__set_agg_expr(agg_expr);
+        TExpr expr = _slot_ref(1);
+        expr.nodes.insert(expr.nodes.begin(), node);
+        return expr;
+    }
+
+    // Row i has key i and value i, so every row is a group of its own.
+    std::vector<vectorized::Block> _create_blocks() {
+        RowDescriptor row_desc(*_desc_tbl, {0}, {false});
+        std::vector<vectorized::Block> blocks;
+        for (int begin = 0; begin < _rows; begin += kBlockRows) {
+            auto block = vectorized::VectorizedUtils::create_empty_columnswithtypename(row_desc);
+            auto columns = block.mutate_columns();
+            for (int i = begin; i < std::min(begin + kBlockRows, _rows); ++i) {
+                columns[0]->insert_data((const char*)&i, sizeof(int32_t));
+                columns[1]->insert_data((const char*)&i, sizeof(int32_t));
+            }
+            block.set_columns(std::move(columns));
+            blocks.push_back(std::move(block));
+        }
+        return blocks;
+    }
+
+    int _rows;
+    int _parallelism;
+    ObjectPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RuntimeState> _state;
+    std::unique_ptr<BlocksSourceNode> _input_node;
+    std::unique_ptr<vectorized::AggregationNode> _agg_node;
+};
+
 // This is sample custom test. User can write custom test code at custom_init()&custom_run().
 // Call method: ./benchmark_tool --operation=Custom
 class CustomBenchmark : public BaseBenchmark {
@@ -286,6 +677,28 @@ public:
         } else if (equal_ignore_case(FLAGS_operation, "BinaryDictPageDecode")) {
             benchmarks.emplace_back(new doris::BinaryDictPageDecodeBenchmark(
                     FLAGS_operation, std::stoi(FLAGS_iterations), std::stoi(FLAGS_rows_number)));
+        } else if (equal_ignore_case(FLAGS_operation, "CacheLookup")) {
+            benchmarks.emplace_back(new doris::CacheLookupBenchmark(
+                    "CacheLookup_LRU", std::stoi(FLAGS_iterations), std::stoi(FLAGS_rows_number),
+                    CacheEvictionPolicy::LRU));
+            benchmarks.emplace_back(new doris::CacheLookupBenchmark(
+                    "CacheLookup_CLOCK", std::stoi(FLAGS_iterations),
+                    std::stoi(FLAGS_rows_number), CacheEvictionPolicy::CLOCK));
+        } else if (equal_ignore_case(FLAGS_operation, "AggFinalize")) {
+            benchmarks.emplace_back(new doris::AggFinalizeBenchmark(
+                    "AggFinalize_Serial", std::stoi(FLAGS_iterations),
+                    std::stoi(FLAGS_rows_number), 1));
+            int parallelism = static_cast<int>(std::thread::hardware_concurrency());
+            benchmarks.emplace_back(new doris::AggFinalizeBenchmark(
+                    "AggFinalize_Parallel", std::stoi(FLAGS_iterations),
+                    std::stoi(FLAGS_rows_number), std::max(parallelism, 2)));
+        } else if (equal_ignore_case(FLAGS_operation, "HashJoin")) {
+            benchmarks.emplace_back(new doris::HashJoinBenchmark(
+                    "HashJoin_RowOrder", std::stoi(FLAGS_iterations),
+                    std::stoi(FLAGS_rows_number), false));
+            benchmarks.emplace_back(new doris::HashJoinBenchmark(
+                    "HashJoin_RadixPartition", std::stoi(FLAGS_iterations),
+                    std::stoi(FLAGS_rows_number), true));
         } else {
             std::cout << "operation invalid!" << std::endl;
         }
@@ -306,7 +719,13 @@ int main(int argc, char** argv) {
     gflags::SetUsageMessage(usage);
     google::ParseCommandLineFlags(&argc, &argv, true);
 
+    doris::ExecEnv::GetInstance()->init_mem_tracker();
+    doris::thread_context()->thread_mem_tracker_mgr->init();
     doris::StoragePageCache::create_global_cache(1 << 30, 10, 0);
+    static_cast<void>(doris::ThreadPoolBuilder("AggFinalizeThreadPool")
+                              .set_min_threads(1)
+                              .set_max_threads(std::thread::hardware_concurrency())
+                              .build(&doris::ExecEnv::GetInstance()->_agg_finalize_thread_pool));
 
     doris::MultiBenchmark multi_bm;
     multi_bm.add_bm();
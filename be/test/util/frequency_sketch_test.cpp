@@ -0,0 +1,85 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/frequency_sketch.h"
+
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <vector>
+
+#include "gtest/gtest_pred_impl.h"
+
+namespace doris {
+
+TEST(FrequencySketchTest, Empty) {
+    FrequencySketch sketch;
+    sketch.increment(1);
+    EXPECT_EQ(0, sketch.frequency(1));
+}
+
+TEST(FrequencySketchTest, Increment) {
+    FrequencySketch sketch;
+    sketch.ensure_capacity(512);
+    EXPECT_EQ(0, sketch.frequency(1));
+    for (int i = 1; i <= 20; ++i) {
+        sketch.increment(1);
+        // saturate at 15
+        EXPECT_EQ(std::min(i, 15), sketch.frequency(1));
+    }
+    sketch.increment(2);
+    EXPECT_EQ(1, sketch.frequency(2));
+    EXPECT_EQ(15, sketch.frequency(1));
+}
+
+TEST(FrequencySketchTest, Reset) {
+    FrequencySketch sketch;
+    sketch.ensure_capacity(1024);
+    for (int i = 0; i < 10; ++i) {
+        sketch.increment(1);
+    }
+    EXPECT_EQ(10, sketch.frequency(1));
+    // the counters are halved after 10 * capacity increments
+    for (uint64_t i = 100; i < 100 + 10 * 1024; ++i) {
+        sketch.increment(i);
+    }
+    EXPECT_LT(sketch.frequency(1), 10);
+}
+
+TEST(FrequencySketchTest, GrowKeepsFrequencies) {
+    FrequencySketch sketch;
+    sketch.ensure_capacity(1024);
+    for (uint64_t key = 0; key < 1000; ++key) {
+        for (uint64_t i = 0; i < key % 16; ++i) {
+            sketch.increment(key * 0x9e3779b97f4a7c15ULL);
+        }
+    }
+    std::vector<uint32_t> frequencies;
+    for (uint64_t key = 0; key < 1000; ++key) {
+        frequencies.push_back(sketch.frequency(key * 0x9e3779b97f4a7c15ULL));
+    }
+    // a smaller capacity is a no-op, a larger one grows the table to 8192 words
+    sketch.ensure_capacity(10);
+    EXPECT_EQ(1024U, sketch._table.size());
+    sketch.ensure_capacity(5000);
+    EXPECT_EQ(8192U, sketch._table.size());
+    for (uint64_t key = 0; key < 1000; ++key) {
+        EXPECT_EQ(frequencies[key], sketch.frequency(key * 0x9e3779b97f4a7c15ULL)) << key;
+    }
+}
+
+} // namespace doris
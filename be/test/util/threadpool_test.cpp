@@ -945,4 +945,34 @@ TEST_F(ThreadPoolTest, TestThreadTokenConcurrent) {
     ASSERT_EQ(0, token1->num_tasks());
 }
 
+TEST_F(ThreadPoolTest, TestRunInParallel) {
+    std::unique_ptr<ThreadPool> thread_pool;
+    ThreadPoolBuilder("my_pool").set_min_threads(0).set_max_threads(2).build(&thread_pool);
+
+    std::vector<int> results(16, 0);
+    std::vector<std::function<void()>> tasks;
+    for (int i = 0; i < 16; i++) {
+        tasks.emplace_back([&results, i] { results[i] = i * i; });
+    }
+    run_in_parallel(thread_pool.get(), std::move(tasks));
+    for (int i = 0; i < 16; i++) {
+        EXPECT_EQ(i * i, results[i]);
+    }
+
+    // the tasks queued behind a blocked pool are run by the calling thread
+    CountDownLatch latch(1);
+    for (int i = 0; i < 2; i++) {
+        ASSERT_TRUE(thread_pool->submit_func([&latch] { latch.wait(); }).ok());
+    }
+    std::atomic<int> num_done = 0;
+    tasks.clear();
+    for (int i = 0; i < 4; i++) {
+        tasks.emplace_back([&num_done] { num_done++; });
+    }
+    run_in_parallel(thread_pool.get(), std::move(tasks));
+    EXPECT_EQ(4, num_done);
+    latch.count_down();
+    thread_pool->wait();
+}
+
 } // namespace doris
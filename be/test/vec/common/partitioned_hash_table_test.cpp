@@ -0,0 +1,124 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest_pred_impl.h"
+#include "vec/common/hash_table/hash.h"
+#include "vec/common/hash_table/partitioned_hash_map.h"
+
+namespace doris::vectorized {
+
+using Data = PartitionedHashMap<UInt64, UInt32, HashCRC32<UInt64>>;
+
+// Keys with repetitions, every 13th row is skipped like a null key.
+static void create_rows(const Data& data, size_t num_rows, std::vector<UInt64>& keys,
+                        std::vector<size_t>& hash_values, std::vector<uint8_t>& skip) {
+    for (size_t i = 0; i < num_rows; ++i) {
+        keys.push_back(i * 7919 % 3001);
+        hash_values.push_back(data.hash(keys.back()));
+        skip.push_back(i % 13 == 0);
+    }
+}
+
+TEST(PartitionedHashTableTest, RadixPartitionClustersRowsBySubTable) {
+    const size_t num_rows = 10000;
+    Data data;
+    std::vector<UInt64> keys;
+    std::vector<size_t> hash_values;
+    std::vector<uint8_t> skip;
+    create_rows(data, num_rows, keys, hash_values, skip);
+
+    std::vector<uint32_t> rows;
+    data.radix_partition(hash_values.data(), num_rows, skip.data(), rows);
+
+    // every row that is not skipped, once, clustered by sub table in the order of the input
+    std::vector<uint32_t> expected;
+    for (size_t sub_table = 0; sub_table < Data::NUM_LEVEL1_SUB_TABLES; ++sub_table) {
+        for (uint32_t i = 0; i < num_rows; ++i) {
+            if (!skip[i] && Data::get_sub_table_from_hash(hash_values[i]) == sub_table) {
+                expected.push_back(i);
+            }
+        }
+    }
+    EXPECT_EQ(num_rows - (num_rows + 12) / 13, rows.size());
+    EXPECT_EQ(expected, rows);
+
+    // without a skip map every row is kept
+    data.radix_partition(hash_values.data(), num_rows, nullptr, rows);
+    EXPECT_EQ(num_rows, rows.size());
+    for (size_t i = 1; i < rows.size(); ++i) {
+        auto prev = Data::get_sub_table_from_hash(hash_values[rows[i - 1]]);
+        auto cur = Data::get_sub_table_from_hash(hash_values[rows[i]]);
+        EXPECT_TRUE(prev < cur || (prev == cur && rows[i - 1] < rows[i])) << "row " << i;
+    }
+
+    data.radix_partition(hash_values.data(), 0, nullptr, rows);
+    EXPECT_TRUE(rows.empty());
+}
+
+TEST(PartitionedHashTableTest, RadixPartitionedInsertKeepsResults) {
+    const size_t num_rows = 10000;
+    Data row_order;
+    Data radix_order;
+    for (auto* data : {&row_order, &radix_order}) {
+        data->set_partitioned_threshold(64);
+        data->expanse_for_add_elem(num_rows);
+        ASSERT_TRUE(data->is_partitioned());
+    }
+    std::vector<UInt64> keys;
+    std::vector<size_t> hash_values;
+    std::vector<uint8_t> skip;
+    create_rows(row_order, num_rows, keys, hash_values, skip);
+
+    // count the rows of each key
+    auto count = [&](Data& data, uint32_t row) {
+        Data::LookupResult it;
+        bool inserted;
+        data.emplace(keys[row], it, inserted, hash_values[row]);
+        if (inserted) {
+            new (lookup_result_get_mapped(it)) UInt32(0);
+        }
+        ++*lookup_result_get_mapped(it);
+    };
+    for (uint32_t i = 0; i < num_rows; ++i) {
+        if (!skip[i]) {
+            count(row_order, i);
+        }
+    }
+    std::vector<uint32_t> rows;
+    radix_order.radix_partition(hash_values.data(), num_rows, skip.data(), rows);
+    for (auto row : rows) {
+        count(radix_order, row);
+    }
+
+    ASSERT_EQ(row_order.size(), radix_order.size());
+    for (uint32_t i = 0; i < num_rows; ++i) {
+        auto it = radix_order.find(keys[i], hash_values[i]);
+        auto expected_it = row_order.find(keys[i], hash_values[i]);
+        ASSERT_EQ(expected_it == nullptr, it == nullptr) << "key " << keys[i];
+        if (it != nullptr) {
+            EXPECT_EQ(*lookup_result_get_mapped(expected_it), *lookup_result_get_mapped(it));
+        }
+    }
+}
+
+} // namespace doris::vectorized
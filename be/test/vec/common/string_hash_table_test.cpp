@@ -0,0 +1,105 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <map>
+#include <string>
+
+#include "gtest/gtest_pred_impl.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/arena.h"
+#include "vec/common/columns_hashing.h"
+#include "vec/common/hash_table/hash.h"
+#include "vec/common/hash_table/string_hash_map.h"
+
+namespace doris::vectorized {
+
+using Data = StringHashMap<UInt64>;
+using State = ColumnsHashing::HashMethodString<typename Data::value_type, UInt64, true, false>;
+
+// Keys of every sub table: empty, up to 8, 16 and 24 bytes, and longer, with repetitions.
+static ColumnString::MutablePtr create_keys(size_t rows) {
+    auto column = ColumnString::create();
+    for (size_t i = 0; i < rows; ++i) {
+        size_t id = i * 7919 % 1000;
+        std::string key = std::to_string(id);
+        key.resize(id % 40, static_cast<char>('a' + id % 26));
+        column->insert_data(key.data(), key.size());
+    }
+    return column;
+}
+
+// Count the rows of each key like the aggregation node does, optionally prefetching the bucket
+// HASH_MAP_PREFETCH_DIST rows ahead.
+static void count_keys(const ColumnString& keys, bool prefetch, Data& data, Arena& arena) {
+    ColumnRawPtrs key_columns {&keys};
+    State state(key_columns, {}, nullptr);
+    size_t num_rows = keys.size();
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (prefetch && i + HASH_MAP_PREFETCH_DIST < num_rows) {
+            state.prefetch_key<false>(data, i + HASH_MAP_PREFETCH_DIST, arena);
+        }
+        auto result = state.emplace_key(data, i, arena);
+        if (result.is_inserted()) {
+            result.set_mapped(0);
+        }
+        ++result.get_mapped();
+    }
+}
+
+TEST(StringHashTableTest, PrefetchKeepsResults) {
+    const size_t num_rows = 10000;
+    auto keys = create_keys(num_rows);
+    std::map<std::string, UInt64> expected;
+    for (size_t i = 0; i < num_rows; ++i) {
+        ++expected[keys->get_data_at(i).to_string()];
+    }
+
+    Arena arena;
+    Data data;
+    Data prefetched_data;
+    count_keys(*keys, false, data, arena);
+    count_keys(*keys, true, prefetched_data, arena);
+    EXPECT_EQ(expected.size(), data.size());
+    EXPECT_EQ(expected.size(), prefetched_data.size());
+
+    // look up every key, and some missing ones, with prefetched finds
+    auto probe_keys = create_keys(num_rows + 500);
+    for (size_t i = 0; i < 500; ++i) {
+        std::string key = "missing" + std::string(i % 40, 'x');
+        probe_keys->insert_data(key.data(), key.size());
+    }
+    ColumnRawPtrs key_columns {probe_keys.get()};
+    State state(key_columns, {}, nullptr);
+    size_t num_probe_rows = probe_keys->size();
+    for (size_t i = 0; i < num_probe_rows; ++i) {
+        if (i + HASH_MAP_PREFETCH_DIST < num_probe_rows) {
+            state.prefetch_key<true>(prefetched_data, i + HASH_MAP_PREFETCH_DIST, arena);
+        }
+        auto result = state.find_key(prefetched_data, i, arena);
+        auto it = expected.find(probe_keys->get_data_at(i).to_string());
+        ASSERT_EQ(it != expected.end(), result.is_found()) << "row " << i;
+        if (result.is_found()) {
+            EXPECT_EQ(it->second, result.get_mapped());
+            EXPECT_EQ(it->second, state.find_key(data, i, arena).get_mapped());
+        }
+    }
+}
+
+} // namespace doris::vectorized
@@ -23,6 +23,7 @@
 
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -54,6 +55,7 @@
 #include "vec/data_types/data_type_nullable.h"
 #include "vec/data_types/data_type_number.h"
 #include "vec/data_types/data_type_string.h"
+#include "vec/exec/vanalytic_eval_node.h"
 
 namespace doris {
 class RuntimeProfile;
@@ -494,4 +496,85 @@ TEST_F(TestBlockSpill, TestBitmap) {
     auto bitmap_str = convert_bitmap_to_string(real_column->get_element(0));
     EXPECT_EQ(bitmap_str, expected_bitmap_str[3 * batch_size]);
 }
+
+// Rows [begin, end) of one partition, the key is `key` and the value is the row number.
+static vectorized::Block create_analytic_block(int key, int begin, int end) {
+    auto key_column = vectorized::ColumnVector<int>::create();
+    auto value_column = vectorized::ColumnString::create();
+    for (int i = begin; i < end; ++i) {
+        key_column->insert_value(key);
+        auto str = std::to_string(i);
+        value_column->insert_data(str.c_str(), str.size());
+    }
+    return vectorized::Block(
+            {{std::move(key_column), std::make_shared<vectorized::DataTypeInt32>(), "key"},
+             {std::move(value_column), std::make_shared<vectorized::DataTypeString>(), "value"}});
+}
+
+static void check_analytic_block(const vectorized::Block& block, int key, int begin, int end) {
+    ASSERT_EQ(block.rows(), static_cast<size_t>(end - begin));
+    ASSERT_FALSE(is_column_const(*block.get_by_position(0).column));
+    ASSERT_FALSE(is_column_const(*block.get_by_position(1).column));
+    for (int i = begin; i < end; ++i) {
+        EXPECT_EQ(block.get_by_position(0).column->get_int(i - begin), key);
+        EXPECT_EQ(block.get_by_position(1).column->get_data_at(i - begin).to_string(),
+                  std::to_string(i));
+    }
+}
+
+TEST_F(TestBlockSpill, TestAnalyticBlockSpiller) {
+    vectorized::AnalyticBlockSpiller spiller;
+    spiller.init(1, profile_);
+    EXPECT_FALSE(spiller.need_spill(0));
+    EXPECT_TRUE(spiller.need_spill(1));
+
+    // blocks 1 and 2 are in the middle of the partition of key 7, they go to one stream
+    std::vector<vectorized::Block> blocks;
+    blocks.push_back(create_analytic_block(7, 0, 10));
+    blocks.push_back(create_analytic_block(7, 10, 20));
+    blocks.push_back(create_analytic_block(7, 20, 25));
+    blocks.push_back(create_analytic_block(7, 25, 30));
+    EXPECT_TRUE(spiller.spill(1, &blocks[1], {0}).ok());
+    EXPECT_TRUE(spiller.spill(2, &blocks[2], {0}).ok());
+    EXPECT_FALSE(spiller.is_spilled(0));
+    EXPECT_TRUE(spiller.is_spilled(1));
+    EXPECT_TRUE(spiller.is_spilled(2));
+    EXPECT_EQ(spiller.first_spilled_block(), 1U);
+
+    // the stand-ins keep the rows and the partition key, everything else is a const default
+    EXPECT_EQ(blocks[1].rows(), 10U);
+    EXPECT_TRUE(is_column_const(*blocks[1].get_by_position(0).column));
+    EXPECT_TRUE(is_column_const(*blocks[1].get_by_position(1).column));
+    EXPECT_EQ(blocks[1].get_by_position(0).column->get_int(9), 7);
+    EXPECT_EQ(blocks[2].rows(), 5U);
+    const auto& key = blocks[0].get_by_position(0).column;
+    const auto& stand_in_key = blocks[2].get_by_position(0).column;
+    EXPECT_EQ(vectorized::AnalyticBlockSpiller::compare_at(key, 9, stand_in_key, 4), 0);
+    EXPECT_EQ(vectorized::AnalyticBlockSpiller::compare_at(stand_in_key, 0, key, 3), 0);
+    auto other_key = create_analytic_block(8, 0, 1).get_by_position(0).column;
+    EXPECT_LT(vectorized::AnalyticBlockSpiller::compare_at(stand_in_key, 2, other_key, 0), 0);
+
+    // blocks in memory are left unchanged, spilled ones are read back in order
+    EXPECT_TRUE(spiller.restore(0, &blocks[0]).ok());
+    check_analytic_block(blocks[0], 7, 0, 10);
+    EXPECT_FALSE(spiller.restore(2, &blocks[2]).ok());
+    EXPECT_TRUE(spiller.restore(1, &blocks[1]).ok());
+    check_analytic_block(blocks[1], 7, 10, 20);
+    EXPECT_TRUE(spiller.restore(2, &blocks[2]).ok());
+    check_analytic_block(blocks[2], 7, 20, 25);
+    EXPECT_FALSE(spiller.is_spilled(2));
+    EXPECT_EQ(spiller.first_spilled_block(), std::numeric_limits<size_t>::max());
+
+    // the next partition goes to a new stream
+    blocks.push_back(create_analytic_block(9, 30, 40));
+    EXPECT_TRUE(spiller.spill(4, &blocks[4], {0}).ok());
+    EXPECT_TRUE(spiller.restore(4, &blocks[4]).ok());
+    check_analytic_block(blocks[4], 9, 30, 40);
+
+    // the blocks which are never read back are removed
+    blocks.push_back(create_analytic_block(9, 40, 50));
+    EXPECT_TRUE(spiller.spill(5, &blocks[5], {0}).ok());
+    spiller.close();
+    EXPECT_FALSE(spiller.is_spilled(5));
+}
 } // namespace doris
@@ -301,6 +301,57 @@ TEST(BlockTest, SerializeAndDeserializeBlock) {
     serialize_and_deserialize_test(segment_v2::CompressionTypePB::LZ4);
 }
 
+TEST(BlockTest, SerializeAndDeserializeEncodedColumns) {
+    config::compress_rowbatches = true;
+    // a narrow range of integers, a few distinct strings with nulls, integers over the whole range
+    auto narrow_ints = vectorized::ColumnVector<Int64>::create();
+    auto strings = vectorized::ColumnString::create();
+    auto null_map = vectorized::ColumnUInt8::create();
+    auto wide_ints = vectorized::ColumnVector<Int32>::create();
+    std::vector<std::string> dict = {"beijing", "shanghai", "", "shenzhen"};
+    for (int i = 0; i < 4096; ++i) {
+        narrow_ints->insert_value(1000000007LL + i % 100);
+        strings->insert_data(dict[i % 4].data(), dict[i % 4].size());
+        null_map->insert_value(i % 10 < 3);
+        wide_ints->insert_value(static_cast<Int32>(i * 2654435761U));
+    }
+    auto nullable_strings =
+            vectorized::ColumnNullable::create(std::move(strings), std::move(null_map));
+    vectorized::Block block(
+            {{narrow_ints->get_ptr(), std::make_shared<vectorized::DataTypeInt64>(), "narrow"},
+             {nullable_strings->get_ptr(),
+              vectorized::make_nullable(std::make_shared<vectorized::DataTypeString>()), "str"},
+             {wide_ints->get_ptr(), std::make_shared<vectorized::DataTypeInt32>(), "wide"}});
+
+    PBlock pblock;
+    size_t uncompressed_bytes = 0;
+    size_t compressed_bytes = 0;
+    EXPECT_TRUE(block.serialize(BeExecVersionManager::get_newest_version(), &pblock,
+                                &uncompressed_bytes, &compressed_bytes,
+                                segment_v2::CompressionTypePB::LZ4, false, true)
+                        .ok());
+    ASSERT_EQ(3, pblock.column_encodings_size());
+    EXPECT_EQ(COLUMN_ENCODING_FOR_BITPACK, pblock.column_encodings(0));
+    EXPECT_EQ(COLUMN_ENCODING_DICTIONARY, pblock.column_encodings(1));
+    EXPECT_EQ(COLUMN_ENCODING_PLAIN, pblock.column_encodings(2));
+    const auto& stats = block.get_column_encoding_stats();
+    ASSERT_EQ(3, stats.size());
+    EXPECT_LT(stats[0].encoded_bytes, stats[0].plain_bytes);
+    EXPECT_LT(stats[1].encoded_bytes, stats[1].plain_bytes);
+    EXPECT_EQ(stats[2].encoded_bytes, stats[2].plain_bytes);
+
+    vectorized::Block block2;
+    EXPECT_TRUE(block2.deserialize(pblock).ok());
+    ASSERT_EQ(block.rows(), block2.rows());
+    for (size_t i = 0; i < block.columns(); ++i) {
+        const auto& column = *block.get_by_position(i).column;
+        const auto& column2 = *block2.get_by_position(i).column;
+        for (size_t row = 0; row < block.rows(); ++row) {
+            EXPECT_EQ(0, column.compare_at(row, row, column2, 1));
+        }
+    }
+}
+
 TEST(BlockTest, dump_data) {
     auto vec = vectorized::ColumnVector<Int32>::create();
     auto& int32_data = vec->get_data();
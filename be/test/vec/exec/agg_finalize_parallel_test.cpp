@@ -0,0 +1,252 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gen_cpp/Exprs_types.h>
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/PlanNodes_types.h>
+#include <gen_cpp/Types_types.h>
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/object_pool.h"
+#include "exec/exec_node.h"
+#include "gtest/gtest_pred_impl.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "testutil/desc_tbl_builder.h"
+#include "util/threadpool.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
+#include "vec/core/block.h"
+#include "vec/exec/vaggregation_node.h"
+#include "vec/utils/util.hpp"
+
+namespace doris::vectorized {
+
+// Returns the given blocks one by one, then an empty block with eos.
+class AggInputNode : public ExecNode {
+public:
+    AggInputNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                 std::vector<Block> blocks)
+            : ExecNode(pool, tnode, descs), _blocks(std::move(blocks)) {}
+
+    Status get_next(RuntimeState* state, Block* block, bool* eos) override {
+        if (_next < _blocks.size()) {
+            block->swap(_blocks[_next++]);
+            *eos = false;
+        } else {
+            block->clear_column_data();
+            *eos = true;
+        }
+        return Status::OK();
+    }
+
+private:
+    std::vector<Block> _blocks;
+    size_t _next = 0;
+};
+
+class AggFinalizeParallelTest : public testing::Test {
+protected:
+    void SetUp() override {
+        static_cast<void>(ThreadPoolBuilder("AggFinalizeThreadPool")
+                                  .set_min_threads(4)
+                                  .set_max_threads(4)
+                                  .build(&ExecEnv::GetInstance()->_agg_finalize_thread_pool));
+        _agg_finalize_parallelism = config::agg_finalize_parallelism;
+        // tuple 0 is the input (k1, k2, v), tuples 1 and 2 the intermediate and output of
+        // `sum(v) group by k1`, tuples 3 and 4 those of `sum(v) group by k1, k2`. All the
+        // slots are nullable.
+        DescriptorTblBuilder builder(&_pool);
+        builder.declare_tuple() << TYPE_INT << TYPE_INT << TYPE_INT;
+        builder.declare_tuple() << TYPE_INT << TYPE_BIGINT;
+        builder.declare_tuple() << TYPE_INT << TYPE_BIGINT;
+        builder.declare_tuple() << TYPE_INT << TYPE_INT << TYPE_BIGINT;
+        builder.declare_tuple() << TYPE_INT << TYPE_INT << TYPE_BIGINT;
+        _desc_tbl = builder.build();
+    }
+
+    void TearDown() override {
+        ExecEnv::GetInstance()->_agg_finalize_thread_pool->shutdown();
+        ExecEnv::GetInstance()->_agg_finalize_thread_pool.reset();
+        config::agg_finalize_parallelism = _agg_finalize_parallelism;
+    }
+
+    static TExpr slot_ref(SlotId slot_id) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::SLOT_REF);
+        node.__set_type(TypeDescriptor(TYPE_INT).to_thrift());
+        node.__set_num_children(0);
+        node.__set_is_nullable(true);
+        TSlotRef slot;
+        slot.__set_slot_id(slot_id);
+        slot.__set_tuple_id(0);
+        node.__set_slot_ref(slot);
+        TExpr expr;
+        expr.nodes.push_back(node);
+        return expr;
+    }
+
+    // sum(v) of the input tuple
+    static TExpr sum_expr() {
+        TFunctionName name;
+        name.__set_function_name("sum");
+        TFunction fn;
+        fn.__set_name(name);
+        fn.__set_binary_type(TFunctionBinaryType::BUILTIN);
+        fn.__set_arg_types({TypeDescriptor(TYPE_INT).to_thrift()});
+        fn.__set_ret_type(TypeDescriptor(TYPE_BIGINT).to_thrift());
+        fn.__set_has_var_args(false);
+        TAggregateExpr agg_expr;
+        agg_expr.__set_is_merge_agg(false);
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::AGG_EXPR);
+        node.__set_type(TypeDescriptor(TYPE_BIGINT).to_thrift());
+        node.__set_num_children(1);
+        node.__set_is_nullable(true);
+        node.__set_fn(fn);
+        node.__set_agg_expr(agg_expr);
+        TExpr expr = slot_ref(2);
+        expr.nodes.insert(expr.nodes.begin(), node);
+        return expr;
+    }
+
+    // Row i has k1 `i % 5000`, k2 `i % 3` and v `i`, every 13th k1 and every 7th k2 are null.
+    std::vector<Block> create_blocks(int rows) {
+        RowDescriptor row_desc(*_desc_tbl, {0}, {false});
+        std::vector<Block> blocks;
+        for (int begin = 0; begin < rows; begin += 1000) {
+            auto block = VectorizedUtils::create_empty_columnswithtypename(row_desc);
+            auto columns = block.mutate_columns();
+            for (int i = begin; i < std::min(begin + 1000, rows); ++i) {
+                auto insert = [](IColumn& column, bool is_null, int value) {
+                    auto& nullable = assert_cast<ColumnNullable&>(column);
+                    if (is_null) {
+                        nullable.insert_default();
+                    } else {
+                        nullable.get_nested_column().insert_value(value);
+                        nullable.get_null_map_data().push_back(0);
+                    }
+                };
+                insert(*columns[0], i % 13 == 0, i % 5000);
+                insert(*columns[1], i % 7 == 0, i % 3);
+                insert(*columns[2], false, i);
+            }
+            block.set_columns(std::move(columns));
+            blocks.push_back(std::move(block));
+        }
+        return blocks;
+    }
+
+    // Aggregate 20000 rows by the first `num_keys` keys with the given finalize parallelism,
+    // return the output rows sorted.
+    std::vector<std::string> run_agg(int num_keys, int parallelism) {
+        config::agg_finalize_parallelism = parallelism;
+        TQueryOptions query_options;
+        query_options.__set_batch_size(64);
+        query_options.__set_enable_pipeline_engine(false);
+        RuntimeState state(TUniqueId(), query_options, TQueryGlobals(), ExecEnv::GetInstance());
+        state.init_mem_trackers();
+        state.set_desc_tbl(_desc_tbl);
+
+        TPlanNode input_tnode;
+        input_tnode.__set_node_id(0);
+        input_tnode.__set_node_type(TPlanNodeType::EMPTY_SET_NODE);
+        input_tnode.__set_row_tuples({0});
+        input_tnode.__set_nullable_tuples({false});
+        input_tnode.__set_limit(-1);
+
+        TupleId output_tuple_id = num_keys == 1 ? 2 : 4;
+        TPlanNode agg_tnode;
+        agg_tnode.__set_node_id(1);
+        agg_tnode.__set_node_type(TPlanNodeType::AGGREGATION_NODE);
+        agg_tnode.__set_row_tuples({output_tuple_id});
+        agg_tnode.__set_nullable_tuples({false});
+        agg_tnode.__set_limit(-1);
+        TAggregationNode agg_node;
+        std::vector<TExpr> grouping_exprs;
+        for (int i = 0; i < num_keys; ++i) {
+            grouping_exprs.push_back(slot_ref(i));
+        }
+        agg_node.__set_grouping_exprs(grouping_exprs);
+        agg_node.__set_aggregate_functions({sum_expr()});
+        agg_node.__set_intermediate_tuple_id(output_tuple_id - 1);
+        agg_node.__set_output_tuple_id(output_tuple_id);
+        agg_node.__set_need_finalize(true);
+        agg_node.__set_use_streaming_preaggregation(false);
+        agg_tnode.__set_agg_node(agg_node);
+
+        auto* input_node = _pool.add(
+                new AggInputNode(&_pool, input_tnode, *_desc_tbl, create_blocks(20000)));
+        auto* agg_exec_node = _pool.add(new AggregationNode(&_pool, agg_tnode, *_desc_tbl));
+        agg_exec_node->_children = {input_node};
+
+        EXPECT_TRUE(input_node->init(input_tnode, &state).ok());
+        EXPECT_TRUE(agg_exec_node->init(agg_tnode, &state).ok());
+        EXPECT_TRUE(agg_exec_node->prepare(&state).ok());
+        EXPECT_TRUE(agg_exec_node->open(&state).ok());
+
+        std::vector<std::string> rows;
+        bool eos = false;
+        while (!eos) {
+            Block block;
+            auto st = agg_exec_node->get_next(&state, &block, &eos);
+            EXPECT_TRUE(st.ok()) << st;
+            if (!st.ok()) {
+                break;
+            }
+            EXPECT_LE(block.rows(), 64U);
+            for (size_t i = 0; i < block.rows(); ++i) {
+                rows.push_back(block.dump_one_line(i, block.columns()));
+            }
+        }
+        EXPECT_TRUE(agg_exec_node->close(&state).ok());
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+    ObjectPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    int32_t _agg_finalize_parallelism;
+};
+
+TEST_F(AggFinalizeParallelTest, ParallelFinalizeMatchesSerialFinalize) {
+    // 5000 groups of k1 and the null group
+    auto expected = run_agg(1, 1);
+    EXPECT_EQ(5001U, expected.size());
+    for (int parallelism : {2, 4, 16}) {
+        EXPECT_EQ(expected, run_agg(1, parallelism)) << "parallelism " << parallelism;
+    }
+}
+
+TEST_F(AggFinalizeParallelTest, ParallelFinalizeWithNullableKeys) {
+    auto expected = run_agg(2, 1);
+    EXPECT_GT(expected.size(), 5000U);
+    for (int parallelism : {2, 4, 16}) {
+        EXPECT_EQ(expected, run_agg(2, parallelism)) << "parallelism " << parallelism;
+    }
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,285 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gen_cpp/Exprs_types.h>
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/PlanNodes_types.h>
+#include <gen_cpp/Types_types.h>
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exec/exec_node.h"
+#include "gtest/gtest_pred_impl.h"
+#include "io/fs/local_file_system.h"
+#include "olap/options.h"
+#include "runtime/block_spill_manager.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "testutil/desc_tbl_builder.h"
+#include "util/runtime_profile.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
+#include "vec/core/block.h"
+#include "vec/exec/vanalytic_eval_node.h"
+#include "vec/utils/util.hpp"
+
+namespace doris::vectorized {
+
+static const std::string SPILL_DIR = "./ut_dir/analytic_spill_test";
+
+// Returns the given blocks one by one, then an empty block with eos.
+class AnalyticInputNode : public ExecNode {
+public:
+    AnalyticInputNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                      std::vector<Block> blocks)
+            : ExecNode(pool, tnode, descs), _blocks(std::move(blocks)) {}
+
+    Status get_next(RuntimeState* state, Block* block, bool* eos) override {
+        if (_next < _blocks.size()) {
+            block->swap(_blocks[_next++]);
+            *eos = false;
+        } else {
+            block->clear_column_data();
+            *eos = true;
+        }
+        return Status::OK();
+    }
+
+private:
+    std::vector<Block> _blocks;
+    size_t _next = 0;
+};
+
+class AnalyticSpillTest : public testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        static_cast<void>(io::global_local_filesystem()->delete_and_create_directory(SPILL_DIR));
+        std::vector<StorePath> paths;
+        paths.emplace_back(SPILL_DIR, -1);
+        _spill_manager = std::make_unique<BlockSpillManager>(paths);
+        static_cast<void>(_spill_manager->init());
+    }
+
+    static void TearDownTestSuite() {
+        ExecEnv::GetInstance()->_block_spill_mgr = nullptr;
+        _spill_manager.reset();
+        static_cast<void>(io::global_local_filesystem()->delete_directory(SPILL_DIR));
+    }
+
+    void SetUp() override {
+        ExecEnv::GetInstance()->_block_spill_mgr = _spill_manager.get();
+        // tuple 0 is the input (k, o, v), tuples 1 and 2 the intermediate and output of
+        // `sum(v)`, tuple 3 the buffered tuple. All the slots are nullable.
+        DescriptorTblBuilder builder(&_pool);
+        builder.declare_tuple() << TYPE_INT << TYPE_INT << TYPE_INT;
+        builder.declare_tuple() << TYPE_BIGINT;
+        builder.declare_tuple() << TYPE_BIGINT;
+        builder.declare_tuple() << TYPE_INT << TYPE_INT << TYPE_INT;
+        _desc_tbl = builder.build();
+    }
+
+    static TExpr slot_ref(SlotId slot_id) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::SLOT_REF);
+        node.__set_type(TypeDescriptor(TYPE_INT).to_thrift());
+        node.__set_num_children(0);
+        node.__set_is_nullable(true);
+        TSlotRef slot;
+        slot.__set_slot_id(slot_id);
+        slot.__set_tuple_id(0);
+        node.__set_slot_ref(slot);
+        TExpr expr;
+        expr.nodes.push_back(node);
+        return expr;
+    }
+
+    // sum(v) of the input tuple
+    static TExpr sum_expr() {
+        TFunctionName name;
+        name.__set_function_name("sum");
+        TFunction fn;
+        fn.__set_name(name);
+        fn.__set_binary_type(TFunctionBinaryType::BUILTIN);
+        fn.__set_arg_types({TypeDescriptor(TYPE_INT).to_thrift()});
+        fn.__set_ret_type(TypeDescriptor(TYPE_BIGINT).to_thrift());
+        fn.__set_has_var_args(false);
+        TAggregateExpr agg_expr;
+        agg_expr.__set_is_merge_agg(false);
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::AGG_EXPR);
+        node.__set_type(TypeDescriptor(TYPE_BIGINT).to_thrift());
+        node.__set_num_children(1);
+        node.__set_is_nullable(true);
+        node.__set_fn(fn);
+        node.__set_agg_expr(agg_expr);
+        TExpr expr = slot_ref(2);
+        expr.nodes.insert(expr.nodes.begin(), node);
+        return expr;
+    }
+
+    static TAnalyticWindowBoundary boundary(TAnalyticWindowBoundaryType::type type,
+                                            int64_t offset = 0) {
+        TAnalyticWindowBoundary b;
+        b.__set_type(type);
+        if (type != TAnalyticWindowBoundaryType::CURRENT_ROW) {
+            b.__set_rows_offset_value(offset);
+        }
+        return b;
+    }
+
+    // 20000 rows in blocks of 700, row i has k `i / 5000`, o `i / 1500` and v `i`, so the
+    // partitions and the peer groups span several blocks.
+    std::vector<Block> create_blocks() {
+        RowDescriptor row_desc(*_desc_tbl, {0}, {false});
+        std::vector<Block> blocks;
+        for (int begin = 0; begin < 20000; begin += 700) {
+            auto block = VectorizedUtils::create_empty_columnswithtypename(row_desc);
+            auto columns = block.mutate_columns();
+            for (int i = begin; i < std::min(begin + 700, 20000); ++i) {
+                int values[] = {i / 5000, i / 1500, i};
+                for (size_t c = 0; c < columns.size(); ++c) {
+                    auto& nullable = assert_cast<ColumnNullable&>(*columns[c]);
+                    nullable.get_nested_column().insert_value(values[c]);
+                    nullable.get_null_map_data().push_back(0);
+                }
+            }
+            block.set_columns(std::move(columns));
+            blocks.push_back(std::move(block));
+        }
+        return blocks;
+    }
+
+    // sum(v) over (partition by k [order by o] [window]) with the given spill threshold,
+    // return the output rows and the number of spilled blocks.
+    std::vector<std::string> run_analytic(const TAnalyticWindow* window, int64_t threshold,
+                                          int64_t* spilled_blocks) {
+        TQueryOptions query_options;
+        query_options.__set_batch_size(700);
+        query_options.__set_enable_pipeline_engine(false);
+        query_options.__set_external_analytic_bytes_threshold(threshold);
+        RuntimeState state(TUniqueId(), query_options, TQueryGlobals(), ExecEnv::GetInstance());
+        state.init_mem_trackers();
+        state.set_desc_tbl(_desc_tbl);
+
+        TPlanNode input_tnode;
+        input_tnode.__set_node_id(0);
+        input_tnode.__set_node_type(TPlanNodeType::EMPTY_SET_NODE);
+        input_tnode.__set_row_tuples({0});
+        input_tnode.__set_nullable_tuples({false});
+        input_tnode.__set_limit(-1);
+
+        TPlanNode analytic_tnode;
+        analytic_tnode.__set_node_id(1);
+        analytic_tnode.__set_node_type(TPlanNodeType::ANALYTIC_EVAL_NODE);
+        analytic_tnode.__set_row_tuples({0, 2});
+        analytic_tnode.__set_nullable_tuples({false, false});
+        analytic_tnode.__set_limit(-1);
+        TAnalyticNode analytic_node;
+        analytic_node.__set_partition_exprs({slot_ref(0)});
+        analytic_node.__set_order_by_exprs({});
+        if (window != nullptr) {
+            analytic_node.__set_order_by_exprs({slot_ref(1)});
+            analytic_node.__set_window(*window);
+        }
+        analytic_node.__set_analytic_functions({sum_expr()});
+        analytic_node.__set_intermediate_tuple_id(1);
+        analytic_node.__set_output_tuple_id(2);
+        analytic_node.__set_buffered_tuple_id(3);
+        analytic_tnode.__set_analytic_node(analytic_node);
+
+        auto* input_node = _pool.add(
+                new AnalyticInputNode(&_pool, input_tnode, *_desc_tbl, create_blocks()));
+        auto* analytic_exec_node =
+                _pool.add(new VAnalyticEvalNode(&_pool, analytic_tnode, *_desc_tbl));
+        analytic_exec_node->_children = {input_node};
+
+        EXPECT_TRUE(input_node->init(input_tnode, &state).ok());
+        EXPECT_TRUE(analytic_exec_node->init(analytic_tnode, &state).ok());
+        EXPECT_TRUE(analytic_exec_node->prepare(&state).ok());
+        EXPECT_TRUE(analytic_exec_node->open(&state).ok());
+
+        std::vector<std::string> rows;
+        bool eos = false;
+        while (!eos) {
+            Block block;
+            auto st = analytic_exec_node->get_next(&state, &block, &eos);
+            EXPECT_TRUE(st.ok()) << st;
+            if (!st.ok()) {
+                break;
+            }
+            for (size_t i = 0; i < block.rows(); ++i) {
+                rows.push_back(block.dump_one_line(i, block.columns()));
+            }
+        }
+        *spilled_blocks =
+                analytic_exec_node->runtime_profile()->get_counter("SpilledBlockCount")->value();
+        EXPECT_TRUE(analytic_exec_node->close(&state).ok());
+        return rows;
+    }
+
+    void check_spill_keeps_results(const TAnalyticWindow* window) {
+        int64_t spilled_blocks = 0;
+        auto expected = run_analytic(window, 0, &spilled_blocks);
+        EXPECT_EQ(20000U, expected.size());
+        EXPECT_EQ(0, spilled_blocks);
+        // every block after the start of a partition and before its end is spilled
+        EXPECT_EQ(expected, run_analytic(window, 1, &spilled_blocks));
+        EXPECT_GT(spilled_blocks, 16);
+    }
+
+    static std::unique_ptr<BlockSpillManager> _spill_manager;
+    ObjectPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+};
+
+std::unique_ptr<BlockSpillManager> AnalyticSpillTest::_spill_manager;
+
+TEST_F(AnalyticSpillTest, PartitionWindow) {
+    check_spill_keeps_results(nullptr);
+}
+
+TEST_F(AnalyticSpillTest, RangeWindowAcrossSpilledPeerGroups) {
+    TAnalyticWindow window;
+    window.__set_type(TAnalyticWindowType::RANGE);
+    window.__set_window_end(boundary(TAnalyticWindowBoundaryType::CURRENT_ROW));
+    check_spill_keeps_results(&window);
+}
+
+TEST_F(AnalyticSpillTest, RowsWindowUnboundedPreceding) {
+    TAnalyticWindow window;
+    window.__set_type(TAnalyticWindowType::ROWS);
+    window.__set_window_end(boundary(TAnalyticWindowBoundaryType::CURRENT_ROW));
+    check_spill_keeps_results(&window);
+}
+
+TEST_F(AnalyticSpillTest, BoundedRowsWindowSpillsAggInput) {
+    TAnalyticWindow window;
+    window.__set_type(TAnalyticWindowType::ROWS);
+    window.__set_window_start(boundary(TAnalyticWindowBoundaryType::PRECEDING, 2));
+    window.__set_window_end(boundary(TAnalyticWindowBoundaryType::FOLLOWING, 1));
+    check_spill_keeps_results(&window);
+}
+
+} // namespace doris::vectorized
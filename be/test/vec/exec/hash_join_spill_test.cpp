@@ -0,0 +1,328 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gen_cpp/Exprs_types.h>
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gen_cpp/PlanNodes_types.h>
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exec/exec_node.h"
+#include "gtest/gtest_pred_impl.h"
+#include "io/fs/local_file_system.h"
+#include "olap/options.h"
+#include "runtime/block_spill_manager.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "testutil/desc_tbl_builder.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
+#include "vec/core/block.h"
+#include "vec/exec/join/vhash_join_node.h"
+#include "vec/utils/template_helpers.hpp"
+#include "vec/utils/util.hpp"
+
+namespace doris::vectorized {
+
+static const std::string SPILL_DIR = "./ut_dir/hash_join_spill_test";
+
+// Returns the given blocks one by one, then an empty block with eos.
+class BlocksSourceNode : public ExecNode {
+public:
+    BlocksSourceNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                     std::vector<Block> blocks)
+            : ExecNode(pool, tnode, descs), _blocks(std::move(blocks)) {}
+
+    Status get_next(RuntimeState* state, Block* block, bool* eos) override {
+        if (_next < _blocks.size()) {
+            block->swap(_blocks[_next++]);
+            *eos = false;
+        } else {
+            block->clear_column_data();
+            *eos = true;
+        }
+        return Status::OK();
+    }
+
+private:
+    std::vector<Block> _blocks;
+    size_t _next = 0;
+};
+
+class HashJoinSpillTest : public testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        static_cast<void>(io::global_local_filesystem()->delete_and_create_directory(SPILL_DIR));
+        std::vector<StorePath> paths;
+        paths.emplace_back(SPILL_DIR, -1);
+        _spill_manager = std::make_unique<BlockSpillManager>(paths);
+        static_cast<void>(_spill_manager->init());
+    }
+
+    static void TearDownTestSuite() {
+        ExecEnv::GetInstance()->_block_spill_mgr = nullptr;
+        _spill_manager.reset();
+        static_cast<void>(io::global_local_filesystem()->delete_directory(SPILL_DIR));
+    }
+
+    void SetUp() override {
+        ExecEnv::GetInstance()->_block_spill_mgr = _spill_manager.get();
+        // tuple 0 is the probe side, tuple 1 the build side and tuple 2 the output, every
+        // tuple has a key and a value slot of nullable int.
+        DescriptorTblBuilder builder(&_pool);
+        builder.declare_tuple() << TYPE_INT << TYPE_INT;
+        builder.declare_tuple() << TYPE_INT << TYPE_INT;
+        builder.declare_tuple() << TYPE_INT << TYPE_INT << TYPE_INT << TYPE_INT;
+        _desc_tbl = builder.build();
+    }
+
+    static TExpr slot_ref(TupleId tuple_id, SlotId slot_id) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::SLOT_REF);
+        node.__set_type(TypeDescriptor(TYPE_INT).to_thrift());
+        node.__set_num_children(0);
+        node.__set_is_nullable(true);
+        TSlotRef slot;
+        slot.__set_slot_id(slot_id);
+        slot.__set_tuple_id(tuple_id);
+        node.__set_slot_ref(slot);
+        TExpr expr;
+        expr.nodes.push_back(node);
+        return expr;
+    }
+
+    // Rows i in [begin, end) with key `i % keys` and value `i + value_offset`, every 13th key is
+    // null. Rows before `hot_key_rows` all have key 7.
+    Block create_block(TupleId tuple_id, int begin, int end, int keys, int value_offset,
+                       int hot_key_rows) {
+        RowDescriptor row_desc(*_desc_tbl, {tuple_id}, {false});
+        auto block = VectorizedUtils::create_empty_columnswithtypename(row_desc);
+        auto columns = block.mutate_columns();
+        for (int i = begin; i < end; ++i) {
+            auto& key = assert_cast<ColumnNullable&>(*columns[0]);
+            if (i < hot_key_rows) {
+                key.get_nested_column().insert_value(7);
+                key.get_null_map_data().push_back(0);
+            } else if (i % 13 == 0) {
+                key.insert_default();
+            } else {
+                key.get_nested_column().insert_value(i % keys);
+                key.get_null_map_data().push_back(0);
+            }
+            auto& value = assert_cast<ColumnNullable&>(*columns[1]);
+            value.get_nested_column().insert_value(i + value_offset);
+            value.get_null_map_data().push_back(0);
+        }
+        block.set_columns(std::move(columns));
+        return block;
+    }
+
+    std::vector<Block> create_blocks(TupleId tuple_id, int rows, int keys, int value_offset,
+                                     int hot_key_rows = 0) {
+        std::vector<Block> blocks;
+        for (int begin = 0; begin < rows; begin += 1000) {
+            blocks.push_back(create_block(tuple_id, begin, std::min(begin + 1000, rows), keys,
+                                          value_offset, hot_key_rows));
+        }
+        return blocks;
+    }
+
+    struct SpillStats {
+        int64_t build_rows = 0;
+        int64_t repartitions = 0;
+        // whether the hash table was split into sub tables
+        bool partitioned_hash_table = false;
+    };
+
+    // Join 3000 probe rows with 5000 build rows, or 25000 of which the first `hot_key_rows`
+    // have the same key, and return the output rows, sorted. In `pipeline` mode the join node
+    // is driven like the hash join build sink and probe operators drive it.
+    std::vector<std::string> run_join(TJoinOp::type join_op, int64_t spill_threshold,
+                                      bool pipeline, int hot_key_rows, SpillStats* stats) {
+        TQueryOptions query_options;
+        query_options.__set_batch_size(1024);
+        query_options.__set_enable_pipeline_engine(pipeline);
+        query_options.__set_external_join_bytes_threshold(spill_threshold);
+        query_options.__set_external_join_partition_bits(2);
+        if (_partitioned_hash_join_rows_threshold > 0) {
+            query_options.__set_partitioned_hash_join_rows_threshold(
+                    _partitioned_hash_join_rows_threshold);
+        }
+        RuntimeState state(TUniqueId(), query_options, TQueryGlobals(), ExecEnv::GetInstance());
+        state.set_desc_tbl(_desc_tbl);
+
+        TPlanNode probe_tnode;
+        probe_tnode.__set_node_id(0);
+        probe_tnode.__set_node_type(TPlanNodeType::EMPTY_SET_NODE);
+        probe_tnode.__set_row_tuples({0});
+        probe_tnode.__set_nullable_tuples({false});
+        probe_tnode.__set_limit(-1);
+        TPlanNode build_tnode = probe_tnode;
+        build_tnode.__set_node_id(1);
+        build_tnode.__set_row_tuples({1});
+
+        TPlanNode join_tnode;
+        join_tnode.__set_node_id(2);
+        join_tnode.__set_node_type(TPlanNodeType::HASH_JOIN_NODE);
+        join_tnode.__set_row_tuples({2});
+        join_tnode.__set_nullable_tuples({false});
+        join_tnode.__set_limit(-1);
+        THashJoinNode hash_join_node;
+        hash_join_node.__set_join_op(join_op);
+        TEqJoinCondition eq_join_conjunct;
+        eq_join_conjunct.__set_left(slot_ref(0, 0));
+        eq_join_conjunct.__set_right(slot_ref(1, 2));
+        hash_join_node.__set_eq_join_conjuncts({eq_join_conjunct});
+        hash_join_node.__set_vintermediate_tuple_id_list({0, 1});
+        hash_join_node.__set_voutput_tuple_id(2);
+        join_tnode.__set_hash_join_node(hash_join_node);
+
+        auto* probe_node = _pool.add(new BlocksSourceNode(&_pool, probe_tnode, *_desc_tbl,
+                                                          create_blocks(0, 3000, 700, 0)));
+        auto* build_node = _pool.add(new BlocksSourceNode(
+                &_pool, build_tnode, *_desc_tbl,
+                create_blocks(1, hot_key_rows > 0 ? 25000 : 5000, 1000, 100000, hot_key_rows)));
+        auto* join_node = _pool.add(new HashJoinNode(&_pool, join_tnode, *_desc_tbl));
+        join_node->_children = {probe_node, build_node};
+
+        EXPECT_TRUE(probe_node->init(probe_tnode, &state).ok());
+        EXPECT_TRUE(build_node->init(build_tnode, &state).ok());
+        EXPECT_TRUE(join_node->init(join_tnode, &state).ok());
+        EXPECT_TRUE(join_node->prepare(&state).ok());
+        EXPECT_TRUE(join_node->alloc_resource(&state).ok());
+        // the build side is materialized on the calling thread, `open` would need the join
+        // node thread pool of a running BE.
+        EXPECT_TRUE(join_node->_materialize_build_side(&state).ok());
+
+        std::vector<std::string> rows;
+        bool eos = false;
+        while (!eos) {
+            Block block;
+            Status st;
+            if (!pipeline) {
+                st = join_node->get_next(&state, &block, &eos);
+            } else if (join_node->need_more_input_data()) {
+                Block probe_block;
+                bool probe_eos = false;
+                st = probe_node->get_next(&state, &probe_block, &probe_eos);
+                if (st.ok()) {
+                    join_node->prepare_for_next();
+                    st = join_node->push(&state, &probe_block, probe_eos);
+                }
+            } else {
+                st = join_node->pull(&state, &block, &eos);
+            }
+            EXPECT_TRUE(st.ok()) << st;
+            if (!st.ok()) {
+                break;
+            }
+            for (size_t i = 0; i < block.rows(); ++i) {
+                rows.push_back(block.dump_one_line(i, block.columns()));
+            }
+        }
+        if (join_node->_spill_build_rows_counter != nullptr) {
+            stats->build_rows = join_node->_spill_build_rows_counter->value();
+            stats->repartitions = join_node->_spill_repartition_counter->value();
+        }
+        std::visit(Overload {[&](std::monostate&) {},
+                             [&](auto&& arg) {
+                                 stats->partitioned_hash_table = arg.hash_table.is_partitioned();
+                             }},
+                   *join_node->_hash_table_variants);
+        EXPECT_TRUE(join_node->close(&state).ok());
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+    ObjectPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    // the hash table is split into sub tables once it has this many buckets, 0 never splits it
+    int _partitioned_hash_join_rows_threshold = 0;
+    static inline std::unique_ptr<BlockSpillManager> _spill_manager;
+};
+
+TEST_F(HashJoinSpillTest, SpilledJoinMatchesInMemoryJoin) {
+    for (bool pipeline : {false, true}) {
+        for (auto join_op : {TJoinOp::INNER_JOIN, TJoinOp::LEFT_OUTER_JOIN,
+                             TJoinOp::RIGHT_OUTER_JOIN, TJoinOp::FULL_OUTER_JOIN}) {
+            SpillStats stats;
+            auto expected = run_join(join_op, 0, pipeline, 0, &stats);
+            EXPECT_EQ(0, stats.build_rows);
+            EXPECT_FALSE(expected.empty());
+
+            // any build block exceeds one byte, so the whole build side is spilled, and every
+            // partition is split again until the bits of the hash are used up.
+            auto rows = run_join(join_op, 1, pipeline, 0, &stats);
+            EXPECT_EQ(5000, stats.build_rows);
+            EXPECT_GT(stats.repartitions, 0);
+            EXPECT_EQ(expected, rows) << "join op " << join_op << ", pipeline " << pipeline;
+        }
+    }
+}
+
+TEST_F(HashJoinSpillTest, SkewedPartitionIsSplitAgain) {
+    for (bool pipeline : {false, true}) {
+        for (auto join_op : {TJoinOp::INNER_JOIN, TJoinOp::RIGHT_OUTER_JOIN}) {
+            SpillStats stats;
+            auto expected = run_join(join_op, 0, pipeline, 20000, &stats);
+            EXPECT_EQ(0, stats.build_rows);
+
+            // The 20000 rows of key 7 exceed 64KB in any partition, the others do not, so only
+            // the partitions of key 7 are split again, down to the last level.
+            auto rows = run_join(join_op, 64 * 1024, pipeline, 20000, &stats);
+            EXPECT_EQ(25000, stats.build_rows);
+            EXPECT_EQ(3, stats.repartitions);
+            EXPECT_EQ(expected, rows) << "join op " << join_op << ", pipeline " << pipeline;
+        }
+    }
+}
+
+TEST_F(HashJoinSpillTest, RadixPartitionedJoinMatchesRowOrderJoin) {
+    bool enable_hash_join_radix_partition = config::enable_hash_join_radix_partition;
+    // the build side of 5000 rows is inserted into a hash table of 16 sub tables
+    _partitioned_hash_join_rows_threshold = 64;
+    for (bool pipeline : {false, true}) {
+        for (auto join_op : {TJoinOp::INNER_JOIN, TJoinOp::LEFT_OUTER_JOIN,
+                             TJoinOp::RIGHT_OUTER_JOIN, TJoinOp::FULL_OUTER_JOIN,
+                             TJoinOp::LEFT_SEMI_JOIN, TJoinOp::LEFT_ANTI_JOIN,
+                             TJoinOp::NULL_AWARE_LEFT_ANTI_JOIN}) {
+            SpillStats stats;
+            config::enable_hash_join_radix_partition = false;
+            auto expected = run_join(join_op, 0, pipeline, 0, &stats);
+            EXPECT_TRUE(stats.partitioned_hash_table);
+            EXPECT_FALSE(expected.empty());
+
+            // rows are inserted and looked up sub table by sub table
+            config::enable_hash_join_radix_partition = true;
+            auto rows = run_join(join_op, 0, pipeline, 0, &stats);
+            EXPECT_TRUE(stats.partitioned_hash_table);
+            EXPECT_EQ(expected, rows) << "join op " << join_op << ", pipeline " << pipeline;
+        }
+    }
+    config::enable_hash_join_radix_partition = enable_hash_join_radix_partition;
+}
+
+} // namespace doris::vectorized
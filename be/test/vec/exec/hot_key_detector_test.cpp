@@ -0,0 +1,124 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/sink/hot_key_detector.h"
+
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <vector>
+
+#include "common/config.h"
+#include "gtest/gtest_pred_impl.h"
+#include "util/runtime_profile.h"
+
+namespace doris::vectorized {
+
+static constexpr size_t NUM_CHANNELS = 4;
+static constexpr uint64_t HOT_KEY = 42;
+
+// a third of the rows are the hot key, the others are unique
+static std::vector<uint64_t> create_hashes(int rows, uint64_t* next_key) {
+    std::vector<uint64_t> hashes(rows);
+    for (int i = 0; i < rows; ++i) {
+        hashes[i] = i % 3 == 0 ? HOT_KEY : (*next_key)++;
+    }
+    return hashes;
+}
+
+static void warm_up(HotKeyDetector& detector, uint64_t* next_key) {
+    for (int i = 0; i < 8; ++i) {
+        auto hashes = create_hashes(4096, next_key);
+        detector.assign_channels(hashes.data(), hashes.size());
+    }
+}
+
+class HotKeyDetectorTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _enable_exchange_hot_key_detection = config::enable_exchange_hot_key_detection;
+        config::enable_exchange_hot_key_detection = true;
+    }
+
+    void TearDown() override {
+        config::enable_exchange_hot_key_detection = _enable_exchange_hot_key_detection;
+    }
+
+    bool _enable_exchange_hot_key_detection;
+};
+
+TEST_F(HotKeyDetectorTest, ReportHotKey) {
+    RuntimeProfile profile("test");
+    HotKeyDetector detector;
+    detector.init(NUM_CHANNELS, &profile);
+    uint64_t next_key = 1000;
+    warm_up(detector, &next_key);
+    EXPECT_TRUE(detector.is_hot_key(HOT_KEY));
+
+    // the rows of the hot key still go to the channel of their hash
+    auto hashes = create_hashes(4096, &next_key);
+    auto keys = hashes;
+    detector.assign_channels(hashes.data(), hashes.size());
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        EXPECT_EQ(keys[i] % NUM_CHANNELS, hashes[i]);
+    }
+    EXPECT_GT(profile.get_counter("HotKeyRows")->value(), 0);
+
+    detector.update_channel_bytes(hashes.data(), hashes.size(), 4096 * 8);
+    detector.close();
+    EXPECT_NE(nullptr, profile.get_info_string("ChannelBytesSent"));
+}
+
+TEST_F(HotKeyDetectorTest, NoHotKey) {
+    RuntimeProfile profile("test");
+    HotKeyDetector detector;
+    detector.init(NUM_CHANNELS, &profile);
+    uint64_t next_key = 1000;
+    for (int i = 0; i < 8; ++i) {
+        std::vector<uint64_t> hashes(4096);
+        for (auto& hash : hashes) {
+            hash = next_key++;
+        }
+        detector.assign_channels(hashes.data(), hashes.size());
+    }
+    EXPECT_EQ(0, profile.get_counter("HotKeys")->value());
+}
+
+TEST_F(HotKeyDetectorTest, Disabled) {
+    config::enable_exchange_hot_key_detection = false;
+    RuntimeProfile profile("test");
+    HotKeyDetector detector;
+    detector.init(NUM_CHANNELS, &profile);
+    uint64_t next_key = 1000;
+    warm_up(detector, &next_key);
+    EXPECT_FALSE(detector.is_hot_key(HOT_KEY));
+
+    auto hashes = create_hashes(4096, &next_key);
+    auto keys = hashes;
+    detector.assign_channels(hashes.data(), hashes.size());
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        EXPECT_EQ(keys[i] % NUM_CHANNELS, hashes[i]);
+    }
+    EXPECT_EQ(0, profile.get_counter("HotKeys")->value());
+
+    // nothing is counted per channel either
+    detector.update_channel_bytes(hashes.data(), hashes.size(), 4096 * 8);
+    detector.close();
+    EXPECT_EQ(nullptr, profile.get_info_string("ChannelBytesSent"));
+}
+
+} // namespace doris::vectorized
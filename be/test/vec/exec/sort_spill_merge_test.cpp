@@ -0,0 +1,168 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gen_cpp/PaloInternalService_types.h>
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "common/config.h"
+#include "common/object_pool.h"
+#include "gtest/gtest_pred_impl.h"
+#include "io/fs/local_file_system.h"
+#include "olap/options.h"
+#include "runtime/block_spill_manager.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "testutil/desc_tbl_builder.h"
+#include "util/runtime_profile.h"
+#include "util/threadpool.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/sort/sorter.h"
+#include "vec/core/block.h"
+#include "vec/core/sort_description.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris::vectorized {
+
+static const std::string SPILL_DIR = "./ut_dir/sort_spill_merge_test";
+
+class SortSpillMergeTest : public testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        static_cast<void>(io::global_local_filesystem()->delete_and_create_directory(SPILL_DIR));
+        std::vector<StorePath> paths;
+        paths.emplace_back(SPILL_DIR, -1);
+        _spill_manager = std::make_unique<BlockSpillManager>(paths);
+        static_cast<void>(_spill_manager->init());
+    }
+
+    static void TearDownTestSuite() {
+        ExecEnv::GetInstance()->_block_spill_mgr = nullptr;
+        _spill_manager.reset();
+        static_cast<void>(io::global_local_filesystem()->delete_directory(SPILL_DIR));
+    }
+
+    void SetUp() override {
+        ExecEnv::GetInstance()->_block_spill_mgr = _spill_manager.get();
+        static_cast<void>(ThreadPoolBuilder("SpillSortMergeThreadPool")
+                                  .set_min_threads(4)
+                                  .set_max_threads(4)
+                                  .build(&ExecEnv::GetInstance()->_spill_sort_merge_thread_pool));
+        DescriptorTblBuilder builder(&_pool);
+        builder.declare_tuple() << TYPE_INT << TYPE_INT;
+        _desc_tbl = builder.build();
+        _spill_sort_merge_parallelism = config::spill_sort_merge_parallelism;
+    }
+
+    void TearDown() override {
+        ExecEnv::GetInstance()->_spill_sort_merge_thread_pool->shutdown();
+        ExecEnv::GetInstance()->_spill_sort_merge_thread_pool.reset();
+        config::spill_sort_merge_parallelism = _spill_sort_merge_parallelism;
+    }
+
+    // `num_blocks` sorted blocks of `rows` rows, the keys of all the blocks are distinct and
+    // the value of a row is twice its key.
+    static std::vector<Block> create_sorted_blocks(int num_blocks, int rows) {
+        std::vector<Block> blocks;
+        int total_rows = num_blocks * rows;
+        for (int b = 0; b < num_blocks; ++b) {
+            std::vector<int32_t> keys;
+            for (int i = b * rows; i < (b + 1) * rows; ++i) {
+                keys.push_back(static_cast<int32_t>(int64_t(i) * 7919 % total_rows));
+            }
+            std::sort(keys.begin(), keys.end());
+            auto key_column = ColumnInt32::create();
+            auto value_column = ColumnInt32::create();
+            for (auto key : keys) {
+                key_column->insert_value(key);
+                value_column->insert_value(key * 2);
+            }
+            auto type = std::make_shared<DataTypeInt32>();
+            blocks.push_back(Block({{std::move(key_column), type, "k"},
+                                    {std::move(value_column), type, "v"}}));
+        }
+        return blocks;
+    }
+
+    // Spill all the blocks and merge them with the given parallelism, return the keys read.
+    std::vector<int32_t> spill_and_merge(int parallelism, int64_t offset, int64_t limit) {
+        config::spill_sort_merge_parallelism = parallelism;
+        TQueryOptions query_options;
+        query_options.__set_batch_size(1024);
+        // every block is spilled and two streams are merged at a time, so 20 spilled blocks
+        // take several rounds of intermediate merges.
+        query_options.__set_external_sort_bytes_threshold(1);
+        RuntimeState state(TUniqueId(), query_options, TQueryGlobals(), ExecEnv::GetInstance());
+        state.init_mem_trackers();
+        RuntimeProfile profile("SortSpillMergeTest");
+        RowDescriptor row_desc(*_desc_tbl, {0}, {false});
+        MergeSorterState sorter_state(row_desc, offset, limit, &state, &profile);
+
+        for (auto& block : create_sorted_blocks(20, 1000)) {
+            EXPECT_TRUE(sorter_state.add_sorted_block(block).ok());
+        }
+        EXPECT_TRUE(sorter_state.is_spilled());
+        SortDescription sort_description {SortColumnDescription(0, 1, 1)};
+        auto st = sorter_state.build_merge_tree(sort_description);
+        EXPECT_TRUE(st.ok()) << st;
+
+        std::vector<int32_t> keys;
+        bool eos = false;
+        while (st.ok() && !eos) {
+            Block block;
+            st = sorter_state.merge_sort_read(&state, &block, &eos);
+            EXPECT_TRUE(st.ok()) << st;
+            for (size_t i = 0; i < block.rows(); ++i) {
+                auto key = static_cast<int32_t>(block.get_by_position(0).column->get_int(i));
+                EXPECT_EQ(key * 2, block.get_by_position(1).column->get_int(i));
+                keys.push_back(key);
+            }
+        }
+        return keys;
+    }
+
+    ObjectPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    int32_t _spill_sort_merge_parallelism;
+    static inline std::unique_ptr<BlockSpillManager> _spill_manager;
+};
+
+TEST_F(SortSpillMergeTest, ParallelMergeMatchesSerialMerge) {
+    auto expected = spill_and_merge(1, 0, -1);
+    ASSERT_EQ(20000U, expected.size());
+    EXPECT_TRUE(std::is_sorted(expected.begin(), expected.end()));
+    EXPECT_EQ(0, expected.front());
+    EXPECT_EQ(19999, expected.back());
+
+    for (int parallelism : {2, 4, 16}) {
+        EXPECT_EQ(expected, spill_and_merge(parallelism, 0, -1)) << "parallelism " << parallelism;
+    }
+}
+
+TEST_F(SortSpillMergeTest, ParallelMergeWithOffsetAndLimit) {
+    auto expected = spill_and_merge(1, 100, 3000);
+    ASSERT_EQ(3000U, expected.size());
+    EXPECT_EQ(100, expected.front());
+    EXPECT_EQ(expected, spill_and_merge(4, 100, 3000));
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,105 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest-message.h>
+#include <gtest/gtest-test-part.h>
+
+#include "common/config.h"
+#include "gtest/gtest_pred_impl.h"
+#include "vec/columns/columns_number.h"
+#include "vec/exec/vaggregation_node.h"
+
+namespace doris::vectorized {
+
+static constexpr int64_t ROWS = 4096;
+// larger than any cache, so the table needs a significant reduction to grow
+static constexpr size_t HUGE_HT_MEM = 1UL << 40;
+
+static ColumnPtr create_keys(int64_t cardinality, int64_t start) {
+    auto column = ColumnInt64::create();
+    for (int64_t i = 0; i < ROWS; ++i) {
+        column->insert_value(start + i % cardinality);
+    }
+    return column;
+}
+
+class StreamingAggReductionTrackerTest : public testing::Test {
+public:
+    void SetUp() override { _sample_interval = config::streaming_agg_sample_interval; }
+    void TearDown() override { config::streaming_agg_sample_interval = _sample_interval; }
+
+private:
+    int32_t _sample_interval;
+};
+
+TEST_F(StreamingAggReductionTrackerTest, StopAndResume) {
+    config::streaming_agg_sample_interval = 2;
+    StreamingAggReductionTracker tracker;
+    auto unique_keys = create_keys(ROWS, 0);
+    auto repeated_keys = create_keys(16, 0);
+    ColumnRawPtrs unique_columns {unique_keys.get()};
+    ColumnRawPtrs repeated_columns {repeated_keys.get()};
+
+    // no statistics yet
+    EXPECT_TRUE(tracker.should_expand(unique_columns, ROWS, HUGE_HT_MEM, 0));
+
+    // near unique keys are not worth growing the table out of the cache
+    tracker.add_aggregated_rows(ROWS);
+    EXPECT_FALSE(tracker.should_expand(unique_columns, ROWS, HUGE_HT_MEM, ROWS));
+    EXPECT_FALSE(tracker.is_expanding());
+
+    // the sampled block is still unique
+    EXPECT_FALSE(tracker.should_expand(repeated_columns, ROWS, HUGE_HT_MEM, ROWS));
+    EXPECT_FALSE(tracker.should_expand(unique_columns, ROWS, HUGE_HT_MEM, ROWS));
+    // the keys repeat in the sampled block
+    EXPECT_FALSE(tracker.should_expand(repeated_columns, ROWS, HUGE_HT_MEM, ROWS));
+    EXPECT_TRUE(tracker.should_expand(repeated_columns, ROWS, HUGE_HT_MEM, ROWS));
+    EXPECT_TRUE(tracker.is_expanding());
+
+    // only the reduction since the aggregation resumed counts
+    tracker.add_aggregated_rows(ROWS);
+    EXPECT_TRUE(tracker.should_expand(repeated_columns, ROWS, HUGE_HT_MEM, ROWS + 16));
+    tracker.add_aggregated_rows(ROWS);
+    EXPECT_FALSE(tracker.should_expand(unique_columns, ROWS, HUGE_HT_MEM, 3 * ROWS));
+}
+
+TEST_F(StreamingAggReductionTrackerTest, SmallHashTable) {
+    StreamingAggReductionTracker tracker;
+    auto unique_keys = create_keys(ROWS, 0);
+    ColumnRawPtrs unique_columns {unique_keys.get()};
+
+    // always expand while the table fits in the L2 cache
+    tracker.add_aggregated_rows(ROWS);
+    EXPECT_TRUE(tracker.should_expand(unique_columns, ROWS, 1024, ROWS));
+}
+
+TEST_F(StreamingAggReductionTrackerTest, NoSampling) {
+    config::streaming_agg_sample_interval = 0;
+    StreamingAggReductionTracker tracker;
+    auto unique_keys = create_keys(ROWS, 0);
+    auto repeated_keys = create_keys(1, 0);
+    ColumnRawPtrs unique_columns {unique_keys.get()};
+    ColumnRawPtrs repeated_columns {repeated_keys.get()};
+
+    tracker.add_aggregated_rows(ROWS);
+    EXPECT_FALSE(tracker.should_expand(unique_columns, ROWS, HUGE_HT_MEM, ROWS));
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_FALSE(tracker.should_expand(repeated_columns, ROWS, HUGE_HT_MEM, ROWS));
+    }
+}
+
+} // namespace doris::vectorized
@@ -321,6 +321,9 @@ public class SessionVariable implements Serializable, Writable {
     public static final String EXTERNAL_SORT_BYTES_THRESHOLD = "external_sort_bytes_threshold";
     public static final String EXTERNAL_AGG_BYTES_THRESHOLD = "external_agg_bytes_threshold";
     public static final String EXTERNAL_AGG_PARTITION_BITS = "external_agg_partition_bits";
+    public static final String EXTERNAL_JOIN_BYTES_THRESHOLD = "external_join_bytes_threshold";
+    public static final String EXTERNAL_JOIN_PARTITION_BITS = "external_join_partition_bits";
+    public static final String EXTERNAL_ANALYTIC_BYTES_THRESHOLD = "external_analytic_bytes_threshold";
 
     public static final String ENABLE_TWO_PHASE_READ_OPT = "enable_two_phase_read_opt";
     public static final String TOPN_OPT_LIMIT_THRESHOLD = "topn_opt_limit_threshold";
@@ -1026,6 +1029,28 @@ public class SessionVariable implements Serializable, Writable {
             checker = "checkExternalAggPartitionBits", fuzzy = true)
     public int externalAggPartitionBits = 8; // means that the hash table will be partitioned into 256 blocks.
 
+    // If the build side of hash join exceed this limit, will trigger spill to disk;
+    // Set to 0 to disable; min: 128M
+    public static final long MIN_EXTERNAL_JOIN_BYTES_THRESHOLD = 134217728;
+    @VariableMgr.VarAttr(name = EXTERNAL_JOIN_BYTES_THRESHOLD,
+            checker = "checkExternalJoinBytesThreshold")
+    public long externalJoinBytesThreshold = 0;
+
+    public static final int MIN_EXTERNAL_JOIN_PARTITION_BITS = 2;
+    public static final int MAX_EXTERNAL_JOIN_PARTITION_BITS = 8;
+    @VariableMgr.VarAttr(name = EXTERNAL_JOIN_PARTITION_BITS,
+            checker = "checkExternalJoinPartitionBits")
+    public int externalJoinPartitionBits = 4; // means that both sides will be partitioned into 16 parts.
+
+    // If the buffered input of analytic node exceed this limit, will trigger spill to disk;
+    // Only the columns the window functions do not read are spilled, the partition by, order by
+    // and agg input columns of the current partition always stay in memory.
+    // Set to 0 to disable; min: 128M
+    public static final long MIN_EXTERNAL_ANALYTIC_BYTES_THRESHOLD = 134217728;
+    @VariableMgr.VarAttr(name = EXTERNAL_ANALYTIC_BYTES_THRESHOLD,
+            checker = "checkExternalAnalyticBytesThreshold")
+    public long externalAnalyticBytesThreshold = 0;
+
     // Whether enable two phase read optimization
     // 1. read related rowids along with necessary column data
     // 2. spawn fetch RPC to other nodes to get related data by sorted rowids
@@ -2179,6 +2204,33 @@ public class SessionVariable implements Serializable, Writable {
         }
     }
 
+    public void checkExternalJoinBytesThreshold(String externalJoinBytesThreshold) {
+        long value = Long.valueOf(externalJoinBytesThreshold);
+        if (value > 0 && value < MIN_EXTERNAL_JOIN_BYTES_THRESHOLD) {
+            LOG.warn("external join bytes threshold: {}, min: {}", value, MIN_EXTERNAL_JOIN_BYTES_THRESHOLD);
+            throw new UnsupportedOperationException("minimum value is " + MIN_EXTERNAL_JOIN_BYTES_THRESHOLD);
+        }
+    }
+
+    public void checkExternalJoinPartitionBits(String externalJoinPartitionBits) {
+        int value = Integer.valueOf(externalJoinPartitionBits);
+        if (value < MIN_EXTERNAL_JOIN_PARTITION_BITS || value > MAX_EXTERNAL_JOIN_PARTITION_BITS) {
+            LOG.warn("external join partition bits: {}, min: {}, max: {}",
+                    value, MIN_EXTERNAL_JOIN_PARTITION_BITS, MAX_EXTERNAL_JOIN_PARTITION_BITS);
+            throw new UnsupportedOperationException("min value is " + MIN_EXTERNAL_JOIN_PARTITION_BITS
+                    + " max value is " + MAX_EXTERNAL_JOIN_PARTITION_BITS);
+        }
+    }
+
+    public void checkExternalAnalyticBytesThreshold(String externalAnalyticBytesThreshold) {
+        long value = Long.valueOf(externalAnalyticBytesThreshold);
+        if (value > 0 && value < MIN_EXTERNAL_ANALYTIC_BYTES_THRESHOLD) {
+            LOG.warn("external analytic bytes threshold: {}, min: {}", value,
+                    MIN_EXTERNAL_ANALYTIC_BYTES_THRESHOLD);
+            throw new UnsupportedOperationException("minimum value is " + MIN_EXTERNAL_ANALYTIC_BYTES_THRESHOLD);
+        }
+    }
+
     public boolean isEnableFileCache() {
         return enableFileCache;
     }
@@ -2324,6 +2376,12 @@ public class SessionVariable implements Serializable, Writable {
 
         tResult.setExternalAggPartitionBits(externalAggPartitionBits);
 
+        tResult.setExternalJoinBytesThreshold(externalJoinBytesThreshold);
+
+        tResult.setExternalJoinPartitionBits(externalJoinPartitionBits);
+
+        tResult.setExternalAnalyticBytesThreshold(externalAnalyticBytesThreshold);
+
         tResult.setEnableFileCache(enableFileCache);
 
         tResult.setEnablePageCache(enablePageCache);
@@ -247,6 +247,17 @@ struct TQueryOptions {
   84: optional bool enable_profile = false;
   85: optional bool enable_page_cache = false;
   86: optional i32 analyze_timeout = 43200
+
+  // spill the build side of hash join into disk once it exceeds this size, not supported by
+  // the pipelineX engine
+  87: optional i64 external_join_bytes_threshold = 0
+
+  // partition count(1 << external_join_partition_bits) when spill hash join data into disk
+  88: optional i32 external_join_partition_bits = 4
+
+  // spill the buffered input blocks of analytic node once they exceed it, except for their
+  // partition by, order by and agg input columns, 0 to disable
+  89: optional i64 external_analytic_bytes_threshold = 0
 }
 
 